@@ -0,0 +1,228 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <string>
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY
+#include <emmintrin.h>
+#define SENDBIRD_TRANSCODE_SSE2 1
+#elif PLATFORM_ENABLE_VECTORINTRINSICS_NEON && (defined(__aarch64__) || defined(_M_ARM64))
+#include <arm_neon.h>
+#define SENDBIRD_TRANSCODE_NEON 1
+#endif
+
+/**
+ * Direct conversion between the SDK's std::wstring (UTF-16 on Windows, UTF-32 elsewhere) and FString (UTF-16),
+ * without the intermediate UTF-8 hop of std::wstring_convert.
+ * Runs of BMP characters are converted 8 code units at a time; surrogate pairs take the scalar path.
+ */
+namespace SendbirdTranscode
+{
+	static constexpr uint32 REPLACEMENT_CHARACTER = 0xFFFD;
+
+	template<bool bSameWidth, typename WideCharType = wchar_t>
+	struct TImpl;
+
+	// wchar_t and TCHAR are the same width: a plain copy.
+	template<typename WideCharType>
+	struct TImpl<true, WideCharType>
+	{
+		static FString ToFString(const wchar_t* Data, int32 Len)
+		{
+			return FString(Len, reinterpret_cast<const TCHAR*>(Data));
+		}
+
+		static std::wstring ToWString(const TCHAR* Data, int32 Len)
+		{
+			return std::wstring(reinterpret_cast<const wchar_t*>(Data), Len);
+		}
+	};
+
+	// wchar_t is UTF-32 and TCHAR is UTF-16.
+	template<typename WideCharType>
+	struct TImpl<false, WideCharType>
+	{
+		static_assert(sizeof(WideCharType) == 4 && sizeof(TCHAR) == 2, "Unsupported wchar_t/TCHAR combination.");
+
+		static int32 NarrowBlocks(const uint32* Src, uint16* Dst, int32 Len)
+		{
+			int32 Index = 0;
+#if SENDBIRD_TRANSCODE_SSE2
+			const __m128i Bias32 = _mm_set1_epi32(0x8000);
+			const __m128i Bias16 = _mm_set1_epi16((int16)0x8000);
+			const __m128i SurrogateLow = _mm_set1_epi32(0xD7FF);
+			const __m128i SurrogateHigh = _mm_set1_epi32(0xE000);
+			for (; Index + 8 <= Len; Index += 8)
+			{
+				const __m128i A = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src + Index));
+				const __m128i B = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src + Index + 4));
+
+				// Everything must be in the BMP and outside the surrogate range.
+				const __m128i OutOfBmp = _mm_srli_epi32(_mm_or_si128(A, B), 16);
+				const __m128i SurrogateA = _mm_and_si128(_mm_cmpgt_epi32(A, SurrogateLow), _mm_cmplt_epi32(A, SurrogateHigh));
+				const __m128i SurrogateB = _mm_and_si128(_mm_cmpgt_epi32(B, SurrogateLow), _mm_cmplt_epi32(B, SurrogateHigh));
+				if (_mm_movemask_epi8(_mm_cmpeq_epi32(OutOfBmp, _mm_setzero_si128())) != 0xFFFF
+					|| _mm_movemask_epi8(_mm_or_si128(SurrogateA, SurrogateB)) != 0)
+					break;
+
+				// Bias into the signed 16-bit range so the saturating pack is exact, then undo the bias.
+				const __m128i Packed = _mm_packs_epi32(_mm_sub_epi32(A, Bias32), _mm_sub_epi32(B, Bias32));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + Index), _mm_xor_si128(Packed, Bias16));
+			}
+#elif SENDBIRD_TRANSCODE_NEON
+			const uint32x4_t SurrogateBase = vdupq_n_u32(0xD800);
+			const uint32x4_t SurrogateSize = vdupq_n_u32(0x800);
+			for (; Index + 8 <= Len; Index += 8)
+			{
+				const uint32x4_t A = vld1q_u32(Src + Index);
+				const uint32x4_t B = vld1q_u32(Src + Index + 4);
+
+				const uint32x4_t Surrogate = vorrq_u32(vcltq_u32(vsubq_u32(A, SurrogateBase), SurrogateSize), vcltq_u32(vsubq_u32(B, SurrogateBase), SurrogateSize));
+				if (vmaxvq_u32(vmaxq_u32(A, B)) > 0xFFFF || vmaxvq_u32(Surrogate) != 0)
+					break;
+
+				vst1q_u16(Dst + Index, vcombine_u16(vmovn_u32(A), vmovn_u32(B)));
+			}
+#endif
+			return Index;
+		}
+
+		static int32 WidenBlocks(const uint16* Src, uint32* Dst, int32 Len)
+		{
+			int32 Index = 0;
+#if SENDBIRD_TRANSCODE_SSE2
+			const __m128i SurrogateMask = _mm_set1_epi16((int16)0xF800);
+			const __m128i SurrogateBase = _mm_set1_epi16((int16)0xD800);
+			const __m128i Zero = _mm_setzero_si128();
+			for (; Index + 8 <= Len; Index += 8)
+			{
+				const __m128i Units = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src + Index));
+				if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(Units, SurrogateMask), SurrogateBase)) != 0)
+					break;
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + Index), _mm_unpacklo_epi16(Units, Zero));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + Index + 4), _mm_unpackhi_epi16(Units, Zero));
+			}
+#elif SENDBIRD_TRANSCODE_NEON
+			const uint16x8_t SurrogateMask = vdupq_n_u16(0xF800);
+			const uint16x8_t SurrogateBase = vdupq_n_u16(0xD800);
+			for (; Index + 8 <= Len; Index += 8)
+			{
+				const uint16x8_t Units = vld1q_u16(Src + Index);
+				if (vmaxvq_u16(vceqq_u16(vandq_u16(Units, SurrogateMask), SurrogateBase)) != 0)
+					break;
+
+				vst1q_u32(Dst + Index, vmovl_u16(vget_low_u16(Units)));
+				vst1q_u32(Dst + Index + 4, vmovl_u16(vget_high_u16(Units)));
+			}
+#endif
+			return Index;
+		}
+
+		static FString ToFString(const wchar_t* Data, int32 Len)
+		{
+			const uint32* Src = reinterpret_cast<const uint32*>(Data);
+
+			FString Result;
+			TArray<TCHAR>& Chars = Result.GetCharArray();
+			Chars.SetNumUninitialized(Len + 1);
+			uint16* Dst = reinterpret_cast<uint16*>(Chars.GetData());
+
+			int32 SrcIndex = 0;
+			int32 DstIndex = 0;
+			while (SrcIndex < Len)
+			{
+				const int32 Converted = NarrowBlocks(Src + SrcIndex, Dst + DstIndex, Len - SrcIndex);
+				SrcIndex += Converted;
+				DstIndex += Converted;
+
+				// Scalar until the next block boundary, or the end of the string.
+				const int32 ScalarEnd = FMath::Min(SrcIndex + 8, Len);
+				for (; SrcIndex < ScalarEnd; ++SrcIndex)
+				{
+					const uint32 CodePoint = Src[SrcIndex];
+					if (CodePoint < 0x10000)
+					{
+						Dst[DstIndex++] = (CodePoint >= 0xD800 && CodePoint <= 0xDFFF) ? REPLACEMENT_CHARACTER : (uint16)CodePoint;
+					}
+					else if (CodePoint <= 0x10FFFF)
+					{
+						// A surrogate pair needs one more unit than reserved.
+						Chars.AddUninitialized(1);
+						Dst = reinterpret_cast<uint16*>(Chars.GetData());
+
+						const uint32 Offset = CodePoint - 0x10000;
+						Dst[DstIndex++] = (uint16)(0xD800 + (Offset >> 10));
+						Dst[DstIndex++] = (uint16)(0xDC00 + (Offset & 0x3FF));
+					}
+					else
+					{
+						Dst[DstIndex++] = REPLACEMENT_CHARACTER;
+					}
+				}
+			}
+
+			Dst[DstIndex] = 0;
+			return Result;
+		}
+
+		static std::wstring ToWString(const TCHAR* Data, int32 Len)
+		{
+			const uint16* Src = reinterpret_cast<const uint16*>(Data);
+
+			std::wstring Result;
+			Result.resize(Len);
+			uint32* Dst = reinterpret_cast<uint32*>(&Result[0]);
+
+			int32 SrcIndex = 0;
+			int32 DstIndex = 0;
+			while (SrcIndex < Len)
+			{
+				const int32 Converted = WidenBlocks(Src + SrcIndex, Dst + DstIndex, Len - SrcIndex);
+				SrcIndex += Converted;
+				DstIndex += Converted;
+
+				const int32 ScalarEnd = FMath::Min(SrcIndex + 8, Len);
+				while (SrcIndex < ScalarEnd)
+				{
+					const uint16 Unit = Src[SrcIndex++];
+					if (Unit >= 0xD800 && Unit <= 0xDBFF && SrcIndex < Len && Src[SrcIndex] >= 0xDC00 && Src[SrcIndex] <= 0xDFFF)
+					{
+						Dst[DstIndex++] = 0x10000 + (((uint32)Unit - 0xD800) << 10) + ((uint32)Src[SrcIndex++] - 0xDC00);
+					}
+					else
+					{
+						Dst[DstIndex++] = (Unit >= 0xD800 && Unit <= 0xDFFF) ? REPLACEMENT_CHARACTER : Unit;
+					}
+				}
+			}
+
+			Result.resize(DstIndex);
+			return Result;
+		}
+	};
+
+	using FImpl = TImpl<sizeof(wchar_t) == sizeof(TCHAR)>;
+
+	inline FString ToFString(const wchar_t* Data, int32 Len)
+	{
+		return Len > 0 ? FImpl::ToFString(Data, Len) : FString();
+	}
+
+	inline FString ToFString(const std::wstring& Source)
+	{
+		return ToFString(Source.data(), (int32)Source.size());
+	}
+
+	inline std::wstring ToWString(const TCHAR* Data, int32 Len)
+	{
+		return Len > 0 ? FImpl::ToWString(Data, Len) : std::wstring();
+	}
+
+	inline std::wstring ToWString(const FString& Source)
+	{
+		return ToWString(*Source, Source.Len());
+	}
+}
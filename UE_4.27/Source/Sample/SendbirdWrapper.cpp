@@ -4,6 +4,20 @@
 #include "SendbirdWrapper.h"
 
 #if WITH_SENDBIRD
+#include "Sendbird/SendbirdTranscode.h"
+#include "Containers/Ticker.h"
+
+ReconnectionHandler::~ReconnectionHandler() {
+	CancelRetry();
+}
+
+void ReconnectionHandler::CancelRetry() {
+	if (retryHandle.IsValid()) {
+		FTicker::GetCoreTicker().RemoveTicker(retryHandle);
+		retryHandle.Reset();
+	}
+}
+
 void ReconnectionHandler::Started() {
 	UE_LOG(LogTemp, Warning, TEXT("Reconnection Started()"));
 
@@ -19,6 +33,9 @@ void ReconnectionHandler::Succeeded() {
 	UE_LOG(LogTemp, Warning, TEXT("Reconnection Succeeded()"));
 
 	AsyncTask(ENamedThreads::GameThread, [this]() {
+		this->failedAttempts = 0;
+		this->CancelRetry();
+
 		if (this->sendbird != nullptr && this->sendbird->reconnectionSucceededDelegate.IsBound()) {
 			UE_LOG(LogTemp, Warning, TEXT("reconnectionSucceededDelegate.Broadcast()"));
 			this->sendbird->reconnectionSucceededDelegate.Broadcast();
@@ -30,7 +47,17 @@ void ReconnectionHandler::Failed() {
 	UE_LOG(LogTemp, Warning, TEXT("Reconnection Failed()"));
 
 	AsyncTask(ENamedThreads::GameThread, [this]() {
-		SBDMain::Reconnect(); // Reconnect
+		// Full jitter: anywhere from now to the exponential bound.
+		const float bound = FMath::Min(MAX_BACKOFF_SECONDS, BASE_BACKOFF_SECONDS * (float)(1 << FMath::Min(this->failedAttempts, 16)));
+		const float delay = FMath::FRandRange(0.0f, bound);
+		++this->failedAttempts;
+
+		this->CancelRetry();
+		this->retryHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([this](float) {
+			this->retryHandle.Reset();
+			SBDMain::Reconnect(); // Reconnect
+			return false;
+		}), delay);
 
 		if (this->sendbird != nullptr && this->sendbird->reconnectionFailedDelegate.IsBound()) {
 			UE_LOG(LogTemp, Warning, TEXT("reconnectionFailedDelegate.Broadcast()"));
@@ -52,9 +79,9 @@ void ChannelHandler::MessageReceived(SBDBaseChannel* channel, SBDBaseMessage* me
 			if (message->message_type == SBDMessageType::User) {
 				SBDUserMessage* userMessage = static_cast<SBDUserMessage*>(message);
 
-				FString fstrChannelUrl = FString(UTF8_TO_TCHAR(std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes(groupChannel->channel_url).c_str()));
-				FString fstrMessage = FString(UTF8_TO_TCHAR(std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes(userMessage->message).c_str()));
-				FString fstrSender = FString(UTF8_TO_TCHAR(std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes(userMessage->sender.user_id).c_str()));
+				FString fstrChannelUrl = SendbirdTranscode::ToFString(groupChannel->channel_url);
+				FString fstrMessage = SendbirdTranscode::ToFString(userMessage->message);
+				FString fstrSender = SendbirdTranscode::ToFString(userMessage->sender.user_id);
 				if (this->sendbird != nullptr) {
 					this->sendbird->GroupChannelUserMessageReceived(fstrChannelUrl, fstrMessage, fstrSender);
 				}
@@ -64,9 +91,9 @@ void ChannelHandler::MessageReceived(SBDBaseChannel* channel, SBDBaseMessage* me
 			if (message->message_type == SBDMessageType::User) {
 				SBDUserMessage* userMessage = static_cast<SBDUserMessage*>(message);
 
-				FString fstrChannelUrl = FString(UTF8_TO_TCHAR(std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes(openChannel->channel_url).c_str()));
-				FString fstrMessage = FString(UTF8_TO_TCHAR(std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes(userMessage->message).c_str()));
-				FString fstrSender = FString(UTF8_TO_TCHAR(std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes(userMessage->sender.user_id).c_str()));
+				FString fstrChannelUrl = SendbirdTranscode::ToFString(openChannel->channel_url);
+				FString fstrMessage = SendbirdTranscode::ToFString(userMessage->message);
+				FString fstrSender = SendbirdTranscode::ToFString(userMessage->sender.user_id);
 				if (this->sendbird != nullptr) {
 					this->sendbird->OpenChannelUserMessageReceived(fstrChannelUrl, fstrMessage, fstrSender);
 				}
@@ -107,7 +134,7 @@ FString USendbirdWrapper::GetSdkVersion()
 {
 	FString version;
 #if WITH_SENDBIRD
-	version = FString(std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes(SBDMain::GetSdkVersion()).c_str());
+	version = SendbirdTranscode::ToFString(SBDMain::GetSdkVersion());
 	UE_LOG(LogTemp, Warning, TEXT("GetSdkVersion(): %s"), *version);
 #endif
 	return version;
@@ -123,15 +150,15 @@ void USendbirdWrapper::Connect(const FString& userId)
 	}
 
 	AsyncTask(ENamedThreads::GameThread, [this, userId]() {
-		std::wstring wstrUserId = std::wstring_convert<std::codecvt_utf8<wchar_t>>().from_bytes(std::string(TCHAR_TO_UTF8(*userId)));
+		std::wstring wstrUserId = SendbirdTranscode::ToWString(userId);
 
 		SBDMain::Connect(wstrUserId, SBD_NULL_WSTRING, [this, userId](SBDUser* user, SBDError* error) {
 			bool isConnected = (error == nullptr);
 			if (isConnected) {
-				std::string strUserId = std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes(user->user_id);
-				AsyncTask(ENamedThreads::GameThread, [this, isConnected, strUserId]() {
+				FString fstrUserId = SendbirdTranscode::ToFString(user->user_id);
+				AsyncTask(ENamedThreads::GameThread, [this, isConnected, fstrUserId]() {
 					if (this->connectDelegate.IsBound()) {
-						this->connectDelegate.Broadcast(isConnected, FString(UTF8_TO_TCHAR(strUserId.c_str())));
+						this->connectDelegate.Broadcast(isConnected, fstrUserId);
 					}
 				});
 			} else {
@@ -230,8 +257,8 @@ void USendbirdWrapper::GroupChannelListQuery()
 						TArray<FString> channelNames;
 						TArray<int> memberCounts;
 						for (SBDGroupChannel* channel : channels) {
-							channelUrls.Add(FString(UTF8_TO_TCHAR(std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes(channel->channel_url).c_str())));
-							channelNames.Add(FString(UTF8_TO_TCHAR(std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes(channel->name).c_str())));
+							channelUrls.Add(SendbirdTranscode::ToFString(channel->channel_url));
+							channelNames.Add(SendbirdTranscode::ToFString(channel->name));
 							memberCounts.Add(static_cast<int>(channel->member_count));
 						}
 						this->groupChannelListQueryDelegate.Broadcast(result, channelUrls, channelNames, memberCounts);
@@ -262,8 +289,8 @@ void USendbirdWrapper::GroupChannelCreate(const FString& channelName, const FStr
 	}
 
 	AsyncTask(ENamedThreads::GameThread, [this, channelName, userIdToInvite]() {
-		std::wstring wstrChannelName = std::wstring_convert<std::codecvt_utf8<wchar_t>>().from_bytes(std::string(TCHAR_TO_UTF8(*channelName)));
-		std::wstring wstrUserId = std::wstring_convert<std::codecvt_utf8<wchar_t>>().from_bytes(std::string(TCHAR_TO_UTF8(*userIdToInvite)));
+		std::wstring wstrChannelName = SendbirdTranscode::ToWString(channelName);
+		std::wstring wstrUserId = SendbirdTranscode::ToWString(userIdToInvite);
 
 		std::vector<std::wstring> userIds;
 		userIds.push_back(wstrUserId);
@@ -290,7 +317,7 @@ void USendbirdWrapper::GroupChannelMessageListQuery(const FString& channelUrl)
 	}
 
 	AsyncTask(ENamedThreads::GameThread, [this, channelUrl]() {
-		std::wstring wstrChannelUrl = std::wstring_convert<std::codecvt_utf8<wchar_t>>().from_bytes(std::string(TCHAR_TO_UTF8(*channelUrl)));
+		std::wstring wstrChannelUrl = SendbirdTranscode::ToWString(channelUrl);
 
 		SBDGroupChannel::GetChannel(wstrChannelUrl, [this](SBDGroupChannel* channel, SBDError* error) {
 			if (error == nullptr) {
@@ -304,8 +331,8 @@ void USendbirdWrapper::GroupChannelMessageListQuery(const FString& channelUrl)
 									TArray<FString> senders;
 									for (SBDBaseMessage* baseMessage : baseMessages) {
 										SBDUserMessage* userMessage = static_cast<SBDUserMessage*>(baseMessage);
-										messages.Add(FString(UTF8_TO_TCHAR(std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes(userMessage->message).c_str())));
-										senders.Add(FString(UTF8_TO_TCHAR(std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes(userMessage->sender.user_id).c_str())));
+										messages.Add(SendbirdTranscode::ToFString(userMessage->message));
+										senders.Add(SendbirdTranscode::ToFString(userMessage->sender.user_id));
 									}
 									this->groupChannelMessageListQueryDelegate.Broadcast(true, messages, senders);
 								}
@@ -329,7 +356,7 @@ void USendbirdWrapper::GroupChannelSendUserMessage(const FString& channelUrl, co
 	}
 
 	AsyncTask(ENamedThreads::GameThread, [this, channelUrl, message]() {
-		std::wstring wstrChannelUrl = std::wstring_convert<std::codecvt_utf8<wchar_t>>().from_bytes(std::string(TCHAR_TO_UTF8(*channelUrl)));
+		std::wstring wstrChannelUrl = SendbirdTranscode::ToWString(channelUrl);
 
 		SBDGroupChannel::GetChannel(wstrChannelUrl, [this, message](SBDGroupChannel* channel, SBDError* error) {
 			if (error == nullptr) {
@@ -338,8 +365,8 @@ void USendbirdWrapper::GroupChannelSendUserMessage(const FString& channelUrl, co
 						if (error == nullptr) {
 							AsyncTask(ENamedThreads::GameThread, [this, userMessage]() {
 								if (this->groupChannelSendUserMessageDelegate.IsBound()) {
-									FString fstrMessage = FString(UTF8_TO_TCHAR(std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes(userMessage->message).c_str()));
-									FString fstrSender = FString(UTF8_TO_TCHAR(std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes(userMessage->sender.user_id).c_str()));
+									FString fstrMessage = SendbirdTranscode::ToFString(userMessage->message);
+									FString fstrSender = SendbirdTranscode::ToFString(userMessage->sender.user_id);
 									this->groupChannelSendUserMessageDelegate.Broadcast(true, fstrMessage, fstrSender);
 									UE_LOG(LogTemp, Warning, TEXT("groupChannelSendUserMessageDelegate.Broadcast(): %s"), *fstrMessage);
 								}
@@ -370,8 +397,8 @@ void USendbirdWrapper::OpenChannelListQuery()
 						TArray<FString> channelNames;
 						TArray<int> participantCounts;
 						for (SBDOpenChannel* channel : channels) {
-							channelUrls.Add(FString(UTF8_TO_TCHAR(std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes(channel->channel_url).c_str())));
-							channelNames.Add(FString(UTF8_TO_TCHAR(std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes(channel->name).c_str())));
+							channelUrls.Add(SendbirdTranscode::ToFString(channel->channel_url));
+							channelNames.Add(SendbirdTranscode::ToFString(channel->name));
 							participantCounts.Add(static_cast<int>(channel->participant_count));
 						}
 						this->openChannelListQueryDelegate.Broadcast(result, channelUrls, channelNames, participantCounts);
@@ -402,7 +429,7 @@ void USendbirdWrapper::OpenChannelCreate(const FString& channelName)
 	}
 
 	AsyncTask(ENamedThreads::GameThread, [this, channelName]() {
-		std::wstring wstrChannelName = std::wstring_convert<std::codecvt_utf8<wchar_t>>().from_bytes(std::string(TCHAR_TO_UTF8(*channelName)));
+		std::wstring wstrChannelName = SendbirdTranscode::ToWString(channelName);
 
 		SBDOpenChannel::CreateChannel(wstrChannelName, SBD_NULL_WSTRING, SBD_NULL_WSTRING, SBD_NULL_WSTRING,
 			std::vector<std::wstring>(), SBD_NULL_WSTRING, [this](SBDOpenChannel* channel, SBDError* error) {
@@ -427,7 +454,7 @@ void USendbirdWrapper::OpenChannelMessageListQuery(const FString& channelUrl)
 	}
 
 	AsyncTask(ENamedThreads::GameThread, [this, channelUrl]() {
-		std::wstring wstrChannelUrl = std::wstring_convert<std::codecvt_utf8<wchar_t>>().from_bytes(std::string(TCHAR_TO_UTF8(*channelUrl)));
+		std::wstring wstrChannelUrl = SendbirdTranscode::ToWString(channelUrl);
 
 		SBDOpenChannel::GetChannel(wstrChannelUrl, [this](SBDOpenChannel* channel, SBDError* error) {
 			if (error == nullptr) {
@@ -441,8 +468,8 @@ void USendbirdWrapper::OpenChannelMessageListQuery(const FString& channelUrl)
 									TArray<FString> senders;
 									for (SBDBaseMessage* baseMessage : baseMessages) {
 										SBDUserMessage* userMessage = static_cast<SBDUserMessage*>(baseMessage);
-										messages.Add(FString(UTF8_TO_TCHAR(std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes(userMessage->message).c_str())));
-										senders.Add(FString(UTF8_TO_TCHAR(std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes(userMessage->sender.user_id).c_str())));
+										messages.Add(SendbirdTranscode::ToFString(userMessage->message));
+										senders.Add(SendbirdTranscode::ToFString(userMessage->sender.user_id));
 									}
 									this->openChannelMessageListQueryDelegate.Broadcast(true, messages, senders);
 								}
@@ -466,7 +493,7 @@ void USendbirdWrapper::OpenChannelEnter(const FString& channelUrl)
 	}
 
 	AsyncTask(ENamedThreads::GameThread, [this, channelUrl]() {
-		std::wstring wstrChannelUrl = std::wstring_convert<std::codecvt_utf8<wchar_t>>().from_bytes(std::string(TCHAR_TO_UTF8(*channelUrl)));
+		std::wstring wstrChannelUrl = SendbirdTranscode::ToWString(channelUrl);
 
 		SBDOpenChannel::GetChannel(wstrChannelUrl, [this](SBDOpenChannel* channel, SBDError* error) {
 			AsyncTask(ENamedThreads::GameThread, [this, channel, error]() {
@@ -510,7 +537,7 @@ void USendbirdWrapper::OpenChannelExit(const FString& channelUrl)
 	}
 
 	AsyncTask(ENamedThreads::GameThread, [this, channelUrl]() {
-		std::wstring wstrChannelUrl = std::wstring_convert<std::codecvt_utf8<wchar_t>>().from_bytes(std::string(TCHAR_TO_UTF8(*channelUrl)));
+		std::wstring wstrChannelUrl = SendbirdTranscode::ToWString(channelUrl);
 
 		SBDOpenChannel::GetChannel(wstrChannelUrl, [this](SBDOpenChannel* channel, SBDError* error) {
 			AsyncTask(ENamedThreads::GameThread, [this, channel, error]() {
@@ -554,7 +581,7 @@ void USendbirdWrapper::OpenChannelSendUserMessage(const FString& channelUrl, con
 	}
 
 	AsyncTask(ENamedThreads::GameThread, [this, channelUrl, message]() {
-		std::wstring wstrChannelUrl = std::wstring_convert<std::codecvt_utf8<wchar_t>>().from_bytes(std::string(TCHAR_TO_UTF8(*channelUrl)));
+		std::wstring wstrChannelUrl = SendbirdTranscode::ToWString(channelUrl);
 
 		SBDOpenChannel::GetChannel(wstrChannelUrl, [this, message](SBDOpenChannel* channel, SBDError* error) {
 			AsyncTask(ENamedThreads::GameThread, [this, channel, error, message]() {
@@ -563,8 +590,8 @@ void USendbirdWrapper::OpenChannelSendUserMessage(const FString& channelUrl, con
 						if (error == nullptr) {
 							AsyncTask(ENamedThreads::GameThread, [this, userMessage]() {
 								if (this->openChannelSendUserMessageDelegate.IsBound()) {
-									FString fstrMessage = FString(UTF8_TO_TCHAR(std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes(userMessage->message).c_str()));
-									FString fstrSender = FString(UTF8_TO_TCHAR(std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes(userMessage->sender.user_id).c_str()));
+									FString fstrMessage = SendbirdTranscode::ToFString(userMessage->message);
+									FString fstrSender = SendbirdTranscode::ToFString(userMessage->sender.user_id);
 									this->openChannelSendUserMessageDelegate.Broadcast(true, fstrMessage, fstrSender);
 									UE_LOG(LogTemp, Warning, TEXT("openChannelSendUserMessageDelegate.Broadcast(): %s"), *fstrMessage);
 								}
@@ -44,18 +44,29 @@ private:
 	TWeakObjectPtr<USendbirdWrapper> sendbird;
 };
 
+// Failed reconnections are retried after a full-jitter backoff: a random delay up to
+// min(MAX_BACKOFF_SECONDS, BASE_BACKOFF_SECONDS * 2^n) after the n-th failure in a row, so the clients one server
+// blip dropped don't all retry at once.
 class ReconnectionHandler : public SBDConnectionHandler {
 public:
-	ReconnectionHandler(USendbirdWrapper* sendbirdWrapper) : sendbird(sendbirdWrapper) {}
-	virtual ~ReconnectionHandler() {}
+	static constexpr float BASE_BACKOFF_SECONDS = 1.0f;
+	static constexpr float MAX_BACKOFF_SECONDS = 60.0f;
+
+	ReconnectionHandler(USendbirdWrapper* sendbirdWrapper) : sendbird(sendbirdWrapper), failedAttempts(0) {}
+	virtual ~ReconnectionHandler();
 
 private:
 	void Started();
 	void Succeeded();
 	void Failed();
 
+	void CancelRetry();
+
 private:
 	TWeakObjectPtr<USendbirdWrapper> sendbird;
+	// Game thread only.
+	int32 failedAttempts;
+	FDelegateHandle retryHandle;
 };
 #endif
 
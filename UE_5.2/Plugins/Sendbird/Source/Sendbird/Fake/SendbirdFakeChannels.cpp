@@ -0,0 +1,1366 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#include "SendbirdFakeServer.h"
+
+#if SENDBIRD_FAKE_BACKEND
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include <algorithm>
+#include <string>
+
+using namespace SendbirdFake;
+using FChannelRecord = FSendbirdFakeServer::FChannelRecord;
+
+static const char* DescribeError(int64_t Code)
+{
+	switch (Code)
+	{
+	case ERROR_CHANNEL_NOT_FOUND:	return "Channel not found.";
+	case ERROR_MESSAGE_NOT_FOUND:	return "Message not found.";
+	case ERROR_NOT_A_MEMBER:		return "User is not a member of the channel.";
+	case ERROR_USER_MUTED:			return "User is muted.";
+	case ERROR_CHANNEL_FROZEN:		return "Channel is frozen.";
+	case ERROR_USER_BANNED:			return "User is banned.";
+	case SBDErrorInvalidParameter:	return "Invalid parameter.";
+	default:						return "Request failed.";
+	}
+}
+
+// Runs Work on the channel's record under Lock once the request reaches the server; Work returns an error code or SBDErrorNone.
+static void ChannelRequest(const std::wstring& ChannelUrl, std::function<int64_t(FSendbirdFakeServer&, FChannelRecord&)> Work, std::function<void(SBDError*)> Done)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	Server.Request([&Server, ChannelUrl, Work, Done](SBDError* Error) {
+		FServerError ServerError;
+		if (Error == nullptr)
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+			FChannelRecord* Record = Server.FindRecord(ChannelUrl);
+			const int64_t Code = Record != nullptr ? Work(Server, *Record) : ERROR_CHANNEL_NOT_FOUND;
+			if (Code != SBDErrorNone)
+				Error = ServerError.Set(Code, DescribeError(Code));
+		}
+		Done(Error);
+	});
+}
+
+template<typename ResultType>
+static void ChannelRequest(const std::wstring& ChannelUrl, std::function<int64_t(FSendbirdFakeServer&, FChannelRecord&, ResultType&)> Work,
+	std::function<void(const ResultType&, SBDError*)> Done)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	Server.Request([&Server, ChannelUrl, Work, Done](SBDError* Error) {
+		FServerError ServerError;
+		ResultType Result{};
+		if (Error == nullptr)
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+			FChannelRecord* Record = Server.FindRecord(ChannelUrl);
+			const int64_t Code = Record != nullptr ? Work(Server, *Record, Result) : ERROR_CHANNEL_NOT_FOUND;
+			if (Code != SBDErrorNone)
+			{
+				Result = ResultType{};
+				Error = ServerError.Set(Code, DescribeError(Code));
+			}
+		}
+		Done(Result, Error);
+	});
+}
+
+static int64_t GetSendErrorCode(FSendbirdFakeServer& Server, const FChannelRecord* Record)
+{
+	if (Record == nullptr)
+		return ERROR_CHANNEL_NOT_FOUND;
+
+	const std::wstring& UserId = Server.CurrentUser.user_id;
+	if (Record->bOpen)
+	{
+		if (Record->BannedUserIds.count(UserId) > 0)
+			return ERROR_USER_BANNED;
+		if (Record->Participants.count(UserId) == 0)
+			return ERROR_NOT_A_MEMBER;
+		if (Record->MutedUserIds.count(UserId) > 0)
+			return ERROR_USER_MUTED;
+		if (static_cast<SBDOpenChannel*>(Record->Channel)->is_frozen && Record->OperatorUserIds.count(UserId) == 0)
+			return ERROR_CHANNEL_FROZEN;
+		return SBDErrorNone;
+	}
+
+	const SBDMember* Me = FSendbirdFakeServer::FindMember(static_cast<SBDGroupChannel*>(Record->Channel), UserId);
+	return Me != nullptr && Me->state == SBDMemberState::Joined ? (int64_t)SBDErrorNone : ERROR_NOT_A_MEMBER;
+}
+
+// Stores a pending message once the request reaches the server. Own messages are not echoed to the channel handlers.
+template<typename MessageType>
+static void DeliverMessage(MessageType* Message, std::function<void(MessageType*, SBDError*)> CompletionHandler)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	Server.Request([&Server, Message, CompletionHandler](SBDError* Error) {
+		FServerError ServerError;
+		bool bUnreadChanged = false;
+		if (Error == nullptr)
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+			FChannelRecord* Record = Server.FindRecord(Message->channel_url);
+			const int64_t Code = GetSendErrorCode(Server, Record);
+			if (Code != SBDErrorNone)
+			{
+				Error = ServerError.Set(Code, DescribeError(Code));
+			}
+			else
+			{
+				Message->created_at = Server.NextTimestamp();
+				Server.AddMessage(*Record, Message);
+
+				bUnreadChanged = !Record->bOpen && static_cast<SBDGroupChannel*>(Record->Channel)->unread_message_count > 0;
+				Server.MarkAsRead(*Record, Server.CurrentUser.user_id);
+			}
+		}
+
+		Complete(CompletionHandler, Message, Error);
+		if (bUnreadChanged)
+			Server.BroadcastUnreadCountChanged();
+	});
+}
+
+static std::wstring GetSenderId(const SBDBaseMessage* Message)
+{
+	switch (Message->message_type)
+	{
+	case SBDMessageType::User:	return static_cast<const SBDUserMessage*>(Message)->sender.user_id;
+	case SBDMessageType::File:	return static_cast<const SBDFileMessage*>(Message)->sender.user_id;
+	default:					return std::wstring();
+	}
+}
+
+static void SetIfNotNull(std::wstring& Field, const std::wstring& Value)
+{
+	if (!IsNullWString(Value))
+		Field = Value;
+}
+
+static void CollectAround(const FSendbirdFakeServer& Server, const FChannelRecord& Record, int64_t Pivot, int64_t PrevLimit, int64_t NextLimit, bool bReverse,
+	SBDMessageTypeFilter MessageType, const std::wstring& CustomType, std::vector<SBDBaseMessage*>& OutMessages)
+{
+	// The pivot itself counts towards the previous page when both sides are requested.
+	if (PrevLimit > 0)
+		Server.CollectMessages(Record, Pivot, false, NextLimit > 0, PrevLimit, MessageType, CustomType, OutMessages);
+	if (NextLimit > 0)
+		Server.CollectMessages(Record, Pivot, true, false, NextLimit, MessageType, CustomType, OutMessages);
+	FSendbirdFakeServer::SortMessages(OutMessages, bReverse);
+}
+
+static int64_t FindPivot(FSendbirdFakeServer& Server, const FChannelRecord& Record, int64_t MessageId, int64_t& OutPivot)
+{
+	const SBDBaseMessage* Message = Server.FindMessage((uint64_t)MessageId);
+	if (Message == nullptr || Message->channel_url != Record.Channel->channel_url)
+		return ERROR_MESSAGE_NOT_FOUND;
+
+	OutPivot = Message->created_at;
+	return SBDErrorNone;
+}
+
+static void SyncOperators(FSendbirdFakeServer& Server, FChannelRecord& Record)
+{
+	if (!Record.bOpen)
+		return;
+
+	SBDOpenChannel* Channel = static_cast<SBDOpenChannel*>(Record.Channel);
+	Channel->operators.clear();
+	for (const std::wstring& UserId : Record.OperatorUserIds)
+		Channel->operators.push_back(*Server.FindOrAddUser(UserId));
+}
+
+//+ SBDBaseChannel
+SBDBaseChannel::SBDBaseChannel(const std::string& dict)
+	: created_at(0)
+	, is_group_channel(false)
+	, is_open_channel(false)
+{
+}
+
+SBDUserMessage* SBDBaseChannel::SendUserMessage(SBDUserMessageParams& params, std::function<void(SBDUserMessage*, SBDError*)> completion_handler)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	SBDUserMessage* Message = nullptr;
+	{
+		FScopeLock ScopeLock(&Server.Lock);
+		FChannelRecord* Record = Server.FindRecord(this);
+		if (Record == nullptr)
+		{
+			Server.Reject([completion_handler](SBDError* Error) { Complete(completion_handler, nullptr, Error); }, ERROR_CHANNEL_NOT_FOUND, DescribeError(ERROR_CHANNEL_NOT_FOUND));
+			return nullptr;
+		}
+
+		Message = Server.NewUserMessage(*Record, Server.CurrentUser, SBDCommand::GetMessage(params));
+		Message->created_at = 0;
+		Message->request_id = Server.NextRequestId();
+		Message->data = SBDCommand::GetData(params);
+		Message->custom_type = SBDCommand::GetCustomType(params);
+		Message->mention_type = SBDCommand::GetMentionType(params);
+		for (const std::wstring& UserId : SBDCommand::GetMentionedUserIds(params))
+		{
+			if (const SBDUser* User = Server.FindUser(UserId))
+				Message->mentioned_users.push_back(*User);
+		}
+		for (const std::wstring& Key : SBDCommand::GetMetaArrayKeys(params))
+			Message->meta_arrays.push_back(FSBDMessageMetaArray::Make(Key));
+	}
+
+	DeliverMessage(Message, completion_handler);
+	return Message;
+}
+
+static SBDFileMessage* SendFile(SBDBaseChannel* Channel, const std::wstring& Url, const std::wstring& Name, int64_t Size, const std::wstring& Type,
+	const std::vector<SBDThumbnailSize>& ThumbnailSizes, const std::wstring& Data, const std::wstring& CustomType,
+	std::function<void(SBDFileMessage*, SBDError*)> CompletionHandler)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	SBDFileMessage* Message = nullptr;
+	{
+		FScopeLock ScopeLock(&Server.Lock);
+		FChannelRecord* Record = Server.FindRecord(Channel);
+		if (Record == nullptr)
+		{
+			Server.Reject([CompletionHandler](SBDError* Error) { Complete(CompletionHandler, nullptr, Error); }, ERROR_CHANNEL_NOT_FOUND, DescribeError(ERROR_CHANNEL_NOT_FOUND));
+			return nullptr;
+		}
+
+		Message = Server.NewFileMessage(*Record, Server.CurrentUser, Name, (uint64_t)FMath::Max<int64_t>(Size, 0), Type);
+		Message->created_at = 0;
+		Message->request_id = Server.NextRequestId();
+		Message->data = Data;
+		Message->custom_type = CustomType;
+		if (!Url.empty())
+			Message->url = Url;
+
+		for (const SBDThumbnailSize& ThumbnailSize : ThumbnailSizes)
+		{
+			const std::wstring ThumbnailUrl = Message->url + L"?thumbnail=" + std::to_wstring(ThumbnailSize.max_width) + L"x" + std::to_wstring(ThumbnailSize.max_height);
+			Message->thumbnails.emplace_back(ThumbnailSize.max_width, ThumbnailSize.max_height, ThumbnailSize.max_width, ThumbnailSize.max_height, ThumbnailUrl, false);
+		}
+	}
+
+	DeliverMessage(Message, CompletionHandler);
+	return Message;
+}
+
+SBDFileMessage* SBDBaseChannel::SendFileMessage(const char* file_buf, const std::wstring& filename, int64_t size, const std::wstring& type,
+	std::vector<SBDThumbnailSize> thumbnail_sizes, const std::wstring& data, const std::wstring& custom_type,
+	std::function<void(SBDFileMessage*, SBDError*)> completion_handler)
+{
+	return SendFile(this, std::wstring(), filename, size, type, thumbnail_sizes, data, custom_type, completion_handler);
+}
+
+SBDFileMessage* SBDBaseChannel::SendFileMessage(SBDFileMessageParams& params, std::function<void(SBDFileMessage*, SBDError*)> completion_handler)
+{
+	std::wstring FileName = params.file_name;
+	int64_t FileSize = params.file_size;
+	if (params.file_url.empty())
+	{
+		const FString FilePath = SendbirdTranscode::ToFString(params.file_path);
+		const int64 DiskSize = params.file_path.empty() ? -1 : IFileManager::Get().FileSize(*FilePath);
+		if (DiskSize < 0)
+		{
+			FSendbirdFakeServer::Get().Reject([completion_handler](SBDError* Error) { Complete(completion_handler, nullptr, Error); },
+				SBDErrorInvalidParameter, "File not found.");
+			return nullptr;
+		}
+
+		if (FileName.empty())
+			FileName = SendbirdTranscode::ToWString(FPaths::GetCleanFilename(FilePath));
+		if (FileSize <= 0)
+			FileSize = DiskSize;
+	}
+
+	return SendFile(this, params.file_url, FileName, FileSize, params.mime_type, params.thumbnail_sizes, params.data, params.custom_type, completion_handler);
+}
+
+void SBDBaseChannel::DeleteMessage(SBDBaseMessage* message, std::function<void(SBDError*)> completion_handler)
+{
+	const uint64_t MessageId = message != nullptr ? message->message_id : 0;
+	ChannelRequest(channel_url, [MessageId](FSendbirdFakeServer& Server, FChannelRecord& Record) {
+		return Server.RemoveMessage(Record, MessageId) ? (int64_t)SBDErrorNone : ERROR_MESSAGE_NOT_FOUND;
+	}, [completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+
+void SBDBaseChannel::UpdateUserMessage(SBDUserMessage* message, const std::wstring& message_text, const std::wstring& data, const std::wstring& custom_type,
+	std::function<void(SBDUserMessage*, SBDError*)> completion_handler)
+{
+	const uint64_t MessageId = message != nullptr ? message->message_id : 0;
+	ChannelRequest<SBDUserMessage*>(channel_url, [MessageId, message_text, data, custom_type](FSendbirdFakeServer& Server, FChannelRecord& Record, SBDUserMessage*& OutMessage) {
+		SBDBaseMessage* Message = Server.FindMessage(MessageId);
+		if (Message == nullptr || Message->channel_url != Record.Channel->channel_url || Message->message_type != SBDMessageType::User)
+			return ERROR_MESSAGE_NOT_FOUND;
+
+		OutMessage = static_cast<SBDUserMessage*>(Message);
+		SetIfNotNull(OutMessage->message, message_text);
+		SetIfNotNull(OutMessage->data, data);
+		SetIfNotNull(OutMessage->custom_type, custom_type);
+		OutMessage->updated_at = Server.NextTimestamp();
+		return (int64_t)SBDErrorNone;
+	}, [completion_handler](SBDUserMessage* const& Message, SBDError* Error) { Complete(completion_handler, Message, Error); });
+}
+
+void SBDBaseChannel::UpdateFileMessage(SBDFileMessage* message, const std::wstring& data, const std::wstring& custom_type, std::function<void(SBDFileMessage*, SBDError*)> completion_handler)
+{
+	const uint64_t MessageId = message != nullptr ? message->message_id : 0;
+	ChannelRequest<SBDFileMessage*>(channel_url, [MessageId, data, custom_type](FSendbirdFakeServer& Server, FChannelRecord& Record, SBDFileMessage*& OutMessage) {
+		SBDBaseMessage* Message = Server.FindMessage(MessageId);
+		if (Message == nullptr || Message->channel_url != Record.Channel->channel_url || Message->message_type != SBDMessageType::File)
+			return ERROR_MESSAGE_NOT_FOUND;
+
+		OutMessage = static_cast<SBDFileMessage*>(Message);
+		SetIfNotNull(OutMessage->data, data);
+		SetIfNotNull(OutMessage->custom_type, custom_type);
+		OutMessage->updated_at = Server.NextTimestamp();
+		return (int64_t)SBDErrorNone;
+	}, [completion_handler](SBDFileMessage* const& Message, SBDError* Error) { Complete(completion_handler, Message, Error); });
+}
+
+SBDPreviousMessageListQuery* SBDBaseChannel::CreatePreviousMessageListQuery()
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+	return Server.Own(FSBDPreviousMessageListQuery::Create(this), Server.OwnedMessageQueries);
+}
+
+//+ Meta counters
+typedef std::map<std::wstring, int64_t> FMetaCounters;
+
+static void MetaCountersRequest(const std::wstring& ChannelUrl, std::function<void(FMetaCounters& Stored, FMetaCounters& Out)> Work,
+	std::function<void(const FMetaCounters& meta_counters, SBDError*)> CompletionHandler)
+{
+	ChannelRequest<FMetaCounters>(ChannelUrl, [Work](FSendbirdFakeServer& Server, FChannelRecord& Record, FMetaCounters& OutCounters) {
+		Work(Record.MetaCounters, OutCounters);
+		return (int64_t)SBDErrorNone;
+	}, [CompletionHandler](const FMetaCounters& Counters, SBDError* Error) { Complete(CompletionHandler, Counters, Error); });
+}
+
+void SBDBaseChannel::CreateMetaCounters(const std::map<std::wstring, int64_t>& meta_counters,
+	std::function<void(const std::map<std::wstring, int64_t>& meta_counters, SBDError*)> completion_handler)
+{
+	MetaCountersRequest(channel_url, [meta_counters](FMetaCounters& Stored, FMetaCounters& Out) {
+		for (const auto& Pair : meta_counters)
+		{
+			if (Stored.emplace(Pair.first, Pair.second).second)
+				Out.insert(Pair);
+		}
+	}, completion_handler);
+}
+
+void SBDBaseChannel::GetMetaCounters(const std::vector<std::wstring>& keys,
+	std::function<void(const std::map<std::wstring, int64_t>& meta_counters, SBDError*)> completion_handler)
+{
+	MetaCountersRequest(channel_url, [keys](FMetaCounters& Stored, FMetaCounters& Out) {
+		for (const std::wstring& Key : keys)
+		{
+			auto It = Stored.find(Key);
+			if (It != Stored.end())
+				Out.insert(*It);
+		}
+	}, completion_handler);
+}
+
+void SBDBaseChannel::GetAllMetaCounters(std::function<void(const std::map<std::wstring, int64_t>& meta_counters, SBDError*)> completion_handler)
+{
+	MetaCountersRequest(channel_url, [](FMetaCounters& Stored, FMetaCounters& Out) { Out = Stored; }, completion_handler);
+}
+
+void SBDBaseChannel::UpdateMetaCounters(const std::map<std::wstring, int64_t>& meta_counters,
+	std::function<void(const std::map<std::wstring, int64_t>& meta_counters, SBDError*)> completion_handler)
+{
+	MetaCountersRequest(channel_url, [meta_counters](FMetaCounters& Stored, FMetaCounters& Out) {
+		for (const auto& Pair : meta_counters)
+		{
+			auto It = Stored.find(Pair.first);
+			if (It != Stored.end())
+			{
+				It->second = Pair.second;
+				Out.insert(Pair);
+			}
+		}
+	}, completion_handler);
+}
+
+void SBDBaseChannel::IncreaseMetaCounters(const std::map<std::wstring, int64_t>& meta_counters,
+	std::function<void(const std::map<std::wstring, int64_t>& meta_counters, SBDError*)> completion_handler)
+{
+	MetaCountersRequest(channel_url, [meta_counters](FMetaCounters& Stored, FMetaCounters& Out) {
+		for (const auto& Pair : meta_counters)
+			Out[Pair.first] = Stored[Pair.first] += Pair.second;
+	}, completion_handler);
+}
+
+void SBDBaseChannel::DecreaseMetaCounters(const std::map<std::wstring, int64_t>& meta_counters,
+	std::function<void(const std::map<std::wstring, int64_t>& meta_counters, SBDError*)> completion_handler)
+{
+	MetaCountersRequest(channel_url, [meta_counters](FMetaCounters& Stored, FMetaCounters& Out) {
+		for (const auto& Pair : meta_counters)
+			Out[Pair.first] = Stored[Pair.first] -= Pair.second;
+	}, completion_handler);
+}
+
+void SBDBaseChannel::DeleteMetaCounter(const std::wstring& key, std::function<void(SBDError*)> completion_handler)
+{
+	ChannelRequest(channel_url, [key](FSendbirdFakeServer& Server, FChannelRecord& Record) {
+		Record.MetaCounters.erase(key);
+		return (int64_t)SBDErrorNone;
+	}, [completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+
+void SBDBaseChannel::DeleteAllMetaCounters(std::function<void(SBDError*)> completion_handler)
+{
+	ChannelRequest(channel_url, [](FSendbirdFakeServer& Server, FChannelRecord& Record) {
+		Record.MetaCounters.clear();
+		return (int64_t)SBDErrorNone;
+	}, [completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+//- Meta counters
+
+//+ Meta data
+typedef std::map<std::wstring, std::wstring> FMetaData;
+
+static void MetaDataRequest(const std::wstring& ChannelUrl, std::function<void(FMetaData& Stored, FMetaData& Out)> Work,
+	std::function<void(const FMetaData& meta_data, SBDError*)> CompletionHandler)
+{
+	ChannelRequest<FMetaData>(ChannelUrl, [Work](FSendbirdFakeServer& Server, FChannelRecord& Record, FMetaData& OutMetaData) {
+		Work(Record.MetaData, OutMetaData);
+		return (int64_t)SBDErrorNone;
+	}, [CompletionHandler](const FMetaData& MetaData, SBDError* Error) { Complete(CompletionHandler, MetaData, Error); });
+}
+
+void SBDBaseChannel::CreateMetaData(const std::map<std::wstring, std::wstring>& meta_data,
+	std::function<void(const std::map<std::wstring, std::wstring>& meta_data, SBDError*)> completion_handler)
+{
+	MetaDataRequest(channel_url, [meta_data](FMetaData& Stored, FMetaData& Out) {
+		for (const auto& Pair : meta_data)
+		{
+			if (Stored.emplace(Pair.first, Pair.second).second)
+				Out.insert(Pair);
+		}
+	}, completion_handler);
+}
+
+void SBDBaseChannel::GetMetaData(const std::vector<std::wstring>& keys,
+	std::function<void(const std::map<std::wstring, std::wstring>& meta_data, SBDError* error)> completion_handler)
+{
+	MetaDataRequest(channel_url, [keys](FMetaData& Stored, FMetaData& Out) {
+		for (const std::wstring& Key : keys)
+		{
+			auto It = Stored.find(Key);
+			if (It != Stored.end())
+				Out.insert(*It);
+		}
+	}, completion_handler);
+}
+
+void SBDBaseChannel::GetAllMetaData(std::function<void(const std::map<std::wstring, std::wstring>& meta_data, SBDError* error)> completion_handler)
+{
+	MetaDataRequest(channel_url, [](FMetaData& Stored, FMetaData& Out) { Out = Stored; }, completion_handler);
+}
+
+void SBDBaseChannel::UpdateMetaData(const std::map<std::wstring, std::wstring>& meta_data,
+	std::function<void(const std::map<std::wstring, std::wstring>& meta_data, SBDError*)> completion_handler)
+{
+	MetaDataRequest(channel_url, [meta_data](FMetaData& Stored, FMetaData& Out) {
+		for (const auto& Pair : meta_data)
+		{
+			auto It = Stored.find(Pair.first);
+			if (It != Stored.end())
+			{
+				It->second = Pair.second;
+				Out.insert(Pair);
+			}
+		}
+	}, completion_handler);
+}
+
+void SBDBaseChannel::DeleteMetaData(const std::wstring& key, std::function<void(SBDError*)> completion_handler)
+{
+	ChannelRequest(channel_url, [key](FSendbirdFakeServer& Server, FChannelRecord& Record) {
+		Record.MetaData.erase(key);
+		return (int64_t)SBDErrorNone;
+	}, [completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+
+void SBDBaseChannel::DeleteAllMetaData(std::function<void(SBDError*)> completion_handler)
+{
+	ChannelRequest(channel_url, [](FSendbirdFakeServer& Server, FChannelRecord& Record) {
+		Record.MetaData.clear();
+		return (int64_t)SBDErrorNone;
+	}, [completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+//- Meta data
+
+//+ Message queries
+typedef std::vector<SBDBaseMessage*> FMessages;
+
+static void MessagesRequest(const std::wstring& ChannelUrl, std::function<int64_t(FSendbirdFakeServer& Server, FChannelRecord& Record, FMessages& Out)> Work,
+	std::function<void(const FMessages&, SBDError*)> CompletionHandler)
+{
+	ChannelRequest<FMessages>(ChannelUrl, Work, [CompletionHandler](const FMessages& Messages, SBDError* Error) { Complete(CompletionHandler, Messages, Error); });
+}
+
+void SBDBaseChannel::GetNextMessagesByTimestamp(int64_t timestamp, int64_t next_limit, bool reverse, SBDMessageTypeFilter message_type,
+	const std::wstring& custom_type, std::function<void(const std::vector<SBDBaseMessage*>&, SBDError*)> completion_handler)
+{
+	GetMessagesByTimestamp(timestamp, 0, next_limit, reverse, message_type, custom_type, completion_handler);
+}
+
+void SBDBaseChannel::GetPreviousMessagesByTimestamp(int64_t timestamp, int64_t prev_limit, bool reverse, SBDMessageTypeFilter message_type,
+	const std::wstring& custom_type, std::function<void(const std::vector<SBDBaseMessage*>&, SBDError*)> completion_handler)
+{
+	GetMessagesByTimestamp(timestamp, prev_limit, 0, reverse, message_type, custom_type, completion_handler);
+}
+
+void SBDBaseChannel::GetMessagesByTimestamp(int64_t timestamp, int64_t prev_limit, int64_t next_limit, bool reverse, SBDMessageTypeFilter message_type,
+	const std::wstring& custom_type, std::function<void(const std::vector<SBDBaseMessage*>&, SBDError*)> completion_handler)
+{
+	MessagesRequest(channel_url, [=](FSendbirdFakeServer& Server, FChannelRecord& Record, FMessages& OutMessages) {
+		CollectAround(Server, Record, timestamp, prev_limit, next_limit, reverse, message_type, custom_type, OutMessages);
+		return (int64_t)SBDErrorNone;
+	}, completion_handler);
+}
+
+void SBDBaseChannel::GetNextMessagesByMessageId(int64_t message_id, int64_t next_limit, bool reverse, SBDMessageTypeFilter message_type, const std::wstring& custom_type,
+	std::function<void(const std::vector<SBDBaseMessage*>&, SBDError*)> completion_handler)
+{
+	GetMessagesByMessageId(message_id, 0, next_limit, reverse, message_type, custom_type, completion_handler);
+}
+
+void SBDBaseChannel::GetPreviousMessagesByMessageId(int64_t message_id, int64_t prev_limit, bool reverse, SBDMessageTypeFilter message_type, const std::wstring& custom_type,
+	std::function<void(const std::vector<SBDBaseMessage*>&, SBDError*)> completion_handler)
+{
+	GetMessagesByMessageId(message_id, prev_limit, 0, reverse, message_type, custom_type, completion_handler);
+}
+
+void SBDBaseChannel::GetMessagesByMessageId(int64_t message_id, int64_t prev_limit, int64_t next_limit, bool reverse, SBDMessageTypeFilter message_type,
+	const std::wstring& custom_type, std::function<void(const std::vector<SBDBaseMessage*>&, SBDError*)> completion_handler)
+{
+	MessagesRequest(channel_url, [=](FSendbirdFakeServer& Server, FChannelRecord& Record, FMessages& OutMessages) {
+		int64_t Pivot = 0;
+		const int64_t Code = FindPivot(Server, Record, message_id, Pivot);
+		if (Code == SBDErrorNone)
+			CollectAround(Server, Record, Pivot, prev_limit, next_limit, reverse, message_type, custom_type, OutMessages);
+		return Code;
+	}, completion_handler);
+}
+//- Message queries
+
+//+ Message meta arrays
+typedef std::map<std::wstring, std::vector<std::wstring>> FMetaArrayValues;
+
+static void MetaArrayRequest(const std::wstring& ChannelUrl, int64_t MessageId, std::function<void(std::vector<SBDMessageMetaArray>& MetaArrays)> Work,
+	std::function<void(SBDBaseMessage*, SBDError*)> CompletionHandler)
+{
+	ChannelRequest<SBDBaseMessage*>(ChannelUrl, [MessageId, Work](FSendbirdFakeServer& Server, FChannelRecord& Record, SBDBaseMessage*& OutMessage) {
+		SBDBaseMessage* Message = Server.FindMessage((uint64_t)MessageId);
+		if (Message == nullptr || Message->channel_url != Record.Channel->channel_url)
+			return ERROR_MESSAGE_NOT_FOUND;
+
+		Work(Message->meta_arrays);
+		Message->updated_at = Server.NextTimestamp();
+		OutMessage = Message;
+		return (int64_t)SBDErrorNone;
+	}, [CompletionHandler](SBDBaseMessage* const& Message, SBDError* Error) { Complete(CompletionHandler, Message, Error); });
+}
+
+static SBDMessageMetaArray& FindOrAddMetaArray(std::vector<SBDMessageMetaArray>& MetaArrays, const std::wstring& Key)
+{
+	auto It = std::find_if(MetaArrays.begin(), MetaArrays.end(), [&Key](const SBDMessageMetaArray& MetaArray) { return MetaArray.GetKey() == Key; });
+	if (It != MetaArrays.end())
+		return *It;
+
+	MetaArrays.push_back(FSBDMessageMetaArray::Make(Key));
+	return MetaArrays.back();
+}
+
+static FMetaArrayValues ToMetaArrayValues(const std::vector<SBDMessageMetaArray>& MetaArrays)
+{
+	FMetaArrayValues KeyValue;
+	for (const SBDMessageMetaArray& MetaArray : MetaArrays)
+		KeyValue[MetaArray.GetKey()] = MetaArray.GetValue();
+	return KeyValue;
+}
+
+void SBDBaseChannel::AddMessageMetaArrayValues(const std::wstring& channel_url, int64_t message_id, const std::map<std::wstring, std::vector<std::wstring>>& key_value,
+	std::function<void(SBDBaseMessage*, SBDError*)> completion_handler)
+{
+	MetaArrayRequest(channel_url, message_id, [key_value](std::vector<SBDMessageMetaArray>& MetaArrays) {
+		for (const auto& Pair : key_value)
+			FindOrAddMetaArray(MetaArrays, Pair.first).AddValue(Pair.second);
+	}, completion_handler);
+}
+
+void SBDBaseChannel::AddMessageMetaArrayValues(const std::wstring& channel_url, int64_t message_id, const std::vector<SBDMessageMetaArray>& metaarrays,
+	std::function<void(SBDBaseMessage*, SBDError*)> completion_handler)
+{
+	AddMessageMetaArrayValues(channel_url, message_id, ToMetaArrayValues(metaarrays), completion_handler);
+}
+
+void SBDBaseChannel::RemoveMessageMetaArrayValues(const std::wstring& channel_url, int64_t message_id, const std::map<std::wstring, std::vector<std::wstring>>& key_value,
+	std::function<void(SBDBaseMessage*, SBDError*)> completion_handler)
+{
+	MetaArrayRequest(channel_url, message_id, [key_value](std::vector<SBDMessageMetaArray>& MetaArrays) {
+		for (SBDMessageMetaArray& MetaArray : MetaArrays)
+		{
+			auto It = key_value.find(MetaArray.GetKey());
+			if (It != key_value.end())
+				MetaArray.RemoveValue(It->second);
+		}
+	}, completion_handler);
+}
+
+void SBDBaseChannel::RemoveMessageMetaArrayValues(const std::wstring& channel_url, int64_t message_id, const std::vector<SBDMessageMetaArray>& metaarrays,
+	std::function<void(SBDBaseMessage*, SBDError*)> completion_handler)
+{
+	RemoveMessageMetaArrayValues(channel_url, message_id, ToMetaArrayValues(metaarrays), completion_handler);
+}
+
+void SBDBaseChannel::DeleteMessageMetaArrayKeys(const std::wstring& channel_url, int64_t message_id, const std::vector<std::wstring>& metaarray_keys,
+	std::function<void(SBDBaseMessage*, SBDError*)> completion_handler)
+{
+	MetaArrayRequest(channel_url, message_id, [metaarray_keys](std::vector<SBDMessageMetaArray>& MetaArrays) {
+		MetaArrays.erase(std::remove_if(MetaArrays.begin(), MetaArrays.end(), [&metaarray_keys](const SBDMessageMetaArray& MetaArray) {
+			return std::find(metaarray_keys.begin(), metaarray_keys.end(), MetaArray.GetKey()) != metaarray_keys.end();
+		}), MetaArrays.end());
+	}, completion_handler);
+}
+
+void SBDBaseChannel::CreateMessageMetaArrayKeys(const std::wstring& channel_url, int64_t message_id, const std::vector<std::wstring>& metaarray_keys,
+	std::function<void(SBDBaseMessage*, SBDError*)> completion_handler)
+{
+	MetaArrayRequest(channel_url, message_id, [metaarray_keys](std::vector<SBDMessageMetaArray>& MetaArrays) {
+		for (const std::wstring& Key : metaarray_keys)
+			FindOrAddMetaArray(MetaArrays, Key);
+	}, completion_handler);
+}
+//- Message meta arrays
+
+SBDUserMessage* SBDBaseChannel::CopyUserMessage(SBDUserMessage* message, SBDBaseChannel* target_channel, std::function<void(SBDUserMessage*, SBDError*)> completion_handler)
+{
+	if (message == nullptr || target_channel == nullptr)
+	{
+		FSendbirdFakeServer::Get().Reject([completion_handler](SBDError* Error) { Complete(completion_handler, nullptr, Error); }, SBDErrorInvalidParameter, DescribeError(SBDErrorInvalidParameter));
+		return nullptr;
+	}
+
+	SBDUserMessageParams Params;
+	Params.SetMessage(message->message).SetData(message->data).SetCustomType(message->custom_type);
+	return target_channel->SendUserMessage(Params, completion_handler);
+}
+
+SBDFileMessage* SBDBaseChannel::CopyFileMessage(SBDFileMessage* message, SBDBaseChannel* target_channel, std::function<void(SBDFileMessage*, SBDError*)> completion_handler)
+{
+	if (message == nullptr || target_channel == nullptr)
+	{
+		FSendbirdFakeServer::Get().Reject([completion_handler](SBDError* Error) { Complete(completion_handler, nullptr, Error); }, SBDErrorInvalidParameter, DescribeError(SBDErrorInvalidParameter));
+		return nullptr;
+	}
+
+	std::vector<SBDThumbnailSize> ThumbnailSizes;
+	for (const SBDThumbnail& Thumbnail : message->thumbnails)
+		ThumbnailSizes.emplace_back(Thumbnail.max_width, Thumbnail.max_height);
+
+	return SendFile(target_channel, message->url, message->name, (int64_t)message->size, message->type, ThumbnailSizes, message->data, message->custom_type, completion_handler);
+}
+
+//+ Operators, reports
+void SBDBaseChannel::AddOperators(const std::vector<std::wstring>& user_ids, std::function<void(SBDError*)> completion_handler)
+{
+	ChannelRequest(channel_url, [user_ids](FSendbirdFakeServer& Server, FChannelRecord& Record) {
+		Record.OperatorUserIds.insert(user_ids.begin(), user_ids.end());
+		SyncOperators(Server, Record);
+		return (int64_t)SBDErrorNone;
+	}, [completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+
+void SBDBaseChannel::RemoveOperators(const std::vector<std::wstring>& user_ids, std::function<void(SBDError*)> completion_handler)
+{
+	ChannelRequest(channel_url, [user_ids](FSendbirdFakeServer& Server, FChannelRecord& Record) {
+		for (const std::wstring& UserId : user_ids)
+			Record.OperatorUserIds.erase(UserId);
+		SyncOperators(Server, Record);
+		return (int64_t)SBDErrorNone;
+	}, [completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+
+void SBDBaseChannel::RemoveAllOperators(std::function<void(SBDError*)> completion_handler)
+{
+	ChannelRequest(channel_url, [](FSendbirdFakeServer& Server, FChannelRecord& Record) {
+		Record.OperatorUserIds.clear();
+		SyncOperators(Server, Record);
+		return (int64_t)SBDErrorNone;
+	}, [completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+
+SBDOperatorListQuery* SBDBaseChannel::CreateOperatorListQuery()
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+	return Server.Own(new SBDOperatorListQuery(this), Server.OwnedOperatorQueries);
+}
+
+void SBDBaseChannel::Report(SBDReportCategory report_category, std::wstring report_description, std::function<void(SBDError*)> completion_handler)
+{
+	ChannelRequest(channel_url, [](FSendbirdFakeServer& Server, FChannelRecord& Record) { return (int64_t)SBDErrorNone; },
+		[completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+
+void SBDBaseChannel::ReportUser(SBDUser& offending_user, SBDReportCategory report_category, std::wstring report_description, std::function<void(SBDError*)> completion_handler)
+{
+	Report(report_category, report_description, completion_handler);
+}
+
+void SBDBaseChannel::ReportMessage(SBDBaseMessage* message, SBDReportCategory report_category, std::wstring report_description, std::function<void(SBDError*)> completion_handler)
+{
+	Report(report_category, report_description, completion_handler);
+}
+//- Operators, reports
+//- SBDBaseChannel
+
+//+ SBDGroupChannel
+SBDGroupChannel::SBDGroupChannel(const std::string& dict)
+	: SBDBaseChannel(dict)
+	, last_message_id(0)
+	, is_distinct(false)
+	, is_public(false)
+	, unread_message_count(0)
+	, member_count(0)
+	, has_inviter(false)
+	, is_hidden(false)
+	, hidden_state(SBDGroupChannelHiddenState::Unhidden)
+	, last_start_typing_ts(0)
+	, last_end_typing_ts(0)
+	, has_been_updated(false)
+{
+	is_group_channel = true;
+}
+
+void SBDGroupChannel::CreateChannel(std::vector<std::wstring> user_ids, const std::wstring& name, bool is_distinct, const std::wstring& cover_url,
+	const std::wstring& data, const std::wstring& custom_type, std::function<void(SBDGroupChannel*, SBDError*)> completion_handler)
+{
+	SBDGroupChannelParams Params;
+	Params.SetUserIds(user_ids).SetName(name).SetDistinct(is_distinct).SetCoverUrl(cover_url).SetData(data).SetCustomType(custom_type);
+	CreateChannel(Params, completion_handler);
+}
+
+void SBDGroupChannel::CreateChannel(const std::vector<std::wstring> user_ids, const std::wstring& name, bool is_distinct, const std::wstring& cover_image_file_path,
+	const std::wstring& file_mime_type, const std::wstring& data, const std::wstring& custom_type,
+	std::function<void(SBDGroupChannel*, SBDError*)> completion_handler)
+{
+	std::vector<std::wstring> UserIds = user_ids;
+	SBDGroupChannelParams Params;
+	Params.SetUserIds(UserIds).SetName(name).SetDistinct(is_distinct).SetCoverImageFilePathAndFileMimeType(cover_image_file_path, file_mime_type).SetData(data).SetCustomType(custom_type);
+	CreateChannel(Params, completion_handler);
+}
+
+void SBDGroupChannel::CreateChannel(SBDGroupChannelParams& params, std::function<void(SBDGroupChannel*, SBDError*)> completion_handler)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	const SBDGroupChannelParams Params = params;
+	Server.Request([&Server, Params, completion_handler](SBDError* Error) {
+		FServerError ServerError;
+		SBDGroupChannel* Channel = nullptr;
+		if (Error == nullptr)
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+
+			std::set<std::wstring> MemberIds(Params.user_ids.begin(), Params.user_ids.end());
+			MemberIds.insert(Server.CurrentUser.user_id);
+
+			if (Params.is_distinct)
+			{
+				for (const std::wstring& ChannelUrl : Server.GroupChannelUrls)
+				{
+					SBDGroupChannel* Existing = static_cast<SBDGroupChannel*>(Server.Channels[ChannelUrl].Channel);
+					std::set<std::wstring> ExistingIds;
+					for (const SBDMember& Member : Existing->members)
+						ExistingIds.insert(Member.user_id);
+
+					if (Existing->is_distinct && ExistingIds == MemberIds)
+					{
+						Channel = Existing;
+						break;
+					}
+				}
+			}
+
+			if (Channel == nullptr)
+			{
+				const std::wstring ChannelUrl = Params.channel_url.empty() ? Server.MakeChannelUrl(false) : Params.channel_url;
+				if (Server.FindRecord(ChannelUrl) != nullptr)
+				{
+					Error = ServerError.Set(SBDErrorInvalidParameter, "Channel URL already exists.");
+				}
+				else
+				{
+					Channel = Server.AddGroupChannel(ChannelUrl, Params.name);
+					Channel->cover_url = Params.cover_image_file_path.empty() ? Params.cover_url : L"file://" + Params.cover_image_file_path;
+					Channel->data = Params.data;
+					Channel->custom_type = Params.custom_type;
+					Channel->is_distinct = Params.is_distinct;
+					Channel->is_public = Params.is_public;
+
+					for (const std::wstring& UserId : MemberIds)
+						Server.AddMember(Channel, *Server.FindOrAddUser(UserId), SBDMemberState::Joined);
+
+					Server.FindRecord(ChannelUrl)->OperatorUserIds.insert(Params.operator_user_ids.begin(), Params.operator_user_ids.end());
+				}
+			}
+		}
+		Complete(completion_handler, Channel, Error);
+	});
+}
+
+void SBDGroupChannel::UpdateChannel(const std::wstring& name, bool is_distinct, const std::wstring& cover_url, const std::wstring& data, const std::wstring& custom_type,
+	std::function<void(SBDGroupChannel*, SBDError*)> completion_handler)
+{
+	ChannelRequest<SBDGroupChannel*>(channel_url, [=](FSendbirdFakeServer& Server, FChannelRecord& Record, SBDGroupChannel*& OutChannel) {
+		OutChannel = static_cast<SBDGroupChannel*>(Record.Channel);
+		SetIfNotNull(OutChannel->name, name);
+		SetIfNotNull(OutChannel->cover_url, cover_url);
+		SetIfNotNull(OutChannel->data, data);
+		SetIfNotNull(OutChannel->custom_type, custom_type);
+		OutChannel->is_distinct = is_distinct;
+		return (int64_t)SBDErrorNone;
+	}, [completion_handler](SBDGroupChannel* const& Channel, SBDError* Error) { Complete(completion_handler, Channel, Error); });
+}
+
+void SBDGroupChannel::UpdateChannel(const std::wstring& name, bool is_distinct, const std::wstring& cover_image_file_path, const std::wstring& file_mime_type,
+	const std::wstring& data, const std::wstring& custom_type, std::function<void(SBDGroupChannel*, SBDError*)> completion_handler)
+{
+	const std::wstring CoverUrl = IsNullWString(cover_image_file_path) ? cover_image_file_path : L"file://" + cover_image_file_path;
+	UpdateChannel(name, is_distinct, CoverUrl, data, custom_type, completion_handler);
+}
+
+void SBDGroupChannel::DeleteChannel(std::function<void(SBDError*)> completion_handler)
+{
+	ChannelRequest(channel_url, [](FSendbirdFakeServer& Server, FChannelRecord& Record) {
+		Server.RemoveChannel(Record.Channel->channel_url);
+		return (int64_t)SBDErrorNone;
+	}, [completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+
+void SBDGroupChannel::RefreshChannel(std::function<void(SBDError*)> completion_handler)
+{
+	ChannelRequest(channel_url, [](FSendbirdFakeServer& Server, FChannelRecord& Record) { return (int64_t)SBDErrorNone; },
+		[completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+
+SBDGroupChannelListQuery* SBDGroupChannel::CreateMyGroupChannelListQuery()
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+	return Server.Own(FSBDGroupChannelListQuery::Create(), Server.OwnedGroupChannelQueries);
+}
+
+void SBDGroupChannel::GetChannelFromServer(const std::wstring& channel_url, std::function<void(SBDGroupChannel*, SBDError*)> completion_handler)
+{
+	ChannelRequest<SBDGroupChannel*>(channel_url, [](FSendbirdFakeServer& Server, FChannelRecord& Record, SBDGroupChannel*& OutChannel) {
+		if (Record.bOpen)
+			return ERROR_CHANNEL_NOT_FOUND;
+
+		OutChannel = static_cast<SBDGroupChannel*>(Record.Channel);
+		return (int64_t)SBDErrorNone;
+	}, [completion_handler](SBDGroupChannel* const& Channel, SBDError* Error) { Complete(completion_handler, Channel, Error); });
+}
+
+void SBDGroupChannel::GetChannel(const std::wstring& channel_url, std::function<void(SBDGroupChannel*, SBDError*)> completion_handler)
+{
+	GetChannelFromServer(channel_url, completion_handler);
+}
+
+void SBDGroupChannel::InviteUsers(const std::vector<SBDUser>& users, std::function<void(SBDError*)> completion_handler)
+{
+	ChannelRequest(channel_url, [users](FSendbirdFakeServer& Server, FChannelRecord& Record) {
+		// Seeded users accept invitations automatically.
+		for (const SBDUser& User : users)
+			Server.AddMember(static_cast<SBDGroupChannel*>(Record.Channel), *Server.FindOrAddUser(User.user_id), SBDMemberState::Joined);
+		return (int64_t)SBDErrorNone;
+	}, [completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+
+void SBDGroupChannel::HideChannel(bool hide_prev_messages, std::function<void(SBDError*)> completion_handler)
+{
+	HideChannel(hide_prev_messages, true, completion_handler);
+}
+
+void SBDGroupChannel::HideChannel(bool hide_prev_messages, bool allow_auto_unhide, std::function<void(SBDError*)> completion_handler)
+{
+	ChannelRequest(channel_url, [hide_prev_messages, allow_auto_unhide](FSendbirdFakeServer& Server, FChannelRecord& Record) {
+		SBDGroupChannel* Channel = static_cast<SBDGroupChannel*>(Record.Channel);
+		Channel->is_hidden = true;
+		Channel->hidden_state = allow_auto_unhide ? SBDGroupChannelHiddenState::AllowAutoUnhide : SBDGroupChannelHiddenState::HiddenPreventAutoUnhide;
+		if (hide_prev_messages)
+		{
+			Record.HistoryResetAt = Server.NextTimestamp();
+			Server.MarkAsRead(Record, Server.CurrentUser.user_id);
+		}
+		return (int64_t)SBDErrorNone;
+	}, [completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+
+void SBDGroupChannel::UnhideChannel(std::function<void(SBDError*)> completion_handler)
+{
+	ChannelRequest(channel_url, [](FSendbirdFakeServer& Server, FChannelRecord& Record) {
+		SBDGroupChannel* Channel = static_cast<SBDGroupChannel*>(Record.Channel);
+		Channel->is_hidden = false;
+		Channel->hidden_state = SBDGroupChannelHiddenState::Unhidden;
+		return (int64_t)SBDErrorNone;
+	}, [completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+
+void SBDGroupChannel::JoinChannel(std::function<void(SBDError*)> completion_handler)
+{
+	ChannelRequest(channel_url, [](FSendbirdFakeServer& Server, FChannelRecord& Record) {
+		SBDGroupChannel* Channel = static_cast<SBDGroupChannel*>(Record.Channel);
+		if (!Channel->is_public)
+			return ERROR_NOT_A_MEMBER;
+
+		Server.AddMember(Channel, Server.CurrentUser, SBDMemberState::Joined);
+		return (int64_t)SBDErrorNone;
+	}, [completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+
+void SBDGroupChannel::LeaveChannel(std::function<void(SBDError*)> completion_handler)
+{
+	ChannelRequest(channel_url, [](FSendbirdFakeServer& Server, FChannelRecord& Record) {
+		return Server.RemoveMember(static_cast<SBDGroupChannel*>(Record.Channel), Server.CurrentUser.user_id) ? (int64_t)SBDErrorNone : ERROR_NOT_A_MEMBER;
+	}, [completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+
+void SBDGroupChannel::MarkAllAsRead(std::function<void(SBDError*)> completion_handler)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	Server.Request([&Server, completion_handler](SBDError* Error) {
+		bool bUnreadChanged = false;
+		if (Error == nullptr)
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+			for (const std::wstring& ChannelUrl : Server.GroupChannelUrls)
+			{
+				FChannelRecord& Record = Server.Channels[ChannelUrl];
+				SBDGroupChannel* Channel = static_cast<SBDGroupChannel*>(Record.Channel);
+				if (FSendbirdFakeServer::FindMember(Channel, Server.CurrentUser.user_id) == nullptr)
+					continue;
+
+				bUnreadChanged |= Channel->unread_message_count > 0;
+				Server.MarkAsRead(Record, Server.CurrentUser.user_id);
+			}
+		}
+
+		Complete(completion_handler, Error);
+		if (bUnreadChanged)
+			Server.BroadcastUnreadCountChanged();
+	});
+}
+
+void SBDGroupChannel::MarkAsRead()
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	const std::wstring ChannelUrl = channel_url;
+	Server.Request([&Server, ChannelUrl](SBDError* Error) {
+		bool bUnreadChanged = false;
+		if (Error == nullptr)
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+			if (FChannelRecord* Record = Server.FindRecord(ChannelUrl))
+			{
+				bUnreadChanged = !Record->bOpen && static_cast<SBDGroupChannel*>(Record->Channel)->unread_message_count > 0;
+				Server.MarkAsRead(*Record, Server.CurrentUser.user_id);
+			}
+		}
+
+		if (bUnreadChanged)
+			Server.BroadcastUnreadCountChanged();
+	});
+}
+
+int SBDGroupChannel::GetReadReceipt(SBDBaseMessage* message)
+{
+	return message != nullptr ? (int)GetUnreadMembers(message).size() : 0;
+}
+
+int64_t SBDGroupChannel::GetLastSeenAt(const SBDUser& user)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+
+	const FChannelRecord* Record = Server.FindRecord(this);
+	if (Record == nullptr)
+		return 0;
+
+	auto It = Record->ReadTimestamps.find(user.user_id);
+	return It != Record->ReadTimestamps.end() ? It->second : 0;
+}
+
+std::vector<SBDMember> SBDGroupChannel::GetReadMembers(SBDBaseMessage* message)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+
+	std::vector<SBDMember> ReadMembers;
+	const FChannelRecord* Record = Server.FindRecord(this);
+	if (Record == nullptr || message == nullptr)
+		return ReadMembers;
+
+	const std::wstring SenderId = GetSenderId(message);
+	for (const SBDMember& Member : members)
+	{
+		if (Member.user_id == SenderId || Member.user_id == Server.CurrentUser.user_id)
+			continue;
+
+		auto It = Record->ReadTimestamps.find(Member.user_id);
+		if (It != Record->ReadTimestamps.end() && It->second >= message->created_at)
+			ReadMembers.push_back(Member);
+	}
+	return ReadMembers;
+}
+
+std::vector<SBDMember> SBDGroupChannel::GetUnreadMembers(SBDBaseMessage* message)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+
+	std::vector<SBDMember> UnreadMembers;
+	const FChannelRecord* Record = Server.FindRecord(this);
+	if (Record == nullptr || message == nullptr)
+		return UnreadMembers;
+
+	const std::wstring SenderId = GetSenderId(message);
+	for (const SBDMember& Member : members)
+	{
+		if (Member.user_id == SenderId || Member.user_id == Server.CurrentUser.user_id)
+			continue;
+
+		auto It = Record->ReadTimestamps.find(Member.user_id);
+		if (It == Record->ReadTimestamps.end() || It->second < message->created_at)
+			UnreadMembers.push_back(Member);
+	}
+	return UnreadMembers;
+}
+
+std::map<std::wstring, SBDReadStatus> SBDGroupChannel::GetReadStatus()
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+
+	std::map<std::wstring, SBDReadStatus> ReadStatus;
+	const FChannelRecord* Record = Server.FindRecord(this);
+	if (Record == nullptr)
+		return ReadStatus;
+
+	for (const SBDMember& Member : members)
+	{
+		auto It = Record->ReadTimestamps.find(Member.user_id);
+		if (Member.user_id != Server.CurrentUser.user_id && It != Record->ReadTimestamps.end())
+			ReadStatus.emplace(Member.user_id, FSBDReadStatus::Make(Member, It->second, channel_url));
+	}
+	return ReadStatus;
+}
+
+bool SBDGroupChannel::HasMember(const std::wstring& user_id)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+	return FSendbirdFakeServer::FindMember(this, user_id) != nullptr;
+}
+
+SBDMember SBDGroupChannel::GetMember(const std::wstring& user_id, bool* member_exist)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+
+	const SBDMember* Member = FSendbirdFakeServer::FindMember(this, user_id);
+	if (member_exist != nullptr)
+		*member_exist = Member != nullptr;
+	return Member != nullptr ? *Member : SBDMember();
+}
+
+void SBDGroupChannel::AcceptInvitation(std::function<void(SBDError*)> completion_handler)
+{
+	ChannelRequest(channel_url, [](FSendbirdFakeServer& Server, FChannelRecord& Record) {
+		SBDMember* Me = FSendbirdFakeServer::FindMember(static_cast<SBDGroupChannel*>(Record.Channel), Server.CurrentUser.user_id);
+		if (Me == nullptr)
+			return ERROR_NOT_A_MEMBER;
+
+		Me->state = SBDMemberState::Joined;
+		return (int64_t)SBDErrorNone;
+	}, [completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+
+void SBDGroupChannel::DeclineInvitation(std::function<void(SBDError*)> completion_handler)
+{
+	ChannelRequest(channel_url, [](FSendbirdFakeServer& Server, FChannelRecord& Record) {
+		return Server.RemoveMember(static_cast<SBDGroupChannel*>(Record.Channel), Server.CurrentUser.user_id) ? (int64_t)SBDErrorNone : ERROR_NOT_A_MEMBER;
+	}, [completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+
+void SBDGroupChannel::ResetMyHistory(std::function<void(SBDError*)> completion_handler)
+{
+	ChannelRequest(channel_url, [](FSendbirdFakeServer& Server, FChannelRecord& Record) {
+		Record.HistoryResetAt = Server.NextTimestamp();
+		Server.MarkAsRead(Record, Server.CurrentUser.user_id);
+		return (int64_t)SBDErrorNone;
+	}, [completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+
+void SBDGroupChannel::GetChannelCount(SBDMemberStateFilter member_state_filter, std::function<void(uint64_t group_chanel_count, SBDError* error)> completion_handler)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	Server.Request([&Server, member_state_filter, completion_handler](SBDError* Error) {
+		uint64_t ChannelCount = 0;
+		if (Error == nullptr)
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+			for (const std::wstring& ChannelUrl : Server.GroupChannelUrls)
+			{
+				const SBDMember* Me = FSendbirdFakeServer::FindMember(static_cast<SBDGroupChannel*>(Server.Channels[ChannelUrl].Channel), Server.CurrentUser.user_id);
+				if (Me == nullptr)
+					continue;
+
+				if (member_state_filter == SBDMemberStateFilter::All
+					|| (member_state_filter == SBDMemberStateFilter::JoinedOnly && Me->state == SBDMemberState::Joined)
+					|| (member_state_filter == SBDMemberStateFilter::InvitedOnly && Me->state == SBDMemberState::Invited))
+					++ChannelCount;
+			}
+		}
+		Complete(completion_handler, ChannelCount, Error);
+	});
+}
+
+const SBDBaseMessage* SBDGroupChannel::GetLastMessage()
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+
+	const FChannelRecord* Record = Server.FindRecord(this);
+	if (Record == nullptr || Record->Messages.empty() || Record->Messages.back()->created_at < Record->HistoryResetAt)
+		return nullptr;
+	return Record->Messages.back();
+}
+//- SBDGroupChannel
+
+//+ SBDOpenChannel
+SBDOpenChannel::SBDOpenChannel(const std::string& dict)
+	: SBDBaseChannel(dict)
+	, participant_count(0)
+	, is_frozen(false)
+	, operators_updated_at(0)
+{
+	is_open_channel = true;
+}
+
+SBDOpenChannelListQuery* SBDOpenChannel::CreateOpenChannelListQuery()
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+	return Server.Own(FSBDOpenChannelListQuery::Create(), Server.OwnedOpenChannelQueries);
+}
+
+void SBDOpenChannel::CreateChannel(const std::wstring& name, const std::wstring& channel_url, const std::wstring& cover_url,
+	const std::wstring& data, const std::vector<std::wstring>& operator_user_ids, const std::wstring& custom_type,
+	std::function<void(SBDOpenChannel*, SBDError*)> completion_handler)
+{
+	std::vector<std::wstring> OperatorUserIds = operator_user_ids;
+	SBDOpenChannelParams Params;
+	Params.SetName(name).SetChannelUrl(channel_url).SetCoverUrl(cover_url).SetData(data).SetOperatorUserIds(OperatorUserIds).SetCustomType(custom_type);
+	CreateChannel(Params, completion_handler);
+}
+
+void SBDOpenChannel::CreateChannel(const std::wstring& name, const std::wstring& channel_url, const std::wstring& cover_image_file_path,
+	const std::wstring& file_mime_type, const std::wstring& data, const std::vector<std::wstring>& operator_user_ids,
+	const std::wstring& custom_type, std::function<void(SBDOpenChannel*, SBDError*)> completion_handler)
+{
+	std::vector<std::wstring> OperatorUserIds = operator_user_ids;
+	SBDOpenChannelParams Params;
+	Params.SetName(name).SetChannelUrl(channel_url).SetCoverImageFilePathAndFileMimeType(cover_image_file_path, file_mime_type).SetData(data)
+		.SetOperatorUserIds(OperatorUserIds).SetCustomType(custom_type);
+	CreateChannel(Params, completion_handler);
+}
+
+void SBDOpenChannel::CreateChannel(SBDOpenChannelParams& params, std::function<void(SBDOpenChannel*, SBDError*)> completion_handler)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	const SBDOpenChannelParams Params = params;
+	Server.Request([&Server, Params, completion_handler](SBDError* Error) {
+		FServerError ServerError;
+		SBDOpenChannel* Channel = nullptr;
+		if (Error == nullptr)
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+
+			const std::wstring ChannelUrl = Params.channel_url.empty() ? Server.MakeChannelUrl(true) : Params.channel_url;
+			if (Server.FindRecord(ChannelUrl) != nullptr)
+			{
+				Error = ServerError.Set(SBDErrorInvalidParameter, "Channel URL already exists.");
+			}
+			else
+			{
+				Channel = Server.AddOpenChannel(ChannelUrl, Params.name);
+				Channel->cover_url = Params.cover_image_file_path.empty() ? Params.cover_url : L"file://" + Params.cover_image_file_path;
+				Channel->data = Params.data;
+				Channel->custom_type = Params.custom_type;
+
+				FChannelRecord& Record = *Server.FindRecord(ChannelUrl);
+				Record.OperatorUserIds.insert(Params.operator_user_ids.begin(), Params.operator_user_ids.end());
+				SyncOperators(Server, Record);
+			}
+		}
+		Complete(completion_handler, Channel, Error);
+	});
+}
+
+void SBDOpenChannel::UpdateChannel(const std::wstring& new_name, const std::wstring& new_cover_url, const std::wstring& new_data, const std::vector<std::wstring>& new_operator_user_ids,
+	const std::wstring& new_custom_type, std::function<void(SBDOpenChannel*, SBDError*)> completion_handler)
+{
+	ChannelRequest<SBDOpenChannel*>(channel_url, [=](FSendbirdFakeServer& Server, FChannelRecord& Record, SBDOpenChannel*& OutChannel) {
+		OutChannel = static_cast<SBDOpenChannel*>(Record.Channel);
+		SetIfNotNull(OutChannel->name, new_name);
+		SetIfNotNull(OutChannel->cover_url, new_cover_url);
+		SetIfNotNull(OutChannel->data, new_data);
+		SetIfNotNull(OutChannel->custom_type, new_custom_type);
+		if (!new_operator_user_ids.empty())
+		{
+			Record.OperatorUserIds = std::set<std::wstring>(new_operator_user_ids.begin(), new_operator_user_ids.end());
+			SyncOperators(Server, Record);
+		}
+		return (int64_t)SBDErrorNone;
+	}, [completion_handler](SBDOpenChannel* const& Channel, SBDError* Error) { Complete(completion_handler, Channel, Error); });
+}
+
+void SBDOpenChannel::UpdateChannel(const std::wstring& new_name, const std::wstring& new_cover_image_file_path, const std::wstring& new_cover_file_mime_type,
+	const std::wstring& new_data, const std::vector<std::wstring>& new_operator_user_ids, const std::wstring& new_custom_type,
+	std::function<void(SBDOpenChannel*, SBDError*)> completion_handler)
+{
+	const std::wstring CoverUrl = IsNullWString(new_cover_image_file_path) ? new_cover_image_file_path : L"file://" + new_cover_image_file_path;
+	UpdateChannel(new_name, CoverUrl, new_data, new_operator_user_ids, new_custom_type, completion_handler);
+}
+
+void SBDOpenChannel::DeleteChannel(std::function<void(SBDError*)> completion_handler)
+{
+	ChannelRequest(channel_url, [](FSendbirdFakeServer& Server, FChannelRecord& Record) {
+		Server.RemoveChannel(Record.Channel->channel_url);
+		return (int64_t)SBDErrorNone;
+	}, [completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+
+void SBDOpenChannel::GetChannel(const std::wstring& channel_url, std::function<void(SBDOpenChannel*, SBDError*)> completion_handler)
+{
+	ChannelRequest<SBDOpenChannel*>(channel_url, [](FSendbirdFakeServer& Server, FChannelRecord& Record, SBDOpenChannel*& OutChannel) {
+		if (!Record.bOpen)
+			return ERROR_CHANNEL_NOT_FOUND;
+
+		OutChannel = static_cast<SBDOpenChannel*>(Record.Channel);
+		return (int64_t)SBDErrorNone;
+	}, [completion_handler](SBDOpenChannel* const& Channel, SBDError* Error) { Complete(completion_handler, Channel, Error); });
+}
+
+void SBDOpenChannel::Enter(std::function<void(SBDError*)> completion_handler)
+{
+	ChannelRequest(channel_url, [](FSendbirdFakeServer& Server, FChannelRecord& Record) {
+		if (Record.BannedUserIds.count(Server.CurrentUser.user_id) > 0)
+			return ERROR_USER_BANNED;
+
+		Record.Participants.insert(Server.CurrentUser.user_id);
+		static_cast<SBDOpenChannel*>(Record.Channel)->participant_count = (int64_t)Record.Participants.size();
+		return (int64_t)SBDErrorNone;
+	}, [completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+
+void SBDOpenChannel::Exit(std::function<void(SBDError*)> completion_handler)
+{
+	ChannelRequest(channel_url, [](FSendbirdFakeServer& Server, FChannelRecord& Record) {
+		Record.Participants.erase(Server.CurrentUser.user_id);
+		static_cast<SBDOpenChannel*>(Record.Channel)->participant_count = (int64_t)Record.Participants.size();
+		return (int64_t)SBDErrorNone;
+	}, [completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+
+SBDUserListQuery* SBDOpenChannel::CreateParticipantListQuery()
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+	return Server.Own(FSBDUserListQuery::Create(SBDUserListQueryTypeOpenChannelParticipants, this), Server.OwnedUserQueries);
+}
+
+SBDUserListQuery* SBDOpenChannel::CreateMutedUserListQuery()
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+	return Server.Own(FSBDUserListQuery::Create(SBDUserListQueryTypeOpenChannelMutedUsers, this), Server.OwnedUserQueries);
+}
+
+SBDUserListQuery* SBDOpenChannel::CreateBannedUserListQuery()
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+	return Server.Own(FSBDUserListQuery::Create(SBDUserListQueryTypeOpenChannelBannedUsers, this), Server.OwnedUserQueries);
+}
+
+void SBDOpenChannel::RefreshChannel(std::function<void(SBDError*)> completion_handler)
+{
+	ChannelRequest(channel_url, [](FSendbirdFakeServer& Server, FChannelRecord& Record) { return (int64_t)SBDErrorNone; },
+		[completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+
+void SBDOpenChannel::BanUser(const SBDUser& user, int seconds, std::function<void(SBDError*)> completion_handler)
+{
+	const std::wstring UserId = user.user_id;
+	ChannelRequest(channel_url, [UserId, seconds](FSendbirdFakeServer& Server, FChannelRecord& Record) {
+		Record.BannedUserIds.insert(UserId);
+		Record.Participants.erase(UserId);
+		static_cast<SBDOpenChannel*>(Record.Channel)->participant_count = (int64_t)Record.Participants.size();
+
+		if (seconds > 0)
+		{
+			const std::wstring ChannelUrl = Record.Channel->channel_url;
+			Server.Post([&Server, ChannelUrl, UserId]() {
+				FScopeLock ScopeLock(&Server.Lock);
+				if (FChannelRecord* BannedRecord = Server.FindRecord(ChannelUrl))
+					BannedRecord->BannedUserIds.erase(UserId);
+			}, seconds);
+		}
+		return (int64_t)SBDErrorNone;
+	}, [completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+
+void SBDOpenChannel::UnbanUser(const SBDUser& user, std::function<void(SBDError*)> completion_handler)
+{
+	const std::wstring UserId = user.user_id;
+	ChannelRequest(channel_url, [UserId](FSendbirdFakeServer& Server, FChannelRecord& Record) {
+		Record.BannedUserIds.erase(UserId);
+		return (int64_t)SBDErrorNone;
+	}, [completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+
+void SBDOpenChannel::MuteUser(const SBDUser& user, std::function<void(SBDError*)> completion_handler)
+{
+	const std::wstring UserId = user.user_id;
+	ChannelRequest(channel_url, [UserId](FSendbirdFakeServer& Server, FChannelRecord& Record) {
+		Record.MutedUserIds.insert(UserId);
+		return (int64_t)SBDErrorNone;
+	}, [completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+
+void SBDOpenChannel::UnmuteUser(const SBDUser& user, std::function<void(SBDError*)> completion_handler)
+{
+	const std::wstring UserId = user.user_id;
+	ChannelRequest(channel_url, [UserId](FSendbirdFakeServer& Server, FChannelRecord& Record) {
+		Record.MutedUserIds.erase(UserId);
+		return (int64_t)SBDErrorNone;
+	}, [completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+
+bool SBDOpenChannel::IsOperator(const SBDUser& user)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+
+	const FChannelRecord* Record = Server.FindRecord(this);
+	return Record != nullptr && Record->OperatorUserIds.count(user.user_id) > 0;
+}
+//- SBDOpenChannel
+#endif
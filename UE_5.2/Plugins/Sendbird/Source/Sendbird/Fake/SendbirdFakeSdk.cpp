@@ -0,0 +1,1082 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#include "SendbirdFakeServer.h"
+
+#if SENDBIRD_FAKE_BACKEND
+#include <algorithm>
+#include <cwchar>
+#include <string>
+
+using namespace SendbirdFake;
+
+static constexpr int64_t DEFAULT_QUERY_LIMIT = 20;
+static const wchar_t* const SEEDED_GROUP_CHANNEL_PREFIX = L"sendbird_group_channel_fake_";
+
+static size_t ParseToken(const std::string& Token)
+{
+	return Token.empty() ? 0 : (size_t)std::stoull(Token);
+}
+
+template<typename ElementType>
+static void TakePage(const std::vector<ElementType>& Candidates, int64_t Limit, std::string& Token, bool& bHasNext, std::vector<ElementType>& OutPage)
+{
+	const size_t Offset = FMath::Min(ParseToken(Token), Candidates.size());
+	const size_t End = FMath::Min(Offset + (size_t)FMath::Max<int64_t>(Limit, 1), Candidates.size());
+	OutPage.assign(Candidates.begin() + Offset, Candidates.begin() + End);
+
+	Token = std::to_string(End);
+	bHasNext = End < Candidates.size();
+}
+
+static bool ContainsText(const std::wstring& Text, const std::wstring& Filter)
+{
+	return Filter.empty() || Text.find(Filter) != std::wstring::npos;
+}
+
+//+ SBDOption, SBDError
+bool SBDOption::use_member_as_message_sender = false;
+
+SBDError::SBDError(const std::string& msg, int64_t c)
+	: message(msg.begin(), msg.end())
+	, code(c)
+{
+}
+//- SBDOption, SBDError
+
+//+ SBDUser, SBDMember, SBDReadStatus
+SBDUser::SBDUser()
+	: connection_status(SBDUserConnectionStatus::NotAvailable)
+	, last_seen_at(0)
+{
+}
+
+void SBDUser::CreateMetaData(const std::map<std::wstring, std::wstring>& meta_data,
+	std::function<void(const std::map<std::wstring, std::wstring>& meta_data, SBDError* error)> completion_handler)
+{
+	UpdateMetaData(meta_data, completion_handler);
+}
+
+void SBDUser::UpdateMetaData(const std::map<std::wstring, std::wstring>& meta_data,
+	std::function<void(const std::map<std::wstring, std::wstring>& meta_data, SBDError* error)> completion_handler)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	Server.Request([this, &Server, meta_data, completion_handler](SBDError* Error) {
+		if (Error == nullptr)
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+			for (const auto& Pair : meta_data)
+				this->meta_data[Pair.first] = Pair.second;
+
+			if (SBDUser* User = Server.FindUser(user_id))
+				User->meta_data = this->meta_data;
+		}
+		Complete(completion_handler, meta_data, Error);
+	});
+}
+
+void SBDUser::DeleteMetaData(const std::wstring& key, std::function<void(SBDError*)> completion_handler)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	Server.Request([this, &Server, key, completion_handler](SBDError* Error) {
+		if (Error == nullptr)
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+			meta_data.erase(key);
+			if (SBDUser* User = Server.FindUser(user_id))
+				User->meta_data = meta_data;
+		}
+		Complete(completion_handler, Error);
+	});
+}
+
+void SBDUser::DeleteAllMetaData(std::function<void(SBDError*)> completion_handler)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	Server.Request([this, &Server, completion_handler](SBDError* Error) {
+		if (Error == nullptr)
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+			meta_data.clear();
+			if (SBDUser* User = Server.FindUser(user_id))
+				User->meta_data.clear();
+		}
+		Complete(completion_handler, Error);
+	});
+}
+
+SBDMember::SBDMember()
+	: state(SBDMemberState::Joined)
+	, is_blocked_by_me(false)
+	, is_blocking_me(false)
+{
+}
+
+SBDReadStatus::SBDReadStatus()
+	: timestamp(0)
+{
+}
+//- SBDUser, SBDMember, SBDReadStatus
+
+//+ Messages
+SBDMessageMetaArray::SBDMessageMetaArray(std::wstring key)
+	: key(key)
+{
+}
+
+SBDMessageMetaArray::SBDMessageMetaArray(std::wstring key, const std::vector<std::wstring>& value)
+	: key(key)
+	, value(value)
+{
+}
+
+std::wstring SBDMessageMetaArray::GetKey() const { return key; }
+std::vector<std::wstring> SBDMessageMetaArray::GetValue() const { return value; }
+void SBDMessageMetaArray::SetKey(std::wstring key) { this->key = key; }
+void SBDMessageMetaArray::SetValue(std::vector<std::wstring> value) { this->value = value; }
+
+void SBDMessageMetaArray::AddValue(std::wstring value)
+{
+	if (std::find(this->value.begin(), this->value.end(), value) == this->value.end())
+		this->value.push_back(value);
+}
+
+void SBDMessageMetaArray::AddValue(std::vector<std::wstring> value)
+{
+	for (const std::wstring& Value : value)
+		AddValue(Value);
+}
+
+void SBDMessageMetaArray::RemoveValue(std::wstring value)
+{
+	this->value.erase(std::remove(this->value.begin(), this->value.end(), value), this->value.end());
+}
+
+void SBDMessageMetaArray::RemoveValue(std::vector<std::wstring> value)
+{
+	for (const std::wstring& Value : value)
+		RemoveValue(Value);
+}
+
+SBDBaseMessage::SBDBaseMessage(const std::string& dict)
+	: message_type(SBDMessageType::User)
+	, message_id(0)
+	, created_at(0)
+	, updated_at(0)
+	, mention_type(SBDMentionType::Users)
+{
+}
+
+bool SBDBaseMessage::IsOpenChannel() { return channel_type == CHANNEL_TYPE_OPEN; }
+bool SBDBaseMessage::IsGroupChannel() { return channel_type == CHANNEL_TYPE_GROUP; }
+
+std::vector<SBDMessageMetaArray> SBDBaseMessage::GetMetaArraysWithKeys(const std::vector<std::wstring>& metaarraykeys)
+{
+	std::vector<SBDMessageMetaArray> MetaArrays;
+	for (const SBDMessageMetaArray& MetaArray : meta_arrays)
+	{
+		if (std::find(metaarraykeys.begin(), metaarraykeys.end(), MetaArray.GetKey()) != metaarraykeys.end())
+			MetaArrays.push_back(MetaArray);
+	}
+	return MetaArrays;
+}
+
+SBDUserMessage::SBDUserMessage(const std::string& dict)
+	: SBDBaseMessage(dict)
+{
+	message_type = SBDMessageType::User;
+}
+
+SBDUser& SBDUserMessage::GetSender() { return sender; }
+
+SBDAdminMessage::SBDAdminMessage(const std::string& dict)
+	: SBDBaseMessage(dict)
+{
+	message_type = SBDMessageType::Admin;
+}
+
+SBDFileMessage::SBDFileMessage(const std::string& dict)
+	: SBDBaseMessage(dict)
+	, size(0)
+	, require_auth(false)
+{
+	message_type = SBDMessageType::File;
+}
+
+SBDUser& SBDFileMessage::GetSender() { return sender; }
+
+SBDThumbnailSize::SBDThumbnailSize(int64_t max_width, int64_t max_height)
+	: max_width(max_width)
+	, max_height(max_height)
+{
+}
+
+SBDThumbnail::SBDThumbnail(int64_t max_width, int64_t max_height, int64_t real_width, int64_t real_height, const std::wstring& url, bool require_auth)
+	: max_width(max_width)
+	, max_height(max_height)
+	, real_width(real_width)
+	, real_height(real_height)
+	, url(url)
+	, require_auth(require_auth)
+{
+}
+
+std::wstring SBDThumbnail::GetUrl() { return url; }
+//- Messages
+
+//+ Params
+SBDUserMessageParams::SBDUserMessageParams()
+	: mention_type(SBDMentionType::Users)
+	, pushnotification_delivery_option(SBDPushNotificationDeliveryOption::Default)
+{
+}
+
+SBDUserMessageParams::~SBDUserMessageParams() {}
+SBDUserMessageParams& SBDUserMessageParams::SetMessage(std::wstring message) { this->message = message; return *this; }
+SBDUserMessageParams& SBDUserMessageParams::SetData(std::wstring data) { this->data = data; return *this; }
+SBDUserMessageParams& SBDUserMessageParams::SetCustomType(std::wstring custom_type) { this->custom_type = custom_type; return *this; }
+SBDUserMessageParams& SBDUserMessageParams::SetTargetLanguages(std::vector<std::wstring>& target_languages) { this->target_languages = target_languages; return *this; }
+SBDUserMessageParams& SBDUserMessageParams::SetMentionType(SBDMentionType mention_type) { this->mention_type = mention_type; return *this; }
+SBDUserMessageParams& SBDUserMessageParams::SetMentionedUserIds(std::vector<std::wstring>& mentioned_user_ids) { this->mentioned_user_ids = mentioned_user_ids; return *this; }
+SBDUserMessageParams& SBDUserMessageParams::SetPushNotificationDeliveryOption(SBDPushNotificationDeliveryOption pushnotification_delivery_option) { this->pushnotification_delivery_option = pushnotification_delivery_option; return *this; }
+SBDUserMessageParams& SBDUserMessageParams::SetMetaArrayKeys(std::vector<std::wstring>& metaarray_keys) { this->metaarray_keys = metaarray_keys; return *this; }
+
+SBDFileMessageParams::SBDFileMessageParams()
+	: file_size(0)
+{
+}
+
+SBDFileMessageParams::~SBDFileMessageParams() {}
+SBDFileMessageParams& SBDFileMessageParams::SetFileUrl(std::wstring file_url) { this->file_url = file_url; return *this; }
+SBDFileMessageParams& SBDFileMessageParams::SetFilePath(std::wstring file_path) { this->file_path = file_path; return *this; }
+SBDFileMessageParams& SBDFileMessageParams::SetFileName(std::wstring file_name) { this->file_name = file_name; return *this; }
+SBDFileMessageParams& SBDFileMessageParams::SetMimeType(std::wstring mime_type) { this->mime_type = mime_type; return *this; }
+SBDFileMessageParams& SBDFileMessageParams::SetFileSize(int64_t file_size) { this->file_size = file_size; return *this; }
+SBDFileMessageParams& SBDFileMessageParams::SetThumbnailSizes(std::vector<SBDThumbnailSize>& thumbnail_sizes) { this->thumbnail_sizes = thumbnail_sizes; return *this; }
+SBDFileMessageParams& SBDFileMessageParams::SetData(std::wstring data) { this->data = data; return *this; }
+SBDFileMessageParams& SBDFileMessageParams::SetCustomType(std::wstring custom_type) { this->custom_type = custom_type; return *this; }
+
+SBDGroupChannelParams::SBDGroupChannelParams()
+	: is_distinct(false)
+	, is_public(false)
+{
+}
+
+SBDGroupChannelParams::~SBDGroupChannelParams() {}
+SBDGroupChannelParams& SBDGroupChannelParams::SetUserIds(std::vector<std::wstring>& user_ids) { this->user_ids = user_ids; return *this; }
+SBDGroupChannelParams& SBDGroupChannelParams::SetName(std::wstring name) { this->name = name; return *this; }
+SBDGroupChannelParams& SBDGroupChannelParams::SetDistinct(bool is_distinct) { this->is_distinct = is_distinct; return *this; }
+SBDGroupChannelParams& SBDGroupChannelParams::SetPublic(bool is_public) { this->is_public = is_public; return *this; }
+SBDGroupChannelParams& SBDGroupChannelParams::SetChannelUrl(std::wstring channel_url) { this->channel_url = channel_url; return *this; }
+SBDGroupChannelParams& SBDGroupChannelParams::SetCoverUrl(std::wstring cover_url) { this->cover_url = cover_url; return *this; }
+SBDGroupChannelParams& SBDGroupChannelParams::SetCoverImageFilePathAndFileMimeType(std::wstring cover_image_file_path, std::wstring file_mime_type)
+{
+	this->cover_image_file_path = cover_image_file_path;
+	this->file_mime_type = file_mime_type;
+	return *this;
+}
+SBDGroupChannelParams& SBDGroupChannelParams::SetData(std::wstring data) { this->data = data; return *this; }
+SBDGroupChannelParams& SBDGroupChannelParams::SetCustomType(std::wstring custom_type) { this->custom_type = custom_type; return *this; }
+SBDGroupChannelParams& SBDGroupChannelParams::SetOperatorUserIds(std::vector<std::wstring>& operator_user_ids) { this->operator_user_ids = operator_user_ids; return *this; }
+
+SBDOpenChannelParams::SBDOpenChannelParams() {}
+SBDOpenChannelParams::~SBDOpenChannelParams() {}
+SBDOpenChannelParams& SBDOpenChannelParams::SetName(std::wstring name) { this->name = name; return *this; }
+SBDOpenChannelParams& SBDOpenChannelParams::SetChannelUrl(std::wstring channel_url) { this->channel_url = channel_url; return *this; }
+SBDOpenChannelParams& SBDOpenChannelParams::SetCoverUrl(std::wstring cover_url) { this->cover_url = cover_url; return *this; }
+SBDOpenChannelParams& SBDOpenChannelParams::SetCoverImageFilePathAndFileMimeType(std::wstring cover_image_file_path, std::wstring file_mime_type)
+{
+	this->cover_image_file_path = cover_image_file_path;
+	this->file_mime_type = file_mime_type;
+	return *this;
+}
+SBDOpenChannelParams& SBDOpenChannelParams::SetData(std::wstring data) { this->data = data; return *this; }
+SBDOpenChannelParams& SBDOpenChannelParams::SetCustomType(std::wstring custom_type) { this->custom_type = custom_type; return *this; }
+SBDOpenChannelParams& SBDOpenChannelParams::SetOperatorUserIds(std::vector<std::wstring>& operator_user_ids) { this->operator_user_ids = operator_user_ids; return *this; }
+
+SBDGroupChannelTotalUnreadMessageCountParams::SBDGroupChannelTotalUnreadMessageCountParams() {}
+SBDGroupChannelTotalUnreadMessageCountParams::~SBDGroupChannelTotalUnreadMessageCountParams() {}
+SBDGroupChannelTotalUnreadMessageCountParams& SBDGroupChannelTotalUnreadMessageCountParams::SetChannelCustomTypesFilter(std::vector<std::wstring>& channel_custom_types)
+{
+	this->channel_custom_types = channel_custom_types;
+	return *this;
+}
+//- Params
+
+//+ SBDMain
+std::wstring SBDMain::GetApplicationId()
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+	return Server.ApplicationId;
+}
+
+std::wstring SBDMain::GetSdkVersion()
+{
+	return L"3.1.2-fake";
+}
+
+bool SBDMain::IsInitialized()
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+	return Server.bInitialized;
+}
+
+void SBDMain::Init(std::wstring application_id)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	Server.StartWorker();
+
+	FScopeLock ScopeLock(&Server.Lock);
+	Server.Seed(application_id);
+}
+
+SBDConnectionState SBDMain::GetConnectionState()
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+	return Server.ConnectionState;
+}
+
+void SBDMain::AddConnectionHandler(std::wstring identifier, SBDConnectionHandler* handler)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+	Server.ConnectionHandlers[identifier] = handler;
+}
+
+void SBDMain::RemoveConnectionHandler(std::wstring identifier)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+	Server.ConnectionHandlers.erase(identifier);
+}
+
+void SBDMain::RemoveAllConnectionHandlers()
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+	Server.ConnectionHandlers.clear();
+}
+
+void SBDMain::AddUserEventHandler(std::wstring identifier, SBDUserEventHandler* handler)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+	Server.UserEventHandlers[identifier] = handler;
+}
+
+void SBDMain::RemoveUserEventHandler(std::wstring identifier)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+	Server.UserEventHandlers.erase(identifier);
+}
+
+void SBDMain::RemoveAllUserEventHandlers()
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+	Server.UserEventHandlers.clear();
+}
+
+void SBDMain::AddChannelHandler(std::wstring identifier, SBDChannelHandler* handler)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+	Server.ChannelHandlers[identifier] = handler;
+}
+
+void SBDMain::RemoveChannelHandler(std::wstring identifier)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+	Server.ChannelHandlers.erase(identifier);
+}
+
+void SBDMain::RemoveAllChannelHandlers()
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+	Server.ChannelHandlers.clear();
+}
+
+void SBDMain::Connect(std::wstring user_id, std::wstring access_token, std::function<void(SBDUser*, SBDError*)> completion_handler)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	{
+		FScopeLock ScopeLock(&Server.Lock);
+		if (!Server.bInitialized)
+		{
+			Server.Reject([completion_handler](SBDError* Error) { Complete(completion_handler, nullptr, Error); }, SBDErrorInvalidInitialization, "SBDMain::Init() must be called first.");
+			return;
+		}
+		if (user_id.empty())
+		{
+			Server.Reject([completion_handler](SBDError* Error) { Complete(completion_handler, nullptr, Error); }, SBDErrorInvalidParameter, "user_id is empty.");
+			return;
+		}
+		Server.ConnectionState = SBDConnectionState::Connecting;
+	}
+
+	Server.Request([&Server, user_id, completion_handler](SBDError* Error) {
+		SBDUser* CurrentUser = nullptr;
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+			if (Error != nullptr)
+			{
+				Server.ConnectionState = SBDConnectionState::Closed;
+			}
+			else
+			{
+				SBDUser* User = Server.FindOrAddUser(user_id);
+				User->connection_status = SBDUserConnectionStatus::Online;
+				Server.CurrentUser = *User;
+				Server.bHasCurrentUser = true;
+				Server.ConnectionState = SBDConnectionState::Open;
+				CurrentUser = &Server.CurrentUser;
+
+				// Every user is a member of the seeded group channels, so the group channel list is never empty.
+				for (const std::wstring& ChannelUrl : Server.GroupChannelUrls)
+				{
+					SBDGroupChannel* Channel = static_cast<SBDGroupChannel*>(Server.Channels[ChannelUrl].Channel);
+					if (ChannelUrl.compare(0, wcslen(SEEDED_GROUP_CHANNEL_PREFIX), SEEDED_GROUP_CHANNEL_PREFIX) == 0 && Server.FindMember(Channel, user_id) == nullptr)
+						Server.AddMember(Channel, *User, SBDMemberState::Joined);
+				}
+			}
+		}
+		Complete(completion_handler, CurrentUser, Error);
+	}, false);
+}
+
+void SBDMain::Disconnect(std::function<void()> completion_handler)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	{
+		FScopeLock ScopeLock(&Server.Lock);
+		Server.ConnectionState = SBDConnectionState::Closing;
+	}
+
+	Server.Post([&Server, completion_handler]() {
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+			if (Server.bHasCurrentUser)
+			{
+				if (SBDUser* User = Server.FindUser(Server.CurrentUser.user_id))
+					User->connection_status = SBDUserConnectionStatus::Offline;
+
+				for (auto& Pair : Server.Channels)
+				{
+					if (Pair.second.bOpen && Pair.second.Participants.erase(Server.CurrentUser.user_id) > 0)
+						static_cast<SBDOpenChannel*>(Pair.second.Channel)->participant_count = (int64_t)Pair.second.Participants.size();
+				}
+			}
+
+			Server.CurrentUser = SBDUser();
+			Server.bHasCurrentUser = false;
+			Server.ConnectionState = SBDConnectionState::Closed;
+		}
+		Complete(completion_handler);
+	}, Server.NextLatencySeconds());
+}
+
+SBDUser* SBDMain::GetCurrentUser()
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+	return Server.bHasCurrentUser ? &Server.CurrentUser : nullptr;
+}
+
+void SBDMain::UpdateCurrentUserInfo(std::wstring nickname, std::wstring profile_url, std::function<void(SBDError*)> completion_handler)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	Server.Request([&Server, nickname, profile_url, completion_handler](SBDError* Error) {
+		if (Error == nullptr)
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+			if (!IsNullWString(nickname))
+				Server.CurrentUser.nickname = nickname;
+			if (!IsNullWString(profile_url))
+				Server.CurrentUser.profile_url = profile_url;
+
+			if (SBDUser* User = Server.FindUser(Server.CurrentUser.user_id))
+				*User = Server.CurrentUser;
+		}
+		Complete(completion_handler, Error);
+	});
+}
+
+void SBDMain::UpdateCurrentUserInfoWithBinaryProfileImage(std::wstring nickname, std::wstring profile_image_file_path, std::wstring mime_type,
+	std::function<void(SBDError*)> completion_handler)
+{
+	UpdateCurrentUserInfo(nickname, L"file://" + profile_image_file_path, completion_handler);
+}
+
+SBDUserListQuery* SBDMain::CreateAllUserListQuery()
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+	return Server.Own(FSBDUserListQuery::Create(SBDUserListQueryTypeAllUser, nullptr), Server.OwnedUserQueries);
+}
+
+SBDUserListQuery* SBDMain::CreateUserListQuery(std::vector<std::wstring> user_ids)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+	return Server.Own(FSBDUserListQuery::Create(user_ids), Server.OwnedUserQueries);
+}
+
+SBDUserListQuery* SBDMain::CreateBlockedUserListQuery()
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+	return Server.Own(FSBDUserListQuery::Create(SBDUserListQueryTypeBlockedUsers, nullptr), Server.OwnedUserQueries);
+}
+
+void SBDMain::BlockUser(const SBDUser& user, std::function<void(SBDUser* blocked_user, SBDError*)> completion_handler)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	const std::wstring UserId = user.user_id;
+	Server.Request([&Server, UserId, completion_handler](SBDError* Error) {
+		SBDUser* BlockedUser = nullptr;
+		if (Error == nullptr)
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+			Server.BlockedUserIds.insert(UserId);
+			BlockedUser = Server.FindOrAddUser(UserId);
+		}
+		Complete(completion_handler, BlockedUser, Error);
+	});
+}
+
+void SBDMain::UnblockUser(const SBDUser& user, std::function<void(SBDError*)> completion_handler)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	const std::wstring UserId = user.user_id;
+	Server.Request([&Server, UserId, completion_handler](SBDError* Error) {
+		if (Error == nullptr)
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+			Server.BlockedUserIds.erase(UserId);
+		}
+		Complete(completion_handler, Error);
+	});
+}
+
+bool SBDMain::Reconnect()
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	{
+		FScopeLock ScopeLock(&Server.Lock);
+		if (!Server.bHasCurrentUser)
+			return false;
+
+		Server.ConnectionState = SBDConnectionState::Connecting;
+	}
+
+	Server.Post([&Server]() {
+		Server.BroadcastConnectionEvent([](SBDConnectionHandler* Handler) { Handler->Started(); });
+	});
+
+	Server.Request([&Server](SBDError* Error) {
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+			Server.ConnectionState = Error == nullptr ? SBDConnectionState::Open : SBDConnectionState::Closed;
+		}
+
+		if (Error == nullptr)
+			Server.BroadcastConnectionEvent([](SBDConnectionHandler* Handler) { Handler->Succeeded(); });
+		else
+			Server.BroadcastConnectionEvent([](SBDConnectionHandler* Handler) { Handler->Failed(); });
+	}, false);
+	return true;
+}
+
+void SBDMain::SetChannelInvitationPreference(bool auto_accept, std::function<void(SBDError*)> completion_handler)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	Server.Request([&Server, auto_accept, completion_handler](SBDError* Error) {
+		if (Error == nullptr)
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+			Server.bAutoAcceptInvitation = auto_accept;
+		}
+		Complete(completion_handler, Error);
+	});
+}
+
+void SBDMain::GetChannelInvitationPreference(std::function<void(bool is_auto_accept, SBDError*)> completion_handler)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	Server.Request([&Server, completion_handler](SBDError* Error) {
+		bool bAutoAccept = false;
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+			bAutoAccept = Server.bAutoAcceptInvitation;
+		}
+		Complete(completion_handler, bAutoAccept, Error);
+	});
+}
+
+void SBDMain::GetTotalUnreadChannelCount(std::function<void(int total_unread_channel_count, SBDError*)> completion_handler)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	Server.Request([&Server, completion_handler](SBDError* Error) {
+		int UnreadChannelCount = 0;
+		if (Error == nullptr)
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+			for (const std::wstring& ChannelUrl : Server.GroupChannelUrls)
+			{
+				SBDGroupChannel* Channel = static_cast<SBDGroupChannel*>(Server.Channels[ChannelUrl].Channel);
+				if (Channel->unread_message_count > 0 && Server.FindMember(Channel, Server.CurrentUser.user_id) != nullptr)
+					++UnreadChannelCount;
+			}
+		}
+		Complete(completion_handler, UnreadChannelCount, Error);
+	});
+}
+
+void SBDMain::GetTotalUnreadMessageCount(SBDGroupChannelTotalUnreadMessageCountParams& params, std::function<void(int total_unread_message_count, SBDError*)> completion_handler)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	const std::vector<std::wstring> CustomTypes = params.channel_custom_types;
+	Server.Request([&Server, CustomTypes, completion_handler](SBDError* Error) {
+		int UnreadCount = 0;
+		if (Error == nullptr)
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+			UnreadCount = Server.GetTotalUnreadMessageCount(&CustomTypes);
+		}
+		Complete(completion_handler, UnreadCount, Error);
+	});
+}
+
+int SBDMain::GetSubscribedTotalUnreadMessageCount()
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+	return Server.GetTotalUnreadMessageCount(nullptr);
+}
+
+int SBDMain::GetSubscribedCustomTypeTotalUnreadMessageCount()
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+
+	std::map<std::wstring, int> CountByCustomType;
+	Server.GetTotalUnreadMessageCount(nullptr, &CountByCustomType);
+
+	int TotalCount = 0;
+	for (const auto& Pair : CountByCustomType)
+		TotalCount += Pair.second;
+	return TotalCount;
+}
+
+int SBDMain::GetSubscribedCustomTypeUnreadMessageCount(std::wstring custom_type)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+
+	std::map<std::wstring, int> CountByCustomType;
+	Server.GetTotalUnreadMessageCount(nullptr, &CountByCustomType);
+
+	auto It = CountByCustomType.find(custom_type);
+	return It != CountByCustomType.end() ? It->second : 0;
+}
+
+void SBDMain::RegisterPushTokenForCurrentUser(SBDPushTokenType type, std::wstring token, bool unique, std::function<void(SBDPushTokenRegistrationStatus, SBDError*)> completion_handler)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	{
+		FScopeLock ScopeLock(&Server.Lock);
+		if (!Server.IsConnected())
+		{
+			Server.PendingPushToken = token;
+			Server.Post([completion_handler]() { Complete(completion_handler, SBDPushTokenRegistrationStatus::Pending, nullptr); });
+			return;
+		}
+	}
+
+	Server.Request([completion_handler](SBDError* Error) {
+		Complete(completion_handler, Error == nullptr ? SBDPushTokenRegistrationStatus::Success : SBDPushTokenRegistrationStatus::Error, Error);
+	});
+}
+
+std::wstring SBDMain::GetPendingPushToken()
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+	return Server.PendingPushToken;
+}
+
+void SBDMain::UnregisterPushTokenForCurrentUser(SBDPushTokenType type, std::wstring token, std::function<void(SBDError*)> completion_handler)
+{
+	FSendbirdFakeServer::Get().Request([completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+
+void SBDMain::UnregisterPushTokenAllForCurrentUser(std::function<void(SBDError*)> completion_handler)
+{
+	FSendbirdFakeServer::Get().Request([completion_handler](SBDError* Error) { Complete(completion_handler, Error); });
+}
+//- SBDMain
+
+//+ Queries
+SBDPreviousMessageListQuery::SBDPreviousMessageListQuery(SBDBaseChannel* channel)
+	: is_loading(false)
+	, channel(channel)
+	, minimum_timestamp(INT64_MAX)
+{
+}
+
+void SBDPreviousMessageListQuery::LoadNextPage(int limit, bool reverse, std::function<void(std::vector<SBDBaseMessage*> messages, SBDError*)> completion_handler)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	if (is_loading)
+	{
+		Server.Reject([completion_handler](SBDError* Error) { Complete(completion_handler, std::vector<SBDBaseMessage*>(), Error); }, SBDErrorQueryInProgress, "Query in progress.");
+		return;
+	}
+
+	is_loading = true;
+	Server.Request([this, &Server, limit, reverse, completion_handler](SBDError* Error) {
+		std::vector<SBDBaseMessage*> Messages;
+		FServerError ServerError;
+		if (Error == nullptr)
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+			if (FSendbirdFakeServer::FChannelRecord* Record = Server.FindRecord(channel))
+			{
+				Server.CollectMessages(*Record, minimum_timestamp, false, false, limit, SBDMessageTypeFilter::All, std::wstring(), Messages);
+				if (!Messages.empty())
+					minimum_timestamp = Messages.back()->created_at;
+				FSendbirdFakeServer::SortMessages(Messages, reverse);
+			}
+			else
+			{
+				Error = ServerError.Set(ERROR_CHANNEL_NOT_FOUND, "Channel not found.");
+			}
+		}
+		is_loading = false;
+		Complete(completion_handler, Messages, Error);
+	});
+}
+
+SBDOpenChannelListQuery::SBDOpenChannelListQuery()
+	: limit(DEFAULT_QUERY_LIMIT)
+	, has_next(true)
+	, is_loading(false)
+{
+}
+
+void SBDOpenChannelListQuery::SetChannelUrlFilter(const std::wstring& channel_url) { channel_url_filter = channel_url; }
+void SBDOpenChannelListQuery::SetChannelNameFilter(const std::wstring& channel_name) { channel_name_filter = channel_name; }
+void SBDOpenChannelListQuery::SetCustomTypeFilter(const std::wstring& custom_type) { custom_type_filter = custom_type; }
+
+void SBDOpenChannelListQuery::LoadNextPage(std::function<void(std::vector<SBDOpenChannel*> channels, SBDError*)> completion_handler)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	if (is_loading)
+	{
+		Server.Reject([completion_handler](SBDError* Error) { Complete(completion_handler, std::vector<SBDOpenChannel*>(), Error); }, SBDErrorQueryInProgress, "Query in progress.");
+		return;
+	}
+
+	is_loading = true;
+	Server.Request([this, &Server, completion_handler](SBDError* Error) {
+		std::vector<SBDOpenChannel*> Page;
+		if (Error == nullptr)
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+
+			std::vector<SBDOpenChannel*> Candidates;
+			for (const std::wstring& ChannelUrl : Server.OpenChannelUrls)
+			{
+				SBDOpenChannel* Channel = static_cast<SBDOpenChannel*>(Server.Channels[ChannelUrl].Channel);
+				if ((channel_url_filter.empty() || Channel->channel_url == channel_url_filter)
+					&& ContainsText(Channel->name, channel_name_filter)
+					&& (custom_type_filter.empty() || Channel->custom_type == custom_type_filter))
+					Candidates.push_back(Channel);
+			}
+			TakePage(Candidates, limit, token, has_next, Page);
+		}
+		is_loading = false;
+		Complete(completion_handler, Page, Error);
+	});
+}
+
+SBDGroupChannelListQuery::SBDGroupChannelListQuery()
+	: limit(DEFAULT_QUERY_LIMIT)
+	, include_empty_channel(true)
+	, include_member_list(true)
+	, order(SBDGroupChannelListOrder::LatestLastMessage)
+	, has_next(true)
+	, query_type(SBDGroupChannelListQueryType::And)
+	, is_loading(false)
+	, channel_public_state_filter(SBDChannelPublicStateFilter::All)
+	, channel_hidden_state_filter(SBDChannelHiddenStateFilter::UnhiddenOnly)
+	, member_state_filter(SBDMemberStateFilter::All)
+{
+}
+
+void SBDGroupChannelListQuery::SetCustomTypeFilter(const std::wstring& custom_type) { custom_type_filter = custom_type; }
+void SBDGroupChannelListQuery::SetMemberStateFilter(SBDMemberStateFilter member_state_filter) { this->member_state_filter = member_state_filter; }
+void SBDGroupChannelListQuery::SetChannelUrlsFilter(const std::vector<std::wstring>& channel_urls) { channel_urls_filter = channel_urls; }
+void SBDGroupChannelListQuery::SetChannelNameContainsFilter(const std::wstring& channel_name) { channel_name_filter = channel_name; }
+void SBDGroupChannelListQuery::SetNicknameContainsFilter(const std::wstring& nickname) { nickname_contains_filter = nickname; }
+
+void SBDGroupChannelListQuery::SetUsersIncludeFilter(const std::vector<SBDUser>& users, SBDGroupChannelListQueryType query_type)
+{
+	users_filter_like_match = users;
+	this->query_type = query_type;
+}
+
+void SBDGroupChannelListQuery::SetUsersExactFilter(const std::vector<SBDUser>& users) { users_filter_exact_match = users; }
+void SBDGroupChannelListQuery::SetChannelPublicStateFilter(const SBDChannelPublicStateFilter channel_public_state_filter) { this->channel_public_state_filter = channel_public_state_filter; }
+void SBDGroupChannelListQuery::SetChannelHiddenStateFilter(const SBDChannelHiddenStateFilter channel_hidden_state_filter) { this->channel_hidden_state_filter = channel_hidden_state_filter; }
+
+void SBDGroupChannelListQuery::LoadNextPage(std::function<void(std::vector<SBDGroupChannel*> channels, SBDError*)> completion_handler)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	if (is_loading)
+	{
+		Server.Reject([completion_handler](SBDError* Error) { Complete(completion_handler, std::vector<SBDGroupChannel*>(), Error); }, SBDErrorQueryInProgress, "Query in progress.");
+		return;
+	}
+
+	is_loading = true;
+	Server.Request([this, &Server, completion_handler](SBDError* Error) {
+		std::vector<SBDGroupChannel*> Page;
+		if (Error == nullptr)
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+
+			auto MatchesUsers = [this](SBDGroupChannel* Channel) {
+				if (!users_filter_exact_match.empty())
+				{
+					if (users_filter_exact_match.size() + 1 != Channel->members.size())
+						return false;
+					for (const SBDUser& User : users_filter_exact_match)
+					{
+						if (FSendbirdFakeServer::FindMember(Channel, User.user_id) == nullptr)
+							return false;
+					}
+				}
+
+				if (!users_filter_like_match.empty())
+				{
+					size_t MatchCount = 0;
+					for (const SBDUser& User : users_filter_like_match)
+						MatchCount += FSendbirdFakeServer::FindMember(Channel, User.user_id) != nullptr ? 1 : 0;
+
+					if (query_type == SBDGroupChannelListQueryType::And ? MatchCount != users_filter_like_match.size() : MatchCount == 0)
+						return false;
+				}
+
+				if (!nickname_contains_filter.empty())
+				{
+					auto It = std::find_if(Channel->members.begin(), Channel->members.end(), [this](const SBDMember& Member) { return ContainsText(Member.nickname, nickname_contains_filter); });
+					if (It == Channel->members.end())
+						return false;
+				}
+				return true;
+			};
+
+			auto MatchesState = [this](SBDGroupChannel* Channel, const SBDMember* Me) {
+				if (member_state_filter == SBDMemberStateFilter::JoinedOnly && Me->state != SBDMemberState::Joined)
+					return false;
+				if (member_state_filter == SBDMemberStateFilter::InvitedOnly && Me->state != SBDMemberState::Invited)
+					return false;
+
+				if (channel_public_state_filter == SBDChannelPublicStateFilter::Public && !Channel->is_public)
+					return false;
+				if (channel_public_state_filter == SBDChannelPublicStateFilter::Private && Channel->is_public)
+					return false;
+
+				switch (channel_hidden_state_filter)
+				{
+				case SBDChannelHiddenStateFilter::UnhiddenOnly:				return !Channel->is_hidden;
+				case SBDChannelHiddenStateFilter::HiddenOnly:				return Channel->is_hidden;
+				case SBDChannelHiddenStateFilter::HiddenAllowAutoUnhide:	return Channel->is_hidden && Channel->hidden_state == SBDGroupChannelHiddenState::AllowAutoUnhide;
+				case SBDChannelHiddenStateFilter::HiddenPreventAutoUnhide:	return Channel->is_hidden && Channel->hidden_state == SBDGroupChannelHiddenState::HiddenPreventAutoUnhide;
+				}
+				return true;
+			};
+
+			std::vector<SBDGroupChannel*> Candidates;
+			for (const std::wstring& ChannelUrl : Server.GroupChannelUrls)
+			{
+				const FSendbirdFakeServer::FChannelRecord& Record = Server.Channels[ChannelUrl];
+				SBDGroupChannel* Channel = static_cast<SBDGroupChannel*>(Record.Channel);
+
+				const SBDMember* Me = FSendbirdFakeServer::FindMember(Channel, Server.CurrentUser.user_id);
+				if (Me == nullptr || !MatchesState(Channel, Me) || !MatchesUsers(Channel))
+					continue;
+				if (!include_empty_channel && Record.Messages.empty())
+					continue;
+				if (!custom_type_filter.empty() && Channel->custom_type != custom_type_filter)
+					continue;
+				if (!channel_urls_filter.empty() && std::find(channel_urls_filter.begin(), channel_urls_filter.end(), ChannelUrl) == channel_urls_filter.end())
+					continue;
+				if (!ContainsText(Channel->name, channel_name_filter))
+					continue;
+
+				Candidates.push_back(Channel);
+			}
+
+			if (order == SBDGroupChannelListOrder::LatestLastMessage)
+			{
+				auto LastMessageTime = [&Server](SBDGroupChannel* Channel) {
+					const std::vector<SBDBaseMessage*>& Messages = Server.Channels[Channel->channel_url].Messages;
+					return Messages.empty() ? Channel->created_at * 1000 : Messages.back()->created_at;
+				};
+				std::stable_sort(Candidates.begin(), Candidates.end(), [&LastMessageTime](SBDGroupChannel* A, SBDGroupChannel* B) { return LastMessageTime(A) > LastMessageTime(B); });
+			}
+			else
+			{
+				std::stable_sort(Candidates.begin(), Candidates.end(), [](SBDGroupChannel* A, SBDGroupChannel* B) { return A->created_at > B->created_at; });
+			}
+
+			TakePage(Candidates, limit, token, has_next, Page);
+		}
+		is_loading = false;
+		Complete(completion_handler, Page, Error);
+	});
+}
+
+SBDUserListQuery::SBDUserListQuery(SBDUserListQueryType query_type, SBDBaseChannel* channel)
+	: channel(channel)
+	, query_type(query_type)
+	, limit(DEFAULT_QUERY_LIMIT)
+	, has_next(true)
+	, is_loading(false)
+{
+}
+
+SBDUserListQuery::SBDUserListQuery(const std::vector<std::wstring>& user_ids)
+	: channel(nullptr)
+	, query_type(SBDUserListQueryTypeFilteredUsers)
+	, limit(DEFAULT_QUERY_LIMIT)
+	, has_next(true)
+	, is_loading(false)
+	, user_ids(user_ids)
+{
+}
+
+void SBDUserListQuery::SetMetaDataFilter(const std::wstring& key, const std::vector<std::wstring>& values)
+{
+	meta_data_key = key;
+	meta_data_values = values;
+}
+
+void SBDUserListQuery::LoadNextPage(std::function<void(const std::vector<SBDUser>& users, SBDError* error)> completion_handler)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	if (is_loading)
+	{
+		Server.Reject([completion_handler](SBDError* Error) { Complete(completion_handler, std::vector<SBDUser>(), Error); }, SBDErrorQueryInProgress, "Query in progress.");
+		return;
+	}
+
+	is_loading = true;
+	Server.Request([this, &Server, completion_handler](SBDError* Error) {
+		std::vector<SBDUser> Page;
+		if (Error == nullptr)
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+
+			std::vector<std::wstring> UserIds;
+			const FSendbirdFakeServer::FChannelRecord* Record = Server.FindRecord(channel);
+			switch (query_type)
+			{
+			case SBDUserListQueryTypeAllUser:
+				for (const std::unique_ptr<SBDUser>& User : Server.Users)
+					UserIds.push_back(User->user_id);
+				break;
+			case SBDUserListQueryTypeBlockedUsers:
+				UserIds.assign(Server.BlockedUserIds.begin(), Server.BlockedUserIds.end());
+				break;
+			case SBDUserListQueryTypeOpenChannelParticipants:
+				if (Record != nullptr)
+					UserIds.assign(Record->Participants.begin(), Record->Participants.end());
+				break;
+			case SBDUserListQueryTypeOpenChannelMutedUsers:
+				if (Record != nullptr)
+					UserIds.assign(Record->MutedUserIds.begin(), Record->MutedUserIds.end());
+				break;
+			case SBDUserListQueryTypeOpenChannelBannedUsers:
+				if (Record != nullptr)
+					UserIds.assign(Record->BannedUserIds.begin(), Record->BannedUserIds.end());
+				break;
+			case SBDUserListQueryTypeFilteredUsers:
+				UserIds = user_ids;
+				break;
+			}
+
+			std::vector<SBDUser> Candidates;
+			for (const std::wstring& UserId : UserIds)
+			{
+				const SBDUser* User = Server.FindUser(UserId);
+				if (User == nullptr)
+					continue;
+
+				if (!meta_data_key.empty())
+				{
+					auto It = User->meta_data.find(meta_data_key);
+					if (It == User->meta_data.end() || std::find(meta_data_values.begin(), meta_data_values.end(), It->second) == meta_data_values.end())
+						continue;
+				}
+				Candidates.push_back(*User);
+			}
+			TakePage(Candidates, limit, token, has_next, Page);
+		}
+		is_loading = false;
+		Complete(completion_handler, Page, Error);
+	});
+}
+
+SBDOperatorListQuery::SBDOperatorListQuery(SBDBaseChannel* channel)
+	: channel(channel)
+	, limit(DEFAULT_QUERY_LIMIT)
+	, has_next(true)
+	, is_loading(false)
+{
+}
+
+void SBDOperatorListQuery::SetLimit(int limit) { this->limit = limit; }
+bool SBDOperatorListQuery::HasNext() { return has_next; }
+bool SBDOperatorListQuery::IsLoading() { return is_loading; }
+
+void SBDOperatorListQuery::LoadNextPage(std::function<void(const std::vector<SBDUser>& users, SBDError* error)> completion_handler)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	if (is_loading)
+	{
+		Server.Reject([completion_handler](SBDError* Error) { Complete(completion_handler, std::vector<SBDUser>(), Error); }, SBDErrorQueryInProgress, "Query in progress.");
+		return;
+	}
+
+	is_loading = true;
+	Server.Request([this, &Server, completion_handler](SBDError* Error) {
+		std::vector<SBDUser> Page;
+		if (Error == nullptr)
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+
+			std::vector<SBDUser> Candidates;
+			if (const FSendbirdFakeServer::FChannelRecord* Record = Server.FindRecord(channel))
+			{
+				for (const std::wstring& UserId : Record->OperatorUserIds)
+				{
+					if (const SBDUser* User = Server.FindUser(UserId))
+						Candidates.push_back(*User);
+				}
+			}
+			TakePage(Candidates, limit, token, has_next, Page);
+		}
+		is_loading = false;
+		Complete(completion_handler, Page, Error);
+	});
+}
+//- Queries
+#endif
@@ -0,0 +1,914 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#include "SendbirdFakeServer.h"
+
+#if SENDBIRD_FAKE_BACKEND
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/DateTime.h"
+
+static constexpr double FAKE_WORKER_IDLE_WAIT_SECONDS = 0.1;
+
+static const wchar_t* const SEED_MESSAGES[] = {
+	L"Hello everyone!",
+	L"Anyone up for a match tonight?",
+	L"gg wp \U0001F44D",
+	L"안녕하세요, 오늘 저녁에 같이 게임할래요?",
+	L"今日のイベントは午後三時からです。",
+	L"我们在大厅见面。",
+	L"brb, grabbing a snack",
+	L"That last round was close \U0001F525\U0001F525",
+	L"Does anybody know when the next patch drops?",
+	L"See you at the lobby in 5 minutes, bring the new deck!",
+};
+
+int64_t SendbirdFake::UnixTimeMs()
+{
+	return (FDateTime::UtcNow() - FDateTime(1970, 1, 1)).GetTicks() / ETimespan::TicksPerMillisecond;
+}
+
+SBDReadStatus FSBDReadStatus::Make(const SBDUser& Reader, int64_t Timestamp, const std::wstring& ChannelUrl)
+{
+	SBDReadStatus ReadStatus;
+	ReadStatus.reader = Reader;
+	ReadStatus.timestamp = Timestamp;
+	ReadStatus.channel_url = ChannelUrl;
+	ReadStatus.channel_type = SendbirdFake::CHANNEL_TYPE_GROUP;
+	return ReadStatus;
+}
+
+FSendbirdFakeServer& FSendbirdFakeServer::Get()
+{
+	static FSendbirdFakeServer Server;
+	return Server;
+}
+
+FSendbirdFakeServer::FSendbirdFakeServer()
+	: bStopping(false)
+	, CompletedTaskCount(0)
+{
+}
+
+//+ Worker
+void FSendbirdFakeServer::StartWorker()
+{
+	if (Thread != nullptr)
+		return;
+
+	{
+		FScopeLock ScopeLock(&Lock);
+		Random.Initialize(Config.RandomSeed);
+	}
+
+	bStopping = false;
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	Thread = FRunnableThread::Create(this, TEXT("SendbirdFakeBackend"));
+}
+
+void FSendbirdFakeServer::StopWorker()
+{
+	if (Thread == nullptr)
+		return;
+
+	Thread->Kill(true);
+	delete Thread;
+	Thread = nullptr;
+
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+
+	{
+		FScopeLock ScopeLock(&TaskLock);
+		Tasks.Empty();
+	}
+
+	FScopeLock ScopeLock(&Lock);
+	Clear();
+}
+
+void FSendbirdFakeServer::Post(std::function<void()> Work, double DelaySeconds)
+{
+	{
+		FScopeLock ScopeLock(&TaskLock);
+		Tasks.HeapPush({ FPlatformTime::Seconds() + FMath::Max(DelaySeconds, 0.0), ++TaskSequence, MoveTemp(Work) },
+			[](const FTask& A, const FTask& B) { return A.DueTime != B.DueTime ? A.DueTime < B.DueTime : A.Sequence < B.Sequence; });
+	}
+
+	if (WakeEvent != nullptr)
+		WakeEvent->Trigger();
+}
+
+void FSendbirdFakeServer::Request(std::function<void(SBDError*)> Work, bool bRequiresConnection)
+{
+	double Delay = 0.0;
+	bool bInjectError = false;
+	{
+		FScopeLock ScopeLock(&Lock);
+		Delay = NextLatencySeconds();
+		bInjectError = Config.ErrorRate > 0.0f && Random.FRand() < Config.ErrorRate;
+	}
+
+	Post([this, Work, bRequiresConnection, bInjectError]() {
+		bool bConnected = false;
+		{
+			FScopeLock ScopeLock(&Lock);
+			bConnected = IsConnected();
+		}
+
+		if (bRequiresConnection && !bConnected)
+		{
+			SBDError Error = FSBDError::Make(SBDErrorConnectionRequired, "Connection is required.");
+			Work(&Error);
+		}
+		else if (bInjectError)
+		{
+			SBDError Error = FSBDError::Make(SBDErrorNetworkError, "Simulated network error.");
+			Work(&Error);
+		}
+		else
+		{
+			Work(nullptr);
+		}
+	}, Delay);
+}
+
+void FSendbirdFakeServer::Reject(std::function<void(SBDError*)> Work, int64_t Code, const std::string& Message)
+{
+	Post([Work, Code, Message]() {
+		SBDError Error = FSBDError::Make(Code, Message);
+		Work(&Error);
+	});
+}
+
+int32 FSendbirdFakeServer::GetPendingTaskCount() const
+{
+	FScopeLock ScopeLock(&TaskLock);
+	return Tasks.Num();
+}
+
+uint32 FSendbirdFakeServer::Run()
+{
+	while (!bStopping)
+	{
+		std::function<void()> Work;
+		double WaitSeconds = FAKE_WORKER_IDLE_WAIT_SECONDS;
+		{
+			FScopeLock ScopeLock(&TaskLock);
+			if (Tasks.Num() > 0)
+			{
+				const double Now = FPlatformTime::Seconds();
+				if (Tasks.HeapTop().DueTime <= Now)
+				{
+					FTask Task;
+					Tasks.HeapPop(Task, [](const FTask& A, const FTask& B) { return A.DueTime != B.DueTime ? A.DueTime < B.DueTime : A.Sequence < B.Sequence; }, false);
+					Work = MoveTemp(Task.Work);
+				}
+				else
+				{
+					WaitSeconds = FMath::Min(Tasks.HeapTop().DueTime - Now, WaitSeconds);
+				}
+			}
+		}
+
+		if (Work)
+		{
+			Work();
+			++CompletedTaskCount;
+			continue;
+		}
+
+		WakeEvent->Wait(FTimespan::FromSeconds(WaitSeconds));
+	}
+	return 0;
+}
+
+void FSendbirdFakeServer::Stop()
+{
+	bStopping = true;
+	if (WakeEvent != nullptr)
+		WakeEvent->Trigger();
+}
+//- Worker
+
+//+ Handlers
+void FSendbirdFakeServer::BroadcastChannelEvent(const std::function<void(SBDChannelHandler*)>& Event)
+{
+	std::map<std::wstring, SBDChannelHandler*> Handlers;
+	{
+		FScopeLock ScopeLock(&Lock);
+		Handlers = ChannelHandlers;
+	}
+
+	for (const auto& Pair : Handlers)
+		Event(Pair.second);
+}
+
+void FSendbirdFakeServer::BroadcastConnectionEvent(const std::function<void(SBDConnectionHandler*)>& Event)
+{
+	std::map<std::wstring, SBDConnectionHandler*> Handlers;
+	{
+		FScopeLock ScopeLock(&Lock);
+		Handlers = ConnectionHandlers;
+	}
+
+	for (const auto& Pair : Handlers)
+		Event(Pair.second);
+}
+
+void FSendbirdFakeServer::BroadcastUnreadCountChanged()
+{
+	std::map<std::wstring, SBDUserEventHandler*> Handlers;
+	std::map<std::wstring, int> CountByCustomType;
+	int TotalCount = 0;
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (UserEventHandlers.empty())
+			return;
+
+		Handlers = UserEventHandlers;
+		TotalCount = GetTotalUnreadMessageCount(nullptr, &CountByCustomType);
+	}
+
+	for (const auto& Pair : Handlers)
+		Pair.second->TotalUnreadMessageCountChanged(TotalCount, CountByCustomType);
+}
+//- Handlers
+
+//+ State
+void FSendbirdFakeServer::Seed(const std::wstring& InApplicationId)
+{
+	if (bInitialized && ApplicationId == InApplicationId)
+		return;
+
+	Clear();
+	bInitialized = true;
+	ApplicationId = InApplicationId;
+
+	for (int32 Index = 0; Index < Config.SeedUsers; ++Index)
+	{
+		SBDUser* User = FindOrAddUser(SendbirdTranscode::ToWString(FString::Printf(TEXT("fake_user_%04d"), Index)));
+		User->nickname = SendbirdTranscode::ToWString(FString::Printf(TEXT("User %d"), Index));
+		User->connection_status = Random.FRand() < 0.3f ? SBDUserConnectionStatus::Online : SBDUserConnectionStatus::Offline;
+		User->last_seen_at = SendbirdFake::UnixTimeMs() - Random.RandRange(0, 86400) * 1000LL;
+	}
+
+	// Backdate the seeded history so live traffic always sorts after it.
+	const int32 SeedChannelCount = Config.SeedOpenChannels + Config.SeedGroupChannels;
+	int64_t SeedTime = SendbirdFake::UnixTimeMs() - (int64_t)FMath::Max(SeedChannelCount * Config.SeedMessagesPerChannel, 1) * 1000;
+
+	auto SeedMessages = [this, &SeedTime](FChannelRecord& Record, const std::vector<SBDUser*>& Senders) {
+		if (Senders.empty())
+			return;
+
+		for (int32 Index = 0; Index < Config.SeedMessagesPerChannel; ++Index)
+		{
+			const SBDUser* Sender = Senders[Random.RandRange(0, (int32)Senders.size() - 1)];
+			SBDUserMessage* Message = NewUserMessage(Record, *Sender, SEED_MESSAGES[Random.RandRange(0, (int32)UE_ARRAY_COUNT(SEED_MESSAGES) - 1)]);
+			SeedTime += Random.RandRange(1, 1000);
+			Message->created_at = SeedTime;
+			AddMessage(Record, Message);
+		}
+	};
+
+	std::vector<SBDUser*> AllUsers;
+	for (const std::unique_ptr<SBDUser>& User : Users)
+		AllUsers.push_back(User.get());
+
+	for (int32 Index = 0; Index < Config.SeedOpenChannels; ++Index)
+	{
+		SBDOpenChannel* Channel = AddOpenChannel(SendbirdTranscode::ToWString(FString::Printf(TEXT("sendbird_open_channel_fake_%d"), Index)),
+			SendbirdTranscode::ToWString(FString::Printf(TEXT("Open Channel %d"), Index)));
+		SeedMessages(Channels[Channel->channel_url], AllUsers);
+	}
+
+	for (int32 Index = 0; Index < Config.SeedGroupChannels; ++Index)
+	{
+		SBDGroupChannel* Channel = AddGroupChannel(SendbirdTranscode::ToWString(FString::Printf(TEXT("sendbird_group_channel_fake_%d"), Index)),
+			SendbirdTranscode::ToWString(FString::Printf(TEXT("Group Channel %d"), Index)));
+		Channel->is_public = (Index % 2) == 0;
+
+		std::vector<SBDUser*> Members;
+		for (int32 MemberIndex = 0; MemberIndex < Config.SeedMembersPerGroupChannel && !AllUsers.empty(); ++MemberIndex)
+		{
+			SBDUser* User = AllUsers[Random.RandRange(0, (int32)AllUsers.size() - 1)];
+			if (FindMember(Channel, User->user_id) == nullptr)
+			{
+				AddMember(Channel, *User, SBDMemberState::Joined);
+				Members.push_back(User);
+			}
+		}
+		SeedMessages(Channels[Channel->channel_url], Members);
+	}
+}
+
+void FSendbirdFakeServer::Clear()
+{
+	bInitialized = false;
+	ApplicationId.clear();
+	ConnectionState = SBDConnectionState::Closed;
+	CurrentUser = SBDUser();
+	bHasCurrentUser = false;
+	PendingPushToken.clear();
+
+	Users.clear();
+	UsersById.clear();
+	BlockedUserIds.clear();
+
+	Channels.clear();
+	OpenChannelUrls.clear();
+	GroupChannelUrls.clear();
+	MessagesById.clear();
+
+	// Only safe once nothing can reach the objects anymore, so handed-out pointers survive a re-Init().
+	if (Thread == nullptr)
+	{
+		OwnedOpenChannels.clear();
+		OwnedGroupChannels.clear();
+		OwnedMessages.clear();
+		OwnedMessageQueries.clear();
+		OwnedOpenChannelQueries.clear();
+		OwnedGroupChannelQueries.clear();
+		OwnedUserQueries.clear();
+		OwnedOperatorQueries.clear();
+	}
+}
+
+int64_t FSendbirdFakeServer::NextTimestamp()
+{
+	LastTimestamp = FMath::Max(SendbirdFake::UnixTimeMs(), LastTimestamp + 1);
+	return LastTimestamp;
+}
+
+std::wstring FSendbirdFakeServer::NextRequestId()
+{
+	return SendbirdTranscode::ToWString(FString::Printf(TEXT("fake_request_%llu"), (unsigned long long)++LastRequestId));
+}
+
+double FSendbirdFakeServer::NextLatencySeconds()
+{
+	const float JitterMs = Config.JitterMs > 0.0f ? Random.FRandRange(-Config.JitterMs, Config.JitterMs) : 0.0f;
+	return FMath::Max(Config.LatencyMs + JitterMs, 0.0f) / 1000.0;
+}
+
+SBDUser* FSendbirdFakeServer::FindUser(const std::wstring& UserId)
+{
+	auto It = UsersById.find(UserId);
+	return It != UsersById.end() ? It->second : nullptr;
+}
+
+SBDUser* FSendbirdFakeServer::FindOrAddUser(const std::wstring& UserId)
+{
+	if (SBDUser* User = FindUser(UserId))
+		return User;
+
+	SBDUser* User = new SBDUser();
+	User->user_id = UserId;
+	User->nickname = UserId;
+	User->connection_status = SBDUserConnectionStatus::Offline;
+	Users.emplace_back(User);
+	UsersById.emplace(UserId, User);
+	return User;
+}
+
+FSendbirdFakeServer::FChannelRecord* FSendbirdFakeServer::FindRecord(const std::wstring& ChannelUrl)
+{
+	auto It = Channels.find(ChannelUrl);
+	return It != Channels.end() ? &It->second : nullptr;
+}
+
+SBDOpenChannel* FSendbirdFakeServer::AddOpenChannel(const std::wstring& ChannelUrl, const std::wstring& Name)
+{
+	SBDOpenChannel* Channel = Own(FSBDOpenChannel::Create(), OwnedOpenChannels);
+	Channel->channel_url = ChannelUrl;
+	Channel->name = Name;
+	Channel->created_at = NextTimestamp() / 1000;
+
+	FChannelRecord& Record = Channels[ChannelUrl];
+	Record.Channel = Channel;
+	Record.bOpen = true;
+	OpenChannelUrls.push_back(ChannelUrl);
+	return Channel;
+}
+
+SBDGroupChannel* FSendbirdFakeServer::AddGroupChannel(const std::wstring& ChannelUrl, const std::wstring& Name)
+{
+	SBDGroupChannel* Channel = Own(FSBDGroupChannel::Create(), OwnedGroupChannels);
+	Channel->channel_url = ChannelUrl;
+	Channel->name = Name;
+	Channel->created_at = NextTimestamp() / 1000;
+
+	FChannelRecord& Record = Channels[ChannelUrl];
+	Record.Channel = Channel;
+	Record.bOpen = false;
+	GroupChannelUrls.push_back(ChannelUrl);
+	return Channel;
+}
+
+void FSendbirdFakeServer::RemoveChannel(const std::wstring& ChannelUrl)
+{
+	FChannelRecord* Record = FindRecord(ChannelUrl);
+	if (Record == nullptr)
+		return;
+
+	for (SBDBaseMessage* Message : Record->Messages)
+		MessagesById.erase(Message->message_id);
+
+	std::vector<std::wstring>& Urls = Record->bOpen ? OpenChannelUrls : GroupChannelUrls;
+	Urls.erase(std::remove(Urls.begin(), Urls.end(), ChannelUrl), Urls.end());
+	Channels.erase(ChannelUrl);
+}
+
+std::wstring FSendbirdFakeServer::MakeChannelUrl(bool bOpen)
+{
+	return SendbirdTranscode::ToWString(FString::Printf(TEXT("sendbird_%s_channel_fake_%llu_%08x"), bOpen ? TEXT("open") : TEXT("group"),
+		(unsigned long long)++LastChannelId, (uint32)Random.GetUnsignedInt()));
+}
+
+void FSendbirdFakeServer::AddMember(SBDGroupChannel* Channel, const SBDUser& User, SBDMemberState State)
+{
+	SBDMember* Member = FindMember(Channel, User.user_id);
+	if (Member == nullptr)
+	{
+		Channel->members.emplace_back();
+		Member = &Channel->members.back();
+	}
+
+	static_cast<SBDUser&>(*Member) = User;
+	Member->state = State;
+	Channel->member_count = Channel->members.size();
+
+	if (FChannelRecord* Record = FindRecord(Channel))
+		Record->ReadTimestamps[User.user_id] = NextTimestamp();
+}
+
+bool FSendbirdFakeServer::RemoveMember(SBDGroupChannel* Channel, const std::wstring& UserId)
+{
+	auto It = std::find_if(Channel->members.begin(), Channel->members.end(), [&UserId](const SBDMember& Member) { return Member.user_id == UserId; });
+	if (It == Channel->members.end())
+		return false;
+
+	Channel->members.erase(It);
+	Channel->member_count = Channel->members.size();
+
+	if (FChannelRecord* Record = FindRecord(Channel))
+		Record->ReadTimestamps.erase(UserId);
+	return true;
+}
+
+SBDMember* FSendbirdFakeServer::FindMember(SBDGroupChannel* Channel, const std::wstring& UserId)
+{
+	for (SBDMember& Member : Channel->members)
+	{
+		if (Member.user_id == UserId)
+			return &Member;
+	}
+	return nullptr;
+}
+
+void FSendbirdFakeServer::AddMessage(FChannelRecord& Record, SBDBaseMessage* Message)
+{
+	auto It = std::upper_bound(Record.Messages.begin(), Record.Messages.end(), Message,
+		[](const SBDBaseMessage* A, const SBDBaseMessage* B) { return A->created_at < B->created_at; });
+	Record.Messages.insert(It, Message);
+	MessagesById[Message->message_id] = Message;
+
+	if (!Record.bOpen)
+	{
+		SBDGroupChannel* Channel = static_cast<SBDGroupChannel*>(Record.Channel);
+		if (Record.Messages.back() == Message)
+			Channel->last_message_id = (int64_t)Message->message_id;
+	}
+}
+
+bool FSendbirdFakeServer::RemoveMessage(FChannelRecord& Record, uint64_t MessageId)
+{
+	auto It = std::find_if(Record.Messages.begin(), Record.Messages.end(), [MessageId](const SBDBaseMessage* Message) { return Message->message_id == MessageId; });
+	if (It == Record.Messages.end())
+		return false;
+
+	Record.Messages.erase(It);
+	MessagesById.erase(MessageId);
+
+	if (!Record.bOpen)
+	{
+		SBDGroupChannel* Channel = static_cast<SBDGroupChannel*>(Record.Channel);
+		Channel->last_message_id = Record.Messages.empty() ? 0 : (int64_t)Record.Messages.back()->message_id;
+	}
+	return true;
+}
+
+SBDBaseMessage* FSendbirdFakeServer::FindMessage(uint64_t MessageId)
+{
+	auto It = MessagesById.find(MessageId);
+	return It != MessagesById.end() ? It->second : nullptr;
+}
+
+SBDUserMessage* FSendbirdFakeServer::NewUserMessage(const FChannelRecord& Record, const SBDUser& Sender, const std::wstring& Text)
+{
+	SBDUserMessage* Message = static_cast<SBDUserMessage*>(Own<SBDBaseMessage>(FSBDUserMessage::Create(), OwnedMessages));
+	Message->message_type = SBDMessageType::User;
+	Message->message_id = NextMessageId();
+	Message->channel_url = Record.Channel->channel_url;
+	Message->channel_type = Record.bOpen ? SendbirdFake::CHANNEL_TYPE_OPEN : SendbirdFake::CHANNEL_TYPE_GROUP;
+	Message->created_at = NextTimestamp();
+	Message->sender = Sender;
+	Message->message = Text;
+	return Message;
+}
+
+SBDAdminMessage* FSendbirdFakeServer::NewAdminMessage(const FChannelRecord& Record, const std::wstring& Text)
+{
+	SBDAdminMessage* Message = static_cast<SBDAdminMessage*>(Own<SBDBaseMessage>(FSBDAdminMessage::Create(), OwnedMessages));
+	Message->message_type = SBDMessageType::Admin;
+	Message->message_id = NextMessageId();
+	Message->channel_url = Record.Channel->channel_url;
+	Message->channel_type = Record.bOpen ? SendbirdFake::CHANNEL_TYPE_OPEN : SendbirdFake::CHANNEL_TYPE_GROUP;
+	Message->created_at = NextTimestamp();
+	Message->message = Text;
+	return Message;
+}
+
+SBDFileMessage* FSendbirdFakeServer::NewFileMessage(const FChannelRecord& Record, const SBDUser& Sender, const std::wstring& Name, uint64_t Size, const std::wstring& Type)
+{
+	SBDFileMessage* Message = static_cast<SBDFileMessage*>(Own<SBDBaseMessage>(FSBDFileMessage::Create(), OwnedMessages));
+	Message->message_type = SBDMessageType::File;
+	Message->message_id = NextMessageId();
+	Message->channel_url = Record.Channel->channel_url;
+	Message->channel_type = Record.bOpen ? SendbirdFake::CHANNEL_TYPE_OPEN : SendbirdFake::CHANNEL_TYPE_GROUP;
+	Message->created_at = NextTimestamp();
+	Message->sender = Sender;
+	Message->name = Name;
+	Message->size = Size;
+	Message->type = Type;
+	Message->url = SendbirdTranscode::ToWString(FString::Printf(TEXT("https://file.fake.sendbird.com/%llu/%s"), (unsigned long long)Message->message_id, *SendbirdTranscode::ToFString(Name)));
+	return Message;
+}
+
+void FSendbirdFakeServer::CollectMessages(const FChannelRecord& Record, int64_t Pivot, bool bNext, bool bInclusive, int64_t Limit,
+	SBDMessageTypeFilter TypeFilter, const std::wstring& CustomType, std::vector<SBDBaseMessage*>& OutMessages) const
+{
+	auto Matches = [&Record, TypeFilter, &CustomType](const SBDBaseMessage* Message) {
+		if (Message->created_at < Record.HistoryResetAt)
+			return false;
+
+		switch (TypeFilter)
+		{
+		case SBDMessageTypeFilter::User:	if (Message->message_type != SBDMessageType::User) return false; break;
+		case SBDMessageTypeFilter::File:	if (Message->message_type != SBDMessageType::File) return false; break;
+		case SBDMessageTypeFilter::Admin:	if (Message->message_type != SBDMessageType::Admin) return false; break;
+		default:							break;
+		}
+
+		if (CustomType.empty() || IsNullWString(CustomType))
+			return true;
+
+		switch (Message->message_type)
+		{
+		case SBDMessageType::User:	return static_cast<const SBDUserMessage*>(Message)->custom_type == CustomType;
+		case SBDMessageType::File:	return static_cast<const SBDFileMessage*>(Message)->custom_type == CustomType;
+		default:					return static_cast<const SBDAdminMessage*>(Message)->custom_type == CustomType;
+		}
+	};
+
+	const std::vector<SBDBaseMessage*>& Messages = Record.Messages;
+	if (bNext)
+	{
+		auto It = std::lower_bound(Messages.begin(), Messages.end(), Pivot, [bInclusive](const SBDBaseMessage* Message, int64_t Time) {
+			return bInclusive ? Message->created_at < Time : Message->created_at <= Time;
+		});
+		for (; It != Messages.end() && (int64_t)OutMessages.size() < Limit; ++It)
+		{
+			if (Matches(*It))
+				OutMessages.push_back(*It);
+		}
+	}
+	else
+	{
+		auto It = std::lower_bound(Messages.begin(), Messages.end(), Pivot, [bInclusive](const SBDBaseMessage* Message, int64_t Time) {
+			return bInclusive ? Message->created_at <= Time : Message->created_at < Time;
+		});
+		while (It != Messages.begin() && (int64_t)OutMessages.size() < Limit)
+		{
+			--It;
+			if (Matches(*It))
+				OutMessages.push_back(*It);
+		}
+	}
+}
+
+void FSendbirdFakeServer::SortMessages(std::vector<SBDBaseMessage*>& Messages, bool bReverse)
+{
+	std::sort(Messages.begin(), Messages.end(), [bReverse](const SBDBaseMessage* A, const SBDBaseMessage* B) {
+		return bReverse ? A->created_at > B->created_at : A->created_at < B->created_at;
+	});
+}
+
+uint64_t FSendbirdFakeServer::IncreaseUnreadCount(const FChannelRecord& Record, const SBDBaseMessage* Message)
+{
+	if (Record.bOpen || !bHasCurrentUser)
+		return 0;
+
+	SBDGroupChannel* Channel = static_cast<SBDGroupChannel*>(Record.Channel);
+	if (FindMember(Channel, CurrentUser.user_id) == nullptr)
+		return Channel->unread_message_count;
+
+	if (Message->message_type == SBDMessageType::User && static_cast<const SBDUserMessage*>(Message)->sender.user_id == CurrentUser.user_id)
+		return Channel->unread_message_count;
+
+	return ++Channel->unread_message_count;
+}
+
+void FSendbirdFakeServer::MarkAsRead(FChannelRecord& Record, const std::wstring& UserId)
+{
+	if (Record.bOpen)
+		return;
+
+	Record.ReadTimestamps[UserId] = NextTimestamp();
+	if (bHasCurrentUser && UserId == CurrentUser.user_id)
+		static_cast<SBDGroupChannel*>(Record.Channel)->unread_message_count = 0;
+}
+
+int FSendbirdFakeServer::GetTotalUnreadMessageCount(const std::vector<std::wstring>* CustomTypes, std::map<std::wstring, int>* OutByCustomType)
+{
+	if (!bHasCurrentUser)
+		return 0;
+
+	int TotalCount = 0;
+	for (const std::wstring& ChannelUrl : GroupChannelUrls)
+	{
+		SBDGroupChannel* Channel = static_cast<SBDGroupChannel*>(Channels[ChannelUrl].Channel);
+		if (Channel->unread_message_count == 0 || FindMember(Channel, CurrentUser.user_id) == nullptr)
+			continue;
+
+		if (CustomTypes != nullptr && !CustomTypes->empty() && std::find(CustomTypes->begin(), CustomTypes->end(), Channel->custom_type) == CustomTypes->end())
+			continue;
+
+		TotalCount += (int)Channel->unread_message_count;
+		if (OutByCustomType != nullptr && !Channel->custom_type.empty())
+			(*OutByCustomType)[Channel->custom_type] += (int)Channel->unread_message_count;
+	}
+	return TotalCount;
+}
+//- State
+
+//+ FSendbirdFakeBackend
+FSendbirdFakeBackend& FSendbirdFakeBackend::Get()
+{
+	static FSendbirdFakeBackend Backend;
+	return Backend;
+}
+
+void FSendbirdFakeBackend::Startup()
+{
+	FSendbirdFakeServer::Get().StartWorker();
+}
+
+void FSendbirdFakeBackend::Shutdown()
+{
+	FSendbirdFakeServer::Get().StopWorker();
+}
+
+bool FSendbirdFakeBackend::IsRunning() const
+{
+	return FSendbirdFakeServer::Get().IsRunning();
+}
+
+void FSendbirdFakeBackend::SetConfig(const FConfig& InConfig)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+	Server.Config = InConfig;
+	Server.Random.Initialize(InConfig.RandomSeed);
+}
+
+FSendbirdFakeBackend::FConfig FSendbirdFakeBackend::GetConfig() const
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+	return Server.Config;
+}
+
+uint64 FSendbirdFakeBackend::SimulateMessageReceived(const std::wstring& ChannelUrl, const std::wstring& SenderId, const std::wstring& Text, float DelayMs)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+
+	SBDBaseChannel* Channel = nullptr;
+	SBDUserMessage* Message = nullptr;
+	bool bUnreadChanged = false;
+	{
+		FScopeLock ScopeLock(&Server.Lock);
+		FSendbirdFakeServer::FChannelRecord* Record = Server.FindRecord(ChannelUrl);
+		if (Record == nullptr)
+			return 0;
+
+		Channel = Record->Channel;
+		Message = Server.NewUserMessage(*Record, *Server.FindOrAddUser(SenderId), Text);
+		Server.AddMessage(*Record, Message);
+
+		const uint64_t UnreadCount = Channel->is_group_channel ? static_cast<SBDGroupChannel*>(Channel)->unread_message_count : 0;
+		bUnreadChanged = Server.IncreaseUnreadCount(*Record, Message) != UnreadCount;
+	}
+
+	Server.Post([&Server, Channel, Message, bUnreadChanged]() {
+		Server.BroadcastChannelEvent([Channel, Message](SBDChannelHandler* Handler) { Handler->MessageReceived(Channel, Message); });
+		if (bUnreadChanged)
+			Server.BroadcastUnreadCountChanged();
+	}, DelayMs / 1000.0);
+	return Message->message_id;
+}
+
+bool FSendbirdFakeBackend::SimulateMessageUpdated(const std::wstring& ChannelUrl, uint64 MessageId, const std::wstring& Text, float DelayMs)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	{
+		FScopeLock ScopeLock(&Server.Lock);
+		SBDBaseMessage* Message = Server.FindMessage(MessageId);
+		if (Message == nullptr || Message->channel_url != ChannelUrl || Message->message_type != SBDMessageType::User)
+			return false;
+	}
+
+	Server.Post([&Server, ChannelUrl, MessageId, Text]() {
+		SBDBaseChannel* Channel = nullptr;
+		SBDBaseMessage* Message = nullptr;
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+			FSendbirdFakeServer::FChannelRecord* Record = Server.FindRecord(ChannelUrl);
+			Message = Server.FindMessage(MessageId);
+			if (Record == nullptr || Message == nullptr)
+				return;
+
+			Channel = Record->Channel;
+			static_cast<SBDUserMessage*>(Message)->message = Text;
+			Message->updated_at = Server.NextTimestamp();
+		}
+		Server.BroadcastChannelEvent([Channel, Message](SBDChannelHandler* Handler) { Handler->MessageUpdated(Channel, Message); });
+	}, DelayMs / 1000.0);
+	return true;
+}
+
+bool FSendbirdFakeBackend::SimulateMessageDeleted(const std::wstring& ChannelUrl, uint64 MessageId, float DelayMs)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	{
+		FScopeLock ScopeLock(&Server.Lock);
+		SBDBaseMessage* Message = Server.FindMessage(MessageId);
+		if (Message == nullptr || Message->channel_url != ChannelUrl)
+			return false;
+	}
+
+	Server.Post([&Server, ChannelUrl, MessageId]() {
+		SBDBaseChannel* Channel = nullptr;
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+			FSendbirdFakeServer::FChannelRecord* Record = Server.FindRecord(ChannelUrl);
+			if (Record == nullptr || !Server.RemoveMessage(*Record, MessageId))
+				return;
+
+			Channel = Record->Channel;
+		}
+		Server.BroadcastChannelEvent([Channel, MessageId](SBDChannelHandler* Handler) { Handler->MessageDeleted(Channel, MessageId); });
+	}, DelayMs / 1000.0);
+	return true;
+}
+
+bool FSendbirdFakeBackend::SimulateUserJoined(const std::wstring& ChannelUrl, const std::wstring& UserId, float DelayMs)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	{
+		FScopeLock ScopeLock(&Server.Lock);
+		if (Server.FindRecord(ChannelUrl) == nullptr)
+			return false;
+	}
+
+	Server.Post([&Server, ChannelUrl, UserId]() {
+		SBDBaseChannel* Channel = nullptr;
+		SBDUser User;
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+			FSendbirdFakeServer::FChannelRecord* Record = Server.FindRecord(ChannelUrl);
+			if (Record == nullptr)
+				return;
+
+			Channel = Record->Channel;
+			User = *Server.FindOrAddUser(UserId);
+			if (Record->bOpen)
+			{
+				if (!Record->Participants.insert(UserId).second)
+					return;
+				static_cast<SBDOpenChannel*>(Channel)->participant_count = (int64_t)Record->Participants.size();
+			}
+			else
+			{
+				Server.AddMember(static_cast<SBDGroupChannel*>(Channel), User, SBDMemberState::Joined);
+			}
+		}
+
+		if (Channel->is_open_channel)
+			Server.BroadcastChannelEvent([Channel, &User](SBDChannelHandler* Handler) { Handler->UserEntered(static_cast<SBDOpenChannel*>(Channel), User); });
+		else
+			Server.BroadcastChannelEvent([Channel, &User](SBDChannelHandler* Handler) { Handler->UserJoined(static_cast<SBDGroupChannel*>(Channel), User); });
+	}, DelayMs / 1000.0);
+	return true;
+}
+
+bool FSendbirdFakeBackend::SimulateUserLeft(const std::wstring& ChannelUrl, const std::wstring& UserId, float DelayMs)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	{
+		FScopeLock ScopeLock(&Server.Lock);
+		if (Server.FindRecord(ChannelUrl) == nullptr)
+			return false;
+	}
+
+	Server.Post([&Server, ChannelUrl, UserId]() {
+		SBDBaseChannel* Channel = nullptr;
+		SBDUser User;
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+			FSendbirdFakeServer::FChannelRecord* Record = Server.FindRecord(ChannelUrl);
+			if (Record == nullptr)
+				return;
+
+			Channel = Record->Channel;
+			User = *Server.FindOrAddUser(UserId);
+			if (Record->bOpen)
+			{
+				if (Record->Participants.erase(UserId) == 0)
+					return;
+				static_cast<SBDOpenChannel*>(Channel)->participant_count = (int64_t)Record->Participants.size();
+			}
+			else if (!Server.RemoveMember(static_cast<SBDGroupChannel*>(Channel), UserId))
+			{
+				return;
+			}
+		}
+
+		if (Channel->is_open_channel)
+			Server.BroadcastChannelEvent([Channel, &User](SBDChannelHandler* Handler) { Handler->UserExited(static_cast<SBDOpenChannel*>(Channel), User); });
+		else
+			Server.BroadcastChannelEvent([Channel, &User](SBDChannelHandler* Handler) { Handler->UserLeft(static_cast<SBDGroupChannel*>(Channel), User); });
+	}, DelayMs / 1000.0);
+	return true;
+}
+
+void FSendbirdFakeBackend::SimulateConnectionLoss(bool bRecover, float DownTimeMs)
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	{
+		FScopeLock ScopeLock(&Server.Lock);
+		if (!Server.bHasCurrentUser)
+			return;
+
+		Server.ConnectionState = SBDConnectionState::Connecting;
+	}
+
+	Server.Post([&Server]() {
+		Server.BroadcastConnectionEvent([](SBDConnectionHandler* Handler) { Handler->Started(); });
+	});
+
+	Server.Post([&Server, bRecover]() {
+		{
+			FScopeLock ScopeLock(&Server.Lock);
+			Server.ConnectionState = bRecover ? SBDConnectionState::Open : SBDConnectionState::Closed;
+		}
+
+		if (bRecover)
+			Server.BroadcastConnectionEvent([](SBDConnectionHandler* Handler) { Handler->Succeeded(); });
+		else
+			Server.BroadcastConnectionEvent([](SBDConnectionHandler* Handler) { Handler->Failed(); });
+	}, DownTimeMs / 1000.0);
+}
+
+TArray<std::wstring> FSendbirdFakeBackend::GetChannelUrls(bool bOpenChannels) const
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+
+	const std::vector<std::wstring>& Urls = bOpenChannels ? Server.OpenChannelUrls : Server.GroupChannelUrls;
+	return TArray<std::wstring>(Urls.data(), (int32)Urls.size());
+}
+
+TArray<std::wstring> FSendbirdFakeBackend::GetUserIds() const
+{
+	FSendbirdFakeServer& Server = FSendbirdFakeServer::Get();
+	FScopeLock ScopeLock(&Server.Lock);
+
+	TArray<std::wstring> UserIds;
+	UserIds.Reserve((int32)Server.Users.size());
+	for (const std::unique_ptr<SBDUser>& User : Server.Users)
+		UserIds.Add(User->user_id);
+	return UserIds;
+}
+
+int32 FSendbirdFakeBackend::GetPendingTaskCount() const
+{
+	return FSendbirdFakeServer::Get().GetPendingTaskCount();
+}
+
+int64 FSendbirdFakeBackend::GetCompletedTaskCount() const
+{
+	return FSendbirdFakeServer::Get().GetCompletedTaskCount();
+}
+//- FSendbirdFakeBackend
+#endif
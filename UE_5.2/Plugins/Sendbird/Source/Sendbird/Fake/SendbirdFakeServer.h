@@ -0,0 +1,305 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if SENDBIRD_FAKE_BACKEND
+#include "HAL/Runnable.h"
+#include "Math/RandomStream.h"
+#include "../SendbirdFakeBackend.h"
+#include "../SendbirdTranscode.h"
+
+// The SDK headers carry no export macro. Modular builds on Linux/Mac hide symbols by default,
+// so the definitions below are re-exported to let other modules link against them.
+#if PLATFORM_LINUX || PLATFORM_MAC
+#pragma GCC visibility push(default)
+#endif
+#include "../include/Sendbird.h"
+#if PLATFORM_LINUX || PLATFORM_MAC
+#pragma GCC visibility pop
+#endif
+
+#include <atomic>
+#include <memory>
+#include <set>
+#include <unordered_map>
+
+//+ Builders
+// The SDK befriends these classes to construct its objects; the fake backend defines them to do the same.
+class FSBDError
+{
+public:
+	static SBDError Make(int64_t Code, const std::string& Message) { return SBDError(Message, Code); }
+};
+
+class FSBDUserMessage
+{
+public:
+	static SBDUserMessage* Create() { return new SBDUserMessage(std::string()); }
+};
+
+class FSBDAdminMessage
+{
+public:
+	static SBDAdminMessage* Create() { return new SBDAdminMessage(std::string()); }
+};
+
+class FSBDFileMessage
+{
+public:
+	static SBDFileMessage* Create() { return new SBDFileMessage(std::string()); }
+	static void SetRequireAuth(SBDFileMessage* Message, bool bRequireAuth) { Message->require_auth = bRequireAuth; }
+};
+
+class FSBDMessageMetaArray
+{
+public:
+	static SBDMessageMetaArray Make(const std::wstring& Key) { return SBDMessageMetaArray(Key); }
+	static SBDMessageMetaArray Make(const std::wstring& Key, const std::vector<std::wstring>& Value) { return SBDMessageMetaArray(Key, Value); }
+};
+
+class FSBDReadStatus
+{
+public:
+	static SBDReadStatus Make(const SBDUser& Reader, int64_t Timestamp, const std::wstring& ChannelUrl);
+};
+
+class FSBDOpenChannel
+{
+public:
+	static SBDOpenChannel* Create() { return new SBDOpenChannel(std::string()); }
+};
+
+class FSBDGroupChannel
+{
+public:
+	static SBDGroupChannel* Create() { return new SBDGroupChannel(std::string()); }
+};
+
+class FSBDPreviousMessageListQuery
+{
+public:
+	static SBDPreviousMessageListQuery* Create(SBDBaseChannel* Channel) { return new SBDPreviousMessageListQuery(Channel); }
+};
+
+class FSBDOpenChannelListQuery
+{
+public:
+	static SBDOpenChannelListQuery* Create() { return new SBDOpenChannelListQuery(); }
+};
+
+class FSBDGroupChannelListQuery
+{
+public:
+	static SBDGroupChannelListQuery* Create() { return new SBDGroupChannelListQuery(); }
+};
+
+class FSBDUserListQuery
+{
+public:
+	static SBDUserListQuery* Create(SBDUserListQueryType QueryType, SBDBaseChannel* Channel) { return new SBDUserListQuery(QueryType, Channel); }
+	static SBDUserListQuery* Create(const std::vector<std::wstring>& UserIds) { return new SBDUserListQuery(UserIds); }
+};
+
+// SBDUserMessageParams only exposes its fields to SBDCommand.
+class SBDCommand
+{
+public:
+	static const std::wstring& GetMessage(const SBDUserMessageParams& Params) { return Params.message; }
+	static const std::wstring& GetData(const SBDUserMessageParams& Params) { return Params.data; }
+	static const std::wstring& GetCustomType(const SBDUserMessageParams& Params) { return Params.custom_type; }
+	static SBDMentionType GetMentionType(const SBDUserMessageParams& Params) { return Params.mention_type; }
+	static const std::vector<std::wstring>& GetMentionedUserIds(const SBDUserMessageParams& Params) { return Params.mentioned_user_ids; }
+	static const std::vector<std::wstring>& GetMetaArrayKeys(const SBDUserMessageParams& Params) { return Params.metaarray_keys; }
+};
+//- Builders
+
+namespace SendbirdFake
+{
+	static const wchar_t* const CHANNEL_TYPE_OPEN = L"open";
+	static const wchar_t* const CHANNEL_TYPE_GROUP = L"group";
+
+	// Server error codes the fake reports besides the SDK's own SBDErrorCode values.
+	static constexpr int64_t ERROR_CHANNEL_NOT_FOUND	= 400201;
+	static constexpr int64_t ERROR_MESSAGE_NOT_FOUND	= 400301;
+	static constexpr int64_t ERROR_NOT_A_MEMBER			= 900020;
+	static constexpr int64_t ERROR_USER_MUTED			= 900041;
+	static constexpr int64_t ERROR_CHANNEL_FROZEN		= 900050;
+	static constexpr int64_t ERROR_USER_BANNED			= 900100;
+
+	int64_t UnixTimeMs();
+
+	// Holds an error produced on the server side for the duration of a completion call.
+	class FServerError
+	{
+	public:
+		FServerError() : Error(FSBDError::Make(SBDErrorNone, std::string())) {}
+		SBDError* Set(int64_t Code, const std::string& Message) { Error = FSBDError::Make(Code, Message); return &Error; }
+
+	private:
+		SBDError Error;
+	};
+
+	template<typename HandlerType, typename... ArgTypes>
+	void Complete(const HandlerType& Handler, ArgTypes&&... Args)
+	{
+		if (Handler)
+			Handler(Forward<ArgTypes>(Args)...);
+	}
+}
+
+// Server-side state of the fake backend. Everything below Lock is guarded by it; FCriticalSection is recursive.
+// Handler and completion callbacks always run on the worker thread and never while Lock is held.
+class FSendbirdFakeServer : public FRunnable
+{
+public:
+	struct FChannelRecord
+	{
+		SBDBaseChannel*							Channel = nullptr;
+		bool									bOpen = false;
+		std::vector<SBDBaseMessage*>			Messages;				// ordered by created_at
+		std::set<std::wstring>					Participants;			// open channels: users currently entered
+		std::set<std::wstring>					MutedUserIds;
+		std::set<std::wstring>					BannedUserIds;
+		std::set<std::wstring>					OperatorUserIds;
+		std::map<std::wstring, int64_t>			ReadTimestamps;			// group channels: user id -> last read
+		std::map<std::wstring, int64_t>			MetaCounters;
+		std::map<std::wstring, std::wstring>	MetaData;
+		int64_t									HistoryResetAt = 0;
+	};
+
+	static FSendbirdFakeServer& Get();
+
+	//+ Worker
+	void						StartWorker();
+	void						StopWorker();
+	bool						IsRunning() const { return Thread != nullptr; }
+
+	// Runs Work on the worker thread after DelaySeconds.
+	void						Post(std::function<void()> Work, double DelaySeconds = 0.0);
+	// Runs Work after a simulated round trip, with an error if the request cannot succeed.
+	void						Request(std::function<void(SBDError*)> Work, bool bRequiresConnection = true);
+	// Fails a request that the client side rejects before it reaches the server.
+	void						Reject(std::function<void(SBDError*)> Work, int64_t Code, const std::string& Message);
+
+	int32						GetPendingTaskCount() const;
+	int64						GetCompletedTaskCount() const { return CompletedTaskCount.load(); }
+
+	virtual uint32				Run() override;
+	virtual void				Stop() override;
+	//- Worker
+
+	//+ Handlers. Call these from the worker thread.
+	void						BroadcastChannelEvent(const std::function<void(SBDChannelHandler*)>& Event);
+	void						BroadcastConnectionEvent(const std::function<void(SBDConnectionHandler*)>& Event);
+	void						BroadcastUnreadCountChanged();
+	//- Handlers
+
+	//+ State. Lock must be held.
+	void						Seed(const std::wstring& ApplicationId);
+	void						Clear();
+	bool						IsConnected() const { return ConnectionState == SBDConnectionState::Open && bHasCurrentUser; }
+	int64_t						NextTimestamp();
+	uint64_t					NextMessageId() { return ++LastMessageId; }
+	std::wstring				NextRequestId();
+	double						NextLatencySeconds();
+
+	SBDUser*					FindUser(const std::wstring& UserId);
+	SBDUser*					FindOrAddUser(const std::wstring& UserId);
+
+	FChannelRecord*				FindRecord(const std::wstring& ChannelUrl);
+	FChannelRecord*				FindRecord(const SBDBaseChannel* Channel) { return Channel ? FindRecord(Channel->channel_url) : nullptr; }
+	SBDOpenChannel*				AddOpenChannel(const std::wstring& ChannelUrl, const std::wstring& Name);
+	SBDGroupChannel*			AddGroupChannel(const std::wstring& ChannelUrl, const std::wstring& Name);
+	void						RemoveChannel(const std::wstring& ChannelUrl);
+	std::wstring				MakeChannelUrl(bool bOpen);
+
+	void						AddMember(SBDGroupChannel* Channel, const SBDUser& User, SBDMemberState State);
+	bool						RemoveMember(SBDGroupChannel* Channel, const std::wstring& UserId);
+	static SBDMember*			FindMember(SBDGroupChannel* Channel, const std::wstring& UserId);
+
+	void						AddMessage(FChannelRecord& Record, SBDBaseMessage* Message);
+	bool						RemoveMessage(FChannelRecord& Record, uint64_t MessageId);
+	SBDBaseMessage*				FindMessage(uint64_t MessageId);
+	SBDUserMessage*				NewUserMessage(const FChannelRecord& Record, const SBDUser& Sender, const std::wstring& Text);
+	SBDAdminMessage*			NewAdminMessage(const FChannelRecord& Record, const std::wstring& Text);
+	SBDFileMessage*				NewFileMessage(const FChannelRecord& Record, const SBDUser& Sender, const std::wstring& Name, uint64_t Size, const std::wstring& Type);
+
+	// Messages of Record before (bNext = false) or after Pivot, nearest first, at most Limit, filtered like the SDK's message queries.
+	void						CollectMessages(const FChannelRecord& Record, int64_t Pivot, bool bNext, bool bInclusive, int64_t Limit,
+									SBDMessageTypeFilter TypeFilter, const std::wstring& CustomType, std::vector<SBDBaseMessage*>& OutMessages) const;
+	static void					SortMessages(std::vector<SBDBaseMessage*>& Messages, bool bReverse);
+
+	uint64_t					IncreaseUnreadCount(const FChannelRecord& Record, const SBDBaseMessage* Message);
+	void						MarkAsRead(FChannelRecord& Record, const std::wstring& UserId);
+	int							GetTotalUnreadMessageCount(const std::vector<std::wstring>* CustomTypes, std::map<std::wstring, int>* OutByCustomType = nullptr);
+	//- State
+
+	template<typename ObjectType>
+	ObjectType*					Own(ObjectType* Object, std::vector<std::unique_ptr<ObjectType>>& Owner)
+	{
+		Owner.emplace_back(Object);
+		return Object;
+	}
+
+public:
+	mutable FCriticalSection	Lock;
+	FSendbirdFakeBackend::FConfig	Config;
+	FRandomStream				Random;
+
+	bool						bInitialized = false;
+	std::wstring				ApplicationId;
+	SBDConnectionState			ConnectionState = SBDConnectionState::Closed;
+	SBDUser						CurrentUser;
+	bool						bHasCurrentUser = false;
+	bool						bAutoAcceptInvitation = true;
+	std::wstring				PendingPushToken;
+
+	std::map<std::wstring, SBDConnectionHandler*>	ConnectionHandlers;
+	std::map<std::wstring, SBDUserEventHandler*>	UserEventHandlers;
+	std::map<std::wstring, SBDChannelHandler*>		ChannelHandlers;
+
+	std::vector<std::unique_ptr<SBDUser>>			Users;					// registration order, stable addresses
+	std::unordered_map<std::wstring, SBDUser*>		UsersById;
+	std::set<std::wstring>							BlockedUserIds;
+
+	std::map<std::wstring, FChannelRecord>			Channels;
+	std::vector<std::wstring>						OpenChannelUrls;		// creation order
+	std::vector<std::wstring>						GroupChannelUrls;
+	std::unordered_map<uint64_t, SBDBaseMessage*>	MessagesById;
+
+	// Handed-out objects stay alive until StopWorker(), like the SDK's own caches.
+	std::vector<std::unique_ptr<SBDOpenChannel>>	OwnedOpenChannels;
+	std::vector<std::unique_ptr<SBDGroupChannel>>	OwnedGroupChannels;
+	std::vector<std::unique_ptr<SBDBaseMessage>>	OwnedMessages;
+	std::vector<std::unique_ptr<SBDPreviousMessageListQuery>>	OwnedMessageQueries;
+	std::vector<std::unique_ptr<SBDOpenChannelListQuery>>		OwnedOpenChannelQueries;
+	std::vector<std::unique_ptr<SBDGroupChannelListQuery>>		OwnedGroupChannelQueries;
+	std::vector<std::unique_ptr<SBDUserListQuery>>				OwnedUserQueries;
+	std::vector<std::unique_ptr<SBDOperatorListQuery>>			OwnedOperatorQueries;
+
+private:
+	FSendbirdFakeServer();
+
+	struct FTask
+	{
+		double					DueTime;
+		uint64					Sequence;
+		std::function<void()>	Work;
+	};
+
+	mutable FCriticalSection	TaskLock;
+	TArray<FTask>				Tasks;				// binary heap ordered by (DueTime, Sequence)
+	uint64						TaskSequence = 0;
+	FEvent*						WakeEvent = nullptr;
+	FRunnableThread*			Thread = nullptr;
+	std::atomic<bool>			bStopping;
+	std::atomic<int64>			CompletedTaskCount;
+
+	int64_t						LastTimestamp = 0;
+	uint64_t					LastMessageId = 0;
+	uint64_t					LastRequestId = 0;
+	uint64_t					LastChannelId = 0;
+};
+#endif
@@ -1,6 +1,7 @@
 // Copyright (c) 2021 Sendbird, Inc. All rights reserved.
 
 using UnrealBuildTool;
+using System;
 using System.IO;
 
 public class Sendbird : ModuleRules
@@ -24,7 +25,15 @@ public class Sendbird : ModuleRules
 
         bool isLibrarySupported = false;
 
-        if (Target.Platform == UnrealTargetPlatform.Android)
+        // SENDBIRD_FAKE_BACKEND=1 builds the in-process fake under Fake/ instead of linking the prebuilt SDK,
+        // e.g. for headless Linux runs where no SDK binary exists.
+        bool isFakeBackend = Environment.GetEnvironmentVariable("SENDBIRD_FAKE_BACKEND") == "1";
+
+        if (isFakeBackend)
+        {
+            isLibrarySupported = true;
+        }
+        else if (Target.Platform == UnrealTargetPlatform.Android)
         {
             string arm64_v8aPath = Path.Combine(ModuleDirectory, "lib", "android", "arm64-v8a", "libSendbirdChat.so");
             if (File.Exists(arm64_v8aPath))
@@ -94,5 +103,6 @@ public class Sendbird : ModuleRules
         }
 
         PublicDefinitions.Add(string.Format("WITH_SENDBIRD={0}", isLibrarySupported ? 1 : 0));
+        PublicDefinitions.Add(string.Format("SENDBIRD_FAKE_BACKEND={0}", isFakeBackend ? 1 : 0));
     }
 }
@@ -0,0 +1,67 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if SENDBIRD_FAKE_BACKEND
+#include <string>
+
+/**
+ * In-process stand-in for the Sendbird server, compiled instead of the prebuilt SDK when the module is built with
+ * SENDBIRD_FAKE_BACKEND=1. It implements the public API of Sendbird.h, so WITH_SENDBIRD code runs unchanged.
+ *
+ * Requests complete on the backend's worker thread after a simulated round trip (latency +/- jitter), the way the SDK
+ * completes them on its network thread. The Simulate*() calls inject server-side traffic from other users and are
+ * delivered to the registered SBDChannelHandlers on the same thread.
+ *
+ * Objects handed out (channels, messages, queries) are owned by the backend and stay valid until Shutdown().
+ */
+class SENDBIRD_API FSendbirdFakeBackend
+{
+public:
+	struct FConfig
+	{
+		float		LatencyMs = 40.0f;
+		float		JitterMs = 20.0f;
+		float		ErrorRate = 0.0f;
+		int32		RandomSeed = 0;
+
+		int32		SeedUsers = 200;
+		int32		SeedOpenChannels = 20;
+		int32		SeedGroupChannels = 20;
+		int32		SeedMembersPerGroupChannel = 8;
+		int32		SeedMessagesPerChannel = 200;
+	};
+
+	static FSendbirdFakeBackend& Get();
+
+	void			Startup();
+	void			Shutdown();
+	bool			IsRunning() const;
+
+	// Takes effect immediately for latency and errors; seed counts apply on the next Init().
+	void			SetConfig(const FConfig& InConfig);
+	FConfig			GetConfig() const;
+
+	//+ Server-side events, delivered to the channel handlers on the worker thread
+	uint64			SimulateMessageReceived(const std::wstring& ChannelUrl, const std::wstring& SenderId, const std::wstring& Text, float DelayMs = 0.0f);
+	bool			SimulateMessageUpdated(const std::wstring& ChannelUrl, uint64 MessageId, const std::wstring& Text, float DelayMs = 0.0f);
+	bool			SimulateMessageDeleted(const std::wstring& ChannelUrl, uint64 MessageId, float DelayMs = 0.0f);
+	// UserJoined/UserLeft for group channels, UserEntered/UserExited for open channels.
+	bool			SimulateUserJoined(const std::wstring& ChannelUrl, const std::wstring& UserId, float DelayMs = 0.0f);
+	bool			SimulateUserLeft(const std::wstring& ChannelUrl, const std::wstring& UserId, float DelayMs = 0.0f);
+	// Runs the connection handlers through Started and then Succeeded or Failed.
+	void			SimulateConnectionLoss(bool bRecover, float DownTimeMs = 1000.0f);
+	//- Server-side events
+
+	TArray<std::wstring>	GetChannelUrls(bool bOpenChannels) const;
+	TArray<std::wstring>	GetUserIds() const;
+
+	int32			GetPendingTaskCount() const;
+	int64			GetCompletedTaskCount() const;
+
+private:
+	FSendbirdFakeBackend() = default;
+};
+#endif
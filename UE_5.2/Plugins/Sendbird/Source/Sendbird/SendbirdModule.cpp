@@ -1,18 +1,25 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "SendbirdModule.h"
+#include "SendbirdFakeBackend.h"
 
 #define LOCTEXT_NAMESPACE "FSendbirdModule"
 
 void FSendbirdModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+#if SENDBIRD_FAKE_BACKEND
+	FSendbirdFakeBackend::Get().Startup();
+#endif
 }
 
 void FSendbirdModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+#if SENDBIRD_FAKE_BACKEND
+	FSendbirdFakeBackend::Get().Shutdown();
+#endif
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -2,19 +2,26 @@
 
 #include "SBChat.h"
 #include "Kismet/GameplayStatics.h"
+#include "Async/Async.h"
 #include "../SendbirdSample.h"
 #include "SBChatManager.h"
 #include "SBChatChannelEvent.h"
+#include "SBChatStats.h"
+#include "SBChatLatency.h"
+#include "SBChatMessageProjection.h"
+#include "SBChatThumbnail.h"
+#include "Sendbird/SendbirdTranscode.h"
 
 USBChat::USBChat(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
+	StartTime = FPlatformTime::Seconds();
 }
 
 //+ Common
 FString USBChat::GetSdkVersion() {
 #if WITH_SENDBIRD
-	return WCHAR_TO_TCHAR(SBDMain::GetSdkVersion().c_str());
+	return SendbirdTranscode::ToFString(SBDMain::GetSdkVersion());
 #else
 	return FString(TEXT(""));
 #endif
@@ -23,7 +30,7 @@ FString USBChat::GetSdkVersion() {
 bool USBChat::Init(const FString& AppID)
 {
 #if WITH_SENDBIRD
-	SBDMain::Init(TCHAR_TO_WCHAR(*AppID));
+	SBDMain::Init(SendbirdTranscode::ToWString(AppID));
 	if (!ensureMsgf(SBDMain::IsInitialized(), TEXT("[SBChatManager::Init()] SBDMain::Init() failed!!")))
 		return false;
 #endif
@@ -45,14 +52,31 @@ void USBChat::SetChannelEvent(UObject* InChannelEvent)
     }
 }
 
+void USBChat::SetEventDelivery(bool bBatched, float FrameBudgetMs)
+{
+	SBChatManager::Get().GetEventQueue().SetBatchDelivery(bBatched);
+	SBChatManager::Get().GetEventQueue().SetFrameBudget(FrameBudgetMs);
+}
+
+void USBChat::SetLocalEcho(bool bEnabled)
+{
+	SBChatManager::Get().GetOutbox().SetEchoEnabled(bEnabled);
+}
+
 USBChat* USBChat::Connect(const FString& UserID, const FString& AccessToken)
 {
-	USBChat* BlueprintAsyncAction = NewObject<USBChat>();
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("Connect"));
 #if WITH_SENDBIRD
 	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
 
-	SBDMain::Connect(TCHAR_TO_WCHAR(*UserID), TCHAR_TO_WCHAR(*AccessToken), [UserID, AccessToken, WeakSBChat](SBDUser* User, SBDError* Error) {
-		ProcessCompletionHandler(WeakSBChat, Error, [User]() {
+	SBDMain::Connect(SendbirdTranscode::ToWString(UserID), SendbirdTranscode::ToWString(AccessToken), [UserID, AccessToken, WeakSBChat](SBDUser* User, SBDError* Error) {
+		ProcessCompletionHandler(WeakSBChat, Error, [UserID]() {
+			SBChatManager::Get().GetMessageCache().Open(UserID);
+			SBChatManager::Get().GetOutbox().Start();
+			SBChatManager::Get().GetConnection().Start();
+			SBChatManager::Get().GetUnreadCounter().Start();
+			// Connecting again with channels still held only fetches what was missed meanwhile.
+			SBChatManager::Get().SyncChannels();
 		});
 	});
 #endif
@@ -61,7 +85,7 @@ USBChat* USBChat::Connect(const FString& UserID, const FString& AccessToken)
 
 USBChat* USBChat::Disconnect()
 {
-	USBChat* BlueprintAsyncAction = NewObject<USBChat>();
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("Disconnect"));
 #if WITH_SENDBIRD
 	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
 
@@ -78,6 +102,16 @@ void USBChat::Cleanup()
 {
 	SBChatManager::Get().Reset();
 }
+
+ESBConnectionState USBChat::GetConnectionState()
+{
+	return SBChatManager::Get().GetConnection().GetState();
+}
+
+void USBChat::ReconnectNow()
+{
+	SBChatManager::Get().GetConnection().ReconnectNow();
+}
 //- Common
 
 //+ User
@@ -95,12 +129,12 @@ void USBChat::GetCurrentUserInfo(FSBUserInfo& UserInfo, bool& bSucceeded)
 
 USBChat* USBChat::UpdateCurrentUserInfo(const FString& NickName, const FString& ProfileUrl)
 {
-	USBChat* BlueprintAsyncAction = NewObject<USBChat>();
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("UpdateCurrentUserInfo"));
 #if WITH_SENDBIRD
 	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
 
 	// In order to use the API, the option must be turned on in the dashboard.
-	SBDMain::UpdateCurrentUserInfo(TCHAR_TO_WCHAR(*NickName), TCHAR_TO_WCHAR(*ProfileUrl), [NickName, ProfileUrl, WeakSBChat](SBDError* Error) {
+	SBDMain::UpdateCurrentUserInfo(SendbirdTranscode::ToWString(NickName), SendbirdTranscode::ToWString(ProfileUrl), [NickName, ProfileUrl, WeakSBChat](SBDError* Error) {
 		ProcessCompletionHandler(WeakSBChat, Error, [NickName, ProfileUrl]() {
 		});
 	});
@@ -113,20 +147,89 @@ void USBChat::RegisterProfileTexture(UObject* WorldContextObject, const FString&
 	if (!ensure(ProfileTexture))
 		return;
 
-	SBChatManager::Get().GetCachedProfileTexture().Add(ProfileUrl, ProfileTexture);
+	SBChatManager::Get().GetProfileTextures().Add(ProfileUrl, ProfileTexture);
 }
 
 UTexture2DDynamic* USBChat::GetProfileTexture(UObject* WorldContextObject, const FString& ProfileUrl)
 {
-	if (SBChatManager::Get().GetCachedProfileTexture().Contains(ProfileUrl))
-		return SBChatManager::Get().GetCachedProfileTexture()[ProfileUrl];
+	return SBChatManager::Get().GetProfileTextures().Find(ProfileUrl);
+}
+
+USBChat* USBChat::LoadProfileTexture(UObject* WorldContextObject, const FString& ProfileUrl, UTexture2DDynamic*& ProfileTexture)
+{
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("LoadProfileTexture"));
+	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
+
+	TWeakObjectPtr<UWorld> WeakWorld = WorldContextObject->GetWorld();
+	ProfileTexture = nullptr;
+	SBChatManager::Get().GetProfileTextures().Load(ProfileUrl, [&ProfileTexture, WeakWorld, WeakSBChat](UTexture2DDynamic* Texture) {
+		if (!WeakWorld.IsValid() || !WeakSBChat.IsValid())
+			return;
+
+		ProfileTexture = Texture;
+
+		// A cached texture is handed back before the node's pins are bound, so the result always waits a tick.
+		WeakWorld->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateLambda([WeakSBChat, Texture]() {
+			if (!WeakSBChat.IsValid())
+				return;
+
+			if (Texture != nullptr)
+				WeakSBChat->OnSuccess.Broadcast(FString(TEXT("")), 0);
+			else
+				WeakSBChat->OnFail.Broadcast(TEXT("LoadProfileTexture() failed!!"), -1);
+		}));
+	});
+	return BlueprintAsyncAction;
+}
+
+void USBChat::SetProfileTextureCache(int64 BudgetBytes, bool bDiskCache)
+{
+	if (!ensureMsgf(BudgetBytes > 0, TEXT("[USBChat::SetProfileTextureCache] Wrong BudgetBytes(%lld)!!"), BudgetBytes))
+		return;
+
+	SBChatProfileTextureCache& ProfileTextures = SBChatManager::Get().GetProfileTextures();
+	ProfileTextures.SetMemoryBudget(BudgetBytes);
+	ProfileTextures.SetDiskCacheEnabled(bDiskCache);
+}
+
+void USBChat::SetProfileAtlasEnabled(bool bEnabled, int32 MaxPages)
+{
+	if (!ensureMsgf(MaxPages > 0, TEXT("[USBChat::SetProfileAtlasEnabled] Wrong MaxPages(%d)!!"), MaxPages))
+		return;
 
-	return nullptr;
+	SBChatAvatarAtlas& AvatarAtlas = SBChatManager::Get().GetAvatarAtlas();
+	AvatarAtlas.SetMaxPages(MaxPages);
+	AvatarAtlas.SetEnabled(bEnabled);
+}
+
+void USBChat::AcquireProfileAtlasSlot(const FString& ProfileUrl)
+{
+	SBChatAvatarAtlas& AvatarAtlas = SBChatManager::Get().GetAvatarAtlas();
+	if (AvatarAtlas.IsEnabled())
+		AvatarAtlas.Acquire(ProfileUrl);
+}
+
+void USBChat::ReleaseProfileAtlasSlot(const FString& ProfileUrl)
+{
+	SBChatManager::Get().GetAvatarAtlas().Release(ProfileUrl);
+}
+
+bool USBChat::GetProfileAtlasSlot(const FString& ProfileUrl, UTexture2DDynamic*& AtlasPage, FVector2D& UVMin, FVector2D& UVMax)
+{
+	AtlasPage = nullptr;
+	UVMin = FVector2D::ZeroVector;
+	UVMax = FVector2D::ZeroVector;
+	return SBChatManager::Get().GetAvatarAtlas().Find(ProfileUrl, AtlasPage, UVMin, UVMax);
+}
+
+int32 USBChat::GetProfileAtlasRevision()
+{
+	return (int32)SBChatManager::Get().GetAvatarAtlas().GetRevision();
 }
 
 USBChat* USBChat::GetAllUserList(UObject* WorldContextObject, bool bClearList, TArray<FSBUserInfo>& UserInfos)
 {
-	USBChat* BlueprintAsyncAction = NewObject<USBChat>();
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("GetAllUserList"));
 #if WITH_SENDBIRD
 	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
 	UWorld* World = WorldContextObject->GetWorld();
@@ -153,7 +256,7 @@ USBChat* USBChat::GetAllUserList(UObject* WorldContextObject, bool bClearList, T
 
 USBChat* USBChat::FindUser(UObject* WorldContextObject, const FString& UserID, FSBUserInfo& UserInfo)
 {
-	USBChat* BlueprintAsyncAction = NewObject<USBChat>();
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("FindUser"));
 #if WITH_SENDBIRD
 	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
 
@@ -167,7 +270,7 @@ USBChat* USBChat::FindUser(UObject* WorldContextObject, const FString& UserID, F
 		return BlueprintAsyncAction;
 	}
 
-	if (TCHAR_TO_WCHAR(*UserID) == SBDMain::GetCurrentUser()->user_id)
+	if (SendbirdTranscode::ToWString(UserID) == SBDMain::GetCurrentUser()->user_id)
 	{
 		World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateLambda([BlueprintAsyncAction]() {
 			BlueprintAsyncAction->OnFail.Broadcast(TEXT("You can't enter your ID."), -1);
@@ -176,7 +279,7 @@ USBChat* USBChat::FindUser(UObject* WorldContextObject, const FString& UserID, F
 	}
 
 	std::vector<std::wstring> UserIds;
-	UserIds.push_back(TCHAR_TO_WCHAR(*UserID));
+	UserIds.push_back(SendbirdTranscode::ToWString(UserID));
 
 	// In order to use the API, the option must be turned on in the dashboard.
 	SBDUserListQuery* UserListQuery = SBDMain::CreateUserListQuery(UserIds);
@@ -197,7 +300,8 @@ USBChat* USBChat::FindUser(UObject* WorldContextObject, const FString& UserID, F
 	}
 
 	UserListQuery->LoadNextPage([&UserInfo, World, WeakSBChat](std::vector<SBDUser> Users, SBDError* Error) {
-		if (Error == nullptr && Users.size() > 0 && SBChatManager::Get().IsInUserList(Users[0].user_id))
+		// AddFront() is both the membership test and the insert, so the list is looked up once.
+		if (Error == nullptr && Users.size() > 0 && !SBChatManager::Get().GetUserDirectory().AddFront(Users[0]))
 		{
 			AsyncTask(ENamedThreads::GameThread, [WeakSBChat]() {
 				if (WeakSBChat.IsValid())
@@ -207,11 +311,8 @@ USBChat* USBChat::FindUser(UObject* WorldContextObject, const FString& UserID, F
 		}
 
 		ProcessCompletionHandler(WeakSBChat, Error, [&UserInfo, &Users]() {
-			if (Users.size() > 0 && !SBChatManager::Get().IsInUserList(Users[0].user_id))
-			{
+			if (Users.size() > 0)
 				UserInfo = FSBUserInfo(Users[0]);
-				SBChatManager::Get().GetUserList().Insert(Users[0], 0);
-			}
 		});
 	});
 #endif
@@ -222,7 +323,7 @@ USBChat* USBChat::FindUser(UObject* WorldContextObject, const FString& UserID, F
 //+ OpenChannel
 USBChat* USBChat::CreateOpenChannel(const FString& Name, FSBChannelInfo& OpenChannelInfo)
 {
-	USBChat* BlueprintAsyncAction = NewObject<USBChat>();
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("CreateOpenChannel"));
 #if WITH_SENDBIRD
 	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
 
@@ -231,11 +332,11 @@ USBChat* USBChat::CreateOpenChannel(const FString& Name, FSBChannelInfo& OpenCha
 		user_ids.push_back(SBDMain::GetCurrentUser()->user_id);
 
 	// In order to use the API, the option must be turned on in the dashboard.
-	SBDOpenChannel::CreateChannel(TCHAR_TO_WCHAR(*Name), TCHAR_TO_WCHAR(TEXT("")), TCHAR_TO_WCHAR(TEXT("")), TCHAR_TO_WCHAR(TEXT("")), user_ids, TCHAR_TO_WCHAR(TEXT("")),
+	SBDOpenChannel::CreateChannel(SendbirdTranscode::ToWString(Name), L"", L"", L"", user_ids, L"",
 		[WeakSBChat, &OpenChannelInfo](SBDOpenChannel* OpenChannel, SBDError* Error) {
 		ProcessCompletionHandler(WeakSBChat, Error, [OpenChannel, &OpenChannelInfo]() {
+			SBChatManager::Get().GetChannels().Add(OpenChannel);
 			SBChatManager::Get().SetCurrentChannel(OpenChannel);
-			SBChatManager::Get().GetOpenChannels().Insert(OpenChannel, 0);
 			OpenChannelInfo = FSBChannelInfo(OpenChannel);
 		});
 	});
@@ -243,18 +344,18 @@ USBChat* USBChat::CreateOpenChannel(const FString& Name, FSBChannelInfo& OpenCha
 	return BlueprintAsyncAction;
 }
 
-USBChat* USBChat::UpdateOpenChannel(UObject* WorldContextObject, int Index, const FString& Name, const FString& NewName, FSBChannelInfo& ChannelInfo)
+USBChat* USBChat::UpdateOpenChannelByHandle(UObject* WorldContextObject, const FSBChannelHandle& Channel, const FString& NewName, FSBChannelInfo& ChannelInfo)
 {
-	USBChat* BlueprintAsyncAction = NewObject<USBChat>();
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("UpdateOpenChannel"));
 #if WITH_SENDBIRD
 	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
 
 	UWorld* World = WorldContextObject->GetWorld();
-	SBDOpenChannel* SelectedChannel = SBChatManager::Get().GetSelectedOpenChannel(Index, Name);
-	if (!ensureMsgf(SelectedChannel, TEXT("[USBChat::UpdateOpenChannel] GetSelectedOpenChannel(%d,%s) failed!!"), Index, *Name))
+	SBDOpenChannel* SelectedChannel = SBChatManager::Get().GetOpenChannel(Channel);
+	if (!ensureMsgf(SelectedChannel, TEXT("[USBChat::UpdateOpenChannelByHandle] GetOpenChannel(%s) failed!!"), *Channel.ChannelUrl))
 	{
 		World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateLambda([BlueprintAsyncAction]() {
-			BlueprintAsyncAction->OnFail.Broadcast(TEXT("GetSelectedOpenChannel() failed!!"), -1);
+			BlueprintAsyncAction->OnFail.Broadcast(TEXT("GetOpenChannel() failed!!"), -1);
 		}));
 		return BlueprintAsyncAction;
 	}
@@ -263,40 +364,38 @@ USBChat* USBChat::UpdateOpenChannel(UObject* WorldContextObject, int Index, cons
 	for (SBDUser& User : SelectedChannel->operators)
 		OperatorUserIds.push_back(User.user_id);
 
-	SelectedChannel->UpdateChannel(TCHAR_TO_WCHAR(*NewName), SelectedChannel->cover_url, SelectedChannel->data, OperatorUserIds, SelectedChannel->custom_type,
-		[SelectedChannel, Index, &ChannelInfo, WeakSBChat](SBDOpenChannel* OpenChannel, SBDError* Error) {
-		ProcessCompletionHandler(WeakSBChat, Error, [&ChannelInfo, Index, OpenChannel]() {
+	SelectedChannel->UpdateChannel(SendbirdTranscode::ToWString(NewName), SelectedChannel->cover_url, SelectedChannel->data, OperatorUserIds, SelectedChannel->custom_type,
+		[SelectedChannel, &ChannelInfo, WeakSBChat](SBDOpenChannel* OpenChannel, SBDError* Error) {
+		ProcessCompletionHandler(WeakSBChat, Error, [&ChannelInfo, OpenChannel]() {
 			ChannelInfo = FSBChannelInfo(OpenChannel);
+			SBChatManager::Get().GetChannels().Add(OpenChannel);
 			SBChatManager::Get().SetCurrentChannel(OpenChannel);
-
-			if (ensure(SBChatManager::Get().GetOpenChannels().IsValidIndex(Index)))
-				SBChatManager::Get().GetOpenChannels()[Index] = OpenChannel;
-
 		});
 	});
 #endif
 	return BlueprintAsyncAction;
 }
 
-USBChat* USBChat::DeleteOpenChannel(UObject* WorldContextObject, int Index, const FString& Name)
+USBChat* USBChat::DeleteOpenChannelByHandle(UObject* WorldContextObject, const FSBChannelHandle& Channel)
 {
-	USBChat* BlueprintAsyncAction = NewObject<USBChat>();
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("DeleteOpenChannel"));
 #if WITH_SENDBIRD
 	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
 
 	UWorld* World = WorldContextObject->GetWorld();
-	SBDOpenChannel* SelectedChannel = SBChatManager::Get().GetSelectedOpenChannel(Index, Name);
-	if (!ensureMsgf(SelectedChannel, TEXT("[USBChat::DeleteOpenChannel] GetSelectedOpenChannel(%d,%s) failed!!"), Index, *Name))
+	SBDOpenChannel* SelectedChannel = SBChatManager::Get().GetOpenChannel(Channel);
+	if (!ensureMsgf(SelectedChannel, TEXT("[USBChat::DeleteOpenChannelByHandle] GetOpenChannel(%s) failed!!"), *Channel.ChannelUrl))
 	{
 		World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateLambda([BlueprintAsyncAction]() {
-			BlueprintAsyncAction->OnFail.Broadcast(TEXT("GetSelectedOpenChannel() failed!!"), -1);
+			BlueprintAsyncAction->OnFail.Broadcast(TEXT("GetOpenChannel() failed!!"), -1);
 		}));
 		return BlueprintAsyncAction;
 	}
 
-	SelectedChannel->DeleteChannel([SelectedChannel, Index, WeakSBChat](SBDError* Error) {
-		ProcessCompletionHandler(WeakSBChat, Error, [Index]() {
-			SBChatManager::Get().GetOpenChannels().RemoveAt(Index);
+	const FString ChannelUrl = Channel.ChannelUrl;
+	SelectedChannel->DeleteChannel([SelectedChannel, ChannelUrl, WeakSBChat](SBDError* Error) {
+		ProcessCompletionHandler(WeakSBChat, Error, [ChannelUrl]() {
+			SBChatManager::Get().RemoveChannel(ChannelUrl);
 		});
 	});
 #endif
@@ -305,7 +404,7 @@ USBChat* USBChat::DeleteOpenChannel(UObject* WorldContextObject, int Index, cons
 
 USBChat* USBChat::GetOpenChannelList(UObject* WorldContextObject, bool bClearList, TArray<FSBChannelInfo>& OpenChannelInfos)
 {
-	USBChat* BlueprintAsyncAction = NewObject<USBChat>();
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("GetOpenChannelList"));
 #if WITH_SENDBIRD
 	UWorld* World = WorldContextObject->GetWorld();
 	if (bClearList)
@@ -330,7 +429,8 @@ USBChat* USBChat::GetOpenChannelList(UObject* WorldContextObject, bool bClearLis
 		return BlueprintAsyncAction;
 	}
 
-	if (!OpenChannelListQuery->has_next)
+	SBChatManager::FOpenChannelPaginator& OpenChannelPages = SBChatManager::Get().GetOpenChannelPages();
+	if (!OpenChannelPages.HasNext())
 	{
 		World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateLambda([BlueprintAsyncAction]() {
 			BlueprintAsyncAction->OnSuccess.Broadcast(FString(TEXT("")), 0);
@@ -338,13 +438,14 @@ USBChat* USBChat::GetOpenChannelList(UObject* WorldContextObject, bool bClearLis
 		return BlueprintAsyncAction;
 	}
 
+	// Served from the prefetched pages when they are there; the paginator keeps one request in flight at most.
 	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
-	OpenChannelListQuery->LoadNextPage([&OpenChannelInfos, WeakSBChat](std::vector<SBDOpenChannel*> OpenChannels, SBDError* Error) {
+	OpenChannelPages.Next(SBChatManager::CHANNEL_QUERY_LIST_LIMIT, [&OpenChannelInfos, WeakSBChat](const TArray<SBDOpenChannel*>& OpenChannels, SBDError* Error) {
 		ProcessCompletionHandler(WeakSBChat, Error, [&OpenChannelInfos, &OpenChannels]() {
 			OpenChannelInfos.Empty();
 			for (SBDOpenChannel* OpenChannel : OpenChannels)
 			{
-				SBChatManager::Get().GetOpenChannels().Add(OpenChannel);
+				SBChatManager::Get().GetChannels().Add(OpenChannel);
 				OpenChannelInfos.Add(FSBChannelInfo(OpenChannel));
 			}
 		});
@@ -355,7 +456,7 @@ USBChat* USBChat::GetOpenChannelList(UObject* WorldContextObject, bool bClearLis
 
 USBChat* USBChat::GetOpenChannelParticipantList(UObject* WorldContextObject, bool bClearList, TArray<FSBUserInfo>& UserList)
 {
-	USBChat* BlueprintAsyncAction = NewObject<USBChat>();
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("GetOpenChannelParticipantList"));
 #if WITH_SENDBIRD
 	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
 
@@ -389,7 +490,7 @@ USBChat* USBChat::GetOpenChannelParticipantList(UObject* WorldContextObject, boo
 			}));
 			return BlueprintAsyncAction;
 		}
-		SBChatManager::Get().ResetUserList();
+		SBChatManager::Get().ResetUserList(CurrentOpenChannel);
 	}
 
 	GetUserList(World, WeakSBChat, UserList);
@@ -397,23 +498,23 @@ USBChat* USBChat::GetOpenChannelParticipantList(UObject* WorldContextObject, boo
 	return BlueprintAsyncAction;
 }
 
-USBChat* USBChat::EnterOpenChannel(UObject* WorldContextObject, int Index, const FString& Name)
+USBChat* USBChat::EnterOpenChannelByHandle(UObject* WorldContextObject, const FSBChannelHandle& Channel)
 {
-	USBChat* BlueprintAsyncAction = NewObject<USBChat>();
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("EnterOpenChannel"));
 #if WITH_SENDBIRD
 	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
 
 	UWorld* World = WorldContextObject->GetWorld();
-	SBDOpenChannel* SelectedChannel = SBChatManager::Get().GetSelectedOpenChannel(Index, Name);
-	if (!ensureMsgf(SelectedChannel, TEXT("[USBChat::EnterOpenChannel] GetSelectedOpenChannel(%d,%s) failed!!"), Index, *Name))
+	SBDOpenChannel* SelectedChannel = SBChatManager::Get().GetOpenChannel(Channel);
+	if (!ensureMsgf(SelectedChannel, TEXT("[USBChat::EnterOpenChannelByHandle] GetOpenChannel(%s) failed!!"), *Channel.ChannelUrl))
 	{
 		World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateLambda([BlueprintAsyncAction]() {
-			BlueprintAsyncAction->OnFail.Broadcast(TEXT("GetSelectedOpenChannel() failed!!"), -1);
+			BlueprintAsyncAction->OnFail.Broadcast(TEXT("GetOpenChannel() failed!!"), -1);
 		}));
 		return BlueprintAsyncAction;
 	}
 
-	SelectedChannel->Enter([SelectedChannel, Name, WeakSBChat](SBDError* Error) {
+	SelectedChannel->Enter([SelectedChannel, WeakSBChat](SBDError* Error) {
 		ProcessCompletionHandler(WeakSBChat, Error, [SelectedChannel]() {
 			SBChatManager::Get().SetCurrentChannel(SelectedChannel);
 		});
@@ -424,7 +525,7 @@ USBChat* USBChat::EnterOpenChannel(UObject* WorldContextObject, int Index, const
 
 USBChat* USBChat::ExitOpenChannel(UObject* WorldContextObject)
 {
-	USBChat* BlueprintAsyncAction = NewObject<USBChat>();
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("ExitOpenChannel"));
 #if WITH_SENDBIRD
 	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
 
@@ -449,7 +550,7 @@ USBChat* USBChat::ExitOpenChannel(UObject* WorldContextObject)
 
 USBChat* USBChat::TryToExitOpenChannel(UObject* WorldContextObject)
 {
-	USBChat* BlueprintAsyncAction = NewObject<USBChat>();
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("TryToExitOpenChannel"));
 #if WITH_SENDBIRD
 	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
 
@@ -476,7 +577,7 @@ USBChat* USBChat::TryToExitOpenChannel(UObject* WorldContextObject)
 //+ GroupChannel
 USBChat* USBChat::CreateGroupChannel(const FString& Name, FSBChannelInfo& GroupChannelInfo)
 {
-	USBChat* BlueprintAsyncAction = NewObject<USBChat>();
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("CreateGroupChannel"));
 #if WITH_SENDBIRD
 	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
 	
@@ -485,10 +586,10 @@ USBChat* USBChat::CreateGroupChannel(const FString& Name, FSBChannelInfo& GroupC
 		user_ids.push_back(SBDMain::GetCurrentUser()->user_id);
 
 	// In order to use the API, the option must be turned on in the dashboard.
-	SBDGroupChannel::CreateChannel(user_ids, TCHAR_TO_WCHAR(*Name), false, TCHAR_TO_WCHAR(TEXT("")), TCHAR_TO_WCHAR(TEXT("")), TCHAR_TO_WCHAR(TEXT("")), [WeakSBChat, &GroupChannelInfo](SBDGroupChannel* GroupChannel, SBDError* Error) {
+	SBDGroupChannel::CreateChannel(user_ids, SendbirdTranscode::ToWString(Name), false, L"", L"", L"", [WeakSBChat, &GroupChannelInfo](SBDGroupChannel* GroupChannel, SBDError* Error) {
 		ProcessCompletionHandler(WeakSBChat, Error, [GroupChannel, &GroupChannelInfo]() {
+			SBChatManager::Get().GetChannels().Add(GroupChannel);
 			SBChatManager::Get().SetCurrentChannel(GroupChannel);
-			SBChatManager::Get().GetGroupChannels().Insert(GroupChannel, 0);
 			GroupChannelInfo = FSBChannelInfo(GroupChannel);
 		});
 	});
@@ -498,7 +599,7 @@ USBChat* USBChat::CreateGroupChannel(const FString& Name, FSBChannelInfo& GroupC
 
 USBChat* USBChat::CreateGroupChannelWithUserIds(UObject* WorldContextObject, const FString& ChannelName, const TArray<FString>& FriendIds)
 {
-	USBChat* BlueprintAsyncAction = NewObject<USBChat>();
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("CreateGroupChannelWithUserIds"));
 #if WITH_SENDBIRD
 	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
 	std::vector<std::wstring> user_ids;
@@ -506,11 +607,12 @@ USBChat* USBChat::CreateGroupChannelWithUserIds(UObject* WorldContextObject, con
 		user_ids.push_back(SBDMain::GetCurrentUser()->user_id);
 
 	for (const FString& UserId : FriendIds)
-		user_ids.push_back(TCHAR_TO_WCHAR(*UserId));
+		user_ids.push_back(SendbirdTranscode::ToWString(UserId));
 
 	// In order to use the API, the option must be turned on in the dashboard.
-	SBDGroupChannel::CreateChannel(user_ids, TCHAR_TO_WCHAR(*ChannelName), false, TCHAR_TO_WCHAR(TEXT("")), TCHAR_TO_WCHAR(TEXT("")), TCHAR_TO_WCHAR(TEXT("")), [WeakSBChat](SBDGroupChannel* GroupChannel, SBDError* Error) {
+	SBDGroupChannel::CreateChannel(user_ids, SendbirdTranscode::ToWString(ChannelName), false, L"", L"", L"", [WeakSBChat](SBDGroupChannel* GroupChannel, SBDError* Error) {
 		ProcessCompletionHandler(WeakSBChat, Error, [GroupChannel]() {
+			SBChatManager::Get().GetChannels().Add(GroupChannel);
 			SBChatManager::Get().SetCurrentChannel(GroupChannel);
 		});
 	});
@@ -518,68 +620,67 @@ USBChat* USBChat::CreateGroupChannelWithUserIds(UObject* WorldContextObject, con
 	return BlueprintAsyncAction;
 }
 
-USBChat* USBChat::UpdateGroupChannel(UObject* WorldContextObject, int Index, const FString& Name, const FString& NewName, FSBChannelInfo& ChannelInfo)
+USBChat* USBChat::UpdateGroupChannelByHandle(UObject* WorldContextObject, const FSBChannelHandle& Channel, const FString& NewName, FSBChannelInfo& ChannelInfo)
 {
-	USBChat* BlueprintAsyncAction = NewObject<USBChat>();
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("UpdateGroupChannel"));
 #if WITH_SENDBIRD
 	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
 
 	UWorld* World = WorldContextObject->GetWorld();
-	SBDGroupChannel* SelectedChannel = SBChatManager::Get().GetSelectedGroupChannel(Index, Name);
-	if (!ensureMsgf(SelectedChannel, TEXT("[USBChat::UpdateGroupChannel] GetSelectedGroupChannel(%d,%s) failed!!"), Index, *Name))
+	SBDGroupChannel* SelectedChannel = SBChatManager::Get().GetGroupChannel(Channel);
+	if (!ensureMsgf(SelectedChannel, TEXT("[USBChat::UpdateGroupChannelByHandle] GetGroupChannel(%s) failed!!"), *Channel.ChannelUrl))
 	{
 		World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateLambda([BlueprintAsyncAction]() {
-			BlueprintAsyncAction->OnFail.Broadcast(TEXT("GetSelectedGroupChannel() failed!!"), -1);
+			BlueprintAsyncAction->OnFail.Broadcast(TEXT("GetGroupChannel() failed!!"), -1);
 		}));
 		return BlueprintAsyncAction;
 	}
 
-	SelectedChannel->UpdateChannel(TCHAR_TO_WCHAR(*NewName), false, SelectedChannel->cover_url, SelectedChannel->data, SelectedChannel->custom_type,
-		[SelectedChannel, Index, WeakSBChat, &ChannelInfo](SBDGroupChannel* GroupChannel, SBDError* Error) {
-		ProcessCompletionHandler(WeakSBChat, Error, [Index, GroupChannel, &ChannelInfo]() {
+	SelectedChannel->UpdateChannel(SendbirdTranscode::ToWString(NewName), false, SelectedChannel->cover_url, SelectedChannel->data, SelectedChannel->custom_type,
+		[SelectedChannel, WeakSBChat, &ChannelInfo](SBDGroupChannel* GroupChannel, SBDError* Error) {
+		ProcessCompletionHandler(WeakSBChat, Error, [GroupChannel, &ChannelInfo]() {
+			SBChatManager::Get().GetChannels().Add(GroupChannel);
 			SBChatManager::Get().SetCurrentChannel(GroupChannel);
 			ChannelInfo = FSBChannelInfo(GroupChannel);
-			if (ensure(SBChatManager::Get().GetGroupChannels().IsValidIndex(Index)))
-				SBChatManager::Get().GetGroupChannels()[Index] = GroupChannel;
 		});
 	});
 #endif
 	return BlueprintAsyncAction;
 }
 
-USBChat* USBChat::DeleteGroupChannel(UObject* WorldContextObject, int Index, const FString& Name)
+USBChat* USBChat::DeleteGroupChannelByHandle(UObject* WorldContextObject, const FSBChannelHandle& Channel)
 {
-	USBChat* BlueprintAsyncAction = NewObject<USBChat>();
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("DeleteGroupChannel"));
 #if WITH_SENDBIRD
 	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
 
 	UWorld* World = WorldContextObject->GetWorld();
-	SBDGroupChannel* SelectedChannel = SBChatManager::Get().GetSelectedGroupChannel(Index, Name);
-	if (!ensureMsgf(SelectedChannel, TEXT("[USBChat::DeleteGroupChannel] GetSelectedGroupChannel(%d,%s) failed!!"), Index, *Name))
+	SBDGroupChannel* SelectedChannel = SBChatManager::Get().GetGroupChannel(Channel);
+	if (!ensureMsgf(SelectedChannel, TEXT("[USBChat::DeleteGroupChannelByHandle] GetGroupChannel(%s) failed!!"), *Channel.ChannelUrl))
 	{
 		World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateLambda([BlueprintAsyncAction]() {
-			BlueprintAsyncAction->OnFail.Broadcast(TEXT("GetSelectedGroupChannel() failed!!"), -1);
+			BlueprintAsyncAction->OnFail.Broadcast(TEXT("GetGroupChannel() failed!!"), -1);
 		}));
 		return BlueprintAsyncAction;
 	}
 
+	const FString ChannelUrl = Channel.ChannelUrl;
 	for (SBDMember& Member : SelectedChannel->members)
 	{
 		if (SBDMain::GetCurrentUser() != nullptr && Member.user_id == SBDMain::GetCurrentUser()->user_id)
 		{
-			SelectedChannel->LeaveChannel([Index, WeakSBChat](SBDError* Error) {
-				ProcessCompletionHandler(WeakSBChat, Error, [Index]() {
-					SBChatManager::Get().ResetCurrentChannel();
-					SBChatManager::Get().GetGroupChannels().RemoveAt(Index);
+			SelectedChannel->LeaveChannel([ChannelUrl, WeakSBChat](SBDError* Error) {
+				ProcessCompletionHandler(WeakSBChat, Error, [ChannelUrl]() {
+					SBChatManager::Get().RemoveChannel(ChannelUrl);
 				});
 			});
 			return BlueprintAsyncAction;
 		}
 	}
 
-	SelectedChannel->DeleteChannel([SelectedChannel, Index, WeakSBChat](SBDError* Error) {
-		ProcessCompletionHandler(WeakSBChat, Error, [Index]() {
-			SBChatManager::Get().GetGroupChannels().RemoveAt(Index);
+	SelectedChannel->DeleteChannel([SelectedChannel, ChannelUrl, WeakSBChat](SBDError* Error) {
+		ProcessCompletionHandler(WeakSBChat, Error, [ChannelUrl]() {
+			SBChatManager::Get().RemoveChannel(ChannelUrl);
 		});
 	});
 #endif
@@ -588,7 +689,7 @@ USBChat* USBChat::DeleteGroupChannel(UObject* WorldContextObject, int Index, con
 
 USBChat* USBChat::GetGroupChannelList(UObject* WorldContextObject, bool bClearList, TArray<struct FSBChannelInfo>& GroupChannelInfos)
 {
-	USBChat* BlueprintAsyncAction = NewObject<USBChat>();
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("GetGroupChannelList"));
 #if WITH_SENDBIRD
 	UWorld* World = WorldContextObject->GetWorld();
 	if (bClearList)
@@ -613,7 +714,8 @@ USBChat* USBChat::GetGroupChannelList(UObject* WorldContextObject, bool bClearLi
 		return BlueprintAsyncAction;
 	}
 
-	if (!GroupChannelListQuery->has_next)
+	SBChatManager::FGroupChannelPaginator& GroupChannelPages = SBChatManager::Get().GetGroupChannelPages();
+	if (!GroupChannelPages.HasNext())
 	{
 		World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateLambda([BlueprintAsyncAction]() {
 			BlueprintAsyncAction->OnSuccess.Broadcast(FString(TEXT("")), 0);
@@ -622,12 +724,13 @@ USBChat* USBChat::GetGroupChannelList(UObject* WorldContextObject, bool bClearLi
 	}
 
 	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
-	GroupChannelListQuery->LoadNextPage([&GroupChannelInfos, WeakSBChat](std::vector<SBDGroupChannel*> GroupChannels, SBDError* Error) {
+	GroupChannelPages.Next(SBChatManager::CHANNEL_QUERY_LIST_LIMIT, [&GroupChannelInfos, WeakSBChat](const TArray<SBDGroupChannel*>& GroupChannels, SBDError* Error) {
 		ProcessCompletionHandler(WeakSBChat, Error, [&GroupChannelInfos, &GroupChannels]() {
 			GroupChannelInfos.Empty();
 			for (SBDGroupChannel* GroupChannel : GroupChannels)
 			{
-				SBChatManager::Get().GetGroupChannels().Add(GroupChannel);
+				SBChatManager::Get().GetChannels().Add(GroupChannel);
+				SBChatManager::Get().GetUnreadCounter().Observe(GroupChannel);
 				GroupChannelInfos.Add(FSBChannelInfo(GroupChannel));
 			}
 		});
@@ -636,28 +739,29 @@ USBChat* USBChat::GetGroupChannelList(UObject* WorldContextObject, bool bClearLi
 	return BlueprintAsyncAction;
 }
 
-USBChat* USBChat::JoinGroupChannel(UObject* WorldContextObject, int Index, const FString& Name, TArray<FSBUserInfo>& Members)
+USBChat* USBChat::JoinGroupChannelByHandle(UObject* WorldContextObject, const FSBChannelHandle& Channel, TArray<FSBUserInfo>& Members)
 {
-	USBChat* BlueprintAsyncAction = NewObject<USBChat>();
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("JoinGroupChannel"));
 #if WITH_SENDBIRD
 	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
 
 	UWorld* World = WorldContextObject->GetWorld();
-	SBDGroupChannel* SelectedChannel = SBChatManager::Get().GetSelectedGroupChannel(Index, Name);
-	if (!ensureMsgf(SelectedChannel, TEXT("[USBChat::JoinGroupChannel] GetSelectedGroupChannel(%d,%s) failed!!"), Index, *Name))
+	SBDGroupChannel* SelectedChannel = SBChatManager::Get().GetGroupChannel(Channel);
+	if (!ensureMsgf(SelectedChannel, TEXT("[USBChat::JoinGroupChannelByHandle] GetGroupChannel(%s) failed!!"), *Channel.ChannelUrl))
 	{
 		World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateLambda([BlueprintAsyncAction]() {
-			BlueprintAsyncAction->OnFail.Broadcast(TEXT("GetSelectedGroupChannel() failed!!"), -1);
+			BlueprintAsyncAction->OnFail.Broadcast(TEXT("GetGroupChannel() failed!!"), -1);
 		}));
 		return BlueprintAsyncAction;
 	}
 
 	bool bAlreadyInclude = false;
+	SBChatManager::Get().ResetUserList(SelectedChannel);
+	Members.Reserve(Members.Num() + (int32)SelectedChannel->members.size());
 	for (SBDMember& Member : SelectedChannel->members)
 	{
-		SBChatManager::Get().ResetUserList();
 		const FSBUserInfo UesrInfo(Member);
-		SBChatManager::Get().GetUserList().Add(Member);
+		SBChatManager::Get().GetUserDirectory().Add(Member);
 		Members.Add(UesrInfo);
 		if (SBDMain::GetCurrentUser() != nullptr && Member.user_id == SBDMain::GetCurrentUser()->user_id)
 			bAlreadyInclude = true;
@@ -672,13 +776,13 @@ USBChat* USBChat::JoinGroupChannel(UObject* WorldContextObject, int Index, const
 		return BlueprintAsyncAction;
 	}
 
-	SelectedChannel->JoinChannel([SelectedChannel, Name, WeakSBChat, &Members](SBDError* Error) {
+	SelectedChannel->JoinChannel([SelectedChannel, WeakSBChat, &Members](SBDError* Error) {
 		ProcessCompletionHandler(WeakSBChat, Error, [SelectedChannel, &Members]() {
 			if (SBDMain::GetCurrentUser() != nullptr)
 			{
 				FSBUserInfo UserInfo(SBDMain::GetCurrentUser());
 				Members.Add(UserInfo);
-				SBChatManager::Get().GetUserList().Add(*SBDMain::GetCurrentUser());
+				SBChatManager::Get().GetUserDirectory().Add(*SBDMain::GetCurrentUser());
 			}
 			SBChatManager::Get().SetCurrentChannel(SelectedChannel);
 		});
@@ -690,7 +794,7 @@ USBChat* USBChat::JoinGroupChannel(UObject* WorldContextObject, int Index, const
 
 USBChat* USBChat::LeaveGroupChannel(UObject* WorldContextObject)
 {
-	USBChat* BlueprintAsyncAction = NewObject<USBChat>();
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("LeaveGroupChannel"));
 #if WITH_SENDBIRD
 	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
 
@@ -720,21 +824,159 @@ USBChat* USBChat::LeaveGroupChannel(UObject* WorldContextObject)
 		return BlueprintAsyncAction;
 	}
 
-	CurrentChannel->LeaveChannel([CurrentChannel, WeakSBChat](SBDError* Error) {
-		ProcessCompletionHandler(WeakSBChat, Error, [CurrentChannel]() {
+	const FString ChannelUrl = SendbirdTranscode::ToFString(CurrentChannel->channel_url);
+	CurrentChannel->LeaveChannel([ChannelUrl, WeakSBChat](SBDError* Error) {
+		ProcessCompletionHandler(WeakSBChat, Error, [ChannelUrl]() {
+			SBChatManager::Get().GetReadReceiptScheduler().RemoveChannel(ChannelUrl);
 			SBChatManager::Get().ResetCurrentChannel();
-			SBChatManager::Get().GetGroupChannels().Remove(CurrentChannel);
+			SBChatManager::Get().GetChannels().Remove(ChannelUrl);
 		});
 	});
 #endif
 	return BlueprintAsyncAction;
 }
+
+void USBChat::GetRecentGroupChannels(int MaxCount, TArray<FSBChannelInfo>& GroupChannelInfos)
+{
+	TArray<SBDBaseChannel*> Channels;
+	SBChatManager::Get().GetChannels().GetRecent(true, MaxCount, Channels);
+
+	GroupChannelInfos.Reset(Channels.Num());
+	for (SBDBaseChannel* Channel : Channels)
+		GroupChannelInfos.Add(FSBChannelInfo(Channel));
+}
 //- GroupChannel
 
+//+ Subscription
+USBChat* USBChat::SubscribeChannel(UObject* WorldContextObject, const FSBChannelHandle& Channel)
+{
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("SubscribeChannel"));
+#if WITH_SENDBIRD
+	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
+
+	UWorld* World = WorldContextObject->GetWorld();
+	SBDBaseChannel* SelectedChannel = SBChatManager::Get().GetChannels().Find(Channel.ChannelUrl);
+	if (!ensureMsgf(SelectedChannel, TEXT("[USBChat::SubscribeChannel] Find(%s) failed!!"), *Channel.ChannelUrl))
+	{
+		World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateLambda([BlueprintAsyncAction]() {
+			BlueprintAsyncAction->OnFail.Broadcast(TEXT("Find() failed!!"), -1);
+		}));
+		return BlueprintAsyncAction;
+	}
+
+	SBChatSubscriptions::FState* State = SBChatManager::Get().SubscribeChannel(SelectedChannel);
+	if (State == nullptr)
+	{
+		World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateLambda([BlueprintAsyncAction]() {
+			BlueprintAsyncAction->OnFail.Broadcast(TEXT("Too many subscribed channels."), -1);
+		}));
+		return BlueprintAsyncAction;
+	}
+
+	if (State->bHistoryLoaded)
+	{
+		World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateLambda([BlueprintAsyncAction]() {
+			BlueprintAsyncAction->OnSuccess.Broadcast(TEXT(""), 0);
+		}));
+		return BlueprintAsyncAction;
+	}
+
+	// Open channels only deliver events to participants.
+	if (SelectedChannel->is_open_channel && SelectedChannel != SBChatManager::Get().GetCurrentChannel())
+	{
+		SBDOpenChannel* OpenChannel = static_cast<SBDOpenChannel*>(SelectedChannel);
+		OpenChannel->Enter([SelectedChannel, WeakSBChat](SBDError* Error) {
+			if (Error != nullptr)
+			{
+				SBChatManager::Get().UnsubscribeChannel(SendbirdTranscode::ToFString(SelectedChannel->channel_url));
+				ProcessCompletionHandler(WeakSBChat, Error, []() {});
+				return;
+			}
+			LoadSubscribedHistory(WeakSBChat, SelectedChannel);
+		});
+		return BlueprintAsyncAction;
+	}
+
+	LoadSubscribedHistory(WeakSBChat, SelectedChannel);
+#endif
+	return BlueprintAsyncAction;
+}
+
+void USBChat::UnsubscribeChannel(const FSBChannelHandle& Channel)
+{
+#if WITH_SENDBIRD
+	SBChatSubscriptions::FState* State = SBChatManager::Get().GetSubscriptions().Find(Channel.ChannelUrl);
+	if (State == nullptr)
+		return;
+
+	SBDBaseChannel* SubscribedChannel = State->Channel;
+	SBChatManager::Get().UnsubscribeChannel(Channel.ChannelUrl);
+	if (SubscribedChannel->is_open_channel && SubscribedChannel != SBChatManager::Get().GetCurrentChannel())
+		static_cast<SBDOpenChannel*>(SubscribedChannel)->Exit([](SBDError* Error) {});
+#endif
+}
+
+USBChat* USBChat::FocusChannel(UObject* WorldContextObject, const FSBChannelHandle& Channel, TArray<FSBMessageInfo>& MessageInfos, TArray<FSBUserInfo>& Members)
+{
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("FocusChannel"));
+#if WITH_SENDBIRD
+	UWorld* World = WorldContextObject->GetWorld();
+	SBChatSubscriptions::FState* State = SBChatManager::Get().GetSubscriptions().Find(Channel.ChannelUrl);
+	if (!ensureMsgf(State && State->bHistoryLoaded, TEXT("[USBChat::FocusChannel] Channel(%s) is not subscribed!!"), *Channel.ChannelUrl))
+	{
+		World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateLambda([BlueprintAsyncAction]() {
+			BlueprintAsyncAction->OnFail.Broadcast(TEXT("The channel is not subscribed."), -1);
+		}));
+		return BlueprintAsyncAction;
+	}
+
+	SBChatManager::Get().SetCurrentChannel(State->Channel);
+	if (State->Channel->is_group_channel)
+		SBChatManager::Get().GetReadReceiptScheduler().RequestMarkAsRead(static_cast<SBDGroupChannel*>(State->Channel));
+
+	MessageInfos.Reset(State->History.Num());
+	State->History.ForEach([&MessageInfos](SBDBaseMessage* Message) {
+		SBChatMessageProjection::ProjectInto(Message, MessageInfos);
+	});
+	SBChatManager::Get().GetOutbox().GetPending(Channel.ChannelUrl, MessageInfos);
+
+	TArray<SBDUser> Users;
+	State->Members.GetUsers(Users);
+	Members.Reset(Users.Num());
+	for (const SBDUser& User : Users)
+		Members.Add(FSBUserInfo(User));
+
+	World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateLambda([BlueprintAsyncAction]() {
+		BlueprintAsyncAction->OnSuccess.Broadcast(TEXT(""), 0);
+	}));
+#endif
+	return BlueprintAsyncAction;
+}
+
+void USBChat::GetSubscribedChannels(TArray<FSBChannelInfo>& ChannelInfos)
+{
+	ChannelInfos.Reset(SBChatManager::Get().GetSubscriptions().Num());
+	SBChatManager::Get().GetSubscriptions().ForEach([&ChannelInfos](const SBChatSubscriptions::FState& State) {
+		FSBChannelInfo& ChannelInfo = ChannelInfos.Add_GetRef(FSBChannelInfo(State.Channel));
+		ChannelInfo.UnreadMessageCount = State.UnreadCount;
+	});
+}
+
+void USBChat::GetUnreadCounts(FSBUnreadCounts& Counts)
+{
+	SBChatManager::Get().GetUnreadCounter().GetCounts(Counts);
+}
+
+int32 USBChat::GetChannelUnreadCount(const FSBChannelHandle& Channel)
+{
+	return SBChatManager::Get().GetUnreadCounter().GetChannelCount(Channel.ChannelUrl);
+}
+//- Subscription
+
 //+ Message
 USBChat* USBChat::SendUserMessage(UObject* WorldContextObject, const FString& SendMessage, FSBMessageInfo& MessageInfo)
 {
-	USBChat* BlueprintAsyncAction = NewObject<USBChat>();
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("SendUserMessage"));
 #if WITH_SENDBIRD
 	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
 
@@ -748,26 +990,142 @@ USBChat* USBChat::SendUserMessage(UObject* WorldContextObject, const FString& Se
 		return BlueprintAsyncAction;
 	}
 
-	SBDUserMessageParams Params;
-	Params.SetMessage(TCHAR_TO_WCHAR(*SendMessage));
-	CurrentChannel->SendUserMessage(Params, [WeakSBChat, &MessageInfo](SBDUserMessage* UserMessage, SBDError* Error) {
-		ProcessCompletionHandler(WeakSBChat, Error, [&MessageInfo, &UserMessage]() {
-			SBDBaseChannel* CurrentChannel = SBChatManager::Get().GetCurrentChannel();
-			if (CurrentChannel && CurrentChannel->is_group_channel)
-			{
-				SBDGroupChannel* GroupChannel = static_cast<SBDGroupChannel*>(CurrentChannel);
-				GroupChannel->MarkAsRead();
-			}
-			MessageInfo = SBChatManager::Get().AddHistoryMessage(UserMessage);
+	// Queued in the outbox, which retries across reconnections; the action completes once the server has the message.
+	SBChatManager::Get().GetOutbox().Send(CurrentChannel, SendMessage, [WeakSBChat, &MessageInfo](SBDUserMessage* UserMessage, SBDError* Error) {
+		if (UserMessage == nullptr && Error == nullptr)
+		{
+			AsyncTask(ENamedThreads::GameThread, [WeakSBChat]() {
+				if (WeakSBChat.IsValid())
+					WeakSBChat->OnFail.Broadcast(TEXT("Dropped by the send limiter!!"), -1);
+			});
+			return;
+		}
+
+		ProcessCompletionHandler(WeakSBChat, Error, [&MessageInfo, UserMessage]() {
+			MessageInfo = SBChatManager::Get().ToMessageInfo(UserMessage);
+		});
+	});
+#endif
+	return BlueprintAsyncAction;
+}
+
+USBChat* USBChat::SendFileMessage(UObject* WorldContextObject, const FString& FilePath, const FString& MimeType, int32& UploadID, FSBMessageInfo& MessageInfo)
+{
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("SendFileMessage"));
+#if WITH_SENDBIRD
+	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
+
+	UWorld* World = WorldContextObject->GetWorld();
+	UploadID = INDEX_NONE;
+	SBDBaseChannel* CurrentChannel = SBChatManager::Get().GetCurrentChannel();
+	if (!ensureMsgf(CurrentChannel, TEXT("[USBChat::SendFileMessage] Wrong CurrentChannel!!")))
+	{
+		World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateLambda([BlueprintAsyncAction]() {
+			BlueprintAsyncAction->OnFail.Broadcast(TEXT("Wrong CurrentChannel!!"), -1);
+		}));
+		return BlueprintAsyncAction;
+	}
+
+	UploadID = SBChatManager::Get().GetFileUploader().Upload(CurrentChannel, FilePath, MimeType,
+		[](int32 ID, ESBFileUploadState State, int64 BytesSent, int64 TotalBytes) {
+		TWeakObjectPtr<UObject> ChannelEvent = SBChatManager::Get().GetChannelEvent();
+		if (ChannelEvent.IsValid() && ensure(ChannelEvent->GetClass()->ImplementsInterface(USBChatChannelEvent::StaticClass())))
+			ISBChatChannelEvent::Execute_OnFileUploadProgress(ChannelEvent.Get(), ID, State, BytesSent, TotalBytes);
+	},
+		[WeakSBChat, &MessageInfo](ESBFileUploadState State, SBDFileMessage* FileMessage, SBDError* Error) {
+		if (State == ESBFileUploadState::Succeeded || Error != nullptr)
+		{
+			ProcessCompletionHandler(WeakSBChat, Error, [&MessageInfo, FileMessage]() {
+				MessageInfo = SBChatManager::Get().ToMessageInfo(FileMessage);
+			});
+			return;
+		}
+
+		const TCHAR* Reason = State == ESBFileUploadState::Cancelled ? TEXT("Cancelled!!") : TEXT("Can't read the file!!");
+		AsyncTask(ENamedThreads::GameThread, [WeakSBChat, Reason]() {
+			if (WeakSBChat.IsValid())
+				WeakSBChat->OnFail.Broadcast(Reason, -1);
 		});
 	});
 #endif
 	return BlueprintAsyncAction;
 }
 
+bool USBChat::CancelFileUpload(int32 UploadID)
+{
+	return SBChatManager::Get().GetFileUploader().Cancel(UploadID);
+}
+
+void USBChat::SetMaxConcurrentUploads(int32 MaxConcurrent)
+{
+	if (!ensureMsgf(MaxConcurrent > 0, TEXT("[USBChat::SetMaxConcurrentUploads] Wrong MaxConcurrent(%d)!!"), MaxConcurrent))
+		return;
+
+	SBChatManager::Get().GetFileUploader().SetMaxConcurrent(MaxConcurrent);
+}
+
+void USBChat::SetThumbnailSizes(const TArray<FIntPoint>& Sizes)
+{
+	for (const FIntPoint& Size : Sizes)
+	{
+		if (!ensureMsgf(Size.X > 0 && Size.Y > 0, TEXT("[USBChat::SetThumbnailSizes] Wrong Size(%d x %d)!!"), Size.X, Size.Y))
+			return;
+	}
+
+	SBChatManager::Get().GetFileUploader().SetThumbnailSizes(Sizes);
+}
+
+USBChat* USBChat::LoadFileThumbnail(UObject* WorldContextObject, const FSBFileInfo& FileInfo, int32 Width, int32 Height, UTexture2DDynamic*& Thumbnail)
+{
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("LoadFileThumbnail"));
+	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
+
+	TWeakObjectPtr<UWorld> WeakWorld = WorldContextObject->GetWorld();
+	Thumbnail = nullptr;
+
+	const FSBThumbnailInfo* Best = SBChatThumbnail::PickBest(FileInfo, Width, Height);
+	if (Best == nullptr)
+	{
+		WeakWorld->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateLambda([WeakSBChat]() {
+			if (WeakSBChat.IsValid())
+				WeakSBChat->OnFail.Broadcast(TEXT("No thumbnail!!"), -1);
+		}));
+		return BlueprintAsyncAction;
+	}
+
+	SBChatManager::Get().GetThumbnailTextures().Load(Best->Url, [&Thumbnail, WeakWorld, WeakSBChat](UTexture2DDynamic* Texture) {
+		if (!WeakWorld.IsValid() || !WeakSBChat.IsValid())
+			return;
+
+		Thumbnail = Texture;
+
+		// Like LoadProfileTexture, the result always waits a tick so a cached texture reaches bound pins.
+		WeakWorld->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateLambda([WeakSBChat, Texture]() {
+			if (!WeakSBChat.IsValid())
+				return;
+
+			if (Texture != nullptr)
+				WeakSBChat->OnSuccess.Broadcast(FString(TEXT("")), 0);
+			else
+				WeakSBChat->OnFail.Broadcast(TEXT("LoadFileThumbnail() failed!!"), -1);
+		}));
+	});
+	return BlueprintAsyncAction;
+}
+
+void USBChat::SetThumbnailTextureCache(int64 BudgetBytes, bool bDiskCache)
+{
+	if (!ensureMsgf(BudgetBytes > 0, TEXT("[USBChat::SetThumbnailTextureCache] Wrong BudgetBytes(%lld)!!"), BudgetBytes))
+		return;
+
+	SBChatProfileTextureCache& ThumbnailTextures = SBChatManager::Get().GetThumbnailTextures();
+	ThumbnailTextures.SetMemoryBudget(BudgetBytes);
+	ThumbnailTextures.SetDiskCacheEnabled(bDiskCache);
+}
+
 USBChat* USBChat::UpdateUserMessage(UObject* WorldContextObject, int64 MessageID, const FString& NewMessage, FSBMessageInfo& MessageInfo)
 {
-	USBChat* BlueprintAsyncAction = NewObject<USBChat>();
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("UpdateUserMessage"));
 #if WITH_SENDBIRD
 	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
 
@@ -791,9 +1149,12 @@ USBChat* USBChat::UpdateUserMessage(UObject* WorldContextObject, int64 MessageID
 	}
 
 	SBDUserMessage* UserMessage = static_cast<SBDUserMessage*>(Message);
-	CurrentChannel->UpdateUserMessage(UserMessage, TCHAR_TO_WCHAR(*NewMessage), UserMessage->data, UserMessage->custom_type, [&MessageInfo, WeakSBChat](SBDUserMessage* NewUserMessage, SBDError* Error) {
+	CurrentChannel->UpdateUserMessage(UserMessage, SendbirdTranscode::ToWString(NewMessage), UserMessage->data, UserMessage->custom_type, [&MessageInfo, WeakSBChat](SBDUserMessage* NewUserMessage, SBDError* Error) {
 		ProcessCompletionHandler(WeakSBChat, Error, [&MessageInfo, NewUserMessage]() {
-			MessageInfo = SBChatManager::Get().UpdateHistoryMessage(NewUserMessage);
+			MessageInfo = SBChatManager::Get().ToMessageInfo(NewUserMessage);
+			SBChatManager::RunOnGameThread([NewUserMessage]() {
+				SBChatManager::Get().UpdateHistoryMessage(NewUserMessage);
+			});
 		});
 	});
 #endif
@@ -802,7 +1163,7 @@ USBChat* USBChat::UpdateUserMessage(UObject* WorldContextObject, int64 MessageID
 
 USBChat* USBChat::DeleteMessage(UObject* WorldContextObject, int64 MessageID)
 {
-	USBChat* BlueprintAsyncAction = NewObject<USBChat>();
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("DeleteMessage"));
 #if WITH_SENDBIRD
 	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
 
@@ -826,8 +1187,10 @@ USBChat* USBChat::DeleteMessage(UObject* WorldContextObject, int64 MessageID)
 	}
 
 	CurrentChannel->DeleteMessage(Message, [MessageID, Message, WeakSBChat](SBDError* Error) {
-		ProcessCompletionHandler(WeakSBChat, Error, [Message, MessageID]() {
-			SBChatManager::Get().DeleteHistoryMessage(MessageID);
+		ProcessCompletionHandler(WeakSBChat, Error, [MessageID]() {
+			SBChatManager::RunOnGameThread([MessageID]() {
+				SBChatManager::Get().DeleteHistoryMessage(MessageID);
+			});
 		});
 	});
 #endif
@@ -836,7 +1199,7 @@ USBChat* USBChat::DeleteMessage(UObject* WorldContextObject, int64 MessageID)
 
 USBChat* USBChat::GetPreviousMessageList(UObject* WorldContextObject, TArray<FSBMessageInfo>& MessageInfos)
 {
-	USBChat* BlueprintAsyncAction = NewObject<USBChat>();
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("GetPreviousMessageList"));
 #if WITH_SENDBIRD
 	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
 
@@ -850,31 +1213,191 @@ USBChat* USBChat::GetPreviousMessageList(UObject* WorldContextObject, TArray<FSB
 		return BlueprintAsyncAction;
 	}
 
+	// Re-entering the channel whose history is still held: show it and fetch only what changed since.
+	if (SBChatManager::Get().HasHistoryOf(CurrentChannel))
+	{
+		SBChatHistoryStore& History = SBChatManager::Get().GetHistoryMessages();
+		MessageInfos.Reset(History.Num());
+		History.ForEach([&MessageInfos](SBDBaseMessage* Message) {
+			SBChatMessageProjection::ProjectInto(Message, MessageInfos);
+		});
+		SBChatManager::Get().GetOutbox().GetPending(SendbirdTranscode::ToFString(CurrentChannel->channel_url), MessageInfos);
+
+		World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateLambda([BlueprintAsyncAction, CurrentChannel]() {
+			BlueprintAsyncAction->OnSuccess.Broadcast(TEXT(""), 0);
+			SBChatManager::Get().SyncChannel(CurrentChannel);
+		}));
+		return BlueprintAsyncAction;
+	}
+
+	// Show the cached tail right away and reconcile it with the server in the background.
+	TArray<SBChatMessageCache::FCachedMessage> CachedMessages;
+	if (SBChatManager::Get().GetMessageCache().ReadTail(SendbirdTranscode::ToFString(CurrentChannel->channel_url), SBChatManager::MESSAGE_QUERY_LIST_LIMIT, CachedMessages))
+	{
+		MessageInfos.Reset(CachedMessages.Num());
+		for (const SBChatMessageCache::FCachedMessage& CachedMessage : CachedMessages)
+			MessageInfos.Add(SBChatManager::Get().ToMessageInfo(CachedMessage));
+		SBChatManager::Get().GetOutbox().GetPending(SendbirdTranscode::ToFString(CurrentChannel->channel_url), MessageInfos);
+
+		// Reconcile after the list is shown, so its events can't arrive before the list they change. The history keeps
+		// what it holds until the server answers.
+		World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateLambda([BlueprintAsyncAction, CurrentChannel, CachedMessages]() {
+			BlueprintAsyncAction->OnSuccess.Broadcast(TEXT(""), 0);
+			SBChatManager::Get().ReconcileCachedHistory(CurrentChannel, CachedMessages);
+		}));
+		return BlueprintAsyncAction;
+	}
+
 	SBDPreviousMessageListQuery* ListQuery = CurrentChannel->CreatePreviousMessageListQuery();
 	ListQuery->LoadNextPage(SBChatManager::MESSAGE_QUERY_LIST_LIMIT, false, [&MessageInfos, WeakSBChat](std::vector<SBDBaseMessage*> Messages, SBDError* Error) {
-		ProcessCompletionHandler(WeakSBChat, Error, [&MessageInfos, &Messages]() {
-			SBDBaseChannel* CurrentChannel = SBChatManager::Get().GetCurrentChannel();
-			if (CurrentChannel && CurrentChannel->is_group_channel)
-			{
-				SBDGroupChannel* GroupChannel = static_cast<SBDGroupChannel*>(CurrentChannel);
-				GroupChannel->MarkAsRead();
-			}
-
-			MessageInfos.Empty();
-			SBChatManager::Get().ResetHistoryMessage();
-			for (SBDBaseMessage* Message : Messages)
-			{
-				const FSBMessageInfo AddedMessage = SBChatManager::Get().AddHistoryMessage(Message);
-				MessageInfos.Add(AddedMessage);
-			}
+		ProcessCompletionHandler(WeakSBChat, Error, [&MessageInfos, &Messages, WeakSBChat]() {
+			// The history is game-thread state; this runs there before OnSuccess is broadcast.
+			SBChatManager::RunOnGameThread([&MessageInfos, WeakSBChat, Loaded = TArray<SBDBaseMessage*>(Messages.data(), (int32)Messages.size())]() {
+				if (!WeakSBChat.IsValid())
+					return;
+
+				SBDBaseChannel* CurrentChannel = SBChatManager::Get().GetCurrentChannel();
+				if (CurrentChannel && CurrentChannel->is_group_channel)
+				{
+					SBDGroupChannel* GroupChannel = static_cast<SBDGroupChannel*>(CurrentChannel);
+					SBChatManager::Get().GetReadReceiptScheduler().RequestMarkAsRead(GroupChannel);
+				}
+
+				MessageInfos.Reset(Loaded.Num());
+				SBChatManager::Get().ResetHistoryMessage();
+				for (SBDBaseMessage* Message : Loaded)
+					SBChatManager::Get().AddHistoryMessage(Message, MessageInfos);
+				if (CurrentChannel)
+					SBChatManager::Get().GetOutbox().GetPending(SendbirdTranscode::ToFString(CurrentChannel->channel_url), MessageInfos);
+			});
 		});
 	});
 #endif
 	return BlueprintAsyncAction;
 }
+
+void USBChat::GetReadReceiptStats(int64& Requested, int64& Sent, int64& Saved)
+{
+	const SBChatReadReceiptScheduler& Scheduler = SBChatManager::Get().GetReadReceiptScheduler();
+	Requested = Scheduler.GetRequestedCount();
+	Sent = Scheduler.GetSentCount();
+	Saved = Scheduler.GetSavedCount();
+}
+
+void USBChat::SetHistoryMemoryBudget(int64 BudgetBytes)
+{
+	if (!ensureMsgf(BudgetBytes > 0, TEXT("[USBChat::SetHistoryMemoryBudget] Wrong BudgetBytes(%lld)!!"), BudgetBytes))
+		return;
+
+	SBChatManager::Get().SetHistoryMemoryBudget(BudgetBytes);
+}
+
+void USBChat::SetSendLimits(float ChannelRate, float ChannelBurst, float GlobalRate, float GlobalBurst)
+{
+	SBChatManager::Get().GetSendLimiter().SetChannelLimit(ChannelRate, ChannelBurst);
+	SBChatManager::Get().GetSendLimiter().SetGlobalLimit(GlobalRate, GlobalBurst);
+}
+
+void USBChat::SetSendOverflowPolicy(ESBSendOverflowPolicy Policy, int32 MaxQueued)
+{
+	SBChatManager::Get().GetSendLimiter().SetPolicy(Policy, MaxQueued);
+}
+
+void USBChat::GetSendLimiterStats(int64& Sent, int64& Delayed, int64& Coalesced, int64& Dropped)
+{
+	const SBChatSendLimiter::FStats Stats = SBChatManager::Get().GetSendLimiter().GetStats();
+	Sent = Stats.Sent;
+	Delayed = Stats.Delayed;
+	Coalesced = Stats.Coalesced;
+	Dropped = Stats.Dropped;
+}
+
+bool USBChat::ResendMessage(int64 LocalMessageID)
+{
+	return SBChatManager::Get().GetOutbox().Resend(LocalMessageID);
+}
+
+bool USBChat::DiscardMessage(int64 LocalMessageID)
+{
+	return SBChatManager::Get().GetOutbox().Discard(LocalMessageID);
+}
+
+USBChat* USBChat::SearchMessages(const FString& Query, const FString& ChannelUrl, int32 MaxResults, TArray<FSBSearchResult>& Results)
+{
+	USBChat* BlueprintAsyncAction = NewAction(TEXT("SearchMessages"));
+	TWeakObjectPtr<USBChat> WeakSBChat = BlueprintAsyncAction;
+
+	Async(EAsyncExecution::ThreadPool, [&Results, WeakSBChat, Query, ChannelUrl, MaxResults]() {
+		TArray<FSBSearchResult> Found;
+		SBChatManager::Get().GetSearchIndex().Search(Query, ChannelUrl, MaxResults, Found);
+		const double CompletionTime = FPlatformTime::Seconds();
+
+		AsyncTask(ENamedThreads::GameThread, [&Results, WeakSBChat, CompletionTime, Found = MoveTemp(Found)]() mutable {
+			if (!WeakSBChat.IsValid())
+				return;
+
+			Results = MoveTemp(Found);
+			WeakSBChat->RecordLatency(CompletionTime, 0);
+			SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_DispatchCompletion);
+			WeakSBChat->OnSuccess.Broadcast(FString(TEXT("")), 0);
+		});
+	});
+	return BlueprintAsyncAction;
+}
 //- Message
 
+//+ Deprecated
+USBChat* USBChat::UpdateOpenChannel(UObject* WorldContextObject, int Index, const FString& Name, const FString& NewName, FSBChannelInfo& ChannelInfo)
+{
+	SBDOpenChannel* SelectedChannel = SBChatManager::Get().GetSelectedOpenChannel(Index, Name);
+	return UpdateOpenChannelByHandle(WorldContextObject, SelectedChannel ? FSBChannelHandle(SelectedChannel) : FSBChannelHandle(), NewName, ChannelInfo);
+}
+
+USBChat* USBChat::DeleteOpenChannel(UObject* WorldContextObject, int Index, const FString& Name)
+{
+	SBDOpenChannel* SelectedChannel = SBChatManager::Get().GetSelectedOpenChannel(Index, Name);
+	return DeleteOpenChannelByHandle(WorldContextObject, SelectedChannel ? FSBChannelHandle(SelectedChannel) : FSBChannelHandle());
+}
+
+USBChat* USBChat::EnterOpenChannel(UObject* WorldContextObject, int Index, const FString& Name)
+{
+	SBDOpenChannel* SelectedChannel = SBChatManager::Get().GetSelectedOpenChannel(Index, Name);
+	return EnterOpenChannelByHandle(WorldContextObject, SelectedChannel ? FSBChannelHandle(SelectedChannel) : FSBChannelHandle());
+}
+
+USBChat* USBChat::UpdateGroupChannel(UObject* WorldContextObject, int Index, const FString& Name, const FString& NewName, FSBChannelInfo& ChannelInfo)
+{
+	SBDGroupChannel* SelectedChannel = SBChatManager::Get().GetSelectedGroupChannel(Index, Name);
+	return UpdateGroupChannelByHandle(WorldContextObject, SelectedChannel ? FSBChannelHandle(SelectedChannel) : FSBChannelHandle(), NewName, ChannelInfo);
+}
+
+USBChat* USBChat::DeleteGroupChannel(UObject* WorldContextObject, int Index, const FString& Name)
+{
+	SBDGroupChannel* SelectedChannel = SBChatManager::Get().GetSelectedGroupChannel(Index, Name);
+	return DeleteGroupChannelByHandle(WorldContextObject, SelectedChannel ? FSBChannelHandle(SelectedChannel) : FSBChannelHandle());
+}
+
+USBChat* USBChat::JoinGroupChannel(UObject* WorldContextObject, int Index, const FString& Name, TArray<FSBUserInfo>& Members)
+{
+	SBDGroupChannel* SelectedChannel = SBChatManager::Get().GetSelectedGroupChannel(Index, Name);
+	return JoinGroupChannelByHandle(WorldContextObject, SelectedChannel ? FSBChannelHandle(SelectedChannel) : FSBChannelHandle(), Members);
+}
+//- Deprecated
+
 //+ private
+USBChat* USBChat::NewAction(const TCHAR* Operation)
+{
+	USBChat* BlueprintAsyncAction = NewObject<USBChat>();
+	BlueprintAsyncAction->Operation = FName(Operation);
+	return BlueprintAsyncAction;
+}
+
+void USBChat::RecordLatency(double CompletionTime, int64 ErrorCode) const
+{
+	SBChatStats::RecordRequestLatency(CompletionTime - StartTime);
+	SBChatLatencyTracker::Get().Record(Operation, StartTime, CompletionTime, FPlatformTime::Seconds(), ErrorCode);
+}
+
 void USBChat::GetUserList(UWorld* World, TWeakObjectPtr<USBChat> WeakSBChat, TArray<FSBUserInfo>& UserList)
 {
 #if WITH_SENDBIRD
@@ -889,7 +1412,8 @@ void USBChat::GetUserList(UWorld* World, TWeakObjectPtr<USBChat> WeakSBChat, TAr
 		return;
 	}
 
-	if (!UserListQuery->has_next)
+	SBChatManager::FUserPaginator& UserPages = SBChatManager::Get().GetUserPages();
+	if (!UserPages.HasNext())
 	{
 		World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateLambda([WeakSBChat]() {
 			WeakSBChat->OnSuccess.Broadcast(FString(TEXT("")), 0);
@@ -897,12 +1421,12 @@ void USBChat::GetUserList(UWorld* World, TWeakObjectPtr<USBChat> WeakSBChat, TAr
 		return;
 	}
 
-	UserListQuery->LoadNextPage([&UserList, WeakSBChat](std::vector<SBDUser> Users, SBDError* Error) {
+	UserPages.Next(SBChatManager::USER_QUERY_LIST_LIMIT, [&UserList, WeakSBChat](const TArray<SBDUser>& Users, SBDError* Error) {
 		ProcessCompletionHandler(WeakSBChat, Error, [&UserList, &Users]() {
 			UserList.Empty();
-			for (SBDUser& User : Users)
+			for (const SBDUser& User : Users)
 			{
-				SBChatManager::Get().GetUserList().Add(User);
+				SBChatManager::Get().GetUserDirectory().Add(User);
 				UserList.Add(FSBUserInfo(User));
 			}
 		});
@@ -910,25 +1434,55 @@ void USBChat::GetUserList(UWorld* World, TWeakObjectPtr<USBChat> WeakSBChat, TAr
 #endif
 }
 
+void USBChat::LoadSubscribedHistory(TWeakObjectPtr<USBChat> WeakSBChat, SBDBaseChannel* Channel)
+{
+#if WITH_SENDBIRD
+	SBDPreviousMessageListQuery* ListQuery = Channel->CreatePreviousMessageListQuery();
+	ListQuery->LoadNextPage(SBChatManager::MESSAGE_QUERY_LIST_LIMIT, false, [Channel, WeakSBChat](std::vector<SBDBaseMessage*> Messages, SBDError* Error) {
+		ProcessCompletionHandler(WeakSBChat, Error, [Channel, &Messages]() {
+			// Messages delivered by the handler while the page was loading are already in the store.
+			SBChatManager::RunOnGameThread([Channel, Loaded = TArray<SBDBaseMessage*>(Messages.data(), (int32)Messages.size())]() {
+				SBChatManager::Get().GetSubscriptions().Update(Channel, [&Loaded](SBChatSubscriptions::FState& State) {
+					for (SBDBaseMessage* Message : Loaded)
+						State.History.Add(Message);
+					State.bHistoryLoaded = true;
+				});
+			});
+		});
+	});
+#endif
+}
+
 void USBChat::ProcessCompletionHandler(TWeakObjectPtr<USBChat> WeakSBChat, SBDError* Error, std::function<void()> SuccessHandler)
 {
+	// Taken on the SDK's thread, so the time the game thread takes to pick the result up is not counted.
+	const double CompletionTime = FPlatformTime::Seconds();
+
 	if (Error != nullptr) {
-		FString ErrorMessage = WCHAR_TO_TCHAR(Error->message.c_str());
+		FString ErrorMessage = SendbirdTranscode::ToFString(Error->message);
 		int64 ErrorCode = Error->code;
 		UE_LOG(SendbirdSample, Error, TEXT("[USBChat::CompletionHandler] ErrorMessage(%s) ErrorCode(%d)"), *ErrorMessage, ErrorCode);
 
-		AsyncTask(ENamedThreads::GameThread, [WeakSBChat, ErrorMessage, ErrorCode]() {
-			if (WeakSBChat.IsValid())
-				WeakSBChat->OnFail.Broadcast(ErrorMessage, ErrorCode);
+		AsyncTask(ENamedThreads::GameThread, [WeakSBChat, ErrorMessage, ErrorCode, CompletionTime]() {
+			if (!WeakSBChat.IsValid())
+				return;
+
+			WeakSBChat->RecordLatency(CompletionTime, ErrorCode);
+			SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_DispatchCompletion);
+			WeakSBChat->OnFail.Broadcast(ErrorMessage, ErrorCode);
 		});
 	}
 	else
 	{
 		SuccessHandler();
 
-		AsyncTask(ENamedThreads::GameThread, [WeakSBChat]() {
-			if (WeakSBChat.IsValid())
-				WeakSBChat->OnSuccess.Broadcast(FString(TEXT("")), 0);
+		AsyncTask(ENamedThreads::GameThread, [WeakSBChat, CompletionTime]() {
+			if (!WeakSBChat.IsValid())
+				return;
+
+			WeakSBChat->RecordLatency(CompletionTime, 0);
+			SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_DispatchCompletion);
+			WeakSBChat->OnSuccess.Broadcast(FString(TEXT("")), 0);
 		});
 	}
 }
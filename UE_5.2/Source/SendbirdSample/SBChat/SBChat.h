@@ -26,6 +26,13 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "SBChat")
 	static void SetChannelEvent(class UObject* InChannelEvent);
 
+	// Shows sent messages right away as Pending echoes, replaced through OnMessageSent once the server has them.
+	UFUNCTION(BlueprintCallable, Category = "SBChat")
+	static void SetLocalEcho(bool bEnabled);
+
+	UFUNCTION(BlueprintCallable, Category = "SBChat")
+	static void SetEventDelivery(bool bBatched, float FrameBudgetMs = 2.0f);
+
 	UFUNCTION(BlueprintCallable, Category = "SBChat", meta = (BlueprintInternalUseOnly = "true"))
 	static USBChat* Connect(const FString& UserID, const FString& AccessToken);
 	
@@ -34,6 +41,14 @@ public:
 
 	UFUNCTION(BlueprintCallable, Category = "SBChat")
 	static void Cleanup();
+
+	// Changes also go to the channel event as OnConnectionStateChanged.
+	UFUNCTION(BlueprintPure, Category = "SBChat")
+	static ESBConnectionState GetConnectionState();
+
+	// Skips what is left of the reconnection backoff, e.g. from a retry button.
+	UFUNCTION(BlueprintCallable, Category = "SBChat")
+	static void ReconnectNow();
 	//- Common
 
 	//+ User
@@ -49,6 +64,31 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "SBChat", meta = (HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject", WorldContext = "WorldContextObject"))
 	static UTexture2DDynamic* GetProfileTexture(UObject* WorldContextObject, const FString& ProfileUrl);
 
+	// Downloads and decodes the profile image off the game thread; a url already loading is not fetched twice.
+	UFUNCTION(BlueprintCallable, Category = "SBChat", meta = (BlueprintInternalUseOnly = "true", HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject", WorldContext = "WorldContextObject"))
+	static USBChat* LoadProfileTexture(UObject* WorldContextObject, const FString& ProfileUrl, UTexture2DDynamic*& ProfileTexture);
+
+	UFUNCTION(BlueprintCallable, Category = "SBChat")
+	static void SetProfileTextureCache(int64 BudgetBytes, bool bDiskCache = true);
+
+	// Draws avatars from shared atlas pages; the user list's avatars are packed automatically.
+	UFUNCTION(BlueprintCallable, Category = "SBChat")
+	static void SetProfileAtlasEnabled(bool bEnabled, int32 MaxPages = 4);
+
+	// Packs an avatar that is not in the user list, e.g. a message sender's.
+	UFUNCTION(BlueprintCallable, Category = "SBChat")
+	static void AcquireProfileAtlasSlot(const FString& ProfileUrl);
+
+	UFUNCTION(BlueprintCallable, Category = "SBChat")
+	static void ReleaseProfileAtlasSlot(const FString& ProfileUrl);
+
+	// False until the avatar is packed. Look the slot up again when GetProfileAtlasRevision() changes.
+	UFUNCTION(BlueprintCallable, Category = "SBChat")
+	static bool GetProfileAtlasSlot(const FString& ProfileUrl, UTexture2DDynamic*& AtlasPage, FVector2D& UVMin, FVector2D& UVMax);
+
+	UFUNCTION(BlueprintCallable, Category = "SBChat")
+	static int32 GetProfileAtlasRevision();
+
 	UFUNCTION(BlueprintCallable, Category = "SBChat", meta = (BlueprintInternalUseOnly = "true", bClearList = false, HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject", WorldContext = "WorldContextObject"))
 	static USBChat* GetAllUserList(UObject* WorldContextObject, bool bClearList, TArray<FSBUserInfo>& FriendInfos);
 
@@ -61,10 +101,10 @@ public:
 	static USBChat* CreateOpenChannel(const FString& Name, FSBChannelInfo& OpenChannelInfo);
 	
 	UFUNCTION(BlueprintCallable, Category = "SBChat", meta = (BlueprintInternalUseOnly = "true", HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject", WorldContext = "WorldContextObject"))
-	static USBChat* UpdateOpenChannel(UObject* WorldContextObject, int Index, const FString& Name, const FString& NewName, FSBChannelInfo& ChannelInfo);
+	static USBChat* UpdateOpenChannelByHandle(UObject* WorldContextObject, const FSBChannelHandle& Channel, const FString& NewName, FSBChannelInfo& ChannelInfo);
 	
 	UFUNCTION(BlueprintCallable, Category = "SBChat", meta = (BlueprintInternalUseOnly = "true", HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject", WorldContext = "WorldContextObject"))
-	static USBChat* DeleteOpenChannel(UObject* WorldContextObject, int Index, const FString& Name);
+	static USBChat* DeleteOpenChannelByHandle(UObject* WorldContextObject, const FSBChannelHandle& Channel);
 	
 	UFUNCTION(BlueprintCallable, Category = "SBChat", meta = (BlueprintInternalUseOnly = "true", bClearList = false, HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject", WorldContext = "WorldContextObject"))
 	static USBChat* GetOpenChannelList(UObject* WorldContextObject,bool bClearList, TArray<FSBChannelInfo>& OpenChannelInfos);
@@ -73,7 +113,7 @@ public:
 	static USBChat* GetOpenChannelParticipantList(UObject* WorldContextObject, bool bClearList, TArray<FSBUserInfo>& UserList);
 
 	UFUNCTION(BlueprintCallable, Category = "SBChat", meta = (BlueprintInternalUseOnly = "true", HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject", WorldContext = "WorldContextObject"))
-	static USBChat* EnterOpenChannel(UObject* WorldContextObject, int Index, const FString& Name);
+	static USBChat* EnterOpenChannelByHandle(UObject* WorldContextObject, const FSBChannelHandle& Channel);
 	
 	UFUNCTION(BlueprintCallable, Category = "SBChat", meta = (BlueprintInternalUseOnly = "true", HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject", WorldContext = "WorldContextObject"))
 	static USBChat* ExitOpenChannel(UObject* WorldContextObject);
@@ -90,25 +130,78 @@ public:
 	static USBChat* CreateGroupChannelWithUserIds(UObject* WorldContextObject, const FString& ChannelName, const TArray<FString>& FriendIds);
 
 	UFUNCTION(BlueprintCallable, Category = "SBChat", meta = (BlueprintInternalUseOnly = "true", HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject", WorldContext = "WorldContextObject"))
-	static USBChat* UpdateGroupChannel(UObject* WorldContextObject, int Index, const FString& Name, const FString& NewName, FSBChannelInfo& ChannelInfo);
+	static USBChat* UpdateGroupChannelByHandle(UObject* WorldContextObject, const FSBChannelHandle& Channel, const FString& NewName, FSBChannelInfo& ChannelInfo);
 
 	UFUNCTION(BlueprintCallable, Category = "SBChat", meta = (BlueprintInternalUseOnly = "true", HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject", WorldContext = "WorldContextObject"))
-	static USBChat* DeleteGroupChannel(UObject* WorldContextObject, int Index, const FString& Name);
+	static USBChat* DeleteGroupChannelByHandle(UObject* WorldContextObject, const FSBChannelHandle& Channel);
 
 	UFUNCTION(BlueprintCallable, Category = "SBChat", meta = (BlueprintInternalUseOnly = "true", bClearList = false, HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject", WorldContext = "WorldContextObject"))
 	static USBChat* GetGroupChannelList(UObject* WorldContextObject,bool bClearList, TArray<FSBChannelInfo>& GroupChannelInfos);
 
 	UFUNCTION(BlueprintCallable, Category = "SBChat", meta = (BlueprintInternalUseOnly = "true", HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject", WorldContext = "WorldContextObject"))
-	static USBChat* JoinGroupChannel(UObject* WorldContextObject, int Index, const FString& Name, TArray<FSBUserInfo>& Members);
+	static USBChat* JoinGroupChannelByHandle(UObject* WorldContextObject, const FSBChannelHandle& Channel, TArray<FSBUserInfo>& Members);
 
 	UFUNCTION(BlueprintCallable, Category = "SBChat", meta = (BlueprintInternalUseOnly = "true", HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject", WorldContext = "WorldContextObject"))
 	static USBChat* LeaveGroupChannel(UObject* WorldContextObject);
+
+	// Group channels loaded so far, most recent message first. MaxCount <= 0 returns all of them.
+	UFUNCTION(BlueprintCallable, Category = "SBChat")
+	static void GetRecentGroupChannels(int MaxCount, TArray<FSBChannelInfo>& GroupChannelInfos);
 	//- GroupChannel
 
+	//+ Subscription
+	// Keeps history, members and unread count of the channel live while another channel is focused.
+	// Open channels are entered; group channels must already be joined.
+	UFUNCTION(BlueprintCallable, Category = "SBChat", meta = (BlueprintInternalUseOnly = "true", HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject", WorldContext = "WorldContextObject"))
+	static USBChat* SubscribeChannel(UObject* WorldContextObject, const FSBChannelHandle& Channel);
+
+	UFUNCTION(BlueprintCallable, Category = "SBChat")
+	static void UnsubscribeChannel(const FSBChannelHandle& Channel);
+
+	// Makes a subscribed channel the current one, served from memory.
+	UFUNCTION(BlueprintCallable, Category = "SBChat", meta = (BlueprintInternalUseOnly = "true", HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject", WorldContext = "WorldContextObject"))
+	static USBChat* FocusChannel(UObject* WorldContextObject, const FSBChannelHandle& Channel, TArray<FSBMessageInfo>& MessageInfos, TArray<FSBUserInfo>& Members);
+
+	// UnreadMessageCount is the count kept by the subscription.
+	UFUNCTION(BlueprintCallable, Category = "SBChat")
+	static void GetSubscribedChannels(TArray<FSBChannelInfo>& ChannelInfos);
+
+	// Counts kept from events, without a round trip; changes also go to the channel event as OnUnreadCountsChanged.
+	UFUNCTION(BlueprintCallable, Category = "SBChat")
+	static void GetUnreadCounts(FSBUnreadCounts& Counts);
+
+	UFUNCTION(BlueprintPure, Category = "SBChat")
+	static int32 GetChannelUnreadCount(const FSBChannelHandle& Channel);
+	//- Subscription
+
 	//+ Message
 	UFUNCTION(BlueprintCallable, Category = "SBChat", meta = (BlueprintInternalUseOnly = "true", HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject", WorldContext = "WorldContextObject"))
 	static USBChat* SendUserMessage(UObject* WorldContextObject, const FString& SendMessage, FSBMessageInfo& MessageInfo);
 
+	// Uploads the file from disk without loading it into memory; an empty MimeType is guessed from the file.
+	// Progress goes to the channel event as OnFileUploadProgress with UploadID.
+	UFUNCTION(BlueprintCallable, Category = "SBChat", meta = (BlueprintInternalUseOnly = "true", HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject", WorldContext = "WorldContextObject"))
+	static USBChat* SendFileMessage(UObject* WorldContextObject, const FString& FilePath, const FString& MimeType, int32& UploadID, FSBMessageInfo& MessageInfo);
+
+	// The SendFileMessage action fails with "Cancelled!!".
+	UFUNCTION(BlueprintCallable, Category = "SBChat")
+	static bool CancelFileUpload(int32 UploadID);
+
+	UFUNCTION(BlueprintCallable, Category = "SBChat")
+	static void SetMaxConcurrentUploads(int32 MaxConcurrent = 2);
+
+	// Thumbnail sizes asked for image files sent after this; an empty list sends images without thumbnails.
+	UFUNCTION(BlueprintCallable, Category = "SBChat")
+	static void SetThumbnailSizes(const TArray<FIntPoint>& Sizes);
+
+	// Loads the file's smallest thumbnail that covers Width x Height pixels, never the file itself; fails when the file
+	// has no thumbnail.
+	UFUNCTION(BlueprintCallable, Category = "SBChat", meta = (BlueprintInternalUseOnly = "true", HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject", WorldContext = "WorldContextObject"))
+	static USBChat* LoadFileThumbnail(UObject* WorldContextObject, const FSBFileInfo& FileInfo, int32 Width, int32 Height, UTexture2DDynamic*& Thumbnail);
+
+	UFUNCTION(BlueprintCallable, Category = "SBChat")
+	static void SetThumbnailTextureCache(int64 BudgetBytes, bool bDiskCache = true);
+
 	UFUNCTION(BlueprintCallable, Category = "SBChat", meta = (BlueprintInternalUseOnly = "true", HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject", WorldContext = "WorldContextObject"))
 	static USBChat* UpdateUserMessage(UObject* WorldContextObject, int64 MessageID, const FString& NewMessage, FSBMessageInfo& MessageInfo);
 
@@ -117,10 +210,65 @@ public:
 
 	UFUNCTION(BlueprintCallable, Category = "SBChat", meta = (BlueprintInternalUseOnly = "true", HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject", WorldContext = "WorldContextObject"))
 	static USBChat* GetPreviousMessageList(UObject* WorldContextObject, TArray<FSBMessageInfo>& MessageInfos);
+
+	UFUNCTION(BlueprintCallable, Category = "SBChat")
+	static void GetReadReceiptStats(int64& Requested, int64& Sent, int64& Saved);
+
+	UFUNCTION(BlueprintCallable, Category = "SBChat")
+	static void SetHistoryMemoryBudget(int64 BudgetBytes);
+
+	// Token buckets in front of every send: Rate messages per second, up to Burst at once.
+	UFUNCTION(BlueprintCallable, Category = "SBChat")
+	static void SetSendLimits(float ChannelRate = 2.0f, float ChannelBurst = 5.0f, float GlobalRate = 5.0f, float GlobalBurst = 10.0f);
+
+	// What happens to messages sent over the limit; MaxQueued caps what a channel holds under any policy.
+	UFUNCTION(BlueprintCallable, Category = "SBChat")
+	static void SetSendOverflowPolicy(ESBSendOverflowPolicy Policy, int32 MaxQueued = 32);
+
+	UFUNCTION(BlueprintCallable, Category = "SBChat")
+	static void GetSendLimiterStats(int64& Sent, int64& Delayed, int64& Coalesced, int64& Dropped);
+
+	// Queues a message whose echo is Failed again; false if LocalMessageID is not a failed echo.
+	UFUNCTION(BlueprintCallable, Category = "SBChat")
+	static bool ResendMessage(int64 LocalMessageID);
+
+	// Drops a message whose echo is Failed; the echo goes out as OnMessageDeleted.
+	UFUNCTION(BlueprintCallable, Category = "SBChat")
+	static bool DiscardMessage(int64 LocalMessageID);
+
+	// Searches the messages seen this session, newest first, off the game thread. Words match as prefixes and
+	// "quoted text" as a phrase. An empty ChannelUrl searches every channel.
+	UFUNCTION(BlueprintCallable, Category = "SBChat", meta = (BlueprintInternalUseOnly = "true", MaxResults = 50))
+	static USBChat* SearchMessages(const FString& Query, const FString& ChannelUrl, int32 MaxResults, TArray<FSBSearchResult>& Results);
 	//- Message
+
+	//+ Deprecated
+	// Index and Name address the channel as the channel list widgets did before FSBChannelHandle; both resolve through
+	// SBChatChannelRegistry and forward to the handle version.
+	UFUNCTION(BlueprintCallable, Category = "SBChat", meta = (BlueprintInternalUseOnly = "true", HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject", WorldContext = "WorldContextObject", DeprecatedFunction, DeprecationMessage = "Use UpdateOpenChannelByHandle with the Handle of the channel info."))
+	static USBChat* UpdateOpenChannel(UObject* WorldContextObject, int Index, const FString& Name, const FString& NewName, FSBChannelInfo& ChannelInfo);
+
+	UFUNCTION(BlueprintCallable, Category = "SBChat", meta = (BlueprintInternalUseOnly = "true", HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject", WorldContext = "WorldContextObject", DeprecatedFunction, DeprecationMessage = "Use DeleteOpenChannelByHandle with the Handle of the channel info."))
+	static USBChat* DeleteOpenChannel(UObject* WorldContextObject, int Index, const FString& Name);
+
+	UFUNCTION(BlueprintCallable, Category = "SBChat", meta = (BlueprintInternalUseOnly = "true", HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject", WorldContext = "WorldContextObject", DeprecatedFunction, DeprecationMessage = "Use EnterOpenChannelByHandle with the Handle of the channel info."))
+	static USBChat* EnterOpenChannel(UObject* WorldContextObject, int Index, const FString& Name);
+
+	UFUNCTION(BlueprintCallable, Category = "SBChat", meta = (BlueprintInternalUseOnly = "true", HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject", WorldContext = "WorldContextObject", DeprecatedFunction, DeprecationMessage = "Use UpdateGroupChannelByHandle with the Handle of the channel info."))
+	static USBChat* UpdateGroupChannel(UObject* WorldContextObject, int Index, const FString& Name, const FString& NewName, FSBChannelInfo& ChannelInfo);
+
+	UFUNCTION(BlueprintCallable, Category = "SBChat", meta = (BlueprintInternalUseOnly = "true", HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject", WorldContext = "WorldContextObject", DeprecatedFunction, DeprecationMessage = "Use DeleteGroupChannelByHandle with the Handle of the channel info."))
+	static USBChat* DeleteGroupChannel(UObject* WorldContextObject, int Index, const FString& Name);
+
+	UFUNCTION(BlueprintCallable, Category = "SBChat", meta = (BlueprintInternalUseOnly = "true", HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject", WorldContext = "WorldContextObject", DeprecatedFunction, DeprecationMessage = "Use JoinGroupChannelByHandle with the Handle of the channel info."))
+	static USBChat* JoinGroupChannel(UObject* WorldContextObject, int Index, const FString& Name, TArray<FSBUserInfo>& Members);
+	//- Deprecated
 	
 private:
+	static USBChat* NewAction(const TCHAR* Operation);
+	void RecordLatency(double CompletionTime, int64 ErrorCode) const;
 	static void GetUserList(UWorld* MyWorld, TWeakObjectPtr<USBChat> WeakSBChat, TArray<FSBUserInfo>& UserList);
+	static void LoadSubscribedHistory(TWeakObjectPtr<USBChat> WeakSBChat, SBDBaseChannel* Channel);
 	static void	ProcessCompletionHandler(TWeakObjectPtr<USBChat> WeakSBChat, SBDError* Error, std::function<void()> SuccessHandler);
 
 public:
@@ -129,4 +277,10 @@ public:
 
 	UPROPERTY(BlueprintAssignable)
 	FSBChatCallback OnFail;
+
+private:
+	// FPlatformTime::Seconds() when the action was created, i.e. when the request was made.
+	double StartTime;
+	// The Blueprint node the action belongs to; latency is kept per operation.
+	FName Operation;
 };
@@ -0,0 +1,406 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#include "SBChatAvatarAtlas.h"
+#include "SBChatProfileTextureCache.h"
+#include "SBChatUserDirectory.h"
+#include "SBChatStringTable.h"
+#include "Engine/Texture2DDynamic.h"
+#include "TextureResource.h"
+#include "RenderingThread.h"
+#include "RHI.h"
+#include "SBChatThumbnail.h"
+#include "Async/Async.h"
+
+SBChatAvatarAtlas::SBChatAvatarAtlas(SBChatProfileTextureCache& InProfileTextures, SBChatUserDirectory& InUserDirectory)
+	: ProfileTextures(InProfileTextures)
+	, UserDirectory(InUserDirectory)
+{
+	MaxPages = DEFAULT_MAX_PAGES;
+	UseClock = 0;
+	Revision = 0;
+	Generation = 0;
+	bUserListSynced = false;
+	UserListVersion = 0;
+}
+
+SBChatAvatarAtlas::~SBChatAvatarAtlas()
+{
+	SetEnabled(false);
+}
+
+void SBChatAvatarAtlas::Reset()
+{
+	Entries.Empty();
+	Pages.Empty();
+	PendingUploads.Empty();
+	UseClock = 0;
+	++Revision;
+	// Images still loading for the previous entries are dropped when they arrive.
+	++Generation;
+
+	bUserListSynced = false;
+	UserListUrls.Empty();
+}
+
+void SBChatAvatarAtlas::SetEnabled(bool bEnabled)
+{
+	if (bEnabled == IsEnabled())
+		return;
+
+	if (bEnabled)
+	{
+		TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &SBChatAvatarAtlas::Tick));
+	}
+	else
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+		Reset();
+	}
+}
+
+void SBChatAvatarAtlas::SetMaxPages(int32 InMaxPages)
+{
+	MaxPages = FMath::Max(InMaxPages, 1);
+	if (Pages.Num() > MaxPages)
+		Repack();
+}
+
+void SBChatAvatarAtlas::Acquire(const FString& ProfileUrl)
+{
+	if (ProfileUrl.IsEmpty())
+		return;
+
+	FEntry& Entry = Entries.FindOrAdd(ProfileUrl);
+	++Entry.RefCount;
+	Entry.LastUsed = ++UseClock;
+
+	if (Entry.Page == INDEX_NONE && !Entry.bLoading)
+	{
+		// Pixels are kept when a page was full, so the avatar only has to find a slot.
+		if (Entry.Pixels.Num() > 0)
+			Place(ProfileUrl, MaxPages);
+		else
+			Load(ProfileUrl, Entry);
+	}
+}
+
+void SBChatAvatarAtlas::Release(const FString& ProfileUrl)
+{
+	// The slot stays until it's needed; the same user often shows up again in the next list.
+	FEntry* Entry = Entries.Find(ProfileUrl);
+	if (Entry != nullptr && Entry->RefCount > 0)
+		--Entry->RefCount;
+}
+
+bool SBChatAvatarAtlas::Find(const FString& ProfileUrl, UTexture2DDynamic*& OutPage, FVector2D& OutUVMin, FVector2D& OutUVMax)
+{
+	FEntry* Entry = Entries.Find(ProfileUrl);
+	if (Entry == nullptr || Entry->Page == INDEX_NONE)
+		return false;
+
+	Entry->LastUsed = ++UseClock;
+
+	// Half a texel in from the edges keeps bilinear filtering from reading the neighbouring avatars.
+	const float SlotUV = (float)SLOT_SIZE / PAGE_SIZE;
+	const float HalfTexel = 0.5f / PAGE_SIZE;
+	const FVector2D Origin((Entry->Slot % SLOTS_PER_ROW) * SlotUV, (Entry->Slot / SLOTS_PER_ROW) * SlotUV);
+
+	OutPage = Pages[Entry->Page].Texture;
+	OutUVMin = Origin + FVector2D(HalfTexel, HalfTexel);
+	OutUVMax = Origin + FVector2D(SlotUV - HalfTexel, SlotUV - HalfTexel);
+	return true;
+}
+
+//+ FGCObject
+void SBChatAvatarAtlas::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	for (FPage& Page : Pages)
+		Collector.AddReferencedObject(Page.Texture);
+}
+//- FGCObject
+
+//+ private
+bool SBChatAvatarAtlas::Tick(float DeltaTime)
+{
+	SyncWithUserList();
+	FlushUploads();
+	return true;
+}
+
+void SBChatAvatarAtlas::SyncWithUserList()
+{
+	const uint32 Version = UserDirectory.GetVersion();
+	if (bUserListSynced && Version == UserListVersion)
+		return;
+
+	bUserListSynced = true;
+	UserListVersion = Version;
+
+	TArray<SBDUser> Users;
+	UserDirectory.GetUsers(Users);
+
+	TSet<FString> Urls;
+	Urls.Reserve(Users.Num());
+	for (const SBDUser& User : Users)
+	{
+		FString ProfileUrl = SBChatStringTable::Convert(User.profile_url);
+		if (!ProfileUrl.IsEmpty())
+			Urls.Add(MoveTemp(ProfileUrl));
+	}
+
+	for (const FString& ProfileUrl : UserListUrls)
+	{
+		if (!Urls.Contains(ProfileUrl))
+			Release(ProfileUrl);
+	}
+
+	for (const FString& ProfileUrl : Urls)
+	{
+		if (!UserListUrls.Contains(ProfileUrl))
+			Acquire(ProfileUrl);
+	}
+
+	UserListUrls = MoveTemp(Urls);
+	Repack();
+}
+
+void SBChatAvatarAtlas::Load(const FString& ProfileUrl, FEntry& Entry)
+{
+	Entry.bLoading = true;
+
+	const uint32 LoadGeneration = Generation;
+	ProfileTextures.LoadImage(ProfileUrl, [this, ProfileUrl, LoadGeneration](TSharedPtr<const SBChatProfileTextureCache::FImage, ESPMode::ThreadSafe> Image) {
+		if (LoadGeneration != Generation)
+			return;
+
+		if (!Image.IsValid())
+		{
+			FinishLoad(ProfileUrl, LoadGeneration, TArray<FColor>());
+			return;
+		}
+
+		// Cropping and downscaling a full profile image is too much for the game thread.
+		Async(EAsyncExecution::ThreadPool, [this, ProfileUrl, LoadGeneration, Image]() {
+			TArray<FColor> Pixels;
+			if (!ToSlotPixels(Image->Width, Image->Height, Image->Pixels, Pixels))
+				Pixels.Reset();
+
+			AsyncTask(ENamedThreads::GameThread, [this, ProfileUrl, LoadGeneration, Pixels = MoveTemp(Pixels)]() mutable {
+				FinishLoad(ProfileUrl, LoadGeneration, MoveTemp(Pixels));
+			});
+		});
+	});
+}
+
+void SBChatAvatarAtlas::FinishLoad(const FString& ProfileUrl, uint32 LoadGeneration, TArray<FColor>&& Pixels)
+{
+	if (LoadGeneration != Generation)
+		return;
+
+	FEntry* Loaded = Entries.Find(ProfileUrl);
+	if (Loaded == nullptr)
+		return;
+
+	Loaded->bLoading = false;
+	if (Pixels.Num() == 0)
+	{
+		// Nothing to draw; the row keeps its placeholder, and a later Acquire tries again.
+		if (Loaded->RefCount == 0)
+			Entries.Remove(ProfileUrl);
+		return;
+	}
+
+	Loaded->Pixels = MoveTemp(Pixels);
+	Place(ProfileUrl, MaxPages);
+}
+
+bool SBChatAvatarAtlas::Place(const FString& ProfileUrl, int32 PageLimit)
+{
+	int32 Page = INDEX_NONE;
+	int32 Slot = INDEX_NONE;
+	if (!AllocateSlot(ProfileUrl, PageLimit, Page, Slot))
+		return false;
+
+	// AllocateSlot may have evicted other entries, so the entry is looked up again rather than passed in.
+	FEntry& Placed = Entries.FindChecked(ProfileUrl);
+	Placed.Page = Page;
+	Placed.Slot = Slot;
+	QueueUpload(Placed);
+	++Revision;
+	return true;
+}
+
+bool SBChatAvatarAtlas::AllocateSlot(const FString& ProfileUrl, int32 PageLimit, int32& OutPage, int32& OutSlot)
+{
+	const int32 NumPages = FMath::Min(Pages.Num(), PageLimit);
+	for (int32 PageIndex = 0; PageIndex < NumPages; ++PageIndex)
+	{
+		if (Pages[PageIndex].FreeSlots.Num() > 0)
+		{
+			OutPage = PageIndex;
+			OutSlot = Pages[PageIndex].FreeSlots.Pop(false);
+			return true;
+		}
+	}
+
+	if (Pages.Num() < PageLimit)
+	{
+		UTexture2DDynamic* Texture = UTexture2DDynamic::Create(PAGE_SIZE, PAGE_SIZE);
+		if (Texture == nullptr)
+			return false;
+
+		Texture->SRGB = true;
+		Texture->UpdateResource();
+
+		FPage& Page = Pages.AddDefaulted_GetRef();
+		Page.Texture = Texture;
+		// Popped from the end, so slots fill the page top-left first.
+		Page.FreeSlots.Reserve(SLOTS_PER_PAGE);
+		for (int32 Slot = SLOTS_PER_PAGE - 1; Slot >= 0; --Slot)
+			Page.FreeSlots.Add(Slot);
+
+		OutPage = Pages.Num() - 1;
+		OutSlot = Page.FreeSlots.Pop(false);
+		return true;
+	}
+
+	// Every page is full: take the slot of the least recently used avatar nobody lists anymore.
+	const FString* EvictUrl = nullptr;
+	uint64 OldestUse = MAX_uint64;
+	for (const TPair<FString, FEntry>& Pair : Entries)
+	{
+		const FEntry& Entry = Pair.Value;
+		if (Entry.RefCount == 0 && Entry.Page != INDEX_NONE && Entry.Page < PageLimit && Entry.LastUsed < OldestUse && Pair.Key != ProfileUrl)
+		{
+			EvictUrl = &Pair.Key;
+			OldestUse = Entry.LastUsed;
+		}
+	}
+
+	if (EvictUrl == nullptr)
+		return false;
+
+	const FString EvictedUrl = *EvictUrl;
+	const FEntry& Evicted = Entries.FindChecked(EvictedUrl);
+	OutPage = Evicted.Page;
+	OutSlot = Evicted.Slot;
+	Entries.Remove(EvictedUrl);
+	return true;
+}
+
+void SBChatAvatarAtlas::FreeSlot(FEntry& Entry)
+{
+	if (Entry.Page == INDEX_NONE)
+		return;
+
+	Pages[Entry.Page].FreeSlots.Add(Entry.Slot);
+	Entry.Page = INDEX_NONE;
+	Entry.Slot = INDEX_NONE;
+}
+
+void SBChatAvatarAtlas::Repack()
+{
+	// Pages needed by the avatars that are still listed, including those that didn't fit before.
+	int32 Listed = 0;
+	for (const TPair<FString, FEntry>& Pair : Entries)
+	{
+		if (Pair.Value.RefCount > 0 && (Pair.Value.Page != INDEX_NONE || Pair.Value.Pixels.Num() > 0))
+			++Listed;
+	}
+
+	const int32 TargetPages = FMath::Clamp(FMath::DivideAndRoundUp(Listed, SLOTS_PER_PAGE), 1, MaxPages);
+	if (TargetPages < Pages.Num())
+	{
+		TArray<FString> Moving;
+		for (auto It = Entries.CreateIterator(); It; ++It)
+		{
+			FEntry& Entry = It.Value();
+			if (Entry.Page == INDEX_NONE || Entry.Page < TargetPages)
+				continue;
+
+			if (Entry.RefCount == 0)
+			{
+				It.RemoveCurrent();
+				continue;
+			}
+
+			FreeSlot(Entry);
+			Moving.Add(It.Key());
+		}
+
+		for (int32 PageIndex = TargetPages; PageIndex < Pages.Num(); ++PageIndex)
+			PendingUploads.Remove(PageIndex);
+		Pages.SetNum(TargetPages);
+
+		for (const FString& ProfileUrl : Moving)
+			Place(ProfileUrl, TargetPages);
+
+		++Revision;
+	}
+
+	// Listed avatars that found every page full get another chance now that slots may have been freed.
+	TArray<FString> Unplaced;
+	for (const TPair<FString, FEntry>& Pair : Entries)
+	{
+		if (Pair.Value.RefCount > 0 && Pair.Value.Page == INDEX_NONE && Pair.Value.Pixels.Num() > 0)
+			Unplaced.Add(Pair.Key);
+	}
+
+	for (const FString& ProfileUrl : Unplaced)
+	{
+		if (!Place(ProfileUrl, MaxPages))
+			break;
+	}
+}
+
+void SBChatAvatarAtlas::QueueUpload(const FEntry& Entry)
+{
+	PendingUploads.FindOrAdd(Entry.Page).Add({ Entry.Slot, Entry.Pixels });
+}
+
+void SBChatAvatarAtlas::FlushUploads()
+{
+	// One render command per page and frame, however many avatars arrived during it.
+	for (auto It = PendingUploads.CreateIterator(); It; ++It)
+	{
+		// A page whose resource isn't there yet keeps its uploads for a later frame.
+		FTexture2DDynamicResource* TextureResource = static_cast<FTexture2DDynamicResource*>(Pages[It.Key()].Texture->GetResource());
+		if (TextureResource == nullptr)
+			continue;
+
+		ENQUEUE_RENDER_COMMAND(FSBChatUpdateAvatarAtlas)(
+			[TextureResource, Uploads = MoveTemp(It.Value())](FRHICommandListImmediate& RHICmdList) {
+				FRHITexture* Texture = TextureResource->GetTexture2DRHI();
+				if (Texture == nullptr)
+					return;
+
+				for (const FUpload& Upload : Uploads)
+				{
+					const FUpdateTextureRegion2D Region((Upload.Slot % SLOTS_PER_ROW) * SLOT_SIZE, (Upload.Slot / SLOTS_PER_ROW) * SLOT_SIZE, 0, 0, SLOT_SIZE, SLOT_SIZE);
+					RHIUpdateTexture2D(Texture, 0, Region, SLOT_SIZE * sizeof(FColor), reinterpret_cast<const uint8*>(Upload.Pixels.GetData()));
+				}
+			});
+		It.RemoveCurrent();
+	}
+}
+
+bool SBChatAvatarAtlas::ToSlotPixels(int32 Width, int32 Height, const TArray<FColor>& Pixels, TArray<FColor>& OutPixels)
+{
+	if (Width <= 0 || Height <= 0 || Pixels.Num() < Width * Height)
+		return false;
+
+	// Avatars are drawn as squares, so the centre square is kept.
+	const int32 Side = FMath::Min(Width, Height);
+	const int32 OffsetX = (Width - Side) / 2;
+	const int32 OffsetY = (Height - Side) / 2;
+
+	TArray<FColor> Square;
+	Square.SetNumUninitialized(Side * Side);
+	for (int32 Row = 0; Row < Side; ++Row)
+		FMemory::Memcpy(&Square[Row * Side], &Pixels[(OffsetY + Row) * Width + OffsetX], Side * sizeof(FColor));
+
+	SBChatThumbnail::Resize(Square, Side, Side, SLOT_SIZE, SLOT_SIZE, OutPixels);
+	return OutPixels.Num() == SLOT_SIZE * SLOT_SIZE;
+}
+//- private
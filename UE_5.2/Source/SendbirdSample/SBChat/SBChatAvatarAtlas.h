@@ -0,0 +1,106 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "UObject/GCObject.h"
+
+class UTexture2DDynamic;
+class SBChatProfileTextureCache;
+class SBChatUserDirectory;
+
+// Optional mode that draws profile images out of shared atlas pages instead of one texture per row.
+// Every page is a PAGE_SIZE texture split into SLOT_SIZE squares; an avatar is cropped to a square, downscaled into
+// one slot and handed out as the page plus a UV rect. Once per frame the atlas follows the user list: users that
+// appear are loaded through the profile texture cache, users that are gone leave their slot to be evicted
+// (least recently used first) when a page is full. When the avatars still listed fit in fewer pages, they are moved
+// down and the trailing pages released; moved avatars get new UVs, which bumps the revision.
+// Game thread only, apart from cropping and downscaling the loaded images, which runs on the pool.
+class SBChatAvatarAtlas : public FGCObject
+{
+public:
+	static const int32 PAGE_SIZE = 1024;
+	static const int32 SLOT_SIZE = 64;
+	static const int32 SLOTS_PER_ROW = PAGE_SIZE / SLOT_SIZE;
+	static const int32 SLOTS_PER_PAGE = SLOTS_PER_ROW * SLOTS_PER_ROW;
+	static const int32 DEFAULT_MAX_PAGES = 4;
+
+	SBChatAvatarAtlas(SBChatProfileTextureCache& InProfileTextures, SBChatUserDirectory& InUserDirectory);
+	virtual ~SBChatAvatarAtlas();
+
+	void								Reset();
+	void								SetEnabled(bool bEnabled);
+	bool								IsEnabled() const { return TickerHandle.IsValid(); }
+	void								SetMaxPages(int32 InMaxPages);
+	int32								GetNumPages() const { return Pages.Num(); }
+	int32								Num() const { return Entries.Num(); }
+	// Changes whenever an avatar lands in or moves to a slot; rows holding UVs look them up again when it does.
+	uint32								GetRevision() const { return Revision; }
+
+	// Avatars listed by the user list are acquired automatically; other rows (e.g. message senders) acquire their own.
+	void								Acquire(const FString& ProfileUrl);
+	void								Release(const FString& ProfileUrl);
+
+	// False while the avatar is loading, failed or didn't fit; UVs are (U0, V0) - (U1, V1).
+	bool								Find(const FString& ProfileUrl, UTexture2DDynamic*& OutPage, FVector2D& OutUVMin, FVector2D& OutUVMax);
+
+	//+ FGCObject
+	virtual void						AddReferencedObjects(FReferenceCollector& Collector) override;
+	virtual FString						GetReferencerName() const override { return TEXT("SBChatAvatarAtlas"); }
+	//- FGCObject
+
+private:
+	struct FPage
+	{
+		UTexture2DDynamic*				Texture = nullptr;
+		TArray<int32>					FreeSlots;
+	};
+
+	struct FEntry
+	{
+		int32							RefCount = 0;
+		int32							Page = INDEX_NONE;
+		int32							Slot = INDEX_NONE;
+		uint64							LastUsed = 0;
+		bool							bLoading = false;
+		TArray<FColor>					Pixels;		// SLOT_SIZE x SLOT_SIZE, kept to re-upload when repacked
+	};
+
+	struct FUpload
+	{
+		int32							Slot;
+		TArray<FColor>					Pixels;
+	};
+
+	bool								Tick(float DeltaTime);
+	void								SyncWithUserList();
+	void								Load(const FString& ProfileUrl, FEntry& Entry);
+	// Takes the slot pixels made on the pool; empty when the image couldn't be drawn.
+	void								FinishLoad(const FString& ProfileUrl, uint32 LoadGeneration, TArray<FColor>&& Pixels);
+	bool								Place(const FString& ProfileUrl, int32 PageLimit);
+	bool								AllocateSlot(const FString& ProfileUrl, int32 PageLimit, int32& OutPage, int32& OutSlot);
+	void								FreeSlot(FEntry& Entry);
+	void								Repack();
+	void								QueueUpload(const FEntry& Entry);
+	void								FlushUploads();
+	// Crops the centre square and scales it to SLOT_SIZE; runs on the pool.
+	static bool							ToSlotPixels(int32 Width, int32 Height, const TArray<FColor>& Pixels, TArray<FColor>& OutPixels);
+
+private:
+	SBChatProfileTextureCache&			ProfileTextures;
+	SBChatUserDirectory&				UserDirectory;
+	FTSTicker::FDelegateHandle			TickerHandle;
+
+	TMap<FString, FEntry>				Entries;
+	TArray<FPage>						Pages;
+	TMap<int32, TArray<FUpload>>		PendingUploads;		// by page
+	int32								MaxPages;
+	uint64								UseClock;
+	uint32								Revision;
+	uint32								Generation;
+
+	bool								bUserListSynced;
+	uint32								UserListVersion;
+	TSet<FString>						UserListUrls;
+};
@@ -0,0 +1,272 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+#include "../SendbirdSample.h"
+#include "Sendbird/SendbirdTranscode.h"
+#include "SBChatManager.h"
+#include "SBChatMessageProjection.h"
+#include "SBChatSearchIndex.h"
+#include "SBChatStats.h"
+#include "SBChatStringTable.h"
+#include "SBChatThumbnail.h"
+#include "ImageUtils.h"
+#include <codecvt>
+#include <locale>
+
+#if !UE_BUILD_SHIPPING
+
+namespace SBChatBenchmark
+{
+	struct FPayload
+	{
+		const TCHAR*			Name;
+		std::wstring			Text;
+	};
+
+	static TArray<FPayload> MakeTranscodePayloads()
+	{
+		TArray<FPayload> Payloads;
+		Payloads.Add({ TEXT("ascii"), L"See you at the lobby in 5 minutes, bring the new deck!" });
+		Payloads.Add({ TEXT("korean"), L"안녕하세요, 오늘 저녁에 같이 게임할래요? 준비되면 알려주세요." });
+		Payloads.Add({ TEXT("cjk"), L"今日のイベントは午後三時からです。我们在大厅见面。" });
+		Payloads.Add({ TEXT("emoji"), L"gg \U0001F600 wp \U0001F44D nice \U0001F525\U0001F525 rematch? \U0001F3AE" });
+
+		std::wstring Long;
+		for (const FPayload& Payload : Payloads)
+			Long += Payload.Text;
+		Payloads.Add({ TEXT("mixed-long"), Long + Long + Long + Long });
+		return Payloads;
+	}
+
+	template<typename FunctionType>
+	static double MeasureSeconds(int32 Iterations, FunctionType&& Function)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+			Function();
+		return FPlatformTime::Seconds() - StartTime;
+	}
+
+	static void RunTranscode(const TArray<FString>& Args)
+	{
+		const int32 Iterations = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100000;
+
+		UE_LOG(SendbirdSample, Display, TEXT("[SBChatBenchmark] Transcode, %d iterations per payload (MB/s of wchar_t input)"), Iterations);
+		UE_LOG(SendbirdSample, Display, TEXT("%-12s %12s %12s %12s %12s"), TEXT("payload"), TEXT("wstr_convert"), TEXT("WCHAR_TO_TCHAR"), TEXT("Transcode"), TEXT("ToWString"));
+
+		for (const FPayload& Payload : MakeTranscodePayloads())
+		{
+			const double Megabytes = (double)Payload.Text.size() * sizeof(wchar_t) * Iterations / (1024.0 * 1024.0);
+			const FString Source = SendbirdTranscode::ToFString(Payload.Text);
+			int64 Sink = 0;
+
+			PRAGMA_DISABLE_DEPRECATION_WARNINGS
+			const double ConvertSeconds = MeasureSeconds(Iterations, [&Payload, &Sink]() {
+				Sink += FString(UTF8_TO_TCHAR(std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes(Payload.Text).c_str())).Len();
+			});
+			PRAGMA_ENABLE_DEPRECATION_WARNINGS
+
+			const double MacroSeconds = MeasureSeconds(Iterations, [&Payload, &Sink]() {
+				Sink += FString(WCHAR_TO_TCHAR(Payload.Text.c_str())).Len();
+			});
+
+			const double TranscodeSeconds = MeasureSeconds(Iterations, [&Payload, &Sink]() {
+				Sink += SendbirdTranscode::ToFString(Payload.Text).Len();
+			});
+
+			const double WidenSeconds = MeasureSeconds(Iterations, [&Source, &Sink]() {
+				Sink += (int64)SendbirdTranscode::ToWString(Source).size();
+			});
+
+			UE_LOG(SendbirdSample, Display, TEXT("%-12s %12.1f %12.1f %12.1f %12.1f (%lld)"), Payload.Name,
+				Megabytes / ConvertSeconds, Megabytes / MacroSeconds, Megabytes / TranscodeSeconds, Megabytes / WidenSeconds, Sink);
+		}
+	}
+
+	static FAutoConsoleCommand TranscodeCommand(
+		TEXT("sbchat.Bench.Transcode"),
+		TEXT("Measures std::wstring <-> FString conversion throughput. Usage: sbchat.Bench.Transcode [Iterations]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RunTranscode));
+
+	// How SBChatManager built message infos before the projection stage: a switch per call site, a temporary
+	// FSBUserInfo, and a const result copied into the list.
+	static const FSBMessageInfo LegacyToMessageInfo(SBDBaseMessage* Message)
+	{
+#if WITH_SENDBIRD
+		FDateTime MessageTime = SBChatMessageProjection::ToDateTime(Message->updated_at != 0 ? Message->updated_at : Message->created_at);
+		if (Message->message_type == SBDMessageType::User)
+		{
+			SBDUserMessage* UserMessage = static_cast<SBDUserMessage*>(Message);
+			return FSBMessageInfo(Message->message_id, FSBUserInfo(UserMessage->sender),
+				(ESBMessageType)UserMessage->message_type, SBChatStringTable::Convert(UserMessage->message), MessageTime);
+		}
+		else if (Message->message_type == SBDMessageType::Admin)
+		{
+			SBDAdminMessage* AdminMessage = static_cast<SBDAdminMessage*>(Message);
+			return FSBMessageInfo(Message->message_id, FSBUserInfo(TEXT("Admin"), TEXT("Admin"), TEXT("")),
+				(ESBMessageType)AdminMessage->message_type, SBChatStringTable::Convert(AdminMessage->message), MessageTime);
+		}
+		else if (Message->message_type == SBDMessageType::File)
+		{
+			SBDFileMessage* FileMessage = static_cast<SBDFileMessage*>(Message);
+			return FSBMessageInfo(Message->message_id, FSBUserInfo(FileMessage->sender),
+				(ESBMessageType)FileMessage->message_type, SBChatStringTable::Convert(FileMessage->name), MessageTime);
+		}
+#endif
+		return FSBMessageInfo();
+	}
+
+	static void RunProjection(const TArray<FString>& Args)
+	{
+		const int32 Iterations = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 1000;
+
+		TArray<SBDBaseMessage*> Messages;
+		SBChatManager::Get().GetHistoryMessages().ForEach([&Messages](SBDBaseMessage* Message) {
+			Messages.Add(Message);
+		});
+
+		if (Messages.Num() == 0)
+		{
+			UE_LOG(SendbirdSample, Display, TEXT("[SBChatBenchmark] Projection needs messages; open a channel first."));
+			return;
+		}
+
+		// The way GetPreviousMessageList filled its list before and after.
+		TArray<FSBMessageInfo> MessageInfos;
+		uint64 Allocations = 0;
+		bool bCountsAllocations = SBChatStats::GetAllocationCount(Allocations);
+		uint64 AllocationsAfter = 0;
+		const double LegacySeconds = MeasureSeconds(Iterations, [&Messages, &MessageInfos]() {
+			MessageInfos.Empty();
+			for (SBDBaseMessage* Message : Messages)
+			{
+				const FSBMessageInfo AddedMessage = LegacyToMessageInfo(Message);
+				MessageInfos.Add(AddedMessage);
+			}
+		});
+		bCountsAllocations &= SBChatStats::GetAllocationCount(AllocationsAfter);
+		const uint64 LegacyAllocations = AllocationsAfter - Allocations;
+
+		MessageInfos.Empty();
+		SBChatStats::GetAllocationCount(Allocations);
+		const double ProjectionSeconds = MeasureSeconds(Iterations, [&Messages, &MessageInfos]() {
+			MessageInfos.Reset(Messages.Num());
+			for (SBDBaseMessage* Message : Messages)
+				SBChatMessageProjection::ProjectInto(Message, MessageInfos);
+		});
+		SBChatStats::GetAllocationCount(AllocationsAfter);
+		const uint64 ProjectionAllocations = AllocationsAfter - Allocations;
+
+		const double Count = (double)Messages.Num() * Iterations;
+		auto AllocsPerMessage = [bCountsAllocations, Count](uint64 Calls) {
+			return bCountsAllocations ? FString::Printf(TEXT("%.2f"), Calls / Count) : FString(TEXT("n/a"));
+		};
+		UE_LOG(SendbirdSample, Display, TEXT("[SBChatBenchmark] Projection, %d messages x %d iterations"), Messages.Num(), Iterations);
+		UE_LOG(SendbirdSample, Display, TEXT("%-12s %12s %12s"), TEXT("path"), TEXT("ns/message"), TEXT("allocs/message"));
+		UE_LOG(SendbirdSample, Display, TEXT("%-12s %12.1f %12s"), TEXT("legacy"), LegacySeconds * 1e9 / Count, *AllocsPerMessage(LegacyAllocations));
+		UE_LOG(SendbirdSample, Display, TEXT("%-12s %12.1f %12s"), TEXT("projection"), ProjectionSeconds * 1e9 / Count, *AllocsPerMessage(ProjectionAllocations));
+	}
+
+	static FAutoConsoleCommand ProjectionCommand(
+		TEXT("sbchat.Bench.Projection"),
+		TEXT("Compares allocations and time per message of the message projection against the old per-call-site conversion, over the focused channel's history. Usage: sbchat.Bench.Projection [Iterations]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RunProjection));
+
+	// Fills an index of its own with chat-like messages, so it doesn't need a connection or touch the session's.
+	static void RunSearch(const TArray<FString>& Args)
+	{
+		const int32 MessageCount = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100000;
+
+		static const TCHAR* Words[] = {
+			TEXT("guild"), TEXT("raid"), TEXT("tonight"), TEXT("boss"), TEXT("loot"), TEXT("healer"), TEXT("tank"), TEXT("need"),
+			TEXT("anyone"), TEXT("online"), TEXT("dungeon"), TEXT("quest"), TEXT("trade"), TEXT("sword"), TEXT("gold"), TEXT("ready"),
+			TEXT("wipe"), TEXT("again"), TEXT("lol"), TEXT("gg"), TEXT("invite"), TEXT("party"), TEXT("level"), TEXT("event"),
+			TEXT("\x4ECA\x591C"), TEXT("\x30EC\x30A4\x30C9"), TEXT("\xAE38\xB4DC"), TEXT("\x4E00\x7DD2\x306B"),
+		};
+
+		FRandomStream Random(1234);
+		TArray<FSBUserInfo> Senders;
+		for (int32 Index = 0; Index < 64; ++Index)
+			Senders.Add(FSBUserInfo(FString::Printf(TEXT("user%d"), Index), FString::Printf(TEXT("Player%d"), Index), FString()));
+
+		SBChatSearchIndex SearchIndex;
+		const double BuildStartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < MessageCount; ++Index)
+		{
+			FString Text;
+			const int32 WordCount = Random.RandRange(3, 12);
+			for (int32 Word = 0; Word < WordCount; ++Word)
+			{
+				if (Word > 0)
+					Text += TEXT(" ");
+				Text += Words[Random.RandHelper((int32)UE_ARRAY_COUNT(Words))];
+			}
+
+			// Message ids are unique per channel on the server; here they are unique overall.
+			SearchIndex.Put((uint64)Index + 1, FString::Printf(TEXT("channel%d"), Index % 16), (int64)Index * 1000, 0,
+				ESBMessageType::SBDMessageTypeUser, Senders[Random.RandHelper(Senders.Num())], Text);
+		}
+		const double BuildSeconds = FPlatformTime::Seconds() - BuildStartTime;
+
+		UE_LOG(SendbirdSample, Display, TEXT("[SBChatBenchmark] Search, %d messages indexed in %.1f ms"), MessageCount, BuildSeconds * 1000.0);
+		SearchIndex.Report(*GLog);
+
+		static const TCHAR* Queries[] = {
+			TEXT("raid"), TEXT("gu"), TEXT("g"), TEXT("healer tank"), TEXT("\"boss loot\""), TEXT("\"need healer\" ton"),
+			TEXT("\x30EC\x30A4"), TEXT("\x4ECA\x591C \xAE38\xB4DC"), TEXT("nothingmatches"),
+		};
+
+		const int32 Iterations = 20;
+		UE_LOG(SendbirdSample, Display, TEXT("%-24s %12s %12s"), TEXT("query"), TEXT("ms/query"), TEXT("results"));
+		for (const TCHAR* Query : Queries)
+		{
+			TArray<FSBSearchResult> Results;
+			const double Seconds = MeasureSeconds(Iterations, [&SearchIndex, &Results, Query]() {
+				SearchIndex.Search(Query, FString(), SBChatSearchIndex::DEFAULT_MAX_RESULTS, Results);
+			});
+			UE_LOG(SendbirdSample, Display, TEXT("%-24s %12.3f %12d"), Query, Seconds * 1000.0 / Iterations, Results.Num());
+		}
+	}
+
+	static FAutoConsoleCommand SearchCommand(
+		TEXT("sbchat.Bench.Search"),
+		TEXT("Times indexing and prefix, phrase and CJK queries over a synthetic message index. Usage: sbchat.Bench.Search [Messages]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RunSearch));
+
+	static void RunThumbnail(const TArray<FString>& Args)
+	{
+		const int32 Iterations = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 20;
+
+		// A phone photo, noisy enough that nothing is flat.
+		const int32 SrcWidth = 4032;
+		const int32 SrcHeight = 3024;
+		TArray<FColor> Source;
+		Source.SetNumUninitialized(SrcWidth * SrcHeight);
+		FRandomStream Random(1234);
+		for (FColor& Pixel : Source)
+			Pixel = FColor((uint8)Random.RandHelper(256), (uint8)Random.RandHelper(256), (uint8)Random.RandHelper(256), 255);
+
+		static const int32 Targets[] = { 160, 480, SBChatThumbnail::MAX_DIMENSION };
+		UE_LOG(SendbirdSample, Display, TEXT("%-10s %16s %16s"), TEXT("target"), TEXT("ImageResize ms"), TEXT("halving ms"));
+		for (const int32 Target : Targets)
+		{
+			const FIntPoint Size = SBChatThumbnail::FitWithin(SrcWidth, SrcHeight, Target, Target);
+			TArray<FColor> Pixels;
+			const double LegacySeconds = MeasureSeconds(Iterations, [&Source, &Pixels, &Size]() {
+				FImageUtils::ImageResize(SrcWidth, SrcHeight, Source, Size.X, Size.Y, Pixels, false);
+			});
+			const double HalvingSeconds = MeasureSeconds(Iterations, [&Source, &Pixels, &Size]() {
+				SBChatThumbnail::Resize(Source, SrcWidth, SrcHeight, Size.X, Size.Y, Pixels);
+			});
+			UE_LOG(SendbirdSample, Display, TEXT("%4d x %-4d %16.2f %16.2f"), Size.X, Size.Y, LegacySeconds * 1000.0 / Iterations, HalvingSeconds * 1000.0 / Iterations);
+		}
+	}
+
+	static FAutoConsoleCommand ThumbnailCommand(
+		TEXT("sbchat.Bench.Thumbnail"),
+		TEXT("Times downscaling a 4032x3024 image to thumbnail sizes, ImageResize alone against halving first. Usage: sbchat.Bench.Thumbnail [Iterations]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RunThumbnail));
+}
+
+#endif
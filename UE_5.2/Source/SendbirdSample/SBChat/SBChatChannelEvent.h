@@ -27,6 +27,23 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category = "SBChatChannelEvent")
 	void OnMessageUpdated(const FSBMessageInfo& MessageInfo);
 
+	// The server acked a message sent through the outbox: MessageInfo replaces the echo shown as LocalMessageID.
+	// If a row with MessageInfo's MessageID is already shown, the echo is just removed.
+	UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category = "SBChatChannelEvent")
+	void OnMessageSent(int64 LocalMessageID, const FSBMessageInfo& MessageInfo);
+
+	// A file sent with USBChat::SendFileMessage moved on; BytesSent is TotalBytes once it is Succeeded.
+	UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category = "SBChatChannelEvent")
+	void OnFileUploadProgress(int32 UploadID, ESBFileUploadState State, int64 BytesSent, int64 TotalBytes);
+
+	// The connection dropped, is being brought back, or is back; once per change, on the game thread.
+	UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category = "SBChatChannelEvent")
+	void OnConnectionStateChanged(ESBConnectionState State);
+
+	// Unread counts changed; at most once a frame, with only the channels that changed.
+	UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category = "SBChatChannelEvent")
+	void OnUnreadCountsChanged(const FSBUnreadCounts& Counts);
+
 	UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category = "SBChatChannelEvent")
 	void OnUserJoined(const FSBUserInfo& UserInfo);
 
@@ -41,4 +58,17 @@ public:
 
 	UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category = "SBChatChannelEvent")
 	void OnInvitationReceived(const FSBChannelInfo& ChannelInfo, const TArray<FSBUserInfo>& UserInfos);
+
+	// Batched variants, delivered instead of the per-event callbacks when batch delivery is enabled.
+	UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category = "SBChatChannelEvent")
+	void OnMessagesReceivedBatch(const TArray<FSBMessageInfo>& MessageInfos);
+
+	UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category = "SBChatChannelEvent")
+	void OnMessagesUpdatedBatch(const TArray<FSBMessageInfo>& MessageInfos);
+
+	UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category = "SBChatChannelEvent")
+	void OnMessagesDeletedBatch(const TArray<int64>& MessageIDs);
+
+	UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category = "SBChatChannelEvent")
+	void OnUsersChangedBatch(ESBChannelUserHandlerType HandlerType, const TArray<FSBUserInfo>& UserInfos);
 };
@@ -0,0 +1,242 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#include "SBChatChannelRegistry.h"
+#include "SBChatStringTable.h"
+#include "Sendbird/SendbirdTranscode.h"
+
+SBChatChannelRegistry::SBChatChannelRegistry()
+{
+	NextSequence = 0;
+}
+
+void SBChatChannelRegistry::Reset()
+{
+	FScopeLock ScopeLock(&Lock);
+	Entries.Empty();
+	UrlByChannel.Empty();
+	OpenRecency.Empty();
+	GroupRecency.Empty();
+}
+
+void SBChatChannelRegistry::ResetChannels(bool bGroupChannels)
+{
+	FScopeLock ScopeLock(&Lock);
+	for (const FRecencyKey& Key : GetRecency(bGroupChannels))
+	{
+		FString ChannelUrl;
+		if (UrlByChannel.RemoveAndCopyValue(Key.Channel, ChannelUrl))
+			Entries.Remove(ChannelUrl);
+	}
+	GetRecency(bGroupChannels).Empty();
+}
+
+int32 SBChatChannelRegistry::Num() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Entries.Num();
+}
+
+int32 SBChatChannelRegistry::Num(bool bGroupChannels) const
+{
+	FScopeLock ScopeLock(&Lock);
+	return GetRecency(bGroupChannels).Num();
+}
+
+void SBChatChannelRegistry::Add(SBDBaseChannel* Channel)
+{
+#if WITH_SENDBIRD
+	if (!ensure(Channel))
+		return;
+
+	const FSBChatStringRef ChannelUrlRef = SBChatStringTable::Get().Intern(Channel->channel_url);
+	const FString& ChannelUrl = *ChannelUrlRef;
+	if (!ensureMsgf(!ChannelUrl.IsEmpty(), TEXT("[SBChatChannelRegistry::Add] Empty channel_url!!")))
+		return;
+
+	FScopeLock ScopeLock(&Lock);
+	if (FEntry* Existing = Entries.Find(ChannelUrl))
+	{
+		if (Existing->Channel == Channel)
+			return;
+
+		// The SDK handed out a new object for the same channel; keep its place in the recency index.
+		TArray<FRecencyKey>& Recency = GetRecency(Existing->Channel->is_group_channel);
+		const int32 Index = IndexOf(Recency, *Existing);
+		if (ensure(Index != INDEX_NONE))
+			Recency[Index].Channel = Channel;
+
+		UrlByChannel.Remove(Existing->Channel);
+		UrlByChannel.Add(Channel, ChannelUrl);
+		Existing->Channel = Channel;
+		return;
+	}
+
+	FEntry Entry;
+	Entry.Channel = Channel;
+	Entry.LastMessageTime = Channel->created_at;
+	Entry.Sequence = ++NextSequence;
+
+	TArray<FRecencyKey>& Recency = GetRecency(Channel->is_group_channel);
+	Recency.Insert({ Entry.LastMessageTime, Entry.Sequence, Channel }, LowerBound(Recency, Entry.LastMessageTime, Entry.Sequence));
+	Entries.Add(ChannelUrl, Entry);
+	UrlByChannel.Add(Channel, ChannelUrl);
+#endif
+}
+
+bool SBChatChannelRegistry::Remove(const FString& ChannelUrl)
+{
+	FScopeLock ScopeLock(&Lock);
+	const FEntry* Entry = Entries.Find(ChannelUrl);
+	if (Entry == nullptr)
+		return false;
+
+	RemoveEntry(ChannelUrl, *Entry);
+	return true;
+}
+
+SBDBaseChannel* SBChatChannelRegistry::Find(const FString& ChannelUrl) const
+{
+	FScopeLock ScopeLock(&Lock);
+	const FEntry* Entry = Entries.Find(ChannelUrl);
+	return Entry != nullptr ? Entry->Channel : nullptr;
+}
+
+SBDOpenChannel* SBChatChannelRegistry::FindOpenChannel(const FString& ChannelUrl) const
+{
+#if WITH_SENDBIRD
+	SBDBaseChannel* Channel = Find(ChannelUrl);
+	if (Channel == nullptr || !Channel->is_open_channel)
+		return nullptr;
+
+	return static_cast<SBDOpenChannel*>(Channel);
+#else
+	return nullptr;
+#endif
+}
+
+SBDGroupChannel* SBChatChannelRegistry::FindGroupChannel(const FString& ChannelUrl) const
+{
+#if WITH_SENDBIRD
+	SBDBaseChannel* Channel = Find(ChannelUrl);
+	if (Channel == nullptr || !Channel->is_group_channel)
+		return nullptr;
+
+	return static_cast<SBDGroupChannel*>(Channel);
+#else
+	return nullptr;
+#endif
+}
+
+bool SBChatChannelRegistry::Contains(SBDBaseChannel* Channel) const
+{
+	FScopeLock ScopeLock(&Lock);
+	return UrlByChannel.Contains(Channel);
+}
+
+SBDBaseChannel* SBChatChannelRegistry::FindByName(bool bGroupChannels, int32 Index, const FString& Name) const
+{
+#if WITH_SENDBIRD
+	FScopeLock ScopeLock(&Lock);
+	TArray<const FEntry*> Registered;
+	Registered.Reserve(GetRecency(bGroupChannels).Num());
+	for (const TPair<FString, FEntry>& Pair : Entries)
+	{
+		if (Pair.Value.Channel->is_group_channel == bGroupChannels)
+			Registered.Add(&Pair.Value);
+	}
+	Registered.Sort([](const FEntry& A, const FEntry& B) { return A.Sequence < B.Sequence; });
+
+	if (Registered.IsValidIndex(Index) && Name.Compare(SendbirdTranscode::ToFString(Registered[Index]->Channel->name)) == 0)
+		return Registered[Index]->Channel;
+
+	SBDBaseChannel* Found = nullptr;
+	for (const FEntry* Entry : Registered)
+	{
+		if (Name.Compare(SendbirdTranscode::ToFString(Entry->Channel->name)) != 0)
+			continue;
+
+		if (Found != nullptr)
+			return nullptr;
+
+		Found = Entry->Channel;
+	}
+	return Found;
+#else
+	return nullptr;
+#endif
+}
+
+void SBChatChannelRegistry::Touch(SBDBaseChannel* Channel, int64 MessageTime)
+{
+#if WITH_SENDBIRD
+	FScopeLock ScopeLock(&Lock);
+	const FString* ChannelUrl = UrlByChannel.Find(Channel);
+	if (ChannelUrl == nullptr)
+		return;
+
+	FEntry& Entry = Entries.FindChecked(*ChannelUrl);
+	if (MessageTime <= Entry.LastMessageTime)
+		return;
+
+	TArray<FRecencyKey>& Recency = GetRecency(Channel->is_group_channel);
+	const int32 Index = IndexOf(Recency, Entry);
+	if (!ensure(Index != INDEX_NONE))
+		return;
+
+	Recency.RemoveAt(Index, 1, false);
+	Entry.LastMessageTime = MessageTime;
+	Recency.Insert({ Entry.LastMessageTime, Entry.Sequence, Channel }, LowerBound(Recency, Entry.LastMessageTime, Entry.Sequence));
+#endif
+}
+
+void SBChatChannelRegistry::GetRecent(bool bGroupChannels, int32 MaxCount, TArray<SBDBaseChannel*>& OutChannels) const
+{
+	FScopeLock ScopeLock(&Lock);
+	const TArray<FRecencyKey>& Recency = GetRecency(bGroupChannels);
+	const int32 Count = MaxCount > 0 ? FMath::Min(MaxCount, Recency.Num()) : Recency.Num();
+
+	OutChannels.Reset(Count);
+	for (int32 Index = 0; Index < Count; ++Index)
+		OutChannels.Add(Recency[Index].Channel);
+}
+
+//+ private
+int32 SBChatChannelRegistry::LowerBound(const TArray<FRecencyKey>& Recency, int64 LastMessageTime, uint64 Sequence) const
+{
+	// Newest first: the first key that doesn't come before (LastMessageTime, Sequence) in descending order.
+	int32 Low = 0;
+	int32 High = Recency.Num();
+	while (Low < High)
+	{
+		const int32 Middle = Low + (High - Low) / 2;
+		const FRecencyKey& Key = Recency[Middle];
+		if (Key.LastMessageTime > LastMessageTime || (Key.LastMessageTime == LastMessageTime && Key.Sequence > Sequence))
+			Low = Middle + 1;
+		else
+			High = Middle;
+	}
+	return Low;
+}
+
+int32 SBChatChannelRegistry::IndexOf(const TArray<FRecencyKey>& Recency, const FEntry& Entry) const
+{
+	const int32 Index = LowerBound(Recency, Entry.LastMessageTime, Entry.Sequence);
+	if (Index < Recency.Num() && Recency[Index].Sequence == Entry.Sequence)
+		return Index;
+
+	return INDEX_NONE;
+}
+
+void SBChatChannelRegistry::RemoveEntry(const FString& ChannelUrl, const FEntry& Entry)
+{
+#if WITH_SENDBIRD
+	TArray<FRecencyKey>& Recency = GetRecency(Entry.Channel->is_group_channel);
+	const int32 Index = IndexOf(Recency, Entry);
+	if (ensure(Index != INDEX_NONE))
+		Recency.RemoveAt(Index, 1, false);
+
+	UrlByChannel.Remove(Entry.Channel);
+	Entries.Remove(ChannelUrl);
+#endif
+}
+//- private
@@ -0,0 +1,67 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Sendbird/include/Sendbird.h"
+
+// Open and group channels known to the sample, keyed by channel_url.
+// Blueprint refers to a channel through FSBChannelHandle, so a handle keeps resolving to the same channel when a list
+// reloads or reorders. Each channel type also keeps a secondary index ordered by last-message time, newest first.
+// Completion handlers and channel handlers run on SDK threads, so every call takes the registry lock.
+class SBChatChannelRegistry
+{
+public:
+	SBChatChannelRegistry();
+
+	void								Reset();
+	void								ResetChannels(bool bGroupChannels);
+	int32								Num() const;
+	int32								Num(bool bGroupChannels) const;
+
+	// Adds the channel, or replaces the object registered under its channel_url.
+	void								Add(SBDBaseChannel* Channel);
+	bool								Remove(const FString& ChannelUrl);
+
+	SBDBaseChannel*						Find(const FString& ChannelUrl) const;
+	SBDOpenChannel*						FindOpenChannel(const FString& ChannelUrl) const;
+	SBDGroupChannel*					FindGroupChannel(const FString& ChannelUrl) const;
+	bool								Contains(SBDBaseChannel* Channel) const;
+
+	// For callers that still address a channel by list position and name. Index counts channels of the type in the order
+	// they were registered; a channel there with a different name falls back to the only channel carrying Name.
+	SBDBaseChannel*						FindByName(bool bGroupChannels, int32 Index, const FString& Name) const;
+
+	// Moves a registered channel in the recency index. Older times than the one already known are ignored.
+	void								Touch(SBDBaseChannel* Channel, int64 MessageTime);
+	void								GetRecent(bool bGroupChannels, int32 MaxCount, TArray<SBDBaseChannel*>& OutChannels) const;
+
+private:
+	struct FEntry
+	{
+		SBDBaseChannel*					Channel;
+		int64							LastMessageTime;
+		uint64							Sequence;
+	};
+
+	struct FRecencyKey
+	{
+		int64							LastMessageTime;
+		uint64							Sequence;
+		SBDBaseChannel*					Channel;
+	};
+
+	TArray<FRecencyKey>&				GetRecency(bool bGroupChannels) { return bGroupChannels ? GroupRecency : OpenRecency; }
+	const TArray<FRecencyKey>&			GetRecency(bool bGroupChannels) const { return bGroupChannels ? GroupRecency : OpenRecency; }
+	int32								LowerBound(const TArray<FRecencyKey>& Recency, int64 LastMessageTime, uint64 Sequence) const;
+	int32								IndexOf(const TArray<FRecencyKey>& Recency, const FEntry& Entry) const;
+	void								RemoveEntry(const FString& ChannelUrl, const FEntry& Entry);
+
+private:
+	mutable FCriticalSection			Lock;
+	TMap<FString, FEntry>				Entries;
+	TMap<SBDBaseChannel*, FString>		UrlByChannel;
+	TArray<FRecencyKey>					OpenRecency;
+	TArray<FRecencyKey>					GroupRecency;
+	uint64								NextSequence;
+};
@@ -20,3 +20,43 @@ enum class ESBChannelUserHandlerType : uint8
 	UserJoined,
 	UserLeft,
 };
+
+UENUM(BlueprintType)
+enum class ESBMessageSendingStatus : uint8
+{
+	Succeeded,
+	Pending,
+	Failed,
+};
+
+// What the send limiter does with a message that is over the rate limit.
+UENUM(BlueprintType)
+enum class ESBSendOverflowPolicy : uint8
+{
+	Queue,		// wait for a token, up to the queue limit
+	Coalesce,	// merge what waits in the channel into one message
+	Drop,		// fail the send
+};
+
+// Where a file sent with USBChat::SendFileMessage is.
+UENUM(BlueprintType)
+enum class ESBFileUploadState : uint8
+{
+	Queued,		// waiting for an upload slot or a send token
+	Preparing,	// reading the file's size and type
+	Uploading,
+	Succeeded,
+	Failed,
+	Cancelled,
+};
+
+// Where the connection followed by SBChatConnection is.
+UENUM(BlueprintType)
+enum class ESBConnectionState : uint8
+{
+	Closed,			// not connected yet, or disconnected on purpose
+	Connected,
+	Reconnecting,	// the SDK, or an attempt of ours, is at it
+	WaitingToRetry,	// backing off until the next attempt
+	Offline,		// the platform reports no network; waiting for it
+};
@@ -4,6 +4,7 @@
 
 #include "Sendbird/include/Sendbird.h"
 #include "SBChatCommonEnum.h"
+#include "SBChatStringTable.h"
 #include "SBChatCommonStruct.generated.h"
 
 USTRUCT(BlueprintType)
@@ -14,8 +15,9 @@ struct FSBUserInfo
 	FSBUserInfo() : UserID(TEXT("")), NickName(TEXT("")), ProfileUrl(TEXT("")) {}
 	FSBUserInfo(const FString& InUserID, const FString& InNickName, const FString& InProfileUrl)
 		: UserID(InUserID), NickName(InNickName), ProfileUrl(InProfileUrl) {}
-	FSBUserInfo(SBDUser* User) : FSBUserInfo(WCHAR_TO_TCHAR(User->user_id.c_str()), WCHAR_TO_TCHAR(User->nickname.c_str()), WCHAR_TO_TCHAR(User->profile_url.c_str())) {}
-	FSBUserInfo(SBDUser User) : FSBUserInfo(&User) {}
+	FSBUserInfo(const SBDUser* User)
+		: UserID(SBChatStringTable::Convert(User->user_id)), NickName(SBChatStringTable::Convert(User->nickname)), ProfileUrl(SBChatStringTable::Convert(User->profile_url)) {}
+	FSBUserInfo(const SBDUser& User) : FSBUserInfo(&User) {}
 
 	void Init()
 	{
@@ -32,6 +34,24 @@ struct FSBUserInfo
 	FString ProfileUrl;
 };
 
+// Stable reference to a channel, resolved through SBChatChannelRegistry by channel url.
+USTRUCT(BlueprintType)
+struct FSBChannelHandle
+{
+	GENERATED_USTRUCT_BODY()
+
+	FSBChannelHandle() : ChannelUrl(TEXT("")), IsGroupChannel(false) {}
+	FSBChannelHandle(SBDBaseChannel* Channel)
+		: ChannelUrl(SBChatStringTable::Convert(Channel->channel_url)), IsGroupChannel(Channel->is_group_channel) {}
+
+	bool IsValid() const { return !ChannelUrl.IsEmpty(); }
+
+	UPROPERTY(BlueprintReadOnly)
+	FString ChannelUrl;
+	UPROPERTY(BlueprintReadOnly)
+	bool IsGroupChannel;
+};
+
 USTRUCT(BlueprintType)
 struct FSBChannelInfo
 {
@@ -41,8 +61,9 @@ struct FSBChannelInfo
 		: Name(TEXT("")), IsGroupChannel(false), MemberCount(0), UnreadMessageCount(0) {}
 	FSBChannelInfo(const FString& InName, bool InIsGroupChannel = false, int InMemberCount = 1, int InUnreadMessageCount = 0)
 		: Name(InName), IsGroupChannel(InIsGroupChannel), MemberCount(InMemberCount), UnreadMessageCount(InUnreadMessageCount) {}
-	FSBChannelInfo(SBDBaseChannel* Channel) : FSBChannelInfo(WCHAR_TO_TCHAR(Channel->name.c_str()), Channel->is_group_channel)
+	FSBChannelInfo(SBDBaseChannel* Channel) : FSBChannelInfo(SBChatStringTable::Convert(Channel->name), Channel->is_group_channel)
 	{
+		Handle = FSBChannelHandle(Channel);
 		if (IsGroupChannel)
 		{
 			SBDGroupChannel* GroupChannel = static_cast<SBDGroupChannel*>(Channel);
@@ -64,17 +85,55 @@ struct FSBChannelInfo
 	int MemberCount;						
 	UPROPERTY(BlueprintReadWrite)
 	int UnreadMessageCount;
+	UPROPERTY(BlueprintReadOnly)
+	FSBChannelHandle Handle;
 }; 
 
+USTRUCT(BlueprintType)
+struct FSBThumbnailInfo
+{
+	GENERATED_USTRUCT_BODY()
+
+	FSBThumbnailInfo() : MaxWidth(0), MaxHeight(0), RealWidth(0), RealHeight(0), Url(TEXT("")) {}
+
+	UPROPERTY(BlueprintReadWrite)
+	int64 MaxWidth;
+	UPROPERTY(BlueprintReadWrite)
+	int64 MaxHeight;
+	UPROPERTY(BlueprintReadWrite)
+	int64 RealWidth;
+	UPROPERTY(BlueprintReadWrite)
+	int64 RealHeight;
+	UPROPERTY(BlueprintReadWrite)
+	FString Url;
+};
+
+USTRUCT(BlueprintType)
+struct FSBFileInfo
+{
+	GENERATED_USTRUCT_BODY()
+
+	FSBFileInfo() : Url(TEXT("")), Size(0), MimeType(TEXT("")) {}
+
+	UPROPERTY(BlueprintReadWrite)
+	FString Url;
+	UPROPERTY(BlueprintReadWrite)
+	int64 Size;
+	UPROPERTY(BlueprintReadWrite)
+	FString MimeType;
+	UPROPERTY(BlueprintReadWrite)
+	TArray<FSBThumbnailInfo> Thumbnails;
+};
+
 USTRUCT(BlueprintType)
 struct FSBMessageInfo
 {
 	GENERATED_USTRUCT_BODY()
 
 	FSBMessageInfo()
-		: MessageID(-1), UserInfo(FSBUserInfo()),MessageType(ESBMessageType::SBDMessageTypeUser), Message(TEXT("")), UpdatedTime(FDateTime::Now()) {}
+		: MessageID(-1), UserInfo(FSBUserInfo()),MessageType(ESBMessageType::SBDMessageTypeUser), Message(TEXT("")), UpdatedTime(FDateTime::Now()), SendingStatus(ESBMessageSendingStatus::Succeeded) {}
 	FSBMessageInfo(uint64 InMessageID, const FSBUserInfo& InUserInfo, ESBMessageType InMessageType, const FString& InMessage, const FDateTime& InUpdatedTime)
-		: MessageID(InMessageID), UserInfo(InUserInfo), MessageType(InMessageType), Message(InMessage), UpdatedTime(InUpdatedTime) {}
+		: MessageID(InMessageID), UserInfo(InUserInfo), MessageType(InMessageType), Message(InMessage), UpdatedTime(InUpdatedTime), SendingStatus(ESBMessageSendingStatus::Succeeded) {}
 
 	UPROPERTY(BlueprintReadWrite)
 	int64 MessageID;
@@ -86,4 +145,45 @@ struct FSBMessageInfo
 	FString Message;
 	UPROPERTY(BlueprintReadWrite)
 	FDateTime UpdatedTime;
+	// Pending and Failed messages are local echoes from the outbox; their MessageID is negative.
+	UPROPERTY(BlueprintReadWrite)
+	ESBMessageSendingStatus SendingStatus;
+	// Client request id of a message sent through the outbox, on its echo and its acked message; empty otherwise.
+	UPROPERTY(BlueprintReadWrite)
+	FString RequestID;
+	// File messages only; the file name is in Message.
+	UPROPERTY(BlueprintReadWrite)
+	FSBFileInfo File;
+};
+
+// A message found by USBChat::SearchMessages. File messages carry only their name.
+USTRUCT(BlueprintType)
+struct FSBSearchResult
+{
+	GENERATED_USTRUCT_BODY()
+
+	FSBSearchResult() : ChannelUrl(TEXT("")) {}
+
+	UPROPERTY(BlueprintReadOnly)
+	FString ChannelUrl;
+	UPROPERTY(BlueprintReadOnly)
+	FSBMessageInfo MessageInfo;
+};
+
+// Badge counts kept by the unread counter. Channels are keyed by channel url; custom types with no unread messages may
+// be missing.
+USTRUCT(BlueprintType)
+struct FSBUnreadCounts
+{
+	GENERATED_USTRUCT_BODY()
+
+	FSBUnreadCounts() : TotalCount(0) {}
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 TotalCount;
+	UPROPERTY(BlueprintReadOnly)
+	TMap<FString, int32> CountByCustomType;
+	// In OnUnreadCountsChanged, only the channels whose count changed since the last update.
+	UPROPERTY(BlueprintReadOnly)
+	TMap<FString, int32> ChannelCounts;
 };
@@ -0,0 +1,404 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#include "SBChatConnection.h"
+#include "SBChatManager.h"
+#include "SBChatChannelEvent.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/OutputDeviceRedirector.h"
+
+SBChatConnection::SBChatConnection()
+{
+	State = ESBConnectionState::Closed;
+	NotifiedState = ESBConnectionState::Closed;
+	bStarted = false;
+	bInBackground = false;
+	bOwnAttempt = false;
+	Backoff = 0;
+	NextAttemptTime = 0.0;
+	AttemptStartTime = 0.0;
+	DropTime = 0.0;
+	NextPollTime = 0.0;
+	ResumeSyncTime = 0.0;
+	// Seeded per client; clients seeded alike would back off in step and come back together anyway.
+	Random.Initialize((int32)GetTypeHash(FGuid::NewGuid()));
+}
+
+SBChatConnection::~SBChatConnection()
+{
+	Reset();
+}
+
+void SBChatConnection::Start()
+{
+#if WITH_SENDBIRD
+	SBDMain::AddConnectionHandler(L"SBChatConnection", this);
+#endif
+
+	FScopeLock ScopeLock(&Lock);
+
+	bStarted = true;
+	Events.Empty();
+	State = ESBConnectionState::Connected;
+	bOwnAttempt = false;
+	Backoff = 0;
+	DropTime = 0.0;
+	NextPollTime = 0.0;
+	ResumeSyncTime = 0.0;
+
+	if (!TickerHandle.IsValid())
+		TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &SBChatConnection::Tick));
+}
+
+void SBChatConnection::Reset()
+{
+	FScopeLock ScopeLock(&Lock);
+
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+	if (ForegroundHandle.IsValid())
+	{
+		FCoreDelegates::ApplicationHasEnteredForegroundDelegate.Remove(ForegroundHandle);
+		ForegroundHandle.Reset();
+	}
+	if (BackgroundHandle.IsValid())
+	{
+		FCoreDelegates::ApplicationWillEnterBackgroundDelegate.Remove(BackgroundHandle);
+		BackgroundHandle.Reset();
+	}
+
+	// Disconnecting on purpose is no drop, and the UI that asked for it isn't told.
+	bStarted = false;
+	Events.Empty();
+	State = ESBConnectionState::Closed;
+	NotifiedState = ESBConnectionState::Closed;
+	bOwnAttempt = false;
+	Backoff = 0;
+	DropTime = 0.0;
+	ResumeSyncTime = 0.0;
+	Stats = FStats();
+}
+
+ESBConnectionState SBChatConnection::GetState() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return State;
+}
+
+void SBChatConnection::ReconnectNow()
+{
+	FScopeLock ScopeLock(&Lock);
+
+	if (State == ESBConnectionState::WaitingToRetry || State == ESBConnectionState::Offline)
+	{
+		State = ESBConnectionState::WaitingToRetry;
+		NextAttemptTime = 0.0;
+	}
+}
+
+SBChatConnection::FStats SBChatConnection::GetStats() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Stats;
+}
+
+void SBChatConnection::Report(FOutputDevice& Ar) const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	const double Now = FPlatformTime::Seconds();
+	const double NextAttempt = State == ESBConnectionState::WaitingToRetry ? FMath::Max(NextAttemptTime - Now, 0.0) : 0.0;
+	Ar.Logf(TEXT("state %s, backoff %d, next attempt in %.1f s%s"), *UEnum::GetValueAsString(State), Backoff, NextAttempt,
+		bInBackground ? TEXT(", in background") : TEXT(""));
+
+	Ar.Logf(TEXT("drops %lld, reconnects %lld, attempts %lld (%lld failed), offline waits %lld"), Stats.Drops, Stats.Reconnects,
+		Stats.Attempts, Stats.FailedAttempts, Stats.OfflineWaits);
+
+	const double MeanSeconds = Stats.Reconnects > 0 ? Stats.TotalReconnectSeconds / Stats.Reconnects : 0.0;
+	Ar.Logf(TEXT("time to reconnect: last %.0f ms, mean %.0f ms, max %.0f ms"), Stats.LastReconnectSeconds * 1000.0, MeanSeconds * 1000.0,
+		Stats.MaxReconnectSeconds * 1000.0);
+}
+
+//+ SBDConnectionHandler
+void SBChatConnection::Started()
+{
+	FScopeLock ScopeLock(&Lock);
+	if (bStarted)
+		Events.Add(EEvent::Started);
+}
+
+void SBChatConnection::Succeeded()
+{
+	FScopeLock ScopeLock(&Lock);
+	if (bStarted)
+		Events.Add(EEvent::Succeeded);
+}
+
+void SBChatConnection::Failed()
+{
+	FScopeLock ScopeLock(&Lock);
+	if (bStarted)
+		Events.Add(EEvent::Failed);
+}
+//- SBDConnectionHandler
+
+//+ private
+bool SBChatConnection::Tick(float DeltaTime)
+{
+	// Start runs on the SDK's thread, so the app lifecycle delegates are only bound here.
+	if (!ForegroundHandle.IsValid())
+		ForegroundHandle = FCoreDelegates::ApplicationHasEnteredForegroundDelegate.AddRaw(this, &SBChatConnection::OnEnteredForeground);
+	if (!BackgroundHandle.IsValid())
+		BackgroundHandle = FCoreDelegates::ApplicationWillEnterBackgroundDelegate.AddRaw(this, &SBChatConnection::OnEnteredBackground);
+
+	const double Now = FPlatformTime::Seconds();
+	bool bResumeSync = false;
+	bool bNotify = false;
+	ESBConnectionState NotifyState = ESBConnectionState::Closed;
+	{
+		FScopeLock ScopeLock(&Lock);
+
+		for (EEvent Event : Events)
+			Apply(Event, Now);
+		Events.Reset();
+
+		if (Now >= NextPollTime)
+		{
+			NextPollTime = Now + POLL_SECONDS;
+			Poll(Now);
+		}
+
+		if (State == ESBConnectionState::WaitingToRetry && Now >= NextAttemptTime && !bInBackground)
+			Attempt(Now);
+
+		if (ResumeSyncTime > 0.0 && Now >= ResumeSyncTime)
+		{
+			ResumeSyncTime = 0.0;
+			bResumeSync = State == ESBConnectionState::Connected;
+		}
+
+		if (State != NotifiedState)
+		{
+			NotifiedState = State;
+			NotifyState = State;
+			bNotify = true;
+		}
+	}
+
+	// Both call out of this class, so neither runs under the lock.
+	if (bResumeSync)
+		SBChatManager::Get().SyncChannels();
+
+	if (bNotify)
+	{
+		TWeakObjectPtr<UObject> ChannelEvent = SBChatManager::Get().GetChannelEvent();
+		if (ChannelEvent.IsValid() && ensure(ChannelEvent->GetClass()->ImplementsInterface(USBChatChannelEvent::StaticClass())))
+			ISBChatChannelEvent::Execute_OnConnectionStateChanged(ChannelEvent.Get(), NotifyState);
+	}
+	return true;
+}
+
+void SBChatConnection::Apply(EEvent Event, double Now)
+{
+	switch (Event)
+	{
+	case EEvent::Started:
+		// From Connected it is the SDK noticing the drop; otherwise an attempt, its or ours, getting going.
+		if (State == ESBConnectionState::Connected)
+		{
+			Drop(Now);
+			bOwnAttempt = false;
+		}
+		State = ESBConnectionState::Reconnecting;
+		break;
+
+	case EEvent::Succeeded:
+		if (DropTime > 0.0)
+		{
+			const double Seconds = Now - DropTime;
+			++Stats.Reconnects;
+			Stats.LastReconnectSeconds = Seconds;
+			Stats.TotalReconnectSeconds += Seconds;
+			Stats.MaxReconnectSeconds = FMath::Max(Stats.MaxReconnectSeconds, Seconds);
+
+			// Spread like the reconnections, or every client a blip dropped would sync at once.
+			ResumeSyncTime = Now + Random.FRandRange(0.0f, RESUME_SYNC_SPREAD_SECONDS);
+		}
+		State = ESBConnectionState::Connected;
+		bOwnAttempt = false;
+		Backoff = 0;
+		DropTime = 0.0;
+		break;
+
+	case EEvent::Failed:
+		if (bOwnAttempt)
+			++Stats.FailedAttempts;
+		bOwnAttempt = false;
+		Drop(Now);
+		RetryAfterBackoff(Now);
+		break;
+	}
+}
+
+void SBChatConnection::Poll(double Now)
+{
+#if WITH_SENDBIRD
+	switch (State)
+	{
+	case ESBConnectionState::Reconnecting:
+	case ESBConnectionState::WaitingToRetry:
+		// Back some way the handlers didn't report, e.g. a connect of the app's own.
+		if (SBDMain::GetConnectionState() == SBDConnectionState::Open)
+		{
+			Apply(EEvent::Succeeded, Now);
+		}
+		else if (State == ESBConnectionState::Reconnecting && bOwnAttempt && Now - AttemptStartTime > ATTEMPT_TIMEOUT_SECONDS)
+		{
+			++Stats.FailedAttempts;
+			bOwnAttempt = false;
+			RetryAfterBackoff(Now);
+		}
+		else if (State == ESBConnectionState::WaitingToRetry && !IsNetworkReachable())
+		{
+			++Stats.OfflineWaits;
+			State = ESBConnectionState::Offline;
+		}
+		break;
+
+	case ESBConnectionState::Offline:
+		// The network is back, so the failures before tell nothing about the next attempt.
+		if (IsNetworkReachable())
+		{
+			Backoff = 0;
+			RetrySoon(Now);
+		}
+		break;
+
+	default:
+		break;
+	}
+#endif
+}
+
+void SBChatConnection::Attempt(double Now)
+{
+	if (!IsNetworkReachable())
+	{
+		++Stats.OfflineWaits;
+		State = ESBConnectionState::Offline;
+		return;
+	}
+
+	++Stats.Attempts;
+	bOwnAttempt = true;
+	AttemptStartTime = Now;
+	State = ESBConnectionState::Reconnecting;
+
+#if WITH_SENDBIRD
+	// False when there is nothing to reconnect, e.g. no user; that is retried like a failed attempt.
+	if (!SBDMain::Reconnect())
+	{
+		++Stats.FailedAttempts;
+		bOwnAttempt = false;
+		RetryAfterBackoff(Now);
+	}
+#endif
+}
+
+void SBChatConnection::Drop(double Now)
+{
+	if (DropTime > 0.0)
+		return;
+
+	DropTime = Now;
+	Backoff = 0;
+	++Stats.Drops;
+}
+
+void SBChatConnection::RetryAfterBackoff(double Now)
+{
+	if (!IsNetworkReachable())
+	{
+		++Stats.OfflineWaits;
+		State = ESBConnectionState::Offline;
+		return;
+	}
+
+	// Full jitter: anywhere from now to the exponential bound.
+	const float Bound = FMath::Min(MAX_BACKOFF_SECONDS, BASE_BACKOFF_SECONDS * (float)(1 << FMath::Min(Backoff, 16)));
+	NextAttemptTime = Now + Random.FRandRange(0.0f, Bound);
+	++Backoff;
+	State = ESBConnectionState::WaitingToRetry;
+}
+
+void SBChatConnection::RetrySoon(double Now)
+{
+	const double SoonTime = Now + Random.FRandRange(0.0f, FAST_RESUME_SECONDS);
+	if (State != ESBConnectionState::WaitingToRetry || SoonTime < NextAttemptTime)
+		NextAttemptTime = SoonTime;
+	State = ESBConnectionState::WaitingToRetry;
+}
+
+bool SBChatConnection::IsNetworkReachable() const
+{
+	// Desktop platforms can't tell and say Unknown; only a definite no holds attempts back.
+	const ENetworkConnectionType Type = FPlatformMisc::GetNetworkConnectionType();
+	return Type != ENetworkConnectionType::None && Type != ENetworkConnectionType::AirplaneMode;
+}
+
+void SBChatConnection::OnEnteredForeground()
+{
+	FScopeLock ScopeLock(&Lock);
+
+	bInBackground = false;
+	if (!bStarted)
+		return;
+
+	const double Now = FPlatformTime::Seconds();
+	if (State == ESBConnectionState::WaitingToRetry)
+	{
+		RetrySoon(Now);
+	}
+#if WITH_SENDBIRD
+	else if (State == ESBConnectionState::Connected && SBDMain::GetConnectionState() == SBDConnectionState::Closed)
+	{
+		// Mobile platforms close sockets in the background, often before the SDK notices.
+		Drop(Now);
+		RetrySoon(Now);
+	}
+#endif
+}
+
+void SBChatConnection::OnEnteredBackground()
+{
+	FScopeLock ScopeLock(&Lock);
+	bInBackground = true;
+}
+//- private
+
+#if !UE_BUILD_SHIPPING
+
+namespace SBChatConnectionCommands
+{
+	static void ShowConnection(const TArray<FString>& Args)
+	{
+		SBChatConnection& Connection = SBChatManager::Get().GetConnection();
+		if (Args.Num() > 0 && Args[0] == TEXT("reconnect"))
+		{
+			Connection.ReconnectNow();
+			return;
+		}
+
+		Connection.Report(*GLog);
+	}
+
+	static FAutoConsoleCommand ConnectionCommand(
+		TEXT("sbchat.Connection"),
+		TEXT("Prints the connection state, drops, reconnect attempts and time to reconnect. Usage: sbchat.Connection [reconnect]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&ShowConnection));
+}
+
+#endif
@@ -0,0 +1,106 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Sendbird/include/Sendbird.h"
+#include "SBChatCommonEnum.h"
+
+// The connection's lifecycle from USBChat::Connect on, and what brings it back after a drop.
+// The SDK reconnects by itself when the socket drops (Started, then Succeeded or Failed). Once it gives up, the next
+// attempts are SBDMain::Reconnect calls spaced by exponential backoff with full jitter: attempt n waits a random time
+// up to min(MAX_BACKOFF_SECONDS, BASE_BACKOFF_SECONDS * 2^n), so the clients one server blip dropped don't all come
+// back in the same second.
+// The platform's network type is a reachability hint. With no network there are no attempts; when it comes back, or
+// the app returns to the foreground, the next attempt is brought forward to a random moment within
+// FAST_RESUME_SECONDS. Nothing is attempted while the app is in the background.
+// Once reconnected, every channel with history held (focused or subscribed) is synced from its watermark, after a
+// random moment within RESUME_SYNC_SPREAD_SECONDS; the outbox follows the connection itself. The time from the drop to
+// Succeeded is recorded; sbchat.Connection prints it.
+// The SDK's callbacks only queue what happened; the state machine runs on the game thread's ticker.
+class SBChatConnection : public SBDConnectionHandler
+{
+public:
+	static constexpr float BASE_BACKOFF_SECONDS			= 1.0f;
+	static constexpr float MAX_BACKOFF_SECONDS			= 60.0f;
+	static constexpr float FAST_RESUME_SECONDS			= 2.0f;
+	static constexpr float RESUME_SYNC_SPREAD_SECONDS	= 1.0f;
+	// An attempt of ours the SDK says nothing about for this long counts as failed.
+	static constexpr float ATTEMPT_TIMEOUT_SECONDS		= 30.0f;
+	// How often the SDK's connection state and the network type are looked at.
+	static constexpr float POLL_SECONDS					= 1.0f;
+
+	struct FStats
+	{
+		int64							Drops = 0;
+		int64							Reconnects = 0;
+		int64							Attempts = 0;			// SBDMain::Reconnect calls of ours
+		int64							FailedAttempts = 0;
+		int64							OfflineWaits = 0;
+		double							LastReconnectSeconds = 0.0;
+		double							TotalReconnectSeconds = 0.0;
+		double							MaxReconnectSeconds = 0.0;
+	};
+
+	SBChatConnection();
+	virtual ~SBChatConnection();
+
+	// Starts following the connection; called once connected.
+	void								Start();
+	void								Reset();
+
+	ESBConnectionState					GetState() const;
+	// Attempts on the next tick, skipping what is left of the backoff; for a retry button.
+	void								ReconnectNow();
+
+	FStats								GetStats() const;
+	void								Report(FOutputDevice& Ar) const;
+
+	//+ SBDConnectionHandler
+	virtual void						Started() override;
+	virtual void						Succeeded() override;
+	virtual void						Failed() override;
+	//- SBDConnectionHandler
+
+private:
+	enum class EEvent : uint8
+	{
+		Started,
+		Succeeded,
+		Failed,
+	};
+
+	bool								Tick(float DeltaTime);
+	void								Apply(EEvent Event, double Now);
+	void								Poll(double Now);
+	void								Attempt(double Now);
+	void								Drop(double Now);
+	void								RetryAfterBackoff(double Now);
+	void								RetrySoon(double Now);
+	bool								IsNetworkReachable() const;
+	void								OnEnteredForeground();
+	void								OnEnteredBackground();
+
+private:
+	mutable FCriticalSection			Lock;
+	// Filled by the SDK's threads, applied on the tick.
+	TArray<EEvent>						Events;
+	ESBConnectionState					State;
+	ESBConnectionState					NotifiedState;
+	bool								bStarted;
+	bool								bInBackground;
+	bool								bOwnAttempt;			// the attempt in progress is one of ours
+	int32								Backoff;				// attempts failed since the drop
+	double								NextAttemptTime;
+	double								AttemptStartTime;
+	double								DropTime;
+	double								NextPollTime;
+	double								ResumeSyncTime;			// 0 when no sync is due
+	FRandomStream						Random;
+	FStats								Stats;
+
+	FTSTicker::FDelegateHandle			TickerHandle;
+	FDelegateHandle						ForegroundHandle;
+	FDelegateHandle						BackgroundHandle;
+};
@@ -0,0 +1,278 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#include "SBChatEventQueue.h"
+#include "SBChatManager.h"
+#include "SBChatChannelEvent.h"
+#include "SBChatStats.h"
+
+SBChatEventQueue::SBChatEventQueue()
+{
+	QueueDepth = 0;
+	bBatchDelivery = false;
+	SetFrameBudget(DEFAULT_FRAME_BUDGET_MS);
+}
+
+SBChatEventQueue::~SBChatEventQueue()
+{
+	Stop();
+}
+
+void SBChatEventQueue::Start()
+{
+	if (TickerHandle.IsValid())
+		return;
+
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &SBChatEventQueue::Tick));
+}
+
+void SBChatEventQueue::Stop()
+{
+	if (!TickerHandle.IsValid())
+		return;
+
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	TickerHandle.Reset();
+}
+
+void SBChatEventQueue::Reset()
+{
+	Stop();
+
+	// Producers may still be enqueueing, so the depth only gives back what was actually drained.
+	FSBChatEvent Event;
+	while (Queue.Dequeue(Event))
+		--QueueDepth;
+	PendingBatch.Empty();
+}
+
+void SBChatEventQueue::EnqueueMessageReceived(FSBMessageInfo MessageInfo, double HandlerTime)
+{
+	FSBChatEvent Event;
+	Event.Type = ESBChatEventType::MessageReceived;
+	Event.MessageID = MessageInfo.MessageID;
+	Event.MessageInfo = MoveTemp(MessageInfo);
+	Enqueue(MoveTemp(Event), HandlerTime);
+}
+
+void SBChatEventQueue::EnqueueMessageUpdated(FSBMessageInfo MessageInfo, double HandlerTime)
+{
+	FSBChatEvent Event;
+	Event.Type = ESBChatEventType::MessageUpdated;
+	Event.MessageID = MessageInfo.MessageID;
+	Event.MessageInfo = MoveTemp(MessageInfo);
+	Enqueue(MoveTemp(Event), HandlerTime);
+}
+
+void SBChatEventQueue::EnqueueMessageDeleted(int64 MessageID, double HandlerTime)
+{
+	FSBChatEvent Event;
+	Event.Type = ESBChatEventType::MessageDeleted;
+	Event.MessageID = MessageID;
+	Enqueue(MoveTemp(Event), HandlerTime);
+}
+
+void SBChatEventQueue::EnqueueMessageSent(int64 LocalMessageID, FSBMessageInfo MessageInfo, double HandlerTime)
+{
+	FSBChatEvent Event;
+	Event.Type = ESBChatEventType::MessageSent;
+	Event.MessageID = LocalMessageID;
+	Event.MessageInfo = MoveTemp(MessageInfo);
+	Enqueue(MoveTemp(Event), HandlerTime);
+}
+
+void SBChatEventQueue::EnqueueUser(ESBChannelUserHandlerType HandlerType, const FSBUserInfo& UserInfo, double HandlerTime)
+{
+	FSBChatEvent Event;
+	Event.Type = ESBChatEventType::User;
+	Event.UserHandlerType = HandlerType;
+	Event.MessageID = -1;
+	Event.UserInfo = UserInfo;
+	Enqueue(MoveTemp(Event), HandlerTime);
+}
+
+//+ private
+void SBChatEventQueue::Enqueue(FSBChatEvent&& Event, double HandlerTime)
+{
+	Event.HandlerTime = HandlerTime > 0.0 ? HandlerTime : FPlatformTime::Seconds();
+
+	// Counted before it is visible, so the consumer's decrement can never take the depth below zero.
+	++QueueDepth;
+	Queue.Enqueue(MoveTemp(Event));
+}
+
+bool SBChatEventQueue::Tick(float DeltaTime)
+{
+	UObject* ChannelEvent = SBChatManager::Get().GetChannelEvent().Get();
+	const double Deadline = FPlatformTime::Seconds() + FrameBudgetSeconds;
+
+	// Always deliver at least one event per frame so a tiny budget can't stall the queue.
+	FSBChatEvent Event;
+	while (Queue.Dequeue(Event))
+	{
+		--QueueDepth;
+		if (ChannelEvent == nullptr)
+			continue;
+
+		// A sent message replaces one echo, so it has no batched variant.
+		if (!bBatchDelivery || Event.Type == ESBChatEventType::MessageSent)
+		{
+			if (PendingBatch.Num() > 0)
+				DispatchBatch(ChannelEvent, PendingBatch);
+
+			Dispatch(ChannelEvent, Event);
+			if (DispatchObserver)
+				NotifyDispatched(Event, FPlatformTime::Seconds());
+		}
+		else
+		{
+			// Consecutive events of the same kind form one batch, which keeps the overall ordering intact.
+			if (PendingBatch.Num() > 0 && (PendingBatch[0].Type != Event.Type || PendingBatch[0].UserHandlerType != Event.UserHandlerType))
+				DispatchBatch(ChannelEvent, PendingBatch);
+
+			PendingBatch.Add(MoveTemp(Event));
+		}
+
+		if (FPlatformTime::Seconds() >= Deadline)
+			break;
+	}
+
+	if (ChannelEvent != nullptr && PendingBatch.Num() > 0)
+		DispatchBatch(ChannelEvent, PendingBatch);
+
+	// The core ticker runs on the game thread, the only one that writes histories, so they are read here without a lock.
+	const SBChatHistoryStore& History = SBChatManager::Get().GetHistoryMessages();
+	SBChatStats::SampleFrame(QueueDepth.Load(), History.Num(), History.GetMemoryUsage());
+	return true;
+}
+
+void SBChatEventQueue::Dispatch(UObject* ChannelEvent, const FSBChatEvent& Event)
+{
+	INC_DWORD_STAT(STAT_SBChat_EventsDispatched);
+
+	switch (Event.Type)
+	{
+	case ESBChatEventType::MessageReceived:
+	{
+		SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_DispatchMessageReceived);
+		ISBChatChannelEvent::Execute_OnMessageReceived(ChannelEvent, Event.MessageInfo);
+		break;
+	}
+
+	case ESBChatEventType::MessageUpdated:
+	{
+		SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_DispatchMessageUpdated);
+		ISBChatChannelEvent::Execute_OnMessageUpdated(ChannelEvent, Event.MessageInfo);
+		break;
+	}
+
+	case ESBChatEventType::MessageDeleted:
+	{
+		SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_DispatchMessageDeleted);
+		ISBChatChannelEvent::Execute_OnMessageDeleted(ChannelEvent, Event.MessageID);
+		break;
+	}
+
+	case ESBChatEventType::MessageSent:
+	{
+		SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_DispatchMessageSent);
+		ISBChatChannelEvent::Execute_OnMessageSent(ChannelEvent, Event.MessageID, Event.MessageInfo);
+		break;
+	}
+
+	case ESBChatEventType::User:
+	{
+		SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_DispatchUser);
+		switch (Event.UserHandlerType)
+		{
+		case ESBChannelUserHandlerType::UserEntered:
+			ISBChatChannelEvent::Execute_OnUserEntered(ChannelEvent, Event.UserInfo);
+			break;
+
+		case ESBChannelUserHandlerType::UserExited:
+			ISBChatChannelEvent::Execute_OnUserExited(ChannelEvent, Event.UserInfo);
+			break;
+
+		case ESBChannelUserHandlerType::UserJoined:
+			ISBChatChannelEvent::Execute_OnUserJoined(ChannelEvent, Event.UserInfo);
+			break;
+
+		case ESBChannelUserHandlerType::UserLeft:
+			ISBChatChannelEvent::Execute_OnUserLeft(ChannelEvent, Event.UserInfo);
+			break;
+		}
+		break;
+	}
+	}
+}
+
+void SBChatEventQueue::DispatchBatch(UObject* ChannelEvent, TArray<FSBChatEvent>& Batch)
+{
+	INC_DWORD_STAT_BY(STAT_SBChat_EventsDispatched, Batch.Num());
+
+	switch (Batch[0].Type)
+	{
+	case ESBChatEventType::MessageReceived:
+	case ESBChatEventType::MessageUpdated:
+	{
+		TArray<FSBMessageInfo> MessageInfos;
+		MessageInfos.Reserve(Batch.Num());
+		for (FSBChatEvent& Event : Batch)
+			MessageInfos.Add(MoveTemp(Event.MessageInfo));
+
+		if (Batch[0].Type == ESBChatEventType::MessageReceived)
+		{
+			SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_DispatchMessageReceived);
+			ISBChatChannelEvent::Execute_OnMessagesReceivedBatch(ChannelEvent, MessageInfos);
+		}
+		else
+		{
+			SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_DispatchMessageUpdated);
+			ISBChatChannelEvent::Execute_OnMessagesUpdatedBatch(ChannelEvent, MessageInfos);
+		}
+		break;
+	}
+
+	case ESBChatEventType::MessageDeleted:
+	{
+		TArray<int64> MessageIDs;
+		MessageIDs.Reserve(Batch.Num());
+		for (const FSBChatEvent& Event : Batch)
+			MessageIDs.Add(Event.MessageID);
+
+		SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_DispatchMessageDeleted);
+		ISBChatChannelEvent::Execute_OnMessagesDeletedBatch(ChannelEvent, MessageIDs);
+		break;
+	}
+
+	case ESBChatEventType::MessageSent:
+		checkNoEntry();		// always dispatched on its own
+		break;
+
+	case ESBChatEventType::User:
+	{
+		TArray<FSBUserInfo> UserInfos;
+		UserInfos.Reserve(Batch.Num());
+		for (FSBChatEvent& Event : Batch)
+			UserInfos.Add(MoveTemp(Event.UserInfo));
+
+		SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_DispatchUser);
+		ISBChatChannelEvent::Execute_OnUsersChangedBatch(ChannelEvent, Batch[0].UserHandlerType, UserInfos);
+		break;
+	}
+	}
+
+	if (DispatchObserver)
+	{
+		const double Now = FPlatformTime::Seconds();
+		for (const FSBChatEvent& Event : Batch)
+			NotifyDispatched(Event, Now);
+	}
+
+	Batch.Reset();
+}
+
+void SBChatEventQueue::NotifyDispatched(const FSBChatEvent& Event, double Now)
+{
+	DispatchObserver(Event.Type, Now - Event.HandlerTime);
+}
+//- private
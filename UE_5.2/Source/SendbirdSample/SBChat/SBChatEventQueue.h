@@ -0,0 +1,75 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "Containers/Ticker.h"
+#include "SBChatCommonEnum.h"
+#include "SBChatCommonStruct.h"
+
+enum class ESBChatEventType : uint8
+{
+	MessageReceived,
+	MessageUpdated,
+	MessageDeleted,
+	MessageSent,
+	User,
+};
+
+struct FSBChatEvent
+{
+	ESBChatEventType					Type = ESBChatEventType::MessageReceived;
+	ESBChannelUserHandlerType			UserHandlerType = ESBChannelUserHandlerType::UserEntered;
+	int64								MessageID = -1;		// the echo's local id for MessageSent
+	FSBMessageInfo						MessageInfo;
+	FSBUserInfo							UserInfo;
+	double								HandlerTime = 0.0;		// FPlatformTime::Seconds() when the SDK called the handler
+};
+
+// Channel events are pushed into a lock-free queue from any thread and drained once per frame on the game thread.
+// The manager's handlers enqueue from the game thread, once they have applied the event to the history.
+class SBChatEventQueue
+{
+public:
+	static constexpr float DEFAULT_FRAME_BUDGET_MS = 2.0f;
+
+	// Called on the game thread for every delivered event with the seconds it spent between the handler and dispatch.
+	using FDispatchObserver = TFunction<void(ESBChatEventType, double)>;
+
+	SBChatEventQueue();
+	~SBChatEventQueue();
+
+	void								Start();
+	void								Stop();
+	void								Reset();
+
+	void								SetBatchDelivery(bool bInBatchDelivery) { bBatchDelivery = bInBatchDelivery; }
+	bool								IsBatchDelivery() const { return bBatchDelivery; }
+	void								SetFrameBudget(float Milliseconds) { FrameBudgetSeconds = FMath::Max(Milliseconds, 0.0f) / 1000.0; }
+	int32								GetQueueDepth() const { return QueueDepth.Load(); }
+	void								SetDispatchObserver(FDispatchObserver InObserver) { DispatchObserver = MoveTemp(InObserver); }
+
+	// HandlerTime is when the SDK called the handler behind the event; 0 takes the time of the call.
+	void								EnqueueMessageReceived(FSBMessageInfo MessageInfo, double HandlerTime = 0.0);
+	void								EnqueueMessageUpdated(FSBMessageInfo MessageInfo, double HandlerTime = 0.0);
+	void								EnqueueMessageDeleted(int64 MessageID, double HandlerTime = 0.0);
+	void								EnqueueMessageSent(int64 LocalMessageID, FSBMessageInfo MessageInfo, double HandlerTime = 0.0);
+	void								EnqueueUser(ESBChannelUserHandlerType HandlerType, const FSBUserInfo& UserInfo, double HandlerTime = 0.0);
+
+private:
+	void								Enqueue(FSBChatEvent&& Event, double HandlerTime);
+	bool								Tick(float DeltaTime);
+	void								Dispatch(UObject* ChannelEvent, const FSBChatEvent& Event);
+	void								DispatchBatch(UObject* ChannelEvent, TArray<FSBChatEvent>& Batch);
+	void								NotifyDispatched(const FSBChatEvent& Event, double Now);
+
+private:
+	TQueue<FSBChatEvent, EQueueMode::Mpsc>	Queue;
+	TAtomic<int32>						QueueDepth;
+	FTSTicker::FDelegateHandle			TickerHandle;
+	TArray<FSBChatEvent>				PendingBatch;
+	bool								bBatchDelivery;
+	double								FrameBudgetSeconds;
+	FDispatchObserver					DispatchObserver;
+};
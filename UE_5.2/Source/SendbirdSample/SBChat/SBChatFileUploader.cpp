@@ -0,0 +1,415 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#include "SBChatFileUploader.h"
+#include "SBChatManager.h"
+#include "SBChatThumbnail.h"
+#include "../SendbirdSample.h"
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "IImageWrapperModule.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+#include "Sendbird/SendbirdTranscode.h"
+
+SBChatFileUploader::SBChatFileUploader()
+{
+	MaxConcurrent = DEFAULT_MAX_CONCURRENT;
+	Active = 0;
+	LastUploadID = 0;
+	// A list row and a full-width preview.
+	ThumbnailSizes = { FIntPoint(160, 160), FIntPoint(480, 480) };
+	ImageWrapperModule = nullptr;
+}
+
+SBChatFileUploader::~SBChatFileUploader()
+{
+	Reset();
+}
+
+void SBChatFileUploader::Reset()
+{
+	FScopeLock ScopeLock(&Lock);
+
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+
+	// Uploads still with the SDK find nothing to complete and are dropped. Ids keep counting so they are never reused.
+	Uploads.Empty();
+	Active = 0;
+}
+
+void SBChatFileUploader::SetMaxConcurrent(int32 InMaxConcurrent)
+{
+	FScopeLock ScopeLock(&Lock);
+	MaxConcurrent = FMath::Max(InMaxConcurrent, 1);
+}
+
+void SBChatFileUploader::SetThumbnailSizes(const TArray<FIntPoint>& InThumbnailSizes)
+{
+	FScopeLock ScopeLock(&Lock);
+	ThumbnailSizes.Reset(InThumbnailSizes.Num());
+	for (const FIntPoint& Size : InThumbnailSizes)
+	{
+		if (Size.X > 0 && Size.Y > 0)
+			ThumbnailSizes.AddUnique(Size);
+	}
+}
+
+int32 SBChatFileUploader::Upload(SBDBaseChannel* Channel, const FString& FilePath, const FString& MimeType, FProgress OnProgress, FCompletion OnComplete)
+{
+	check(IsInGameThread());
+	if (!ensure(Channel))
+		return INDEX_NONE;
+
+	if (ImageWrapperModule == nullptr)
+		ImageWrapperModule = &FModuleManager::LoadModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
+
+	FScopeLock ScopeLock(&Lock);
+
+	FUpload& Upload = Uploads.AddDefaulted_GetRef();
+	Upload.UploadID = ++LastUploadID;
+	Upload.Channel = Channel;
+	Upload.ChannelUrl = SendbirdTranscode::ToFString(Channel->channel_url);
+	Upload.FilePath = FilePath;
+	Upload.MimeType = MimeType;
+	Upload.ThumbnailSizes = ThumbnailSizes;
+	Upload.OnProgress = MoveTemp(OnProgress);
+	Upload.OnComplete = MoveTemp(OnComplete);
+
+	if (!TickerHandle.IsValid())
+		TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &SBChatFileUploader::Tick));
+	return Upload.UploadID;
+}
+
+bool SBChatFileUploader::Cancel(int32 UploadID)
+{
+	check(IsInGameThread());
+
+	FUpload Cancelled;
+	{
+		FScopeLock ScopeLock(&Lock);
+
+		FUpload* Upload = Uploads.FindByPredicate([UploadID](const FUpload& Each) { return Each.UploadID == UploadID; });
+		if (Upload == nullptr || Upload->bCancelled)
+			return false;
+
+		// Started uploads are finished by whoever has them next, the preparation or the SDK.
+		if (Upload->State != ESBFileUploadState::Queued)
+		{
+			Upload->bCancelled = true;
+			return true;
+		}
+
+		TakeUpload(UploadID, Cancelled);
+	}
+
+	Finish(Cancelled, ESBFileUploadState::Cancelled, nullptr, nullptr);
+	return true;
+}
+
+void SBChatFileUploader::RemoveChannel(const FString& ChannelUrl)
+{
+	TArray<int32> UploadIDs;
+	{
+		FScopeLock ScopeLock(&Lock);
+		for (const FUpload& Upload : Uploads)
+		{
+			if (Upload.ChannelUrl == ChannelUrl)
+				UploadIDs.Add(Upload.UploadID);
+		}
+	}
+
+	// Channel handlers call this on the SDK's thread; cancelling happens on the game thread.
+	AsyncTask(ENamedThreads::GameThread, [this, UploadIDs]() {
+		for (int32 UploadID : UploadIDs)
+			Cancel(UploadID);
+	});
+}
+
+int32 SBChatFileUploader::Num()
+{
+	FScopeLock ScopeLock(&Lock);
+	return Uploads.Num();
+}
+
+FString SBChatFileUploader::GuessMimeType(const FString& FilePath)
+{
+	static const TMap<FString, FString> MimeTypes = {
+		{ TEXT("png"), TEXT("image/png") }, { TEXT("jpg"), TEXT("image/jpeg") }, { TEXT("jpeg"), TEXT("image/jpeg") },
+		{ TEXT("gif"), TEXT("image/gif") }, { TEXT("webp"), TEXT("image/webp") }, { TEXT("bmp"), TEXT("image/bmp") },
+		{ TEXT("mp4"), TEXT("video/mp4") }, { TEXT("webm"), TEXT("video/webm") }, { TEXT("mov"), TEXT("video/quicktime") },
+		{ TEXT("txt"), TEXT("text/plain") }, { TEXT("log"), TEXT("text/plain") }, { TEXT("json"), TEXT("application/json") },
+		{ TEXT("zip"), TEXT("application/zip") },
+	};
+
+	if (const FString* MimeType = MimeTypes.Find(FPaths::GetExtension(FilePath).ToLower()))
+		return *MimeType;
+
+	// No known extension: look at the first bytes.
+	uint8 Header[12] = {};
+	TUniquePtr<IFileHandle> File(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*FilePath));
+	if (File.IsValid() && File->Read(Header, sizeof(Header)))
+	{
+		if (Header[0] == 0x89 && Header[1] == 'P' && Header[2] == 'N' && Header[3] == 'G')
+			return TEXT("image/png");
+		if (Header[0] == 0xFF && Header[1] == 0xD8 && Header[2] == 0xFF)
+			return TEXT("image/jpeg");
+		if (Header[0] == 'G' && Header[1] == 'I' && Header[2] == 'F')
+			return TEXT("image/gif");
+		if (Header[0] == 'R' && Header[1] == 'I' && Header[2] == 'F' && Header[3] == 'F' && Header[8] == 'W' && Header[9] == 'E' && Header[10] == 'B' && Header[11] == 'P')
+			return TEXT("image/webp");
+		if (Header[4] == 'f' && Header[5] == 't' && Header[6] == 'y' && Header[7] == 'p')
+			return TEXT("video/mp4");
+	}
+	return TEXT("application/octet-stream");
+}
+
+//+ private
+bool SBChatFileUploader::Tick(float DeltaTime)
+{
+	SBChatSendLimiter& Limiter = SBChatManager::Get().GetSendLimiter();
+	const double Now = FPlatformTime::Seconds();
+
+	// Progress is reported once the lock is released, so it may cancel uploads.
+	TArray<TFunction<void()>> Notifications;
+	{
+		FScopeLock ScopeLock(&Lock);
+
+		for (FUpload& Upload : Uploads)
+		{
+			if (Active >= MaxConcurrent)
+				break;
+			if (Upload.State != ESBFileUploadState::Queued)
+				continue;
+
+			// A channel over the limit holds back only its own uploads.
+			if (!Limiter.TryAcquire(Upload.ChannelUrl))
+			{
+				if (Upload.BlockedSince == 0.0)
+				{
+					Upload.BlockedSince = Now;
+					Limiter.RecordDelayed(Upload.ChannelUrl);
+				}
+				continue;
+			}
+
+			if (Upload.BlockedSince != 0.0)
+				Limiter.RecordDelay(Upload.ChannelUrl, Now - Upload.BlockedSince);
+
+			Upload.State = ESBFileUploadState::Preparing;
+			++Active;
+			Prepare(Upload.UploadID, Upload.FilePath, Upload.MimeType, Upload.ThumbnailSizes);
+			if (Upload.OnProgress)
+				Notifications.Add([OnProgress = Upload.OnProgress, UploadID = Upload.UploadID]() { OnProgress(UploadID, ESBFileUploadState::Preparing, 0, 0); });
+		}
+	}
+
+	for (const TFunction<void()>& Notification : Notifications)
+		Notification();
+	return true;
+}
+
+void SBChatFileUploader::Prepare(int32 UploadID, const FString& FilePath, const FString& MimeType, const TArray<FIntPoint>& ThumbnailSizes)
+{
+	// File sizes can take a while on consoles and network drives, so neither is looked up on the game thread.
+	IImageWrapperModule* Wrapper = ImageWrapperModule;
+	Async(EAsyncExecution::ThreadPool, [this, UploadID, FilePath, MimeType, ThumbnailSizes, Wrapper]() {
+		const int64 FileSize = IFileManager::Get().FileSize(*FilePath);
+		const FString FileMimeType = (FileSize < 0 || !MimeType.IsEmpty()) ? MimeType : GuessMimeType(FilePath);
+
+		TArray<FLocalThumbnail> LocalThumbnails;
+		if (FileMimeType.StartsWith(TEXT("image/")) && FileSize > 0 && FileSize <= MAX_THUMBNAIL_SOURCE_BYTES)
+			MakeLocalThumbnails(*Wrapper, FilePath, ThumbnailSizes, LocalThumbnails);
+
+		AsyncTask(ENamedThreads::GameThread, [this, UploadID, FileSize, FileMimeType, LocalThumbnails = MoveTemp(LocalThumbnails)]() mutable {
+			StartUpload(UploadID, FileSize, FileMimeType, MoveTemp(LocalThumbnails));
+		});
+	});
+}
+
+void SBChatFileUploader::StartUpload(int32 UploadID, int64 FileSize, const FString& MimeType, TArray<FLocalThumbnail>&& LocalThumbnails)
+{
+#if WITH_SENDBIRD
+	FUpload Finished;
+	ESBFileUploadState FinishedState = ESBFileUploadState::Failed;
+	SBDBaseChannel* Channel = nullptr;
+	SBDFileMessageParams Params;
+	FProgress OnProgress;
+	{
+		FScopeLock ScopeLock(&Lock);
+
+		FUpload* Upload = Uploads.FindByPredicate([UploadID](const FUpload& Each) { return Each.UploadID == UploadID; });
+		if (Upload == nullptr)
+			return;
+
+		if (Upload->bCancelled || FileSize < 0)
+		{
+			FinishedState = Upload->bCancelled ? ESBFileUploadState::Cancelled : ESBFileUploadState::Failed;
+			TakeUpload(UploadID, Finished);
+		}
+		else
+		{
+			Upload->State = ESBFileUploadState::Uploading;
+			Upload->TotalBytes = FileSize;
+			Upload->MimeType = MimeType;
+			Upload->LocalThumbnails = MoveTemp(LocalThumbnails);
+			OnProgress = Upload->OnProgress;
+
+			Channel = Upload->Channel;
+			Params.SetFilePath(SendbirdTranscode::ToWString(Upload->FilePath))
+				.SetFileName(SendbirdTranscode::ToWString(FPaths::GetCleanFilename(Upload->FilePath)))
+				.SetMimeType(SendbirdTranscode::ToWString(MimeType))
+				.SetFileSize(FileSize);
+
+			if (MimeType.StartsWith(TEXT("image/")) && Upload->ThumbnailSizes.Num() > 0)
+			{
+				std::vector<SBDThumbnailSize> Sizes;
+				Sizes.reserve(Upload->ThumbnailSizes.Num());
+				for (const FIntPoint& Size : Upload->ThumbnailSizes)
+					Sizes.emplace_back(Size.X, Size.Y);
+				Params.SetThumbnailSizes(Sizes);
+			}
+		}
+	}
+
+	if (Channel == nullptr)
+	{
+		if (FileSize < 0)
+			UE_LOG(SendbirdSample, Warning, TEXT("[SBChatFileUploader::StartUpload] %s can't be read!!"), *Finished.FilePath);
+		Finish(Finished, FinishedState, nullptr, nullptr);
+		return;
+	}
+
+	if (OnProgress)
+		OnProgress(UploadID, ESBFileUploadState::Uploading, 0, FileSize);
+
+	Channel->SendFileMessage(Params, [this, UploadID](SBDFileMessage* FileMessage, SBDError* Error) {
+		OnUploadCompleted(UploadID, FileMessage, Error);
+	});
+#endif
+}
+
+void SBChatFileUploader::OnUploadCompleted(int32 UploadID, SBDFileMessage* FileMessage, SBDError* Error)
+{
+#if WITH_SENDBIRD
+	FUpload Upload;
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (!TakeUpload(UploadID, Upload))
+			return;
+	}
+
+	if (Upload.bCancelled)
+	{
+		if (Error == nullptr && FileMessage != nullptr)
+			Upload.Channel->DeleteMessage(FileMessage, [](SBDError* DeleteError) {});
+		Finish(Upload, ESBFileUploadState::Cancelled, nullptr, nullptr);
+		return;
+	}
+
+	if (Error != nullptr || FileMessage == nullptr)
+	{
+		Finish(Upload, ESBFileUploadState::Failed, nullptr, Error);
+		return;
+	}
+
+	CacheLocalThumbnails(FileMessage, Upload.LocalThumbnails);
+	SBChatManager::Get().ReconcileSentMessage(Upload.Channel, 0, FString(), FileMessage);
+	Finish(Upload, ESBFileUploadState::Succeeded, FileMessage, nullptr);
+#endif
+}
+
+bool SBChatFileUploader::TakeUpload(int32 UploadID, FUpload& OutUpload)
+{
+	const int32 Index = Uploads.IndexOfByPredicate([UploadID](const FUpload& Each) { return Each.UploadID == UploadID; });
+	if (Index == INDEX_NONE)
+		return false;
+
+	OutUpload = MoveTemp(Uploads[Index]);
+	Uploads.RemoveAt(Index);
+	if (OutUpload.State != ESBFileUploadState::Queued)
+		--Active;
+	return true;
+}
+
+void SBChatFileUploader::Finish(FUpload& Upload, ESBFileUploadState State, SBDFileMessage* FileMessage, SBDError* Error)
+{
+	if (Upload.OnProgress)
+	{
+		const int64 BytesSent = State == ESBFileUploadState::Succeeded ? Upload.TotalBytes : 0;
+		if (IsInGameThread())
+		{
+			Upload.OnProgress(Upload.UploadID, State, BytesSent, Upload.TotalBytes);
+		}
+		else
+		{
+			AsyncTask(ENamedThreads::GameThread, [OnProgress = MoveTemp(Upload.OnProgress), UploadID = Upload.UploadID, State, BytesSent, TotalBytes = Upload.TotalBytes]() {
+				OnProgress(UploadID, State, BytesSent, TotalBytes);
+			});
+		}
+	}
+
+	if (Upload.OnComplete)
+		Upload.OnComplete(State, FileMessage, Error);
+}
+
+void SBChatFileUploader::MakeLocalThumbnails(IImageWrapperModule& ImageWrapperModule, const FString& FilePath, const TArray<FIntPoint>& ThumbnailSizes, TArray<FLocalThumbnail>& OutThumbnails)
+{
+	if (ThumbnailSizes.Num() == 0)
+		return;
+
+	int32 MaxDimension = 0;
+	for (const FIntPoint& Size : ThumbnailSizes)
+		MaxDimension = FMath::Max3(MaxDimension, Size.X, Size.Y);
+
+	// Decoded once, already at the largest size, and every thumbnail is scaled down from that.
+	TArray<uint8> Bytes;
+	SBChatProfileTextureCache::FImage Source;
+	if (!FFileHelper::LoadFileToArray(Bytes, *FilePath, FILEREAD_Silent) || !SBChatProfileTextureCache::Decode(ImageWrapperModule, Bytes, MaxDimension, Source))
+		return;
+
+	for (const FIntPoint& Size : ThumbnailSizes)
+	{
+		const FIntPoint ThumbnailSize = SBChatThumbnail::FitWithin(Source.Width, Source.Height, Size.X, Size.Y);
+		TSharedRef<SBChatProfileTextureCache::FImage, ESPMode::ThreadSafe> Image = MakeShared<SBChatProfileTextureCache::FImage, ESPMode::ThreadSafe>();
+		Image->Width = ThumbnailSize.X;
+		Image->Height = ThumbnailSize.Y;
+		SBChatThumbnail::Resize(Source.Pixels, Source.Width, Source.Height, Image->Width, Image->Height, Image->Pixels);
+		OutThumbnails.Add({ Size, Image });
+	}
+}
+
+void SBChatFileUploader::CacheLocalThumbnails(SBDFileMessage* FileMessage, const TArray<FLocalThumbnail>& LocalThumbnails)
+{
+#if WITH_SENDBIRD
+	if (LocalThumbnails.Num() == 0)
+		return;
+
+	// The server tells which of its thumbnails is which by the size that was asked for.
+	TArray<TPair<FString, FImagePtr>> Thumbnails;
+	for (SBDThumbnail& Thumbnail : FileMessage->thumbnails)
+	{
+		const FIntPoint MaxSize((int32)Thumbnail.max_width, (int32)Thumbnail.max_height);
+		if (const FLocalThumbnail* Local = LocalThumbnails.FindByPredicate([&MaxSize](const FLocalThumbnail& Each) { return Each.MaxSize == MaxSize; }))
+			Thumbnails.Emplace(SendbirdTranscode::ToFString(Thumbnail.GetUrl()), Local->Image);
+	}
+
+	if (Thumbnails.Num() == 0)
+		return;
+
+	AsyncTask(ENamedThreads::GameThread, [Thumbnails = MoveTemp(Thumbnails)]() {
+		SBChatProfileTextureCache& ThumbnailTextures = SBChatManager::Get().GetThumbnailTextures();
+		for (const TPair<FString, FImagePtr>& Thumbnail : Thumbnails)
+		{
+			if (ThumbnailTextures.Find(Thumbnail.Key) == nullptr)
+				ThumbnailTextures.Add(Thumbnail.Key, SBChatProfileTextureCache::CreateTexture(*Thumbnail.Value));
+		}
+	});
+#endif
+}
+//- private
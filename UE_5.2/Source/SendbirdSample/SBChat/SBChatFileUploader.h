@@ -0,0 +1,98 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Sendbird/include/Sendbird.h"
+#include "SBChatCommonEnum.h"
+#include "SBChatProfileTextureCache.h"
+
+// File messages sent from disk. The SDK is given the file's path (SBDFileMessageParams::SetFilePath) and streams it
+// itself, so a file is never read into memory to be sent; only its first bytes are read, off the game thread, when its
+// MIME type has to be guessed, and images are decoded for their thumbnails (see below).
+// At most MaxConcurrent uploads run at once, oldest first; the rest wait in the queue, as do uploads to a channel
+// that is over the send limiter's limit. A file upload takes a send token like any message, but is never coalesced
+// or dropped by the limiter.
+// The SDK reports no bytes while a file is on its way, so progress moves by state: 0 bytes until the upload
+// completes, then all of them.
+// Cancelling a queued upload removes it. An upload the SDK already has can't be stopped; its message is deleted
+// once the server acks it.
+// Images are sent with the thumbnail sizes set here, which the server renders. The SDK only takes the one file, so
+// the sender's own thumbnails are made locally instead: an image up to MAX_THUMBNAIL_SOURCE_BYTES is decoded and
+// downscaled to each size on the thread pool while it is prepared, and the results are put in the thumbnail texture
+// cache under the urls the server returns, so the sender never downloads them.
+class SBChatFileUploader
+{
+public:
+	static const int32 DEFAULT_MAX_CONCURRENT	= 2;
+	static const int64 MAX_THUMBNAIL_SOURCE_BYTES	= 32 * 1024 * 1024;
+
+	// Called on the game thread each time an upload moves on from Queued. TotalBytes is 0 until the file has been read.
+	using FProgress = TFunction<void(int32 UploadID, ESBFileUploadState, int64 BytesSent, int64 TotalBytes)>;
+	// Called once per upload with Succeeded, Failed or Cancelled. Uploads the SDK completes are completed on its
+	// thread, the others on the game thread; Error is only set by the SDK.
+	using FCompletion = TFunction<void(ESBFileUploadState, SBDFileMessage*, SBDError*)>;
+
+	SBChatFileUploader();
+	~SBChatFileUploader();
+
+	void								Reset();
+	void								SetMaxConcurrent(int32 InMaxConcurrent);
+	// Bounding boxes of the thumbnails asked for image files; empty asks for none. Applies to uploads queued after.
+	void								SetThumbnailSizes(const TArray<FIntPoint>& InThumbnailSizes);
+
+	// Queues the file; an empty MimeType is guessed from the file. Returns the upload's id.
+	int32								Upload(SBDBaseChannel* Channel, const FString& FilePath, const FString& MimeType, FProgress OnProgress, FCompletion OnComplete);
+	bool								Cancel(int32 UploadID);
+	void								RemoveChannel(const FString& ChannelUrl);
+	int32								Num();
+
+	static FString						GuessMimeType(const FString& FilePath);
+
+private:
+	using FImagePtr = TSharedPtr<const SBChatProfileTextureCache::FImage, ESPMode::ThreadSafe>;
+
+	struct FLocalThumbnail
+	{
+		FIntPoint						MaxSize;
+		FImagePtr						Image;
+	};
+
+	struct FUpload
+	{
+		int32							UploadID = 0;
+		SBDBaseChannel*					Channel = nullptr;
+		FString							ChannelUrl;
+		FString							FilePath;
+		FString							MimeType;
+		int64							TotalBytes = 0;
+		ESBFileUploadState				State = ESBFileUploadState::Queued;
+		bool							bCancelled = false;
+		double							BlockedSince = 0.0;		// when the send limiter first held it back
+		TArray<FIntPoint>				ThumbnailSizes;
+		TArray<FLocalThumbnail>			LocalThumbnails;
+		FProgress						OnProgress;
+		FCompletion						OnComplete;
+	};
+
+	bool								Tick(float DeltaTime);
+	void								Prepare(int32 UploadID, const FString& FilePath, const FString& MimeType, const TArray<FIntPoint>& ThumbnailSizes);
+	void								StartUpload(int32 UploadID, int64 FileSize, const FString& MimeType, TArray<FLocalThumbnail>&& LocalThumbnails);
+	void								OnUploadCompleted(int32 UploadID, SBDFileMessage* FileMessage, SBDError* Error);
+	// Takes the upload out; Active counts it no more if it had started.
+	bool								TakeUpload(int32 UploadID, FUpload& OutUpload);
+	static void							Finish(FUpload& Upload, ESBFileUploadState State, SBDFileMessage* FileMessage, SBDError* Error);
+	static void							MakeLocalThumbnails(IImageWrapperModule& ImageWrapperModule, const FString& FilePath, const TArray<FIntPoint>& ThumbnailSizes, TArray<FLocalThumbnail>& OutThumbnails);
+	static void							CacheLocalThumbnails(SBDFileMessage* FileMessage, const TArray<FLocalThumbnail>& LocalThumbnails);
+
+private:
+	FCriticalSection					Lock;
+	TArray<FUpload>						Uploads;
+	FTSTicker::FDelegateHandle			TickerHandle;
+	int32								MaxConcurrent;
+	int32								Active;
+	int32								LastUploadID;
+	TArray<FIntPoint>					ThumbnailSizes;
+	IImageWrapperModule*				ImageWrapperModule;
+};
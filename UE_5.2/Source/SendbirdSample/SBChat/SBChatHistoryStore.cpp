@@ -0,0 +1,282 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#include "SBChatHistoryStore.h"
+
+SBChatHistoryStore::SBChatHistoryStore()
+	: SBChatHistoryStore(DEFAULT_MEMORY_BUDGET)
+{
+}
+
+SBChatHistoryStore::SBChatHistoryStore(int64 InMemoryBudget)
+{
+	Head = 0;
+	Count = 0;
+	MemoryBudget = InMemoryBudget;
+	MemoryUsage = 0;
+}
+
+void SBChatHistoryStore::Reset()
+{
+	Slots.Empty();
+	CreatedAtByID.Empty();
+	Head = 0;
+	Count = 0;
+	MemoryUsage = 0;
+}
+
+void SBChatHistoryStore::SetMemoryBudget(int64 InMemoryBudget)
+{
+	MemoryBudget = InMemoryBudget;
+	EvictOverBudget();
+}
+
+SBDBaseMessage* SBChatHistoryStore::Find(uint64 MessageID) const
+{
+	const int32 Index = IndexOf(MessageID);
+	if (Index == INDEX_NONE)
+		return nullptr;
+
+	return At(Index).Message;
+}
+
+SBDBaseMessage* SBChatHistoryStore::GetAt(int32 Index) const
+{
+	if (!ensureMsgf(0 <= Index && Index < Count, TEXT("[SBChatHistoryStore::GetAt] Wrong Index(%d)!!"), Index))
+		return nullptr;
+
+	return At(Index).Message;
+}
+
+bool SBChatHistoryStore::Add(SBDBaseMessage* Message)
+{
+#if WITH_SENDBIRD
+	if (!ensure(Message))
+		return false;
+
+	if (CreatedAtByID.Contains(Message->message_id))
+	{
+		Update(Message);
+		return false;
+	}
+
+	FEntry Entry;
+	Entry.CreatedAt = Message->created_at;
+	Entry.MessageID = Message->message_id;
+	Entry.Message = Message;
+	Entry.Bytes = EstimateBytes(Message);
+
+	InsertAt(LowerBound(Entry.CreatedAt, Entry.MessageID), Entry);
+	CreatedAtByID.Add(Entry.MessageID, Entry.CreatedAt);
+	MemoryUsage += Entry.Bytes;
+
+	EvictOverBudget();
+	return CreatedAtByID.Contains(Entry.MessageID);
+#else
+	return false;
+#endif
+}
+
+bool SBChatHistoryStore::Update(SBDBaseMessage* Message)
+{
+#if WITH_SENDBIRD
+	if (!ensure(Message))
+		return false;
+
+	const int32 Index = IndexOf(Message->message_id);
+	if (Index == INDEX_NONE)
+		return false;
+
+	FEntry& Entry = At(Index);
+	if (Entry.CreatedAt != Message->created_at)
+	{
+		// The sort key moved, so the entry has to be relocated.
+		MemoryUsage -= Entry.Bytes;
+		RemoveAt(Index);
+		CreatedAtByID.Remove(Message->message_id);
+		Add(Message);
+		return true;
+	}
+
+	const int32 NewBytes = EstimateBytes(Message);
+	MemoryUsage += NewBytes - Entry.Bytes;
+	Entry.Message = Message;
+	Entry.Bytes = NewBytes;
+
+	EvictOverBudget();
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool SBChatHistoryStore::Remove(uint64 MessageID)
+{
+	const int32 Index = IndexOf(MessageID);
+	if (Index == INDEX_NONE)
+		return false;
+
+	MemoryUsage -= At(Index).Bytes;
+	RemoveAt(Index);
+	CreatedAtByID.Remove(MessageID);
+	return true;
+}
+
+int64 SBChatHistoryStore::GetOldestTime() const
+{
+	return Count > 0 ? At(0).CreatedAt : 0;
+}
+
+int64 SBChatHistoryStore::GetNewestTime() const
+{
+	return Count > 0 ? At(Count - 1).CreatedAt : 0;
+}
+
+void SBChatHistoryStore::GetRange(int64 FromTime, int64 ToTime, TArray<SBDBaseMessage*>& OutMessages) const
+{
+	const int32 Begin = LowerBound(FromTime, 0);
+	const int32 End = (ToTime == MAX_int64) ? Count : LowerBound(ToTime + 1, 0);
+
+	OutMessages.Reset(FMath::Max(End - Begin, 0));
+	for (int32 Index = Begin; Index < End; ++Index)
+		OutMessages.Add(At(Index).Message);
+}
+
+void SBChatHistoryStore::GetLatest(int32 MaxCount, TArray<SBDBaseMessage*>& OutMessages) const
+{
+	const int32 Begin = FMath::Max(Count - MaxCount, 0);
+
+	OutMessages.Reset(Count - Begin);
+	for (int32 Index = Begin; Index < Count; ++Index)
+		OutMessages.Add(At(Index).Message);
+}
+
+//+ private
+int32 SBChatHistoryStore::LowerBound(int64 CreatedAt, uint64 MessageID) const
+{
+	// New messages almost always land at the tail, so check it before bisecting.
+	if (Count == 0)
+		return 0;
+
+	const FEntry& Last = At(Count - 1);
+	if (Last.CreatedAt < CreatedAt || (Last.CreatedAt == CreatedAt && Last.MessageID < MessageID))
+		return Count;
+
+	int32 Low = 0;
+	int32 High = Count;
+	while (Low < High)
+	{
+		const int32 Mid = Low + (High - Low) / 2;
+		const FEntry& Entry = At(Mid);
+		if (Entry.CreatedAt < CreatedAt || (Entry.CreatedAt == CreatedAt && Entry.MessageID < MessageID))
+			Low = Mid + 1;
+		else
+			High = Mid;
+	}
+	return Low;
+}
+
+int32 SBChatHistoryStore::IndexOf(uint64 MessageID) const
+{
+	const int64* CreatedAt = CreatedAtByID.Find(MessageID);
+	if (CreatedAt == nullptr)
+		return INDEX_NONE;
+
+	const int32 Index = LowerBound(*CreatedAt, MessageID);
+	if (Index < Count && At(Index).MessageID == MessageID)
+		return Index;
+
+	return INDEX_NONE;
+}
+
+void SBChatHistoryStore::InsertAt(int32 Index, const FEntry& Entry)
+{
+	if (Count == Slots.Num())
+		Grow();
+
+	// Shift whichever side of the ring is shorter.
+	if (Index < Count - Index)
+	{
+		Head = (Head - 1) & (Slots.Num() - 1);
+		for (int32 i = 0; i < Index; ++i)
+			At(i) = At(i + 1);
+	}
+	else
+	{
+		for (int32 i = Count; i > Index; --i)
+			At(i) = At(i - 1);
+	}
+
+	At(Index) = Entry;
+	++Count;
+}
+
+void SBChatHistoryStore::RemoveAt(int32 Index)
+{
+	if (Index < Count - 1 - Index)
+	{
+		for (int32 i = Index; i > 0; --i)
+			At(i) = At(i - 1);
+		Head = (Head + 1) & (Slots.Num() - 1);
+	}
+	else
+	{
+		for (int32 i = Index; i < Count - 1; ++i)
+			At(i) = At(i + 1);
+	}
+
+	--Count;
+	if (Count == 0)
+		Head = 0;
+}
+
+void SBChatHistoryStore::Grow()
+{
+	const int32 NewCapacity = FMath::Max(Slots.Num() * 2, 16);
+
+	TArray<FEntry> NewSlots;
+	NewSlots.SetNumUninitialized(NewCapacity);
+	for (int32 Index = 0; Index < Count; ++Index)
+		NewSlots[Index] = At(Index);
+
+	Slots = MoveTemp(NewSlots);
+	Head = 0;
+}
+
+void SBChatHistoryStore::EvictOverBudget()
+{
+	while (MemoryUsage > MemoryBudget && Count > 1)
+	{
+		const FEntry& Oldest = At(0);
+		MemoryUsage -= Oldest.Bytes;
+		CreatedAtByID.Remove(Oldest.MessageID);
+		RemoveAt(0);
+	}
+}
+
+int32 SBChatHistoryStore::EstimateBytes(SBDBaseMessage* Message)
+{
+	int64 Bytes = sizeof(FEntry) + sizeof(TPair<uint64, int64>);
+#if WITH_SENDBIRD
+	auto UserBytes = [](const SBDUser& User) {
+		return (int64)(User.user_id.size() + User.nickname.size() + User.profile_url.size()) * sizeof(wchar_t);
+	};
+
+	if (Message->message_type == SBDMessageType::User)
+	{
+		SBDUserMessage* UserMessage = static_cast<SBDUserMessage*>(Message);
+		Bytes += sizeof(SBDUserMessage) + UserMessage->message.size() * sizeof(wchar_t) + UserBytes(UserMessage->sender);
+	}
+	else if (Message->message_type == SBDMessageType::Admin)
+	{
+		SBDAdminMessage* AdminMessage = static_cast<SBDAdminMessage*>(Message);
+		Bytes += sizeof(SBDAdminMessage) + AdminMessage->message.size() * sizeof(wchar_t);
+	}
+	else if (Message->message_type == SBDMessageType::File)
+	{
+		SBDFileMessage* FileMessage = static_cast<SBDFileMessage*>(Message);
+		Bytes += sizeof(SBDFileMessage) + (FileMessage->name.size() + FileMessage->url.size()) * sizeof(wchar_t) + UserBytes(FileMessage->sender);
+	}
+#endif
+	return (int32)FMath::Min<int64>(Bytes, MAX_int32);
+}
+//- private
@@ -0,0 +1,73 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Sendbird/include/Sendbird.h"
+
+// Messages of a single channel ordered by (created_at, message_id), kept in a contiguous ring.
+// The oldest messages are evicted once the estimated memory usage exceeds the budget, so an update or delete the server
+// sends later can be for a message that is no longer held.
+// There is no lock: the stores the manager owns are game-thread state, and SDK callbacks hand their changes over with
+// SBChatManager::RunOnGameThread.
+class SBChatHistoryStore
+{
+public:
+	static const int64 DEFAULT_MEMORY_BUDGET = 4 * 1024 * 1024;
+
+	SBChatHistoryStore();
+	explicit SBChatHistoryStore(int64 InMemoryBudget);
+
+	void								Reset();
+	void								SetMemoryBudget(int64 InMemoryBudget);
+	int64								GetMemoryBudget() const { return MemoryBudget; }
+	int64								GetMemoryUsage() const { return MemoryUsage; }
+	int32								Num() const { return Count; }
+	bool								IsEmpty() const { return Count == 0; }
+	bool								Contains(uint64 MessageID) const { return CreatedAtByID.Contains(MessageID); }
+
+	SBDBaseMessage*						Find(uint64 MessageID) const;
+	SBDBaseMessage*						GetAt(int32 Index) const;
+	bool								Add(SBDBaseMessage* Message);
+	bool								Update(SBDBaseMessage* Message);
+	bool								Remove(uint64 MessageID);
+
+	int64								GetOldestTime() const;
+	int64								GetNewestTime() const;
+	void								GetRange(int64 FromTime, int64 ToTime, TArray<SBDBaseMessage*>& OutMessages) const;
+	void								GetLatest(int32 MaxCount, TArray<SBDBaseMessage*>& OutMessages) const;
+
+	template<typename FuncType>
+	void								ForEach(FuncType Func) const
+	{
+		for (int32 Index = 0; Index < Count; ++Index)
+			Func(At(Index).Message);
+	}
+
+private:
+	struct FEntry
+	{
+		int64							CreatedAt;
+		uint64							MessageID;
+		SBDBaseMessage*					Message;
+		int32							Bytes;
+	};
+
+	FEntry&								At(int32 Index) { return Slots[(Head + Index) & (Slots.Num() - 1)]; }
+	const FEntry&						At(int32 Index) const { return Slots[(Head + Index) & (Slots.Num() - 1)]; }
+	int32								LowerBound(int64 CreatedAt, uint64 MessageID) const;
+	int32								IndexOf(uint64 MessageID) const;
+	void								InsertAt(int32 Index, const FEntry& Entry);
+	void								RemoveAt(int32 Index);
+	void								Grow();
+	void								EvictOverBudget();
+	static int32						EstimateBytes(SBDBaseMessage* Message);
+
+private:
+	TArray<FEntry>						Slots;
+	int32								Head;
+	int32								Count;
+	TMap<uint64, int64>					CreatedAtByID;
+	int64								MemoryBudget;
+	int64								MemoryUsage;
+};
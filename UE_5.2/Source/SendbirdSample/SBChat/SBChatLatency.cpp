@@ -0,0 +1,262 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#include "SBChatLatency.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/OutputDeviceRedirector.h"
+#include "../SendbirdSample.h"
+
+namespace
+{
+	const double REPORTED_PERCENTILES[] = { 50.0, 90.0, 99.0, 99.9 };
+}
+
+//+ SBChatLatencyHistogram
+SBChatLatencyHistogram::SBChatLatencyHistogram()
+{
+	Counts.SetNumZeroed(NUM_BUCKETS);
+	Count = 0;
+	Sum = 0;
+	Min = MAX_int64;
+	Max = 0;
+}
+
+void SBChatLatencyHistogram::Reset()
+{
+	FMemory::Memzero(Counts.GetData(), Counts.Num() * sizeof(int64));
+	Count = 0;
+	Sum = 0;
+	Min = MAX_int64;
+	Max = 0;
+}
+
+void SBChatLatencyHistogram::Record(int64 Microseconds)
+{
+	const int64 Value = FMath::Max<int64>(Microseconds, 0);
+	++Counts[ToBucket((uint64)Value)];
+	++Count;
+	Sum += Value;
+	Min = FMath::Min(Min, Value);
+	Max = FMath::Max(Max, Value);
+}
+
+int64 SBChatLatencyHistogram::GetPercentile(double Percentile) const
+{
+	if (Count == 0)
+		return 0;
+
+	const int64 Rank = FMath::Max<int64>(1, (int64)FMath::CeilToDouble(FMath::Clamp(Percentile, 0.0, 100.0) / 100.0 * Count));
+	int64 Seen = 0;
+	for (int32 Bucket = 0; Bucket < NUM_BUCKETS; ++Bucket)
+	{
+		Seen += Counts[Bucket];
+		if (Seen >= Rank)
+			return FMath::Min<int64>((int64)ToHighestEquivalent(Bucket), Max);
+	}
+	return Max;
+}
+
+int32 SBChatLatencyHistogram::ToBucket(uint64 Value)
+{
+	if (Value < SUB_BUCKETS)
+		return (int32)Value;
+
+	const int32 Magnitude = FMath::Min((int32)FMath::FloorLog2_64(Value), MAX_MAGNITUDE);
+	const int32 Shift = Magnitude - SUB_BUCKET_BITS;
+	const int32 SubBucket = (int32)FMath::Min<uint64>(Value >> Shift, SUB_BUCKETS * 2 - 1) - SUB_BUCKETS;
+	return SUB_BUCKETS + Shift * SUB_BUCKETS + SubBucket;
+}
+
+uint64 SBChatLatencyHistogram::ToHighestEquivalent(int32 Bucket)
+{
+	if (Bucket < SUB_BUCKETS)
+		return (uint64)Bucket;
+
+	const int32 Shift = (Bucket - SUB_BUCKETS) / SUB_BUCKETS;
+	const int32 SubBucket = (Bucket - SUB_BUCKETS) % SUB_BUCKETS;
+	return ((uint64)(SUB_BUCKETS + SubBucket + 1) << Shift) - 1;
+}
+//- SBChatLatencyHistogram
+
+//+ SBChatLatencyTracker
+SBChatLatencyTracker& SBChatLatencyTracker::Get()
+{
+	static SBChatLatencyTracker Tracker;
+	return Tracker;
+}
+
+void SBChatLatencyTracker::Record(FName Operation, double StartTime, double CompletionTime, double DispatchTime, int64 ErrorCode)
+{
+	FOperation& Entry = Operations.FindOrAdd(Operation);
+	Entry.Stages[(int32)EStage::Sdk].Record((int64)((CompletionTime - StartTime) * 1e6));
+	Entry.Stages[(int32)EStage::Dispatch].Record((int64)((DispatchTime - CompletionTime) * 1e6));
+	Entry.Stages[(int32)EStage::Total].Record((int64)((DispatchTime - StartTime) * 1e6));
+
+	if (ErrorCode == 0)
+		++Entry.Succeeded;
+	else
+		++Entry.ErrorCounts.FindOrAdd(ErrorCode);
+}
+
+void SBChatLatencyTracker::Reset()
+{
+	Operations.Empty();
+}
+
+void SBChatLatencyTracker::Report(FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("%-32s %-8s %8s %10s %10s %10s %10s %10s %10s"), TEXT("operation"), TEXT("stage"), TEXT("count"),
+		TEXT("mean ms"), TEXT("p50 ms"), TEXT("p90 ms"), TEXT("p99 ms"), TEXT("p99.9 ms"), TEXT("max ms"));
+
+	for (const FName& Name : GetSortedOperations())
+	{
+		const FOperation& Operation = Operations.FindChecked(Name);
+		for (int32 Stage = 0; Stage < (int32)EStage::Num; ++Stage)
+		{
+			const SBChatLatencyHistogram& Histogram = Operation.Stages[Stage];
+			Ar.Logf(TEXT("%-32s %-8s %8lld %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f"), *Name.ToString(), GetStageName((EStage)Stage), Histogram.Num(),
+				Histogram.GetMean() / 1000.0, Histogram.GetPercentile(50.0) / 1000.0, Histogram.GetPercentile(90.0) / 1000.0,
+				Histogram.GetPercentile(99.0) / 1000.0, Histogram.GetPercentile(99.9) / 1000.0, Histogram.GetMax() / 1000.0);
+		}
+
+		FString Errors;
+		for (const TPair<int64, int64>& Error : Operation.ErrorCounts)
+			Errors += FString::Printf(TEXT(" %lld(%s) x%lld"), Error.Key, GetErrorClass(Error.Key), Error.Value);
+		Ar.Logf(TEXT("%-32s succeeded %lld, failed%s"), *Name.ToString(), Operation.Succeeded, Errors.IsEmpty() ? TEXT(" 0") : *Errors);
+	}
+}
+
+FString SBChatLatencyTracker::ToCsv() const
+{
+	FString Csv = TEXT("operation,stage,count,succeeded,failed,min_us,mean_us,p50_us,p90_us,p99_us,p999_us,max_us\n");
+	for (const FName& Name : GetSortedOperations())
+	{
+		const FOperation& Operation = Operations.FindChecked(Name);
+		int64 Failed = 0;
+		for (const TPair<int64, int64>& Error : Operation.ErrorCounts)
+			Failed += Error.Value;
+
+		for (int32 Stage = 0; Stage < (int32)EStage::Num; ++Stage)
+		{
+			const SBChatLatencyHistogram& Histogram = Operation.Stages[Stage];
+			Csv += FString::Printf(TEXT("%s,%s,%lld,%lld,%lld,%lld,%.1f"), *Name.ToString(), GetStageName((EStage)Stage), Histogram.Num(),
+				Operation.Succeeded, Failed, Histogram.GetMin(), Histogram.GetMean());
+			for (double Percentile : REPORTED_PERCENTILES)
+				Csv += FString::Printf(TEXT(",%lld"), Histogram.GetPercentile(Percentile));
+			Csv += FString::Printf(TEXT(",%lld\n"), Histogram.GetMax());
+		}
+	}
+
+	// Error buckets follow as their own rows so the table above stays rectangular.
+	Csv += TEXT("\noperation,error_code,error_class,count\n");
+	for (const FName& Name : GetSortedOperations())
+	{
+		for (const TPair<int64, int64>& Error : Operations.FindChecked(Name).ErrorCounts)
+			Csv += FString::Printf(TEXT("%s,%lld,%s,%lld\n"), *Name.ToString(), Error.Key, GetErrorClass(Error.Key), Error.Value);
+	}
+	return Csv;
+}
+
+FString SBChatLatencyTracker::ToJson() const
+{
+	FString OperationsJson;
+	for (const FName& Name : GetSortedOperations())
+	{
+		const FOperation& Operation = Operations.FindChecked(Name);
+
+		FString StagesJson;
+		for (int32 Stage = 0; Stage < (int32)EStage::Num; ++Stage)
+		{
+			const SBChatLatencyHistogram& Histogram = Operation.Stages[Stage];
+			StagesJson += FString::Printf(TEXT("%s\"%s\": { \"count\": %lld, \"min_us\": %lld, \"mean_us\": %.1f, \"p50_us\": %lld, \"p90_us\": %lld, \"p99_us\": %lld, \"p999_us\": %lld, \"max_us\": %lld }"),
+				StagesJson.IsEmpty() ? TEXT("") : TEXT(", "), GetStageName((EStage)Stage), Histogram.Num(), Histogram.GetMin(), Histogram.GetMean(),
+				Histogram.GetPercentile(50.0), Histogram.GetPercentile(90.0), Histogram.GetPercentile(99.0), Histogram.GetPercentile(99.9), Histogram.GetMax());
+		}
+
+		FString ErrorsJson;
+		for (const TPair<int64, int64>& Error : Operation.ErrorCounts)
+		{
+			ErrorsJson += FString::Printf(TEXT("%s{ \"code\": %lld, \"class\": \"%s\", \"count\": %lld }"),
+				ErrorsJson.IsEmpty() ? TEXT("") : TEXT(", "), Error.Key, GetErrorClass(Error.Key), Error.Value);
+		}
+
+		OperationsJson += FString::Printf(TEXT("%s\n\t\t\"%s\": {\n\t\t\t\"succeeded\": %lld,\n\t\t\t\"errors\": [%s],\n\t\t\t\"stages\": { %s }\n\t\t}"),
+			OperationsJson.IsEmpty() ? TEXT("") : TEXT(","), *Name.ToString(), Operation.Succeeded, *ErrorsJson, *StagesJson);
+	}
+
+	return FString::Printf(TEXT("{\n\t\"timestamp\": \"%s\",\n\t\"operations\": {%s\n\t}\n}\n"), *FDateTime::UtcNow().ToIso8601(), *OperationsJson);
+}
+
+const TCHAR* SBChatLatencyTracker::GetStageName(EStage Stage)
+{
+	switch (Stage)
+	{
+	case EStage::Sdk:		return TEXT("sdk");
+	case EStage::Dispatch:	return TEXT("dispatch");
+	case EStage::Total:		return TEXT("total");
+	default:				return TEXT("");
+	}
+}
+
+const TCHAR* SBChatLatencyTracker::GetErrorClass(int64 ErrorCode)
+{
+	// Sendbird error codes: 400xxx rejected requests, 500xxx server failures, 800xxx raised by the SDK itself.
+	if (ErrorCode >= 400000 && ErrorCode < 500000)
+		return TEXT("request");
+	if (ErrorCode >= 500000 && ErrorCode < 600000)
+		return TEXT("server");
+	if (ErrorCode >= 800000 && ErrorCode < 900000)
+		return TEXT("sdk");
+	return TEXT("other");
+}
+
+TArray<FName> SBChatLatencyTracker::GetSortedOperations() const
+{
+	TArray<FName> Names;
+	Operations.GetKeys(Names);
+	Names.Sort(FNameLexicalLess());
+	return Names;
+}
+//- SBChatLatencyTracker
+
+#if !UE_BUILD_SHIPPING
+
+namespace SBChatLatencyCommands
+{
+	static void ShowLatency(const TArray<FString>& Args)
+	{
+		if (Args.Num() > 0 && Args[0] == TEXT("reset"))
+		{
+			SBChatLatencyTracker::Get().Reset();
+			return;
+		}
+
+		SBChatLatencyTracker::Get().Report(*GLog);
+	}
+
+	static void DumpLatency(const TArray<FString>& Args)
+	{
+		const bool bJson = Args.Num() > 0 && Args[0] == TEXT("json");
+		const FString Path = Args.Num() > 1 ? Args[1] : FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("SBChat"), TEXT("Latency"),
+			FString::Printf(TEXT("Latency-%s.%s"), *FDateTime::Now().ToString(), bJson ? TEXT("json") : TEXT("csv")));
+
+		const FString Contents = bJson ? SBChatLatencyTracker::Get().ToJson() : SBChatLatencyTracker::Get().ToCsv();
+		if (FFileHelper::SaveStringToFile(Contents, *Path))
+			UE_LOG(SendbirdSample, Display, TEXT("[SBChatLatency] Written to %s"), *Path);
+		else
+			UE_LOG(SendbirdSample, Error, TEXT("[SBChatLatency] Can't write %s"), *Path);
+	}
+
+	static FAutoConsoleCommand LatencyCommand(
+		TEXT("sbchat.Latency"),
+		TEXT("Prints per-operation latency (sdk, dispatch, total) and error counts of the USBChat async actions. Usage: sbchat.Latency [reset]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&ShowLatency));
+
+	static FAutoConsoleCommand LatencyDumpCommand(
+		TEXT("sbchat.Latency.Dump"),
+		TEXT("Writes the latency histograms to a file. Usage: sbchat.Latency.Dump [csv|json] [Path]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&DumpLatency));
+}
+
+#endif
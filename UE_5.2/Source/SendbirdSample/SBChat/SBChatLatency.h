@@ -0,0 +1,87 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Log-linear latency histogram in microseconds, in the style of HdrHistogram: values below SUB_BUCKETS are exact,
+// larger ones fall into SUB_BUCKETS linear buckets per power of two, so every recorded value is within 1/SUB_BUCKETS
+// (6.25%) of what is reported. Memory is fixed, recording is O(1).
+class SBChatLatencyHistogram
+{
+public:
+	static const int32 SUB_BUCKET_BITS = 4;
+	static const int32 SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+	static const int32 MAX_MAGNITUDE = 40;	// 2^40 us, about 12 days
+	static const int32 NUM_BUCKETS = SUB_BUCKETS + (MAX_MAGNITUDE - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+	SBChatLatencyHistogram();
+
+	void								Reset();
+	void								Record(int64 Microseconds);
+
+	int64								Num() const { return Count; }
+	int64								GetMin() const { return Count > 0 ? Min : 0; }
+	int64								GetMax() const { return Max; }
+	double								GetMean() const { return Count > 0 ? (double)Sum / Count : 0.0; }
+	// Highest value equivalent to the one at Percentile (0-100), as HdrHistogram reports it.
+	int64								GetPercentile(double Percentile) const;
+
+private:
+	static int32						ToBucket(uint64 Value);
+	static uint64						ToHighestEquivalent(int32 Bucket);
+
+private:
+	TArray<int64>						Counts;
+	int64								Count;
+	int64								Sum;
+	int64								Min;
+	int64								Max;
+};
+
+// Per-operation latency of the USBChat async actions that reach the SDK, recorded when the result reaches the game thread.
+// Each completion is split into stages:
+// - Sdk: from the action being created until the SDK calls back. Network time and the SDK's own queueing both fall
+//   here; the binary SDK doesn't expose when a request actually goes out.
+// - Dispatch: from the SDK's callback until the game thread picks the result up.
+// - Total: the two together.
+// Failures are also counted by error code.
+// Game thread only.
+class SBChatLatencyTracker
+{
+public:
+	enum class EStage : uint8
+	{
+		Sdk,
+		Dispatch,
+		Total,
+		Num,
+	};
+
+	static SBChatLatencyTracker&		Get();
+
+	// Times are FPlatformTime::Seconds(). ErrorCode is 0 for success.
+	void								Record(FName Operation, double StartTime, double CompletionTime, double DispatchTime, int64 ErrorCode);
+	void								Reset();
+
+	void								Report(FOutputDevice& Ar) const;
+	FString								ToCsv() const;
+	FString								ToJson() const;
+
+private:
+	SBChatLatencyTracker() {}
+
+	struct FOperation
+	{
+		SBChatLatencyHistogram			Stages[(int32)EStage::Num];
+		int64							Succeeded = 0;
+		TMap<int64, int64>				ErrorCounts;
+	};
+
+	static const TCHAR*					GetStageName(EStage Stage);
+	static const TCHAR*					GetErrorClass(int64 ErrorCode);
+	TArray<FName>						GetSortedOperations() const;
+
+private:
+	TMap<FName, FOperation>				Operations;
+};
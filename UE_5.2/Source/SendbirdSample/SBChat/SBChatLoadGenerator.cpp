@@ -0,0 +1,579 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#include "SBChatLoadGenerator.h"
+#include "HAL/IConsoleManager.h"
+#include "Async/Async.h"
+#include "Containers/Ticker.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "../SendbirdSample.h"
+#include "SBChatManager.h"
+#include "SBChatStats.h"
+#include "Sendbird/SendbirdTranscode.h"
+#if SENDBIRD_FAKE_BACKEND
+#include "Sendbird/SendbirdFakeBackend.h"
+#endif
+
+#if !UE_BUILD_SHIPPING
+
+/**
+ * sbchat.Bench.Load drives the SBDChannelHandler callbacks of SBChatManager at a fixed rate from a producer thread,
+ * through the fake backend's Simulate*() calls, and measures how the manager and the ISBChatChannelEvent dispatch keep up.
+ *
+ * Latency is measured from the moment the handler is called (on the backend thread), across the hop to the game thread
+ * where the history is updated, to the moment the event is delivered. Results are logged and written as JSON to Saved/Profiling/SBChat/.
+ */
+namespace SBChatBenchmark
+{
+	enum class ELoadScenario : uint8
+	{
+		Received,
+		Updated,
+		Deleted,
+		JoinLeave,
+		Mixed,
+	};
+
+	static const TCHAR* ScenarioNames[] = { TEXT("received"), TEXT("updated"), TEXT("deleted"), TEXT("joinleave"), TEXT("mixed") };
+	static const TCHAR* EventTypeNames[] = { TEXT("received"), TEXT("updated"), TEXT("deleted"), TEXT("user") };
+	static constexpr int32 EVENT_TYPE_COUNT = UE_ARRAY_COUNT(EventTypeNames);
+
+	struct FLoadConfig
+	{
+		ELoadScenario					Scenario = ELoadScenario::Mixed;
+		int32							Rate = 1000;				// handler callbacks per second
+		float							Seconds = 10.0f;
+		int32							PayloadChars = 64;
+		bool							bBatchDelivery = false;
+		float							DrainTimeoutSeconds = 10.0f;
+		FString							OutputPath;
+	};
+
+#if WITH_SENDBIRD && SENDBIRD_FAKE_BACKEND
+	static float Percentile(const TArray<float>& Sorted, double Fraction)
+	{
+		if (Sorted.Num() == 0)
+			return 0.0f;
+
+		const int32 Index = FMath::Clamp((int32)FMath::CeilToDouble(Fraction * Sorted.Num()) - 1, 0, Sorted.Num() - 1);
+		return Sorted[Index];
+	}
+
+	static FString LatencyJson(TArray<float>& Samples)
+	{
+		Samples.Sort();
+		return FString::Printf(TEXT("{ \"count\": %d, \"p50\": %.4f, \"p99\": %.4f, \"p999\": %.4f, \"max\": %.4f }"),
+			Samples.Num(), Percentile(Samples, 0.5), Percentile(Samples, 0.99), Percentile(Samples, 0.999), Samples.Num() > 0 ? Samples.Last() : 0.0f);
+	}
+
+	class FLoadRun : public TSharedFromThis<FLoadRun, ESPMode::ThreadSafe>
+	{
+	public:
+		static constexpr int32 UPDATE_POOL_SIZE = 64;
+		// Every this many passes over the update pool, its messages are replaced by fresh ones, so the history budget
+		// never evicts a target; an update of a message the history no longer holds is not delivered.
+		static constexpr int32 UPDATE_PASSES_PER_REFRESH = 4;
+		static constexpr int32 USER_POOL_SIZE = 256;
+
+		explicit FLoadRun(const FLoadConfig& InConfig) : Config(InConfig) {}
+
+		void Start()
+		{
+			if (!FSendbirdFakeBackend::Get().IsRunning())
+			{
+				UE_LOG(SendbirdSample, Error, TEXT("[SBChatBenchmark] Load: the fake backend is not running."));
+				Finish();
+				return;
+			}
+
+			if (SBDMain::GetCurrentUser() != nullptr)
+			{
+				AcquireChannel();
+				return;
+			}
+
+			if (!SBDMain::IsInitialized())
+				SBDMain::Init(L"sbchat-bench");
+
+			TSharedRef<FLoadRun, ESPMode::ThreadSafe> Run = AsShared();
+			SBDMain::Connect(L"sbchat_bench", L"", [Run](SBDUser* User, SBDError* Error) {
+				const bool bConnected = Error == nullptr;
+				AsyncTask(ENamedThreads::GameThread, [Run, bConnected]() {
+					if (!bConnected)
+					{
+						UE_LOG(SendbirdSample, Error, TEXT("[SBChatBenchmark] Load: connect failed."));
+						Run->Finish();
+						return;
+					}
+					Run->AcquireChannel();
+				});
+			});
+		}
+
+		void RequestStop()
+		{
+			bStopRequested = true;
+		}
+
+		void Finish();
+
+	private:
+		void AcquireChannel()
+		{
+			SBChatManager& Manager = SBChatManager::Get();
+			PreviousChannel = Manager.GetCurrentChannel();
+			if (PreviousChannel != nullptr && PreviousChannel->is_group_channel)
+			{
+				Begin(PreviousChannel);
+				return;
+			}
+
+			const TArray<std::wstring> ChannelUrls = FSendbirdFakeBackend::Get().GetChannelUrls(false);
+			if (ChannelUrls.Num() == 0)
+			{
+				UE_LOG(SendbirdSample, Error, TEXT("[SBChatBenchmark] Load: the fake backend has no group channel."));
+				Finish();
+				return;
+			}
+
+			TSharedRef<FLoadRun, ESPMode::ThreadSafe> Run = AsShared();
+			SBDGroupChannel::GetChannel(ChannelUrls[0], [Run](SBDGroupChannel* Channel, SBDError* Error) {
+				AsyncTask(ENamedThreads::GameThread, [Run, Channel]() {
+					if (Channel == nullptr)
+					{
+						UE_LOG(SendbirdSample, Error, TEXT("[SBChatBenchmark] Load: GetChannel() failed."));
+						Run->Finish();
+						return;
+					}
+					Run->Begin(Channel);
+				});
+			});
+		}
+
+		void Begin(SBDBaseChannel* InChannel)
+		{
+			SBChatManager& Manager = SBChatManager::Get();
+			Channel = InChannel;
+			ChannelUrl = Channel->channel_url;
+			Manager.SetCurrentChannel(Channel);
+
+			PreviousChannelEvent = Manager.GetChannelEvent();
+			if (!PreviousChannelEvent.IsValid())
+			{
+				Sink = NewObject<USBChatLoadSink>();
+				Sink->AddToRoot();
+				Manager.SetChannelEvent(Sink);
+			}
+
+			SBChatEventQueue& EventQueue = Manager.GetEventQueue();
+			bPreviousBatchDelivery = EventQueue.IsBatchDelivery();
+			EventQueue.SetBatchDelivery(Config.bBatchDelivery);
+
+			// Reserve up front so recording doesn't show up in the allocation count.
+			const int32 ExpectedEvents = FMath::Max((int32)(Config.Rate * Config.Seconds * 1.1f), 1024);
+			for (TArray<float>& Samples : LatencyMs)
+				Samples.Reserve(ExpectedEvents);
+			FrameMs.Reserve(FMath::Max((int32)(Config.Seconds + Config.DrainTimeoutSeconds) * 240, 1024));
+
+			// Finish() clears the observer before the run can go away.
+			EventQueue.SetDispatchObserver([this](ESBChatEventType Type, double Seconds) {
+				LatencyMs[(int32)Type].Add((float)(Seconds * 1000.0));
+			});
+
+			UE_LOG(SendbirdSample, Display, TEXT("[SBChatBenchmark] Load: %s, %d callbacks/s for %.1fs, %d chars, batch %s, sink %s"),
+				ScenarioNames[(int32)Config.Scenario], Config.Rate, Config.Seconds, Config.PayloadChars,
+				Config.bBatchDelivery ? TEXT("on") : TEXT("off"), Sink != nullptr ? TEXT("USBChatLoadSink") : *PreviousChannelEvent->GetName());
+
+			const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+			BaseUsedPhysical = MemoryStats.UsedPhysical;
+			PeakUsedPhysical = MemoryStats.UsedPhysical;
+			bCountsAllocations = SBChatStats::GetAllocationCount(BaseMallocCalls);
+			StartTime = FPlatformTime::Seconds();
+			NextMemorySampleTime = StartTime;
+
+			TSharedRef<FLoadRun, ESPMode::ThreadSafe> Run = AsShared();
+			Producer = Async(EAsyncExecution::Thread, [Run]() { Run->Produce(); });
+			TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(Run, &FLoadRun::Tick));
+		}
+
+		// Producer thread. Issues callbacks on schedule; each Simulate*() call is delivered to the handlers by the
+		// backend's worker thread in issue order, so an update or delete always follows the receive it refers to.
+		void Produce()
+		{
+			FRandomStream Random(1234);
+			const std::wstring SenderId = L"sbchat_bench_sender";
+			// Fresh user ids per run, so every join and leave is a real membership change on the backend.
+			const std::wstring UserPrefix = SendbirdTranscode::ToWString(FString::Printf(TEXT("sbchat_bench_%lld_"), (int64)(StartTime * 1000.0)));
+
+			TArray<std::wstring> Payloads = MakePayloads(Random);
+			TArray<std::wstring> UserIds;
+			TBitArray<> JoinedUsers(false, USER_POOL_SIZE);
+			for (int32 Index = 0; Index < USER_POOL_SIZE; ++Index)
+				UserIds.Add(UserPrefix + std::to_wstring(Index));
+
+			TArray<uint64> UpdatePool;
+			int32 NextUpdate = 0;
+			int32 NextPayload = 0;
+
+			const double ProduceStart = FPlatformTime::Seconds();
+			int64 Issued = 0;
+			while (!bStopRequested)
+			{
+				const double Elapsed = FPlatformTime::Seconds() - ProduceStart;
+				if (Elapsed >= Config.Seconds)
+					break;
+
+				const int64 Due = (int64)(Elapsed * Config.Rate);
+				while (Issued < Due)
+				{
+					const std::wstring& Text = Payloads[NextPayload++ % Payloads.Num()];
+
+					ELoadScenario Scenario = Config.Scenario;
+					if (Scenario == ELoadScenario::Mixed)
+					{
+						const float Roll = Random.FRand();
+						Scenario = Roll < 0.70f ? ELoadScenario::Received : Roll < 0.85f ? ELoadScenario::Updated : Roll < 0.90f ? ELoadScenario::Deleted : ELoadScenario::JoinLeave;
+					}
+
+					int32 Callbacks = 0;
+					switch (Scenario)
+					{
+					case ELoadScenario::Received:
+						Callbacks += FSendbirdFakeBackend::Get().SimulateMessageReceived(ChannelUrl, SenderId, Text) != 0 ? 1 : 0;
+						break;
+
+					case ELoadScenario::Updated:
+						if (UpdatePool.Num() < UPDATE_POOL_SIZE)
+						{
+							const uint64 MessageId = FSendbirdFakeBackend::Get().SimulateMessageReceived(ChannelUrl, SenderId, Text);
+							if (MessageId != 0)
+							{
+								UpdatePool.Add(MessageId);
+								++Callbacks;
+							}
+						}
+						else
+						{
+							const int32 Slot = NextUpdate % UPDATE_POOL_SIZE;
+							const bool bRefresh = (NextUpdate / UPDATE_POOL_SIZE) % UPDATE_PASSES_PER_REFRESH == UPDATE_PASSES_PER_REFRESH - 1;
+							++NextUpdate;
+							if (bRefresh)
+							{
+								const uint64 MessageId = FSendbirdFakeBackend::Get().SimulateMessageReceived(ChannelUrl, SenderId, Text);
+								if (MessageId != 0)
+								{
+									UpdatePool[Slot] = MessageId;
+									++Callbacks;
+								}
+							}
+							else if (FSendbirdFakeBackend::Get().SimulateMessageUpdated(ChannelUrl, UpdatePool[Slot], Text))
+							{
+								++Callbacks;
+							}
+						}
+						break;
+
+					case ELoadScenario::Deleted:
+					{
+						const uint64 MessageId = FSendbirdFakeBackend::Get().SimulateMessageReceived(ChannelUrl, SenderId, Text);
+						if (MessageId != 0)
+						{
+							++Callbacks;
+							Callbacks += FSendbirdFakeBackend::Get().SimulateMessageDeleted(ChannelUrl, MessageId) ? 1 : 0;
+						}
+						break;
+					}
+
+					case ELoadScenario::JoinLeave:
+					{
+						const int32 UserIndex = Random.RandHelper(USER_POOL_SIZE);
+						const bool bJoined = JoinedUsers[UserIndex];
+						const bool bIssued = bJoined
+							? FSendbirdFakeBackend::Get().SimulateUserLeft(ChannelUrl, UserIds[UserIndex])
+							: FSendbirdFakeBackend::Get().SimulateUserJoined(ChannelUrl, UserIds[UserIndex]);
+						if (bIssued)
+						{
+							JoinedUsers[UserIndex] = !bJoined;
+							++Callbacks;
+						}
+						break;
+					}
+
+					default:
+						break;
+					}
+
+					// A failed call still consumes its slot so a broken channel can't spin this loop.
+					Issued += FMath::Max(Callbacks, 1);
+					ExpectedDeliveries += Callbacks;
+				}
+
+				FPlatformProcess::Sleep(0.001f);
+			}
+
+			bProducerDone = true;
+		}
+
+		TArray<std::wstring> MakePayloads(FRandomStream& Random) const
+		{
+			static const std::wstring Source =
+				L"See you at the lobby in 5 minutes, bring the new deck! "
+				L"안녕하세요, 오늘 저녁에 같이 게임할래요? 준비되면 알려주세요. "
+				L"今日のイベントは午後三時からです。我们在大厅见面。 "
+				L"gg \U0001F600 wp \U0001F44D nice \U0001F525\U0001F525 rematch? \U0001F3AE ";
+
+			TArray<std::wstring> Payloads;
+			for (int32 Index = 0; Index < 16; ++Index)
+			{
+				std::wstring Text;
+				Text.reserve(Config.PayloadChars);
+				size_t Offset = (size_t)Random.RandHelper((int32)Source.size());
+				while ((int32)Text.size() < Config.PayloadChars)
+				{
+					const size_t Count = FMath::Min(Source.size() - Offset, (size_t)Config.PayloadChars - Text.size());
+					Text.append(Source, Offset, Count);
+					Offset = 0;
+				}
+				Payloads.Add(MoveTemp(Text));
+			}
+			return Payloads;
+		}
+
+		bool Tick(float DeltaTime)
+		{
+			FrameMs.Add(FApp::GetDeltaTime() * 1000.0f);
+			MaxQueueDepth = FMath::Max(MaxQueueDepth, SBChatManager::Get().GetEventQueue().GetQueueDepth());
+
+			const double Now = FPlatformTime::Seconds();
+			if (Now >= NextMemorySampleTime)
+			{
+				PeakUsedPhysical = FMath::Max<uint64>(PeakUsedPhysical, FPlatformMemory::GetStats().UsedPhysical);
+				NextMemorySampleTime = Now + 0.1;
+			}
+
+			if (!bProducerDone)
+				return true;
+
+			if (DrainDeadline == 0.0)
+				DrainDeadline = Now + Config.DrainTimeoutSeconds;
+
+			if (GetDeliveredCount() < ExpectedDeliveries.Load() && Now < DrainDeadline && !bStopRequested)
+				return true;
+
+			EndTime = Now;
+			Report();
+			Finish();
+			return false;
+		}
+
+		int64 GetDeliveredCount() const
+		{
+			int64 Count = 0;
+			for (const TArray<float>& Samples : LatencyMs)
+				Count += Samples.Num();
+			return Count;
+		}
+
+		void Report()
+		{
+			uint64 MallocCalls = 0;
+			const bool bHasMallocCalls = bCountsAllocations && SBChatStats::GetAllocationCount(MallocCalls);
+			const int64 Delivered = GetDeliveredCount();
+			const int64 Expected = ExpectedDeliveries.Load();
+			const double Elapsed = FMath::Max(EndTime - StartTime, 1e-6);
+			const double MessagesPerSecond = Delivered / Elapsed;
+			const double AllocsPerMessage = (bHasMallocCalls && Delivered > 0) ? (double)(MallocCalls - BaseMallocCalls) / Delivered : -1.0;
+			const double MB = 1024.0 * 1024.0;
+
+			TArray<float> AllLatencyMs;
+			AllLatencyMs.Reserve((int32)Delivered);
+			FString LatencyByType;
+			for (int32 Type = 0; Type < EVENT_TYPE_COUNT; ++Type)
+			{
+				AllLatencyMs.Append(LatencyMs[Type]);
+				if (LatencyMs[Type].Num() > 0)
+					LatencyByType += FString::Printf(TEXT("%s\n\t\t\"%s\": %s"), LatencyByType.IsEmpty() ? TEXT("") : TEXT(","), EventTypeNames[Type], *LatencyJson(LatencyMs[Type]));
+			}
+			const FString Latency = LatencyJson(AllLatencyMs);
+
+			FrameMs.Sort();
+			double FrameSum = 0.0;
+			for (float Milliseconds : FrameMs)
+				FrameSum += Milliseconds;
+
+			const FString Json = FString::Printf(TEXT(
+				"{\n"
+				"\t\"benchmark\": \"sbchat.Bench.Load\",\n"
+				"\t\"timestamp\": \"%s\",\n"
+				"\t\"platform\": \"%s\",\n"
+				"\t\"build\": \"%s\",\n"
+				"\t\"config\": { \"scenario\": \"%s\", \"rate\": %d, \"seconds\": %.2f, \"payload_chars\": %d, \"batch_delivery\": %s, \"ui_sink\": %s },\n"
+				"\t\"issued\": %lld,\n"
+				"\t\"delivered\": %lld,\n"
+				"\t\"elapsed_seconds\": %.4f,\n"
+				"\t\"msgs_per_sec\": %.2f,\n"
+				"\t\"latency_ms\": %s,\n"
+				"\t\"latency_ms_by_type\": {%s\n\t},\n"
+				"\t\"frame_ms\": { \"count\": %d, \"avg\": %.3f, \"p99\": %.3f, \"max\": %.3f },\n"
+				"\t\"max_queue_depth\": %d,\n"
+				"\t\"allocs_per_msg\": %.2f,\n"
+				"\t\"used_physical_delta_mb\": %.2f,\n"
+				"\t\"peak_used_physical_mb\": %.2f\n"
+				"}\n"),
+				*FDateTime::UtcNow().ToIso8601(), ANSI_TO_TCHAR(FPlatformProperties::IniPlatformName()), LexToString(FApp::GetBuildConfiguration()),
+				ScenarioNames[(int32)Config.Scenario], Config.Rate, Config.Seconds, Config.PayloadChars,
+				Config.bBatchDelivery ? TEXT("true") : TEXT("false"), Sink != nullptr ? TEXT("false") : TEXT("true"),
+				Expected, Delivered, Elapsed, MessagesPerSecond, *Latency, *LatencyByType,
+				FrameMs.Num(), FrameMs.Num() > 0 ? FrameSum / FrameMs.Num() : 0.0, Percentile(FrameMs, 0.99), FrameMs.Num() > 0 ? FrameMs.Last() : 0.0f,
+				MaxQueueDepth, AllocsPerMessage,
+				((double)FPlatformMemory::GetStats().UsedPhysical - (double)BaseUsedPhysical) / MB, PeakUsedPhysical / MB);
+
+			UE_LOG(SendbirdSample, Display, TEXT("[SBChatBenchmark] Load: %lld/%lld delivered in %.2fs, %.0f msgs/s, latency p50 %.3fms p99 %.3fms p999 %.3fms, frame avg %.2fms max %.2fms"),
+				Delivered, Expected, Elapsed, MessagesPerSecond, Percentile(AllLatencyMs, 0.5), Percentile(AllLatencyMs, 0.99), Percentile(AllLatencyMs, 0.999),
+				FrameMs.Num() > 0 ? FrameSum / FrameMs.Num() : 0.0, FrameMs.Num() > 0 ? FrameMs.Last() : 0.0f);
+			UE_LOG(SendbirdSample, Display, TEXT("[SBChatBenchmark] Load: allocs/msg %.2f (process-wide, includes the fake backend), peak used physical %.1fMB, max queue depth %d"),
+				AllocsPerMessage, PeakUsedPhysical / MB, MaxQueueDepth);
+			if (Delivered < Expected)
+				UE_LOG(SendbirdSample, Warning, TEXT("[SBChatBenchmark] Load: %lld events were not delivered before the drain timeout."), Expected - Delivered);
+
+			const FString OutputPath = !Config.OutputPath.IsEmpty() ? Config.OutputPath
+				: FPaths::ProfilingDir() / TEXT("SBChat") / FString::Printf(TEXT("Load-%s-%s.json"), ScenarioNames[(int32)Config.Scenario], *FDateTime::Now().ToString());
+			if (FFileHelper::SaveStringToFile(Json, *OutputPath))
+				UE_LOG(SendbirdSample, Display, TEXT("[SBChatBenchmark] Load: results written to %s"), *FPaths::ConvertRelativePathToFull(OutputPath));
+			else
+				UE_LOG(SendbirdSample, Error, TEXT("[SBChatBenchmark] Load: failed to write %s"), *OutputPath);
+		}
+
+	private:
+		FLoadConfig							Config;
+		SBDBaseChannel*						Channel = nullptr;
+		std::wstring						ChannelUrl;
+
+		SBDBaseChannel*						PreviousChannel = nullptr;
+		TWeakObjectPtr<UObject>				PreviousChannelEvent;
+		bool								bPreviousBatchDelivery = false;
+		USBChatLoadSink*					Sink = nullptr;
+
+		TFuture<void>						Producer;
+		FTSTicker::FDelegateHandle			TickerHandle;
+		TAtomic<bool>						bStopRequested { false };
+		TAtomic<bool>						bProducerDone { false };
+		TAtomic<int64>						ExpectedDeliveries { 0 };
+
+		double								StartTime = 0.0;
+		double								EndTime = 0.0;
+		double								DrainDeadline = 0.0;
+		double								NextMemorySampleTime = 0.0;
+		TArray<float>						LatencyMs[EVENT_TYPE_COUNT];
+		TArray<float>						FrameMs;
+		int32								MaxQueueDepth = 0;
+		uint64								BaseUsedPhysical = 0;
+		uint64								PeakUsedPhysical = 0;
+		uint64								BaseMallocCalls = 0;
+		bool								bCountsAllocations = false;
+	};
+
+	static TSharedPtr<FLoadRun, ESPMode::ThreadSafe> ActiveRun;
+
+	void FLoadRun::Finish()
+	{
+		bStopRequested = true;
+		if (Producer.IsValid())
+			Producer.Wait();
+
+		SBChatManager& Manager = SBChatManager::Get();
+		SBChatEventQueue& EventQueue = Manager.GetEventQueue();
+		EventQueue.SetDispatchObserver(nullptr);
+		if (Channel != nullptr)
+		{
+			EventQueue.SetBatchDelivery(bPreviousBatchDelivery);
+			Manager.SetCurrentChannel(PreviousChannel);
+		}
+
+		if (Sink != nullptr)
+		{
+			Manager.SetChannelEvent(PreviousChannelEvent.Get());
+			Sink->RemoveFromRoot();
+			Sink = nullptr;
+		}
+
+		if (ActiveRun.Get() == this)
+			ActiveRun.Reset();
+	}
+
+	static void RunLoad(const TArray<FString>& Args)
+	{
+		if (ActiveRun.IsValid())
+		{
+			UE_LOG(SendbirdSample, Warning, TEXT("[SBChatBenchmark] Load: a run is already in progress, use sbchat.Bench.LoadStop to cancel it."));
+			return;
+		}
+
+		const FString Cmd = FString::Join(Args, TEXT(" "));
+		FLoadConfig Config;
+
+		FString ScenarioName;
+		if (FParse::Value(*Cmd, TEXT("Scenario="), ScenarioName))
+		{
+			int32 ScenarioIndex = INDEX_NONE;
+			for (int32 Index = 0; Index < (int32)UE_ARRAY_COUNT(ScenarioNames); ++Index)
+			{
+				if (ScenarioName.Equals(ScenarioNames[Index], ESearchCase::IgnoreCase))
+					ScenarioIndex = Index;
+			}
+
+			if (ScenarioIndex == INDEX_NONE)
+			{
+				UE_LOG(SendbirdSample, Error, TEXT("[SBChatBenchmark] Load: unknown scenario '%s'."), *ScenarioName);
+				return;
+			}
+			Config.Scenario = (ELoadScenario)ScenarioIndex;
+		}
+
+		FParse::Value(*Cmd, TEXT("Rate="), Config.Rate);
+		FParse::Value(*Cmd, TEXT("Seconds="), Config.Seconds);
+		FParse::Value(*Cmd, TEXT("Payload="), Config.PayloadChars);
+		FParse::Bool(*Cmd, TEXT("Batch="), Config.bBatchDelivery);
+		FParse::Value(*Cmd, TEXT("Drain="), Config.DrainTimeoutSeconds);
+		FParse::Value(*Cmd, TEXT("Out="), Config.OutputPath);
+
+		Config.Rate = FMath::Max(Config.Rate, 1);
+		Config.Seconds = FMath::Max(Config.Seconds, 0.1f);
+		Config.PayloadChars = FMath::Max(Config.PayloadChars, 1);
+
+		// Start() may finish the run right away, so keep it alive for the duration of the call.
+		TSharedRef<FLoadRun, ESPMode::ThreadSafe> Run = MakeShared<FLoadRun, ESPMode::ThreadSafe>(Config);
+		ActiveRun = Run;
+		Run->Start();
+	}
+
+	static void StopLoad()
+	{
+		if (ActiveRun.IsValid())
+			ActiveRun->RequestStop();
+	}
+#else
+	static void RunLoad(const TArray<FString>& Args)
+	{
+		UE_LOG(SendbirdSample, Error, TEXT("[SBChatBenchmark] Load requires the fake backend, build with SENDBIRD_FAKE_BACKEND=1."));
+	}
+
+	static void StopLoad()
+	{
+	}
+#endif
+
+	static FAutoConsoleCommand LoadCommand(
+		TEXT("sbchat.Bench.Load"),
+		TEXT("Drives SBChatManager's channel handler at a fixed rate and reports throughput, latency, allocations and memory. ")
+		TEXT("Usage: sbchat.Bench.Load [Scenario=received|updated|deleted|joinleave|mixed] [Rate=1000] [Seconds=10] [Payload=64] [Batch=0|1] [Drain=10] [Out=Path.json]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RunLoad));
+
+	static FAutoConsoleCommand LoadStopCommand(
+		TEXT("sbchat.Bench.LoadStop"),
+		TEXT("Cancels a running sbchat.Bench.Load and reports what was measured so far."),
+		FConsoleCommandDelegate::CreateStatic(&StopLoad));
+}
+
+#endif
@@ -0,0 +1,37 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "SBChatChannelEvent.h"
+#include "SBChatLoadGenerator.generated.h"
+
+// Channel event receiver installed by sbchat.Bench.Load when no chat widget is registered.
+// It only counts deliveries, so the numbers cover SBChatManager and the event queue without any UI cost.
+UCLASS()
+class USBChatLoadSink : public UObject, public ISBChatChannelEvent
+{
+	GENERATED_BODY()
+
+public:
+	virtual void						OnMessageReceived_Implementation(const FSBMessageInfo& MessageInfo) override { ++DeliveredCount; }
+	virtual void						OnMessageDeleted_Implementation(int64 MessageID) override { ++DeliveredCount; }
+	virtual void						OnMessageUpdated_Implementation(const FSBMessageInfo& MessageInfo) override { ++DeliveredCount; }
+	virtual void						OnMessageSent_Implementation(int64 LocalMessageID, const FSBMessageInfo& MessageInfo) override { ++DeliveredCount; }
+	virtual void						OnFileUploadProgress_Implementation(int32 UploadID, ESBFileUploadState State, int64 BytesSent, int64 TotalBytes) override {}
+	virtual void						OnConnectionStateChanged_Implementation(ESBConnectionState State) override {}
+	virtual void						OnUnreadCountsChanged_Implementation(const FSBUnreadCounts& Counts) override {}
+	virtual void						OnUserJoined_Implementation(const FSBUserInfo& UserInfo) override { ++DeliveredCount; }
+	virtual void						OnUserLeft_Implementation(const FSBUserInfo& UserInfo) override { ++DeliveredCount; }
+	virtual void						OnUserEntered_Implementation(const FSBUserInfo& UserInfo) override { ++DeliveredCount; }
+	virtual void						OnUserExited_Implementation(const FSBUserInfo& UserInfo) override { ++DeliveredCount; }
+	virtual void						OnInvitationReceived_Implementation(const FSBChannelInfo& ChannelInfo, const TArray<FSBUserInfo>& UserInfos) override { ++DeliveredCount; }
+
+	virtual void						OnMessagesReceivedBatch_Implementation(const TArray<FSBMessageInfo>& MessageInfos) override { DeliveredCount += MessageInfos.Num(); }
+	virtual void						OnMessagesUpdatedBatch_Implementation(const TArray<FSBMessageInfo>& MessageInfos) override { DeliveredCount += MessageInfos.Num(); }
+	virtual void						OnMessagesDeletedBatch_Implementation(const TArray<int64>& MessageIDs) override { DeliveredCount += MessageIDs.Num(); }
+	virtual void						OnUsersChangedBatch_Implementation(ESBChannelUserHandlerType HandlerType, const TArray<FSBUserInfo>& UserInfos) override { DeliveredCount += UserInfos.Num(); }
+
+	int64								DeliveredCount = 0;
+};
@@ -3,6 +3,9 @@
 #include "SBChatManager.h"
 #include "SBChatCommonStruct.h"
 #include "SBChatChannelEvent.h"
+#include "SBChatStats.h"
+#include "SBChatMessageProjection.h"
+#include "Sendbird/SendbirdTranscode.h"
 
 SBChatManager& SBChatManager::Get()
 {
@@ -11,13 +14,13 @@ SBChatManager& SBChatManager::Get()
 }
 
 SBChatManager::SBChatManager()
+	: ThumbnailTextures(TEXT("Thumbnails"), SBChatThumbnail::MAX_DIMENSION)
+	, AvatarAtlas(ProfileTextures, UserDirectory)
 {
 	ChannelEvent = nullptr;
 	CurrentChannel = nullptr;
-
-	OpenChannelListQuery = nullptr;
-	GroupChannelListQuery = nullptr;
-	UserListQuery = nullptr;
+	FocusedState = nullptr;
+	HistoryMemoryBudget = SBChatHistoryStore::DEFAULT_MEMORY_BUDGET;
 }
 
 SBChatManager::~SBChatManager()
@@ -35,195 +38,471 @@ void SBChatManager::Reset()
 #endif
 
 	ChannelEvent = nullptr;
+	EventQueue.Reset();
+	ReadReceiptScheduler.Reset();
+	Connection.Reset();
+	UnreadCounter.Reset();
 	CurrentChannel = nullptr;
-	HistoryMessages.Empty();
-
-	CachedProfileTexture.Reset();
-
-	OpenChannelListQuery = nullptr;
-	OpenChannels.Empty();
-
-	GroupChannelListQuery = nullptr;
-	GroupChannels.Empty();
+	HistoryMessages.Reset();
+	CachedTailChannelUrl.Reset();
+	CachedTail.Reset();
+
+	FocusedState = nullptr;
+	Subscriptions.Reset();
+	MessageCache.Close();
+	SyncEngine.Reset();
+	Outbox.Reset();
+	SendLimiter.Reset();
+	FileUploader.Reset();
+	ThumbnailTextures.Reset();
+	SearchIndex.Reset();
+
+	AvatarAtlas.Reset();
+	ProfileTextures.Reset();
+
+	Channels.Reset();
+	OpenChannelPages.SetQuery(nullptr);
+	GroupChannelPages.SetQuery(nullptr);
 	
-	UserListQuery = nullptr;
-	UserList.Empty();
+	UserPages.SetQuery(nullptr);
+	UserDirectory.Reset();
+
+	SBChatStringTable::Get().Reset();
 }
 
 void SBChatManager::SetChannelEvent(UObject* InChannelEvent)
 { 
 #if WITH_SENDBIRD
 	SBDMain::RemoveAllChannelHandlers();
-	SBDMain::AddChannelHandler(TCHAR_TO_WCHAR(TEXT("SBChatManager")), this);
+	SBDMain::AddChannelHandler(L"SBChatManager", this);
 #endif
 	ChannelEvent = InChannelEvent; 
+	EventQueue.Start();
+}
+
+void SBChatManager::SetCurrentChannel(SBDBaseChannel* Channel)
+{
+	if (!IsInGameThread())
+	{
+		AsyncTask(ENamedThreads::GameThread, [this, Channel]() { SetCurrentChannel(Channel); });
+		return;
+	}
+
+	// Deliver any pending read receipt of the channel we are leaving.
+	if (CurrentChannel != nullptr && CurrentChannel != Channel && CurrentChannel->is_group_channel)
+		ReadReceiptScheduler.Flush(static_cast<SBDGroupChannel*>(CurrentChannel));
+
+	if (CurrentChannel != Channel)
+	{
+		CachedTailChannelUrl.Reset();
+		CachedTail.Reset();
+	}
+
+	CurrentChannel = Channel;
+	if (Channel != nullptr && Channel->is_group_channel)
+		UnreadCounter.MarkRead(static_cast<SBDGroupChannel*>(Channel));
+
+	// Focusing a subscribed channel switches to the history it has been keeping.
+	FocusedState = Subscriptions.Find(Channel);
+	if (FocusedState != nullptr)
+		FocusedState->UnreadCount = 0;
+}
+
+void SBChatManager::RemoveChannel(const FString& ChannelUrl)
+{
+	if (!IsInGameThread())
+	{
+		AsyncTask(ENamedThreads::GameThread, [this, ChannelUrl]() { RemoveChannel(ChannelUrl); });
+		return;
+	}
+
+	SBDBaseChannel* Channel = Channels.Find(ChannelUrl);
+	if (Channel != nullptr && Channel == CurrentChannel)
+		ResetCurrentChannel();
+
+	if (Channel != nullptr && Channel == UserDirectory.GetChannel())
+		UserDirectory.Reset();
+
+	ReadReceiptScheduler.RemoveChannel(ChannelUrl);
+	UnsubscribeChannel(ChannelUrl);
+	SyncEngine.Forget(ChannelUrl);
+	Outbox.RemoveChannel(ChannelUrl);
+	FileUploader.RemoveChannel(ChannelUrl);
+	SendLimiter.RemoveChannel(ChannelUrl);
+	SearchIndex.RemoveChannel(ChannelUrl);
+	UnreadCounter.RemoveChannel(ChannelUrl);
+
+	Channels.Remove(ChannelUrl);
+}
+
+void SBChatManager::SetHistoryMemoryBudget(int64 BudgetBytes)
+{
+	HistoryMemoryBudget = BudgetBytes;
+	HistoryMessages.SetMemoryBudget(HistoryMemoryBudget);
+	Subscriptions.SetHistoryMemoryBudget(HistoryMemoryBudget);
 }
 
 SBDBaseMessage* SBChatManager::GetHistoryMessage(uint64 MessageID)
+{
+	return GetHistoryMessages().Find(MessageID);
+}
+
+bool SBChatManager::SetHistoryMessage(uint64 MessageID, SBDBaseMessage* NewMessage)
+{
+	if (!ensure(NewMessage) || !ensure(NewMessage->message_id == MessageID))
+		return false;
+
+	return GetHistoryMessages().Update(NewMessage);
+}
+
+FSBMessageInfo SBChatManager::AddHistoryMessage(SBDBaseMessage* Message)
+{
+	if (!ensure(Message))
+		return FSBMessageInfo();
+
+	GetHistoryMessages().Add(Message);
+	PersistMessage(Message);
+	return ToMessageInfo(Message);
+}
+
+void SBChatManager::AddHistoryMessage(SBDBaseMessage* Message, TArray<FSBMessageInfo>& OutMessageInfos)
+{
+	if (!ensure(Message))
+		return;
+
+	GetHistoryMessages().Add(Message);
+	PersistMessage(Message);
+	SBChatMessageProjection::ProjectInto(Message, OutMessageInfos);
+}
+
+bool SBChatManager::DeleteHistoryMessage(uint64 MessageID)
 {
 #if WITH_SENDBIRD
-	SBDBaseMessage** Message = HistoryMessages.Find(MessageID);
-	if (nullptr == Message)
-		return nullptr;
+	if (SBDBaseMessage* Message = GetHistoryMessages().Find(MessageID))
+		MessageCache.Remove(*SBChatStringTable::Get().Intern(Message->channel_url), MessageID);
+#endif
+	SearchIndex.Remove(MessageID);
+	return (0 < GetHistoryMessages().Remove(MessageID));
+}
+
+bool SBChatManager::UpdateHistoryMessage(SBDBaseMessage* Message)
+{
+#if WITH_SENDBIRD
+	if (!ensure(Message))
+		return false;
 
-	return *Message;
+	// The server still edits messages the budget evicted; the caches take the edit either way.
+	const bool bUpdated = SetHistoryMessage(Message->message_id, Message);
+	PersistMessage(Message);
+	return bUpdated;
 #else
-	return nullptr;
+	return false;
 #endif
 }
 
-bool SBChatManager::SetHistoryMessage(uint64 MessageID, SBDBaseMessage* NewMessage)
+FSBMessageInfo SBChatManager::ToMessageInfo(SBDBaseMessage* Message)
 {
-	if (HistoryMessages.Contains(MessageID))
-	{
-		HistoryMessages[MessageID] = NewMessage;
-		return true;
-	}
-	return false;
+	FSBMessageInfo MessageInfo;
+	SBChatMessageProjection::Project(Message, MessageInfo);
+	return MessageInfo;
 }
+//- Common
 
-const FSBMessageInfo SBChatManager::AddHistoryMessage(SBDBaseMessage* Message)
+//+ Outbox
+void SBChatManager::ReconcileSentMessage(SBDBaseChannel* Channel, int64 LocalMessageID, const FString& RequestID, SBDBaseMessage* Message)
 {
 #if WITH_SENDBIRD
-	if (!ensure(Message))
-		return FSBMessageInfo();
+	if (!ensure(Channel) || !ensure(Message))
+		return;
 
-	FDateTime MessageTime = SendbirdTimeToDateTime(Message->updated_at != 0 ? Message->updated_at : Message->created_at);
-	if (Message->message_type == SBDMessageType::User)
+	const double HandlerTime = FPlatformTime::Seconds();
+	RunOnGameThread([this, Channel, LocalMessageID, RequestID, Message, HandlerTime]() {
+		Channels.Touch(Channel, Message->created_at);
+
+		// Left while the message was on its way: a subscribed channel still keeps it, the others load it with their history.
+		if (Channel != CurrentChannel)
+		{
+			Subscriptions.Update(Channel, [this, Message](SBChatSubscriptions::FState& State) {
+				if (State.History.Add(Message))
+					PersistMessage(Message);
+			});
+			return;
+		}
+
+		if (Channel->is_group_channel)
+			ReadReceiptScheduler.RequestMarkAsRead(static_cast<SBDGroupChannel*>(Channel));
+
+		// A sync can bring the message in before its ack; the echo still has to go.
+		FSBMessageInfo MessageInfo = (GetHistoryMessage(Message->message_id) != nullptr) ? ToMessageInfo(Message) : AddHistoryMessage(Message);
+		MessageInfo.RequestID = RequestID;
+		if (LocalMessageID < 0 && Outbox.IsEchoEnabled())
+			EventQueue.EnqueueMessageSent(LocalMessageID, MoveTemp(MessageInfo), HandlerTime);
+	});
+#endif
+}
+
+int64 SBChatManager::ClaimFailedSend(SBDBaseChannel* Channel, SBDBaseMessage* Message, FString& OutRequestID)
+{
+#if WITH_SENDBIRD
+	if (!IsSentByCurrentUser(Message))
+		return 0;
+
+	const FSBChatStringRef ChannelUrlRef = SBChatStringTable::Get().Intern(Channel->channel_url);
+	return Outbox.ClaimDelivered(*ChannelUrlRef, Message, OutRequestID);
+#else
+	return 0;
+#endif
+}
+//- Outbox
+
+//+ Subscription
+SBChatSubscriptions::FState* SBChatManager::SubscribeChannel(SBDBaseChannel* Channel)
+{
+	SBChatSubscriptions::FState* State = Subscriptions.Subscribe(Channel);
+	if (State != nullptr && Channel == CurrentChannel)
 	{
-		SBDUserMessage* UserMessage = static_cast<SBDUserMessage*>(Message);
-		SBChatManager::Get().GetHistoryMessages().Add(Message->message_id, Message);
-		return FSBMessageInfo(Message->message_id, FSBUserInfo(UserMessage->sender),
-			(ESBMessageType)UserMessage->message_type, WCHAR_TO_TCHAR(UserMessage->message.c_str()), MessageTime);
+		// Keep what the focused channel already loaded.
+		if (FocusedState != State && !State->bHistoryLoaded)
+		{
+			State->History = HistoryMessages;
+			State->bHistoryLoaded = true;
+		}
+		FocusedState = State;
+		FocusedState->UnreadCount = 0;
 	}
-	else if (Message->message_type == SBDMessageType::Admin)
+	return State;
+}
+
+void SBChatManager::UnsubscribeChannel(const FString& ChannelUrl)
+{
+	if (!IsInGameThread())
 	{
-		SBDAdminMessage* AdminMessage = static_cast<SBDAdminMessage*>(Message);
-		SBChatManager::Get().GetHistoryMessages().Add(Message->message_id, Message);
-		return FSBMessageInfo(Message->message_id, FSBUserInfo(TEXT("Admin"), TEXT("Admin"), TEXT("")),
-			(ESBMessageType)AdminMessage->message_type, WCHAR_TO_TCHAR(AdminMessage->message.c_str()), MessageTime);
+		AsyncTask(ENamedThreads::GameThread, [this, ChannelUrl]() { UnsubscribeChannel(ChannelUrl); });
+		return;
 	}
-	else if (Message->message_type == SBDMessageType::File)
+
+	SBChatSubscriptions::FState* State = Subscriptions.Find(ChannelUrl);
+	if (State == nullptr)
+		return;
+
+	// The focused channel goes back to the manager's own history.
+	if (State == FocusedState)
 	{
-		SBDFileMessage* FileMessage = static_cast<SBDFileMessage*>(Message);
-		SBChatManager::Get().GetHistoryMessages().Add(Message->message_id, Message);
-		return FSBMessageInfo(Message->message_id, FSBUserInfo(FileMessage->sender),
-			(ESBMessageType)FileMessage->message_type, WCHAR_TO_TCHAR(FileMessage->name.c_str()), MessageTime);
+		HistoryMessages = MoveTemp(State->History);
+		FocusedState = nullptr;
 	}
-
-	ensureMsgf(false, TEXT("Unknown MessageType : %d"), (int)Message->message_type);
-#endif
-	return FSBMessageInfo();
+	Subscriptions.Unsubscribe(ChannelUrl);
 }
+//- Subscription
 
-bool SBChatManager::DeleteHistoryMessage(uint64 MessageID)
+//+ MessageCache
+FSBMessageInfo SBChatManager::ToMessageInfo(const SBChatMessageCache::FCachedMessage& Message)
 {
-	return (0 < HistoryMessages.Remove(MessageID));
+	FDateTime MessageTime = SBChatMessageProjection::ToDateTime(Message.UpdatedAt != 0 ? Message.UpdatedAt : Message.CreatedAt);
+	const ESBMessageType MessageType = (ESBMessageType)Message.MessageType;
+	if (MessageType == ESBMessageType::SBDMessageTypeAdmin)
+		return FSBMessageInfo(Message.MessageID, FSBUserInfo(TEXT("Admin"), TEXT("Admin"), TEXT("")), MessageType, Message.Message, MessageTime);
+
+	return FSBMessageInfo(Message.MessageID, FSBUserInfo(Message.SenderID, Message.NickName, Message.ProfileUrl), MessageType, Message.Message, MessageTime);
 }
 
-const FSBMessageInfo SBChatManager::UpdateHistoryMessage(SBDBaseMessage* Message)
+void SBChatManager::ReconcileCachedHistory(SBDBaseChannel* Channel, const TArray<SBChatMessageCache::FCachedMessage>& CachedMessages)
 {
 #if WITH_SENDBIRD
-	if (!ensure(Message))
-		return FSBMessageInfo();
+	if (!ensure(Channel) || CachedMessages.Num() == 0)
+		return;
 
-	bool bUpdated = SetHistoryMessage(Message->message_id, Message);
-	if (!ensure(bUpdated))
-		return FSBMessageInfo();
+	SBChatSyncEngine::FHeldMessages Held;
+	Held.Reserve(CachedMessages.Num());
+	for (const SBChatMessageCache::FCachedMessage& CachedMessage : CachedMessages)
+		Held.Add(CachedMessage.MessageID, SBChatSyncEngine::FHeldMessage{ CachedMessage.CreatedAt, CachedMessage.UpdatedAt });
 
-	FDateTime MessageTime = SendbirdTimeToDateTime(Message->updated_at != 0 ? Message->updated_at : Message->created_at);
-	if (Message->message_type == SBDMessageType::User)
-	{
-		SBDUserMessage* UserMessage = static_cast<SBDUserMessage*>(Message);
-		return FSBMessageInfo(Message->message_id, FSBUserInfo(UserMessage->sender),
-			(ESBMessageType)UserMessage->message_type, WCHAR_TO_TCHAR(UserMessage->message.c_str()), MessageTime);
-	}
-	else if (Message->message_type == SBDMessageType::Admin)
+	if (Channel == CurrentChannel)
 	{
-		SBDAdminMessage* AdminMessage = static_cast<SBDAdminMessage*>(Message);
-		return FSBMessageInfo(Message->message_id, FSBUserInfo(TEXT("Admin"), TEXT("Admin"), TEXT("")),
-			(ESBMessageType)AdminMessage->message_type, WCHAR_TO_TCHAR(AdminMessage->message.c_str()), MessageTime);
+		CachedTailChannelUrl = SendbirdTranscode::ToFString(Channel->channel_url);
+		CachedTail = Held;
 	}
-	else if (Message->message_type == SBDMessageType::File)
+
+	// The newest cached message anchors one request: the cached window before it and the first page after it.
+	// A full page after it means the gap is longer, and the sync engine pages through the rest.
+	const SBChatMessageCache::FCachedMessage& Newest = CachedMessages.Last();
+	const int64 PrevLimit = CachedMessages.Num();
+	const int64 NextLimit = MESSAGE_QUERY_LIST_LIMIT;
+	Channel->GetMessagesByMessageId((int64)Newest.MessageID, PrevLimit, NextLimit, false, SBDMessageTypeFilter::All, SBD_NULL_WSTRING,
+		[Channel, Held, PrevLimit, NextLimit, OldestCreatedAt = CachedMessages[0].CreatedAt, NewestCreatedAt = Newest.CreatedAt](const std::vector<SBDBaseMessage*>& Messages, SBDError* Error) {
+		if (Error != nullptr)
+		{
+			// The anchor itself was deleted; page through everything since the oldest cached message.
+			SBChatManager::Get().GetSyncEngine().Sync(Channel, OldestCreatedAt - 1, Held,
+				[](SBDBaseChannel* SyncedChannel, const SBChatSyncEngine::FHeldMessages& SyncedHeld, const std::vector<SBDBaseMessage*>& SyncedMessages, int64 WindowStart, int64 WindowEnd) {
+				SBChatManager::Get().HandOverSyncedMessages(SyncedChannel, SyncedHeld, SyncedMessages, WindowStart, WindowEnd);
+			});
+			return;
+		}
+
+		int64 PrevCount = 0;
+		int64 WindowStart = MAX_int64;
+		for (SBDBaseMessage* Message : Messages)
+		{
+			if (Message->created_at <= NewestCreatedAt)
+				++PrevCount;
+			WindowStart = FMath::Min(WindowStart, Message->created_at);
+		}
+
+		// A short previous page means the server has nothing older, so every cached message is covered.
+		const int64 CoveredFrom = PrevCount < PrevLimit ? MIN_int64 : WindowStart;
+		const bool bMoreAfter = (int64)Messages.size() - PrevCount >= NextLimit;
+		SBChatManager::RunOnGameThread([Channel, Held, Loaded = TArray<SBDBaseMessage*>(Messages.data(), (int32)Messages.size()), CoveredFrom, bMoreAfter]() {
+			SBChatManager::Get().ApplySyncedMessages(Channel, Held, Loaded, CoveredFrom, MAX_int64);
+			if (bMoreAfter)
+				SBChatManager::Get().SyncChannel(Channel);
+		});
+	});
+#endif
+}
+//- MessageCache
+
+//+ Sync
+bool SBChatManager::HasHistoryOf(SBDBaseChannel* Channel)
+{
+#if WITH_SENDBIRD
+	if (Channel == nullptr || Channel != CurrentChannel || GetHistoryMessages().IsEmpty())
+		return false;
+
+	// Shown from the cache and not reconciled yet: the history can still hold the previous channel as well.
+	if (!CachedTailChannelUrl.IsEmpty())
+		return false;
+
+	// The manager's own history is only reset when a channel is loaded, so it can still hold the previous one.
+	return GetHistoryMessages().GetAt(0)->channel_url == Channel->channel_url;
+#else
+	return false;
+#endif
+}
+
+bool SBChatManager::SyncChannel(SBDBaseChannel* Channel)
+{
+#if WITH_SENDBIRD
+	if (!ensure(Channel))
+		return false;
+
+	// The latest page of what is held is read again with the gap, which is where edits and deletes are looked for.
+	SBChatSyncEngine::FHeldMessages Held;
+	int64 FromTime = MAX_int64;
+	auto CollectHeld = [&Held, &FromTime](const SBChatHistoryStore& History) {
+		TArray<SBDBaseMessage*> Latest;
+		History.GetLatest(MESSAGE_QUERY_LIST_LIMIT, Latest);
+		Held.Reserve(Latest.Num());
+		for (SBDBaseMessage* Message : Latest)
+		{
+			Held.Add(Message->message_id, SBChatSyncEngine::FHeldMessage{ Message->created_at, Message->updated_at });
+			FromTime = FMath::Min(FromTime, Message->created_at - 1);
+		}
+	};
+
+	if (HasHistoryOf(Channel))
+		CollectHeld(GetHistoryMessages());
+	else
+		Subscriptions.Update(Channel, [&CollectHeld](SBChatSubscriptions::FState& State) { CollectHeld(State.History); });
+
+	SBChatSyncEngine::FWatermark Watermark;
+	if (SyncEngine.GetWatermark(*SBChatStringTable::Get().Intern(Channel->channel_url), Watermark))
+		FromTime = FMath::Min(FromTime, Watermark.NewestCreatedAt);
+
+	if (FromTime == MAX_int64)
+		return false;
+
+	SyncEngine.Sync(Channel, FromTime, MoveTemp(Held),
+		[this](SBDBaseChannel* SyncedChannel, const SBChatSyncEngine::FHeldMessages& SyncedHeld, const std::vector<SBDBaseMessage*>& Messages, int64 WindowStart, int64 WindowEnd) {
+		HandOverSyncedMessages(SyncedChannel, SyncedHeld, Messages, WindowStart, WindowEnd);
+	});
+	return true;
+#else
+	return false;
+#endif
+}
+
+void SBChatManager::SyncChannels()
+{
+	if (!IsInGameThread())
 	{
-		SBDFileMessage* FileMessage = static_cast<SBDFileMessage*>(Message);
-		return FSBMessageInfo(Message->message_id, FSBUserInfo(FileMessage->sender),
-			(ESBMessageType)FileMessage->message_type, WCHAR_TO_TCHAR(FileMessage->name.c_str()), MessageTime);
+		AsyncTask(ENamedThreads::GameThread, [this]() { SyncChannels(); });
+		return;
 	}
 
-	ensureMsgf(false, TEXT("Unknown MessageType : %d"), (int)Message->message_type);
-#endif
-	return FSBMessageInfo();
+	TArray<SBDBaseChannel*> SyncChannelList;
+	if (HasHistoryOf(CurrentChannel))
+		SyncChannelList.Add(CurrentChannel);
+
+	Subscriptions.ForEach([&SyncChannelList](const SBChatSubscriptions::FState& State) {
+		if (State.bHistoryLoaded)
+			SyncChannelList.AddUnique(State.Channel);
+	});
+
+	for (SBDBaseChannel* Channel : SyncChannelList)
+		SyncChannel(Channel);
 }
-//- Common
+//- Sync
 
 //+ User
 SBDUserListQuery* SBChatManager::CreateAllUserListQuery()
 {
 #if WITH_SENDBIRD
-	UserListQuery = SBDMain::CreateAllUserListQuery();
+	SBDUserListQuery* UserListQuery = SBDMain::CreateAllUserListQuery();
 	if (!ensureMsgf(UserListQuery, TEXT("[SBChatManager::CreateAllUserListQuery()] CreateAllUserListQuery() failed!!")))
 		return nullptr;
 
 	UserListQuery->limit = SBChatManager::USER_QUERY_LIST_LIMIT;
+	UserPages.SetQuery(UserListQuery);
 	return UserListQuery;
 #else
 	return nullptr;
 #endif
 }
-
-bool SBChatManager::IsInUserList(const std::wstring& UserID)
-{
-#if WITH_SENDBIRD
-	for (const SBDUser& User : UserList)
-	{
-		if (User.user_id == UserID)
-			return true;
-	}
-#endif
-	return false;
-}
 //- User
 
 //+ OpenChannel
 SBDOpenChannelListQuery* SBChatManager::CreateOpenChannelListQuery()
 {
 #if WITH_SENDBIRD
-	OpenChannelListQuery = SBDOpenChannel::CreateOpenChannelListQuery();
+	SBDOpenChannelListQuery* OpenChannelListQuery = SBDOpenChannel::CreateOpenChannelListQuery();
 	if (!ensureMsgf(OpenChannelListQuery, TEXT("[SBChatManager::CreateOpenChannelListQuery()] CreateOpenChannelListQuery() failed!!")))
 		return nullptr;
 
 	OpenChannelListQuery->limit = SBChatManager::CHANNEL_QUERY_LIST_LIMIT;
+	OpenChannelPages.SetQuery(OpenChannelListQuery);
 	return OpenChannelListQuery;
 #else
 	return nullptr;
 #endif
 }
 
-SBDOpenChannel* SBChatManager::GetSelectedOpenChannel(int Index, const FString& Name)
+SBDOpenChannel* SBChatManager::GetOpenChannel(const FSBChannelHandle& Handle)
 {
-#if WITH_SENDBIRD
-	if (!ensureMsgf(OpenChannels.IsValidIndex(Index), TEXT("[SBChatManager::GetSelectedOpenChannel] Wrong Index(%d)!!"), Index))
+	if (!ensureMsgf(Handle.IsValid() && !Handle.IsGroupChannel, TEXT("[SBChatManager::GetOpenChannel] Wrong Handle(%s)!!"), *Handle.ChannelUrl))
 		return nullptr;
 
-	if (!ensureMsgf(Name.Compare(WCHAR_TO_TCHAR(OpenChannels[Index]->name.c_str())) == 0,
-		TEXT("[SBChatManager::GetSelectedOpenChannel] Wrong Name(%s) != ChannelName(%s)!!"), *Name, WCHAR_TO_TCHAR(OpenChannels[Index]->name.c_str())))
+	return Channels.FindOpenChannel(Handle.ChannelUrl);
+}
+
+SBDOpenChannel* SBChatManager::GetSelectedOpenChannel(int Index, const FString& Name)
+{
+	SBDBaseChannel* Channel = Channels.FindByName(false, Index, Name);
+	if (!ensureMsgf(Channel, TEXT("[SBChatManager::GetSelectedOpenChannel] Wrong Index(%d) or Name(%s)!!"), Index, *Name))
 		return nullptr;
 
-	return OpenChannels[Index];
-#else
-	return nullptr;
-#endif
+	return static_cast<SBDOpenChannel*>(Channel);
 }
 
 SBDUserListQuery* SBChatManager::CreateParticipantListQuery(SBDOpenChannel* OpenChannel)
 {
 #if WITH_SENDBIRD
-	UserListQuery = OpenChannel->CreateParticipantListQuery();
+	SBDUserListQuery* UserListQuery = OpenChannel->CreateParticipantListQuery();
 	if (!ensureMsgf(UserListQuery, TEXT("[SBChatManager::CreateParticipantListQuery()] CreateParticipantListQuery() failed!!")))
 		return nullptr;
 
 	UserListQuery->limit = SBChatManager::USER_QUERY_LIST_LIMIT;
+	UserPages.SetQuery(UserListQuery);
 	return UserListQuery;
 #else
 	return nullptr;
@@ -235,143 +514,262 @@ SBDUserListQuery* SBChatManager::CreateParticipantListQuery(SBDOpenChannel* Open
 SBDGroupChannelListQuery* SBChatManager::CreateGroupChannelListQuery()
 {
 #if WITH_SENDBIRD
-	GroupChannelListQuery = SBDGroupChannel::CreateMyGroupChannelListQuery();
+	SBDGroupChannelListQuery* GroupChannelListQuery = SBDGroupChannel::CreateMyGroupChannelListQuery();
 	if (!ensureMsgf(GroupChannelListQuery, TEXT("[SBChatManager::CreateGroupChannelListQuery()] CreateMyGroupChannelListQuery() failed!!")))
 		return nullptr;
 
 	GroupChannelListQuery->limit = SBChatManager::CHANNEL_QUERY_LIST_LIMIT;
 	GroupChannelListQuery->include_empty_channel = true;
 	GroupChannelListQuery->include_member_list = true;
+	GroupChannelPages.SetQuery(GroupChannelListQuery);
 	return GroupChannelListQuery;
 #else
 	return nullptr;
 #endif
 }
 
-SBDGroupChannel* SBChatManager::GetSelectedGroupChannel(int Index, const FString& Name)
+SBDGroupChannel* SBChatManager::GetGroupChannel(const FSBChannelHandle& Handle)
 {
-#if WITH_SENDBIRD
-	if (!ensureMsgf(GroupChannels.IsValidIndex(Index), TEXT("[SBChatManager::GetSelectedGroupChannel] Wrong Index(%d)!!"), Index))
+	if (!ensureMsgf(Handle.IsValid() && Handle.IsGroupChannel, TEXT("[SBChatManager::GetGroupChannel] Wrong Handle(%s)!!"), *Handle.ChannelUrl))
 		return nullptr;
 
-	if (!ensureMsgf(Name.Compare(WCHAR_TO_TCHAR(GroupChannels[Index]->name.c_str())) == 0,
-		TEXT("[SBChatManager::GetSelectedGroupChannel] Wrong Name(%s) != ChannelName(%s)!!"), *Name, WCHAR_TO_TCHAR(GroupChannels[Index]->name.c_str())))
+	return Channels.FindGroupChannel(Handle.ChannelUrl);
+}
+
+SBDGroupChannel* SBChatManager::GetSelectedGroupChannel(int Index, const FString& Name)
+{
+	SBDBaseChannel* Channel = Channels.FindByName(true, Index, Name);
+	if (!ensureMsgf(Channel, TEXT("[SBChatManager::GetSelectedGroupChannel] Wrong Index(%d) or Name(%s)!!"), Index, *Name))
 		return nullptr;
 
-	return GroupChannels[Index];
-#else
-	return nullptr;
-#endif
+	return static_cast<SBDGroupChannel*>(Channel);
 }
 //- GroupChannel
 
 //+ SBDChannelHandler
 void SBChatManager::MessageReceived(SBDBaseChannel* channel, SBDBaseMessage* message)
 {
+	SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_HandlerMessageReceived);
+
 #if WITH_SENDBIRD
-	if (channel != CurrentChannel)
-		return;
+	const double HandlerTime = FPlatformTime::Seconds();
+	RunOnGameThread([this, channel, message, HandlerTime]() {
+		SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_ApplyMessageReceived);
 
-	if (!ChannelEvent.IsValid())
-		return;
+		Channels.Touch(channel, message->created_at);
 
-	if (ensure(ChannelEvent->GetClass()->ImplementsInterface(USBChatChannelEvent::StaticClass())))
-	{
-		if (channel->is_group_channel)
+		// A send whose ack was lost is Failed in the outbox; its echo goes once the server shows it has the message.
+		FString RequestID;
+		const int64 LocalMessageID = ClaimFailedSend(channel, message, RequestID);
+
+		if (channel != CurrentChannel)
 		{
-			SBDGroupChannel* GroupChannel = static_cast<SBDGroupChannel*>(channel);
-			GroupChannel->MarkAsRead();
+			if (channel->is_group_channel)
+				UnreadCounter.OnMessageReceived(static_cast<SBDGroupChannel*>(channel), IsSentByCurrentUser(message));
+
+			Subscriptions.Update(channel, [this, message](SBChatSubscriptions::FState& State) {
+				if (!State.History.Add(message))
+					return;
+
+				PersistMessage(message);
+				if (!IsSentByCurrentUser(message))
+					++State.UnreadCount;
+			});
+			return;
 		}
 
-		if (GetHistoryMessage(message->message_id) != nullptr)
+		if (!ChannelEvent.IsValid())
 			return;
 
-		const FSBMessageInfo AddedMessage = AddHistoryMessage(message);
-		AsyncTask(ENamedThreads::GameThread, [AddedMessage]() {
-			if (SBChatManager::Get().GetChannelEvent().IsValid())
-				ISBChatChannelEvent::Execute_OnMessageReceived(SBChatManager::Get().GetChannelEvent().Get(), AddedMessage);
-		});
-	}
+		if (ensure(ChannelEvent->GetClass()->ImplementsInterface(USBChatChannelEvent::StaticClass())))
+		{
+			if (channel->is_group_channel)
+			{
+				SBDGroupChannel* GroupChannel = static_cast<SBDGroupChannel*>(channel);
+				ReadReceiptScheduler.RequestMarkAsRead(GroupChannel);
+			}
+
+			if (LocalMessageID < 0)
+			{
+				FSBMessageInfo MessageInfo = (GetHistoryMessage(message->message_id) != nullptr) ? ToMessageInfo(message) : AddHistoryMessage(message);
+				MessageInfo.RequestID = RequestID;
+				EventQueue.EnqueueMessageSent(LocalMessageID, MoveTemp(MessageInfo), HandlerTime);
+				return;
+			}
+
+			if (GetHistoryMessage(message->message_id) != nullptr)
+				return;
+
+			EventQueue.EnqueueMessageReceived(AddHistoryMessage(message), HandlerTime);
+		}
+	});
 #endif
 }
 
 void SBChatManager::MessageUpdated(SBDBaseChannel* channel, SBDBaseMessage* message)
 {
+	SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_HandlerMessageUpdated);
+
 #if WITH_SENDBIRD
-	if (channel != CurrentChannel)
-		return;
+	const double HandlerTime = FPlatformTime::Seconds();
+	RunOnGameThread([this, channel, message, HandlerTime]() {
+		SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_ApplyMessageUpdated);
 
-	if (!ChannelEvent.IsValid())
-		return;
+		if (channel != CurrentChannel)
+		{
+			Subscriptions.Update(channel, [this, message](SBChatSubscriptions::FState& State) {
+				if (State.History.Update(message))
+					PersistMessage(message);
+			});
+			return;
+		}
 
-	if (ensure(ChannelEvent->GetClass()->ImplementsInterface(USBChatChannelEvent::StaticClass())))
-	{
-		const FSBMessageInfo UpdatedMessage = UpdateHistoryMessage(message);
-		AsyncTask(ENamedThreads::GameThread, [UpdatedMessage]() {
-			if (SBChatManager::Get().GetChannelEvent().IsValid())
-				ISBChatChannelEvent::Execute_OnMessageUpdated(SBChatManager::Get().GetChannelEvent().Get(), UpdatedMessage);
-		});
-	}
+		if (!ChannelEvent.IsValid())
+			return;
+
+		if (!ensure(ChannelEvent->GetClass()->ImplementsInterface(USBChatChannelEvent::StaticClass())))
+			return;
+
+		// A cached message on screen joins the history with its edit.
+		bool bShown = UpdateHistoryMessage(message);
+		if (!bShown && CachedTail.Remove(message->message_id) > 0)
+			bShown = GetHistoryMessages().Add(message);
+
+		// A message the history no longer holds is not on screen to update.
+		if (bShown)
+			EventQueue.EnqueueMessageUpdated(ToMessageInfo(message), HandlerTime);
+	});
 #endif
 }
 
 void SBChatManager::MessageDeleted(SBDBaseChannel* channel, uint64_t message_id)
 {
+	SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_HandlerMessageDeleted);
+
 #if WITH_SENDBIRD
-	if (channel != CurrentChannel)
-		return;
+	const double HandlerTime = FPlatformTime::Seconds();
+	RunOnGameThread([this, channel, message_id, HandlerTime]() {
+		SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_ApplyMessageDeleted);
 
-	if (!ChannelEvent.IsValid())
-		return;
+		// The budget may have evicted the message from the history, but the disk cache can still hold it.
+		MessageCache.Remove(*SBChatStringTable::Get().Intern(channel->channel_url), message_id);
 
-	if (ensure(ChannelEvent->GetClass()->ImplementsInterface(USBChatChannelEvent::StaticClass())))
-	{
-		ensure(DeleteHistoryMessage(message_id));
-		AsyncTask(ENamedThreads::GameThread, [message_id]() {
-			if (SBChatManager::Get().GetChannelEvent().IsValid())
-				ISBChatChannelEvent::Execute_OnMessageDeleted(SBChatManager::Get().GetChannelEvent().Get(), message_id);
-		});
-	}
+		if (channel != CurrentChannel)
+		{
+			Subscriptions.Update(channel, [message_id](SBChatSubscriptions::FState& State) {
+				State.History.Remove(message_id);
+			});
+			SearchIndex.Remove(message_id);
+			return;
+		}
+
+		if (!ChannelEvent.IsValid())
+			return;
+
+		if (!ensure(ChannelEvent->GetClass()->ImplementsInterface(USBChatChannelEvent::StaticClass())))
+			return;
+
+		const bool bShown = DeleteHistoryMessage(message_id);
+		if (CachedTail.Remove(message_id) > 0 || bShown)
+			EventQueue.EnqueueMessageDeleted(message_id, HandlerTime);
+	});
+#endif
+}
+
+void SBChatManager::ReadReceiptUpdated(SBDGroupChannel* channel)
+{
+	SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_HandlerReadReceiptUpdated);
+
+#if WITH_SENDBIRD
+	RunOnGameThread([this, channel]() {
+		SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_ApplyReadReceiptUpdated);
+
+		// The focused channel is being read already; its count stays at zero.
+		if (channel != CurrentChannel)
+			UnreadCounter.OnReadReceiptUpdated(channel);
+	});
 #endif
 }
 
 void SBChatManager::UserJoined(SBDGroupChannel* channel, SBDUser& user)
 {
-	if (channel != CurrentChannel)
-		return;
+	SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_HandlerUserJoined);
+
+	const double HandlerTime = FPlatformTime::Seconds();
+	RunOnGameThread([this, channel, User = user, HandlerTime]() {
+		SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_ApplyUserJoined);
 
-	ProcessChannelUserHandler(ESBChannelUserHandlerType::UserJoined, user);
+		UserDirectory.ApplyMembership(channel, User, true);
+		UpdateSubscribedMembers(channel, User, true);
+
+		if (channel != CurrentChannel)
+			return;
+
+		ProcessChannelUserHandler(ESBChannelUserHandlerType::UserJoined, User, HandlerTime);
+	});
 }
 
 void SBChatManager::UserLeft(SBDGroupChannel* channel, SBDUser& user)
 {
-	if (channel != CurrentChannel)
-		return;
+	SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_HandlerUserLeft);
 
-	if (SBDMain::GetCurrentUser() && user.user_id == SBDMain::GetCurrentUser()->user_id)
-		ResetCurrentChannel();
+	const double HandlerTime = FPlatformTime::Seconds();
+	RunOnGameThread([this, channel, User = user, HandlerTime]() {
+		SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_ApplyUserLeft);
+
+		UserDirectory.ApplyMembership(channel, User, false);
+		UpdateSubscribedMembers(channel, User, false);
+
+		if (channel != CurrentChannel)
+			return;
+
+		if (SBDMain::GetCurrentUser() && User.user_id == SBDMain::GetCurrentUser()->user_id)
+			ResetCurrentChannel();
 
-	ProcessChannelUserHandler(ESBChannelUserHandlerType::UserLeft, user);
+		ProcessChannelUserHandler(ESBChannelUserHandlerType::UserLeft, User, HandlerTime);
+	});
 }
 
 void SBChatManager::UserEntered(SBDOpenChannel* channel, SBDUser& user)
 {
-	if (channel != CurrentChannel)
-		return;
-	
-	ProcessChannelUserHandler(ESBChannelUserHandlerType::UserEntered, user);
+	SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_HandlerUserEntered);
+
+	const double HandlerTime = FPlatformTime::Seconds();
+	RunOnGameThread([this, channel, User = user, HandlerTime]() {
+		SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_ApplyUserEntered);
+
+		UserDirectory.ApplyMembership(channel, User, true);
+		UpdateSubscribedMembers(channel, User, true);
+
+		if (channel != CurrentChannel)
+			return;
+
+		ProcessChannelUserHandler(ESBChannelUserHandlerType::UserEntered, User, HandlerTime);
+	});
 }
 
 void SBChatManager::UserExited(SBDOpenChannel* channel, SBDUser& user)
 {
-	if (channel != CurrentChannel)
-		return;
-	
-	ProcessChannelUserHandler(ESBChannelUserHandlerType::UserExited, user);
+	SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_HandlerUserExited);
+
+	const double HandlerTime = FPlatformTime::Seconds();
+	RunOnGameThread([this, channel, User = user, HandlerTime]() {
+		SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_ApplyUserExited);
+
+		UserDirectory.ApplyMembership(channel, User, false);
+		UpdateSubscribedMembers(channel, User, false);
+
+		if (channel != CurrentChannel)
+			return;
+
+		ProcessChannelUserHandler(ESBChannelUserHandlerType::UserExited, User, HandlerTime);
+	});
 }
 
 void SBChatManager::InvitationReceived(SBDGroupChannel* channel, const std::vector<SBDUser>& invitees, SBDUser& inviter)
 {
+	SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_HandlerInvitationReceived);
+
 #if WITH_SENDBIRD
 	if (SBDMain::GetCurrentUser() == nullptr || channel == CurrentChannel)
 		return;
@@ -399,10 +797,12 @@ void SBChatManager::InvitationReceived(SBDGroupChannel* channel, const std::vect
 		if (!ensure(channel->is_group_channel))
 			return;
 
+		Channels.Add(channel);
 		AsyncTask(ENamedThreads::GameThread, [UserInfos, channel]()
 		{
 			if (SBChatManager::Get().GetChannelEvent().IsValid())
 			{
+				SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_DispatchInvitationReceived);
 				SBChatManager::Get().SetCurrentChannel(channel);
 				ISBChatChannelEvent::Execute_OnInvitationReceived(SBChatManager::Get().GetChannelEvent().Get(), FSBChannelInfo(channel), UserInfos);
 			}
@@ -410,61 +810,207 @@ void SBChatManager::InvitationReceived(SBDGroupChannel* channel, const std::vect
 	}
 #endif
 }
+
+void SBChatManager::ChannelDeleted(const std::wstring& channel_url, SBDChannelType channel_type)
+{
+	SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_HandlerChannelDeleted);
+
+#if WITH_SENDBIRD
+	RunOnGameThread([this, ChannelUrl = SendbirdTranscode::ToFString(channel_url)]() {
+		SBCHAT_SCOPE_CYCLE_COUNTER(STAT_SBChat_ApplyChannelDeleted);
+		RemoveChannel(ChannelUrl);
+	});
+#endif
+}
 //- SBDChannelHandler
 
 //+ private
-void SBChatManager::ProcessChannelUserHandler(ESBChannelUserHandlerType HandlerType, SBDUser& user)
+void SBChatManager::PersistMessage(SBDBaseMessage* Message)
+{
+	MessageCache.Put(Message);
+	SyncEngine.Observe(Message);
+	SearchIndex.Put(Message);
+}
+
+void SBChatManager::AdoptCachedTail(SBDBaseChannel* Channel)
 {
 #if WITH_SENDBIRD
-	if (!ChannelEvent.IsValid())
+	if (CachedTailChannelUrl.IsEmpty() || CachedTailChannelUrl != SendbirdTranscode::ToFString(Channel->channel_url))
 		return;
 
-	if (ensure(ChannelEvent->GetClass()->ImplementsInterface(USBChatChannelEvent::StaticClass())))
+	// Messages the handler delivered meanwhile stay, so the page doesn't deliver them again.
+	TArray<uint64> OtherChannelIDs;
+	GetHistoryMessages().ForEach([Channel, &OtherChannelIDs](SBDBaseMessage* Message) {
+		if (Message->channel_url != Channel->channel_url)
+			OtherChannelIDs.Add(Message->message_id);
+	});
+	for (uint64 MessageID : OtherChannelIDs)
+		GetHistoryMessages().Remove(MessageID);
+
+	CachedTailChannelUrl.Reset();
+	CachedTail.Reset();
+#endif
+}
+
+void SBChatManager::HandOverSyncedMessages(SBDBaseChannel* Channel, const SBChatSyncEngine::FHeldMessages& Held,
+	const std::vector<SBDBaseMessage*>& Messages, int64 WindowStart, int64 WindowEnd)
+{
+	RunOnGameThread([this, Channel, Held, Loaded = TArray<SBDBaseMessage*>(Messages.data(), (int32)Messages.size()), WindowStart, WindowEnd]() {
+		ApplySyncedMessages(Channel, Held, Loaded, WindowStart, WindowEnd);
+	});
+}
+
+void SBChatManager::ApplySyncedMessages(SBDBaseChannel* Channel, const SBChatSyncEngine::FHeldMessages& Held,
+	const TArray<SBDBaseMessage*>& Messages, int64 WindowStart, int64 WindowEnd)
+{
+#if WITH_SENDBIRD
+	if (Channel == CurrentChannel)
 	{
-		FSBUserInfo UserInfo(user);
-		AsyncTask(ENamedThreads::GameThread, [HandlerType, UserInfo]()
+		AdoptCachedTail(Channel);
+		ApplySyncedMessages(Channel, &GetHistoryMessages(), ChannelEvent.IsValid(), Held, Messages, WindowStart, WindowEnd);
+		if (Channel->is_group_channel)
+			ReadReceiptScheduler.RequestMarkAsRead(static_cast<SBDGroupChannel*>(Channel));
+		return;
+	}
+
+	// The user moved to another channel; a subscribed channel keeps its store current, and the cache is
+	// brought up to date for the next open either way.
+	const bool bSubscribed = Subscriptions.Update(Channel, [&](SBChatSubscriptions::FState& State) {
+		ApplySyncedMessages(Channel, &State.History, false, Held, Messages, WindowStart, WindowEnd);
+	});
+	if (!bSubscribed)
+		ApplySyncedMessages(Channel, nullptr, false, Held, Messages, WindowStart, WindowEnd);
+#endif
+}
+
+void SBChatManager::ApplySyncedMessages(SBDBaseChannel* Channel, SBChatHistoryStore* History, bool bNotify, const SBChatSyncEngine::FHeldMessages& Held,
+	const TArray<SBDBaseMessage*>& Messages, int64 WindowStart, int64 WindowEnd)
+{
+#if WITH_SENDBIRD
+	TSet<uint64> ServerIDs;
+	ServerIDs.Reserve(Messages.Num());
+	for (SBDBaseMessage* Message : Messages)
+	{
+		ServerIDs.Add(Message->message_id);
+
+		const SBChatSyncEngine::FHeldMessage* HeldMessage = Held.Find(Message->message_id);
+		if (HeldMessage == nullptr)
 		{
-			FString Message;
-			switch (HandlerType)
+			// Already delivered by the channel handler while the request was in flight.
+			if (History != nullptr && History->Contains(Message->message_id))
+				continue;
+
+			FString RequestID;
+			const int64 LocalMessageID = ClaimFailedSend(Channel, Message, RequestID);
+			if (History != nullptr)
+				History->Add(Message);
+			PersistMessage(Message);
+			if (!bNotify)
+				continue;
+
+			FSBMessageInfo MessageInfo = ToMessageInfo(Message);
+			if (LocalMessageID < 0)
 			{
-			case ESBChannelUserHandlerType::UserEntered:
-				if (SBDMain::GetCurrentUser() != nullptr && UserInfo.UserID != WCHAR_TO_TCHAR(SBDMain::GetCurrentUser()->user_id.c_str()))
-					Message = FString::Printf(TEXT("%s Entered."), *UserInfo.NickName);
-				if (SBChatManager::Get().GetChannelEvent().IsValid())
-					ISBChatChannelEvent::Execute_OnUserEntered(SBChatManager::Get().GetChannelEvent().Get(), UserInfo);
-				break;
-
-			case ESBChannelUserHandlerType::UserExited:
-				if (SBDMain::GetCurrentUser() != nullptr && UserInfo.UserID != WCHAR_TO_TCHAR(SBDMain::GetCurrentUser()->user_id.c_str()))
-					Message = FString::Printf(TEXT("%s Exited."), *UserInfo.NickName);
-				if (SBChatManager::Get().GetChannelEvent().IsValid())
-					ISBChatChannelEvent::Execute_OnUserExited(SBChatManager::Get().GetChannelEvent().Get(), UserInfo);
-				break;
-
-			case ESBChannelUserHandlerType::UserJoined:
-				if (SBChatManager::Get().GetChannelEvent().IsValid())
-					ISBChatChannelEvent::Execute_OnUserJoined(SBChatManager::Get().GetChannelEvent().Get(), UserInfo);
-				break;
-
-			case ESBChannelUserHandlerType::UserLeft:
-				if (SBChatManager::Get().GetChannelEvent().IsValid())
-					ISBChatChannelEvent::Execute_OnUserLeft(SBChatManager::Get().GetChannelEvent().Get(), UserInfo);
-				break;
+				MessageInfo.RequestID = RequestID;
+				EventQueue.EnqueueMessageSent(LocalMessageID, MoveTemp(MessageInfo));
 			}
-
-			if (!Message.IsEmpty())
+			else
 			{
-				const FSBMessageInfo AddedMessage(-1, UserInfo, ESBMessageType::SBDMessageTypeAdmin, Message, FDateTime::Now());
-				if (SBChatManager::Get().GetChannelEvent().IsValid())
-					ISBChatChannelEvent::Execute_OnMessageReceived(SBChatManager::Get().GetChannelEvent().Get(), AddedMessage);
+				EventQueue.EnqueueMessageReceived(MoveTemp(MessageInfo));
 			}
-		});
+		}
+		else if (HeldMessage->UpdatedAt != Message->updated_at)
+		{
+			if (History != nullptr)
+				History->Add(Message);
+			PersistMessage(Message);
+			if (bNotify)
+				EventQueue.EnqueueMessageUpdated(ToMessageInfo(Message));
+		}
+		else
+		{
+			// Unchanged, but a channel opened from the disk cache hasn't been indexed this session.
+			if (History != nullptr)
+				History->Add(Message);
+			SearchIndex.Put(Message);
+		}
 	}
+
+	const FSBChatStringRef ChannelUrlRef = SBChatStringTable::Get().Intern(Channel->channel_url);
+	const FString& ChannelUrl = *ChannelUrlRef;
+	for (const TPair<uint64, SBChatSyncEngine::FHeldMessage>& HeldPair : Held)
+	{
+		const bool bCovered = WindowStart <= HeldPair.Value.CreatedAt && HeldPair.Value.CreatedAt <= WindowEnd;
+		if (!bCovered || ServerIDs.Contains(HeldPair.Key))
+			continue;
+
+		if (History != nullptr)
+			History->Remove(HeldPair.Key);
+		MessageCache.Remove(ChannelUrl, HeldPair.Key);
+		SearchIndex.Remove(HeldPair.Key);
+		if (bNotify)
+			EventQueue.EnqueueMessageDeleted(HeldPair.Key);
+	}
+#endif
+}
+
+void SBChatManager::UpdateSubscribedMembers(SBDBaseChannel* Channel, const SBDUser& User, bool bJoined)
+{
+#if WITH_SENDBIRD
+	// Leaving a channel ends its subscription and its read receipts; there are no more events for it.
+	if (!bJoined && Channel->is_group_channel && SBDMain::GetCurrentUser() && User.user_id == SBDMain::GetCurrentUser()->user_id)
+	{
+		const FString ChannelUrl = SendbirdTranscode::ToFString(Channel->channel_url);
+		ReadReceiptScheduler.RemoveChannel(ChannelUrl);
+		UnsubscribeChannel(ChannelUrl);
+		return;
+	}
+
+	Subscriptions.Update(Channel, [&User, bJoined](SBChatSubscriptions::FState& State) {
+		if (bJoined)
+			State.Members.Add(User);
+		else
+			State.Members.Remove(User.user_id);
+	});
 #endif
 }
 
-FDateTime SBChatManager::SendbirdTimeToDateTime(int64 Time)
+bool SBChatManager::IsSentByCurrentUser(SBDBaseMessage* Message)
 {
-	return FDateTime(1970, 1, 1) + FTimespan(Time * ETimespan::TicksPerMillisecond);
+#if WITH_SENDBIRD
+	const SBDUser* CurrentUser = SBDMain::GetCurrentUser();
+	if (CurrentUser == nullptr)
+		return false;
+
+	if (Message->message_type == SBDMessageType::User)
+		return static_cast<SBDUserMessage*>(Message)->sender.user_id == CurrentUser->user_id;
+	else if (Message->message_type == SBDMessageType::File)
+		return static_cast<SBDFileMessage*>(Message)->sender.user_id == CurrentUser->user_id;
+#endif
+	return false;
+}
+
+void SBChatManager::ProcessChannelUserHandler(ESBChannelUserHandlerType HandlerType, const SBDUser& user, double HandlerTime)
+{
+#if WITH_SENDBIRD
+	if (!ChannelEvent.IsValid())
+		return;
+
+	if (ensure(ChannelEvent->GetClass()->ImplementsInterface(USBChatChannelEvent::StaticClass())))
+	{
+		FSBUserInfo UserInfo(user);
+		EventQueue.EnqueueUser(HandlerType, UserInfo, HandlerTime);
+
+		FString Message;
+		const bool bIsOtherUser = SBDMain::GetCurrentUser() != nullptr && user.user_id != SBDMain::GetCurrentUser()->user_id;
+		if (HandlerType == ESBChannelUserHandlerType::UserEntered && bIsOtherUser)
+			Message = FString::Printf(TEXT("%s Entered."), *UserInfo.NickName);
+		else if (HandlerType == ESBChannelUserHandlerType::UserExited && bIsOtherUser)
+			Message = FString::Printf(TEXT("%s Exited."), *UserInfo.NickName);
+
+		if (!Message.IsEmpty())
+			EventQueue.EnqueueMessageReceived(FSBMessageInfo(-1, UserInfo, ESBMessageType::SBDMessageTypeAdmin, Message, FDateTime::Now()), HandlerTime);
+	}
+#endif
 }
 //- private
@@ -3,11 +3,35 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Async/Async.h"
 #include "Sendbird/include/Sendbird.h"
 #include "SBChatCommonEnum.h"
+#include "SBChatHistoryStore.h"
+#include "SBChatChannelRegistry.h"
+#include "SBChatUserDirectory.h"
+#include "SBChatSubscriptions.h"
+#include "SBChatMessageCache.h"
+#include "SBChatSyncEngine.h"
+#include "SBChatPaginator.h"
+#include "SBChatProfileTextureCache.h"
+#include "SBChatAvatarAtlas.h"
+#include "SBChatEventQueue.h"
+#include "SBChatReadReceiptScheduler.h"
+#include "SBChatOutbox.h"
+#include "SBChatConnection.h"
+#include "SBChatUnreadCounter.h"
+#include "SBChatSendLimiter.h"
+#include "SBChatFileUploader.h"
+#include "SBChatThumbnail.h"
+#include "SBChatSearchIndex.h"
 
 class SBChatManager : public SBDChannelHandler
 {	
+public:
+	using FOpenChannelPaginator		= SBChatPaginator<SBDOpenChannelListQuery, SBDOpenChannel*>;
+	using FGroupChannelPaginator	= SBChatPaginator<SBDGroupChannelListQuery, SBDGroupChannel*>;
+	using FUserPaginator			= SBChatPaginator<SBDUserListQuery, SBDUser>;
+
 private:
 	SBChatManager();
 
@@ -23,46 +47,123 @@ public:
 	void								Reset();
 	void								SetChannelEvent(UObject* InChannelEvent);
 	TWeakObjectPtr<UObject>				GetChannelEvent() { return ChannelEvent; }
+	SBChatEventQueue&					GetEventQueue() { return EventQueue; }
+	SBChatReadReceiptScheduler&			GetReadReceiptScheduler() { return ReadReceiptScheduler; }
+	SBChatConnection&					GetConnection() { return Connection; }
+	SBChatUnreadCounter&				GetUnreadCounter() { return UnreadCounter; }
 
+	SBChatChannelRegistry&				GetChannels() { return Channels; }
 	SBDBaseChannel*						GetCurrentChannel() const { return CurrentChannel; }
-	void								SetCurrentChannel(SBDBaseChannel* Channel) { CurrentChannel = Channel; }
-	void								ResetCurrentChannel() { CurrentChannel = nullptr; }
+	// Switches the focused history, so it runs on the game thread; called from elsewhere it is handed over.
+	void								SetCurrentChannel(SBDBaseChannel* Channel);
+	void								ResetCurrentChannel() { SetCurrentChannel(nullptr); }
+	// Drops a channel that is gone and everything kept for it, then its registry entry. Runs on the game thread;
+	// called from elsewhere it is handed over.
+	void								RemoveChannel(const FString& ChannelUrl);
+
+	// Histories are game-thread state. SDK callbacks hand their changes over with this; on the game thread Func runs
+	// right away.
+	template<typename FuncType>
+	static void							RunOnGameThread(FuncType&& Func)
+	{
+		if (IsInGameThread())
+			Func();
+		else
+			AsyncTask(ENamedThreads::GameThread, Forward<FuncType>(Func));
+	}
 
-	TMap<int64, SBDBaseMessage*>&		GetHistoryMessages() { return HistoryMessages; }
-	void								ResetHistoryMessage() { HistoryMessages.Empty(); }
+	// The focused channel's history; a subscribed channel keeps its own store. Game thread only.
+	SBChatHistoryStore&					GetHistoryMessages() { return FocusedState != nullptr ? FocusedState->History : HistoryMessages; }
+	void								ResetHistoryMessage() { GetHistoryMessages().Reset(); }
+	// Budget of every history: the unfocused one, the subscribed ones and the ones subscribed later.
+	void								SetHistoryMemoryBudget(int64 BudgetBytes);
+	int64								GetHistoryMemoryBudget() const { return HistoryMemoryBudget; }
 	SBDBaseMessage*						GetHistoryMessage(uint64 MessageID);
 	bool								SetHistoryMessage(uint64 MessageID, SBDBaseMessage* NewMessage);
-	const struct FSBMessageInfo			AddHistoryMessage(SBDBaseMessage* Message);
+	struct FSBMessageInfo				AddHistoryMessage(SBDBaseMessage* Message);
+	// Projects the added message straight into OutMessageInfos.
+	void								AddHistoryMessage(SBDBaseMessage* Message, TArray<struct FSBMessageInfo>& OutMessageInfos);
 	bool								DeleteHistoryMessage(uint64 MessageID);
-	const struct FSBMessageInfo			UpdateHistoryMessage(SBDBaseMessage* Message);
+	// False when the history doesn't hold the message, e.g. once the budget evicted it.
+	bool								UpdateHistoryMessage(SBDBaseMessage* Message);
+	struct FSBMessageInfo				ToMessageInfo(SBDBaseMessage* Message);
 	//- Common
 
+	//+ MessageCache
+	SBChatMessageCache&					GetMessageCache() { return MessageCache; }
+	struct FSBMessageInfo				ToMessageInfo(const SBChatMessageCache::FCachedMessage& Message);
+	// Brings the history of a channel opened from the cache up to date; differences go out as channel events.
+	// The history only takes the channel over once the server answered; until then edits and deletes of the cached
+	// messages on screen are delivered from their ids.
+	void								ReconcileCachedHistory(SBDBaseChannel* Channel, const TArray<SBChatMessageCache::FCachedMessage>& CachedMessages);
+	//- MessageCache
+
+	//+ Sync
+	SBChatSyncEngine&					GetSyncEngine() { return SyncEngine; }
+	// True when the focused history still holds the channel, e.g. when re-entering the channel that was last open.
+	bool								HasHistoryOf(SBDBaseChannel* Channel);
+	// Fetches what changed since the history held for the channel; returns false when nothing is held to sync from.
+	// Game thread only.
+	bool								SyncChannel(SBDBaseChannel* Channel);
+	// Syncs the focused channel and every subscribed channel, e.g. after reconnecting. Called from elsewhere it is
+	// handed over to the game thread, where the histories it reads live.
+	void								SyncChannels();
+	//- Sync
+
+	//+ Outbox
+	SBChatOutbox&						GetOutbox() { return Outbox; }
+	SBChatSendLimiter&					GetSendLimiter() { return SendLimiter; }
+	SBChatFileUploader&					GetFileUploader() { return FileUploader; }
+	// Textures of image file messages' thumbnails, keyed by thumbnail url.
+	SBChatProfileTextureCache&			GetThumbnailTextures() { return ThumbnailTextures; }
+	// Puts a message the server acked in place of its echo; called on the SDK's thread, applied on the game thread.
+	// File uploads have no echo and pass a LocalMessageID of 0.
+	void								ReconcileSentMessage(SBDBaseChannel* Channel, int64 LocalMessageID, const FString& RequestID, SBDBaseMessage* Message);
+	// A message of ours the server has while its send failed here, e.g. when only the ack was lost: takes the send off
+	// the outbox, matched by the SDK's request_id, and returns its echo's local message id; 0 when there is none.
+	int64								ClaimFailedSend(SBDBaseChannel* Channel, SBDBaseMessage* Message, FString& OutRequestID);
+	//- Outbox
+
+	//+ Search
+	SBChatSearchIndex&					GetSearchIndex() { return SearchIndex; }
+	//- Search
+
+	//+ Subscription
+	SBChatSubscriptions&				GetSubscriptions() { return Subscriptions; }
+	// Game thread only, like the state it returns.
+	SBChatSubscriptions::FState*		SubscribeChannel(SBDBaseChannel* Channel);
+	// Called from elsewhere it is handed over to the game thread.
+	void								UnsubscribeChannel(const FString& ChannelUrl);
+	//- Subscription
+
 	//+ User
-	TMap<FString, UTexture2DDynamic*>	GetCachedProfileTexture() { return CachedProfileTexture; }
+	SBChatProfileTextureCache&			GetProfileTextures() { return ProfileTextures; }
+	SBChatAvatarAtlas&					GetAvatarAtlas() { return AvatarAtlas; }
 	
-	SBDUserListQuery*					GetUserListQuery() { return UserListQuery; }
-	TArray<SBDUser>&					GetUserList() { return UserList; }
-	void								ResetUserList() { UserList.Empty(); }
+	SBDUserListQuery*					GetUserListQuery() { return UserPages.GetQuery(); }
+	FUserPaginator&						GetUserPages() { return UserPages; }
+	SBChatUserDirectory&				GetUserDirectory() { return UserDirectory; }
+	void								ResetUserList(SBDBaseChannel* Channel = nullptr) { UserDirectory.Reset(Channel); }
 	SBDUserListQuery*					CreateAllUserListQuery();
-	bool								IsInUserList(const std::wstring& UserID);
+	bool								IsInUserList(const std::wstring& UserID) const { return UserDirectory.Contains(UserID); }
 	//- User
 
 	//+ OpenChannel
 	SBDOpenChannelListQuery*			CreateOpenChannelListQuery();
-	SBDOpenChannelListQuery*			GetOpenChannelListQuery() { return OpenChannelListQuery; }
-	TArray<SBDOpenChannel*>&			GetOpenChannels() { return OpenChannels; }
-	void								SetOpenChannels(const TArray<SBDOpenChannel*>& InOpenChannels) { OpenChannels = InOpenChannels; }
-	void								ResetOpenChannels() { OpenChannels.Empty(); ResetCurrentChannel(); }
+	SBDOpenChannelListQuery*			GetOpenChannelListQuery() { return OpenChannelPages.GetQuery(); }
+	FOpenChannelPaginator&				GetOpenChannelPages() { return OpenChannelPages; }
+	void								ResetOpenChannels() { Channels.ResetChannels(false); ResetCurrentChannel(); }
+	SBDOpenChannel*						GetOpenChannel(const struct FSBChannelHandle& Handle);
 	SBDOpenChannel*						GetSelectedOpenChannel(int Index, const FString& Name);
 	SBDUserListQuery*					CreateParticipantListQuery(SBDOpenChannel* OpenChannel);
 	//- OpenChannel
 
 	//+ GroupChannel
 	SBDGroupChannelListQuery*			CreateGroupChannelListQuery();
-	SBDGroupChannelListQuery*			GetGroupChannelListQuery() { return GroupChannelListQuery; }
-	TArray<SBDGroupChannel*>&			GetGroupChannels() { return GroupChannels; }
-	void								SetGroupChannels(const TArray<SBDGroupChannel*>& InGroupChannels) { GroupChannels = InGroupChannels; }
-	void								ResetGroupChannels() { GroupChannels.Empty(); ResetCurrentChannel(); }
+	SBDGroupChannelListQuery*			GetGroupChannelListQuery() { return GroupChannelPages.GetQuery(); }
+	FGroupChannelPaginator&				GetGroupChannelPages() { return GroupChannelPages; }
+	void								ResetGroupChannels() { Channels.ResetChannels(true); ResetCurrentChannel(); }
+	SBDGroupChannel*					GetGroupChannel(const struct FSBChannelHandle& Handle);
 	SBDGroupChannel*					GetSelectedGroupChannel(int Index, const FString& Name);
 	//- GroupChannel
 	
@@ -70,37 +171,69 @@ public:
 	virtual void						MessageReceived(SBDBaseChannel* channel, SBDBaseMessage* message) override;
 	virtual void						MessageUpdated(SBDBaseChannel* channel, SBDBaseMessage* message) override;
 	virtual void						MessageDeleted(SBDBaseChannel* channel, uint64_t message_id) override;
+	virtual void						ReadReceiptUpdated(SBDGroupChannel* channel) override;
 	virtual void						UserJoined(SBDGroupChannel* channel, SBDUser& user) override;
 	virtual void						UserLeft(SBDGroupChannel* channel, SBDUser& user) override;
 	virtual void						UserEntered(SBDOpenChannel* channel, SBDUser& user) override;
 	virtual void						UserExited(SBDOpenChannel* channel, SBDUser& user) override;
 	virtual void						InvitationReceived(SBDGroupChannel* channel, const std::vector<SBDUser>& invitees, SBDUser& inviter) override;
+	virtual void						ChannelDeleted(const std::wstring& channel_url, SBDChannelType channel_type) override;
 	//- SBDChannelHandler
 
 private:
-	void								ProcessChannelUserHandler(ESBChannelUserHandlerType HandlerType, SBDUser& user);
-	FDateTime							SendbirdTimeToDateTime(int64 Time);
+	void								PersistMessage(SBDBaseMessage* Message);
+	// Drops what the history still holds of other channels once the server answered for the cached tail on screen.
+	void								AdoptCachedTail(SBDBaseChannel* Channel);
+	// Sync pages arrive on the SDK's thread; this copies one and applies it on the game thread.
+	void								HandOverSyncedMessages(SBDBaseChannel* Channel, const SBChatSyncEngine::FHeldMessages& Held,
+											const std::vector<SBDBaseMessage*>& Messages, int64 WindowStart, int64 WindowEnd);
+	void								ApplySyncedMessages(SBDBaseChannel* Channel, const SBChatSyncEngine::FHeldMessages& Held,
+											const TArray<SBDBaseMessage*>& Messages, int64 WindowStart, int64 WindowEnd);
+	void								ApplySyncedMessages(SBDBaseChannel* Channel, SBChatHistoryStore* History, bool bNotify, const SBChatSyncEngine::FHeldMessages& Held,
+											const TArray<SBDBaseMessage*>& Messages, int64 WindowStart, int64 WindowEnd);
+	void								UpdateSubscribedMembers(SBDBaseChannel* Channel, const SBDUser& User, bool bJoined);
+	static bool							IsSentByCurrentUser(SBDBaseMessage* Message);
+	void								ProcessChannelUserHandler(ESBChannelUserHandlerType HandlerType, const SBDUser& user, double HandlerTime);
 
 private:
 	//+ Common
 	TWeakObjectPtr<UObject>				ChannelEvent;
+	SBChatEventQueue					EventQueue;
+	SBChatReadReceiptScheduler			ReadReceiptScheduler;
+	SBChatConnection					Connection;
+	SBChatUnreadCounter					UnreadCounter;
+	SBChatChannelRegistry				Channels;
 	SBDBaseChannel*						CurrentChannel;
-	TMap<int64, SBDBaseMessage*>		HistoryMessages;
+	SBChatHistoryStore					HistoryMessages;
+	int64								HistoryMemoryBudget;
+	SBChatMessageCache					MessageCache;
+	FString								CachedTailChannelUrl;
+	SBChatSyncEngine::FHeldMessages		CachedTail;
+	SBChatSyncEngine					SyncEngine;
+	SBChatOutbox						Outbox;
+	SBChatSendLimiter					SendLimiter;
+	SBChatFileUploader					FileUploader;
+	SBChatProfileTextureCache			ThumbnailTextures;
+	SBChatSearchIndex					SearchIndex;
 	//- Common
+
+	//+ Subscription
+	SBChatSubscriptions					Subscriptions;
+	SBChatSubscriptions::FState*		FocusedState;
+	//- Subscription
 	
 	//+ User
-	TMap<FString, UTexture2DDynamic*>	CachedProfileTexture;
-	SBDUserListQuery*					UserListQuery;
-	TArray<SBDUser>						UserList;
+	SBChatProfileTextureCache			ProfileTextures;
+	FUserPaginator						UserPages;
+	SBChatUserDirectory					UserDirectory;
+	SBChatAvatarAtlas					AvatarAtlas;
 	//- USer
 
 	//+ OpenChannel
-	SBDOpenChannelListQuery*			OpenChannelListQuery;
-	TArray<SBDOpenChannel*>				OpenChannels;
+	FOpenChannelPaginator				OpenChannelPages;
 	//- OpenChannel
 
 	//+ GroupChannel
-	SBDGroupChannelListQuery*			GroupChannelListQuery;
-	TArray<SBDGroupChannel*>			GroupChannels;
+	FGroupChannelPaginator				GroupChannelPages;
 	//- GroupChannel
 };
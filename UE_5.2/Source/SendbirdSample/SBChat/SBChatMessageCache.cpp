@@ -0,0 +1,689 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#include "SBChatMessageCache.h"
+#include "SBChatStringTable.h"
+#include "HAL/PlatformFileManager.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/Crc.h"
+#include "Algo/BinarySearch.h"
+#include "Hash/CityHash.h"
+#include "Async/Async.h"
+
+namespace
+{
+	const uint32 LOG_MAGIC = 0x434D4253;	// "SBMC"
+	const uint32 LOG_VERSION = 1;
+	const int64 RECORD_HEADER_SIZE = sizeof(uint32) * 2;	// payload size, payload crc
+	const int64 MIN_BYTES_TO_COMPACT = 64 * 1024;
+
+	enum class ERecordOp : uint8
+	{
+		Put = 1,
+		Remove = 2,
+	};
+
+	class FRecordWriter
+	{
+	public:
+		explicit FRecordWriter(TArray<uint8>& InBytes) : Bytes(InBytes) {}
+
+		template<typename T>
+		void Write(T Value)
+		{
+			Bytes.Append(reinterpret_cast<const uint8*>(&Value), sizeof(T));
+		}
+
+		void WriteString(const FString& Value)
+		{
+			FTCHARToUTF8 Converter(*Value);
+			Write<uint32>((uint32)Converter.Length());
+			Bytes.Append(reinterpret_cast<const uint8*>(Converter.Get()), Converter.Length());
+		}
+
+	private:
+		TArray<uint8>& Bytes;
+	};
+
+	class FRecordReader
+	{
+	public:
+		FRecordReader(const uint8* InData, int64 InSize) : Data(InData), Size(InSize), Position(0) {}
+
+		template<typename T>
+		bool Read(T& OutValue)
+		{
+			if (Position + (int64)sizeof(T) > Size)
+				return false;
+
+			FMemory::Memcpy(&OutValue, Data + Position, sizeof(T));
+			Position += sizeof(T);
+			return true;
+		}
+
+		bool ReadString(FString& OutValue)
+		{
+			uint32 Length = 0;
+			if (!Read(Length) || Position + Length > Size)
+				return false;
+
+			FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(Data + Position), Length);
+			OutValue = FString(Converter.Length(), Converter.Get());
+			Position += Length;
+			return true;
+		}
+
+	private:
+		const uint8* Data;
+		int64 Size;
+		int64 Position;
+	};
+
+	void EncodeRecord(TArray<uint8>& OutBytes, ERecordOp Op, uint64 MessageID, const SBChatMessageCache::FCachedMessage* Message)
+	{
+		TArray<uint8> Payload;
+		FRecordWriter Writer(Payload);
+		Writer.Write<uint8>((uint8)Op);
+		Writer.Write<uint64>(MessageID);
+		if (Op == ERecordOp::Put)
+		{
+			Writer.Write<int64>(Message->CreatedAt);
+			Writer.Write<int64>(Message->UpdatedAt);
+			Writer.Write<uint8>(Message->MessageType);
+			Writer.WriteString(Message->SenderID);
+			Writer.WriteString(Message->NickName);
+			Writer.WriteString(Message->ProfileUrl);
+			Writer.WriteString(Message->Message);
+		}
+
+		FRecordWriter Header(OutBytes);
+		Header.Write<uint32>((uint32)Payload.Num());
+		Header.Write<uint32>(FCrc::MemCrc32(Payload.GetData(), Payload.Num()));
+		OutBytes.Append(Payload);
+	}
+
+	bool DecodeMessage(const uint8* Payload, int64 PayloadSize, SBChatMessageCache::FCachedMessage& OutMessage)
+	{
+		FRecordReader Reader(Payload, PayloadSize);
+		uint8 Op = 0;
+		return Reader.Read(Op) && Op == (uint8)ERecordOp::Put
+			&& Reader.Read(OutMessage.MessageID)
+			&& Reader.Read(OutMessage.CreatedAt)
+			&& Reader.Read(OutMessage.UpdatedAt)
+			&& Reader.Read(OutMessage.MessageType)
+			&& Reader.ReadString(OutMessage.SenderID)
+			&& Reader.ReadString(OutMessage.NickName)
+			&& Reader.ReadString(OutMessage.ProfileUrl)
+			&& Reader.ReadString(OutMessage.Message);
+	}
+
+#if WITH_SENDBIRD
+	bool ToCachedMessage(SBDBaseMessage* Message, SBChatMessageCache::FCachedMessage& OutMessage)
+	{
+		OutMessage.MessageID = Message->message_id;
+		OutMessage.CreatedAt = Message->created_at;
+		OutMessage.UpdatedAt = Message->updated_at;
+		OutMessage.MessageType = (uint8)Message->message_type;
+
+		const SBDUser* Sender = nullptr;
+		if (Message->message_type == SBDMessageType::User)
+		{
+			SBDUserMessage* UserMessage = static_cast<SBDUserMessage*>(Message);
+			Sender = &UserMessage->sender;
+			OutMessage.Message = SBChatStringTable::Convert(UserMessage->message);
+		}
+		else if (Message->message_type == SBDMessageType::Admin)
+		{
+			OutMessage.Message = SBChatStringTable::Convert(static_cast<SBDAdminMessage*>(Message)->message);
+		}
+		else if (Message->message_type == SBDMessageType::File)
+		{
+			SBDFileMessage* FileMessage = static_cast<SBDFileMessage*>(Message);
+			Sender = &FileMessage->sender;
+			OutMessage.Message = SBChatStringTable::Convert(FileMessage->name);
+		}
+		else
+		{
+			return false;
+		}
+
+		if (Sender != nullptr)
+		{
+			OutMessage.SenderID = SBChatStringTable::Convert(Sender->user_id);
+			OutMessage.NickName = SBChatStringTable::Convert(Sender->nickname);
+			OutMessage.ProfileUrl = SBChatStringTable::Convert(Sender->profile_url);
+		}
+		return true;
+	}
+#endif
+}
+
+//+ FChannelLog
+class SBChatMessageCache::FChannelLog
+{
+public:
+	FChannelLog(const FString& InPath, const FString& InChannelUrl)
+		: Path(InPath), ChannelUrl(InChannelUrl)
+	{
+	}
+
+	~FChannelLog()
+	{
+		ReleaseMapping();
+		Writer.Reset();
+	}
+
+	bool Load()
+	{
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+		RecoverCompacted();
+		if (!PlatformFile.FileExists(*Path))
+			return true;
+
+		if (!Map())
+			return false;
+
+		TArray<uint8> Header;
+		EncodeHeader(Header);
+		if (DataSize < Header.Num() || FMemory::Memcmp(Data, Header.GetData(), Header.Num()) != 0)
+		{
+			// Another version, or another channel whose url hashed to the same name.
+			ReleaseMapping();
+			PlatformFile.DeleteFile(*Path);
+			FileSize = 0;
+			return true;
+		}
+
+		int64 Position = Header.Num();
+		while (Position + RECORD_HEADER_SIZE <= DataSize)
+		{
+			uint32 PayloadSize = 0;
+			uint32 PayloadCrc = 0;
+			FMemory::Memcpy(&PayloadSize, Data + Position, sizeof(uint32));
+			FMemory::Memcpy(&PayloadCrc, Data + Position + sizeof(uint32), sizeof(uint32));
+
+			const uint8* Payload = Data + Position + RECORD_HEADER_SIZE;
+			if (PayloadSize == 0 || Position + RECORD_HEADER_SIZE + PayloadSize > DataSize || FCrc::MemCrc32(Payload, PayloadSize) != PayloadCrc)
+				break;
+
+			FRecordReader Reader(Payload, PayloadSize);
+			uint8 Op = 0;
+			uint64 MessageID = 0;
+			int64 CreatedAt = 0;
+			Reader.Read(Op);
+			Reader.Read(MessageID);
+			if (Op == (uint8)ERecordOp::Put && Reader.Read(CreatedAt))
+				Index(MessageID, CreatedAt, Position, (int32)(RECORD_HEADER_SIZE + PayloadSize));
+			else if (Op == (uint8)ERecordOp::Remove)
+				Unindex(MessageID);
+
+			Position += RECORD_HEADER_SIZE + PayloadSize;
+		}
+
+		// Anything after the last good record is a torn write; compaction drops it. It is left to the writer, since the
+		// log may be opened by ReadTail on the game thread.
+		FileSize = DataSize;
+		const bool bTorn = Position < DataSize;
+		bNeedsCompaction = bTorn || IsMostlyDead() || ByTime.Num() > MAX_MESSAGES;
+		return true;
+	}
+
+	bool NeedsCompaction() const
+	{
+		return bNeedsCompaction;
+	}
+
+	void CompactIfNeeded()
+	{
+		if (bNeedsCompaction)
+			Compact();
+	}
+
+	void Append(ERecordOp Op, uint64 MessageID, const FCachedMessage* Message)
+	{
+		if (Op == ERecordOp::Remove && !ById.Contains(MessageID))
+			return;
+
+		// Nothing goes after a torn write.
+		if (bNeedsCompaction && !Compact())
+			return;
+
+		TArray<uint8> Record;
+		EncodeRecord(Record, Op, MessageID, Message);
+		if (!OpenWriter() || !Writer->Write(Record.GetData(), Record.Num()))
+			return;
+
+		const int64 Offset = FileSize;
+		FileSize += Record.Num();
+		if (Op == ERecordOp::Put)
+			Index(MessageID, Message->CreatedAt, Offset, Record.Num());
+		else
+			Unindex(MessageID);
+
+		// Edits and deletes leave dead records behind; a long session doesn't wait for the next open to drop them.
+		if (IsMostlyDead())
+			Compact();
+	}
+
+	void ReadTail(int32 MaxCount, TArray<FCachedMessage>& OutMessages)
+	{
+		OutMessages.Reset();
+		if (ByTime.Num() == 0 || !Map())
+			return;
+
+		const int32 First = FMath::Max(0, ByTime.Num() - MaxCount);
+		OutMessages.Reserve(ByTime.Num() - First);
+		for (int32 Index = First; Index < ByTime.Num(); ++Index)
+		{
+			const FIndexEntry& Entry = ById.FindChecked(ByTime[Index].MessageID);
+			if (Entry.Offset + Entry.Size > DataSize)
+				continue;
+
+			FCachedMessage& Message = OutMessages.AddDefaulted_GetRef();
+			if (!DecodeMessage(Data + Entry.Offset + RECORD_HEADER_SIZE, Entry.Size - RECORD_HEADER_SIZE, Message))
+				OutMessages.Pop(false);
+		}
+	}
+
+private:
+	struct FIndexEntry
+	{
+		int64							Offset;
+		int64							CreatedAt;
+		int32							Size;
+	};
+
+	struct FTimeKey
+	{
+		int64							CreatedAt;
+		uint64							MessageID;
+
+		bool operator<(const FTimeKey& Other) const
+		{
+			return CreatedAt < Other.CreatedAt || (CreatedAt == Other.CreatedAt && MessageID < Other.MessageID);
+		}
+	};
+
+	bool IsMostlyDead() const
+	{
+		return FileSize > MIN_BYTES_TO_COMPACT && LiveBytes * 2 < FileSize;
+	}
+
+	void EncodeHeader(TArray<uint8>& OutBytes) const
+	{
+		FRecordWriter Writer(OutBytes);
+		Writer.Write<uint32>(LOG_MAGIC);
+		Writer.Write<uint32>(LOG_VERSION);
+		Writer.WriteString(ChannelUrl);
+	}
+
+	// Reads and writes don't overlap: the writer is closed before mapping and the mapping released before writing,
+	// so platforms that don't allow both on one file behave the same.
+	bool Map()
+	{
+		if (Data != nullptr && DataSize == FileSize)
+			return true;
+
+		ReleaseMapping();
+		Writer.Reset();
+
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+		MappedHandle.Reset(PlatformFile.OpenMapped(*Path));
+		if (MappedHandle.IsValid())
+			MappedRegion.Reset(MappedHandle->MapRegion(0, MappedHandle->GetFileSize()));
+
+		if (MappedRegion.IsValid())
+		{
+			Data = MappedRegion->GetMappedPtr();
+			DataSize = MappedRegion->GetMappedSize();
+			return true;
+		}
+
+		ReleaseMapping();
+		if (!FFileHelper::LoadFileToArray(FallbackBuffer, *Path, FILEREAD_Silent))
+			return false;
+
+		Data = FallbackBuffer.GetData();
+		DataSize = FallbackBuffer.Num();
+		return true;
+	}
+
+	void ReleaseMapping()
+	{
+		MappedRegion.Reset();
+		MappedHandle.Reset();
+		FallbackBuffer.Empty();
+		Data = nullptr;
+		DataSize = 0;
+	}
+
+	bool OpenWriter()
+	{
+		if (Writer.IsValid())
+			return true;
+
+		ReleaseMapping();
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+		Writer.Reset(PlatformFile.OpenWrite(*Path, true));
+		if (!ensureMsgf(Writer.IsValid(), TEXT("[SBChatMessageCache::OpenWriter] OpenWrite(%s) failed!!"), *Path))
+			return false;
+
+		if (FileSize == 0)
+		{
+			TArray<uint8> Header;
+			EncodeHeader(Header);
+			if (!Writer->Write(Header.GetData(), Header.Num()))
+				return false;
+
+			FileSize = Header.Num();
+		}
+		return true;
+	}
+
+	void Index(uint64 MessageID, int64 CreatedAt, int64 Offset, int32 Size)
+	{
+		if (FIndexEntry* Existing = ById.Find(MessageID))
+		{
+			LiveBytes -= Existing->Size;
+			if (Existing->CreatedAt != CreatedAt)
+			{
+				RemoveTimeKey({ Existing->CreatedAt, MessageID });
+				InsertTimeKey({ CreatedAt, MessageID });
+			}
+			*Existing = { Offset, CreatedAt, Size };
+		}
+		else
+		{
+			ById.Add(MessageID, { Offset, CreatedAt, Size });
+			InsertTimeKey({ CreatedAt, MessageID });
+		}
+		LiveBytes += Size;
+	}
+
+	void Unindex(uint64 MessageID)
+	{
+		FIndexEntry Entry;
+		if (!ById.RemoveAndCopyValue(MessageID, Entry))
+			return;
+
+		LiveBytes -= Entry.Size;
+		RemoveTimeKey({ Entry.CreatedAt, MessageID });
+	}
+
+	void InsertTimeKey(const FTimeKey& Key)
+	{
+		// Messages mostly arrive in order, so this is usually an append.
+		if (ByTime.Num() == 0 || ByTime.Last() < Key)
+			ByTime.Add(Key);
+		else
+			ByTime.Insert(Key, Algo::LowerBound(ByTime, Key));
+	}
+
+	void RemoveTimeKey(const FTimeKey& Key)
+	{
+		const int32 Index = Algo::LowerBound(ByTime, Key);
+		if (Index < ByTime.Num() && ByTime[Index].MessageID == Key.MessageID)
+			ByTime.RemoveAt(Index, 1, false);
+	}
+
+	// A compacted log is written to a temp file and renamed to .compact once complete, so there is always one whole
+	// copy on disk: the platform can't rename over an existing file, and a crash can come between dropping the old log
+	// and moving the new one in. Whatever was interrupted is finished here.
+	void RecoverCompacted()
+	{
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+		PlatformFile.DeleteFile(*GetTempPath());
+		if (PlatformFile.FileExists(*GetCompactedPath()))
+			SwapInCompacted();
+	}
+
+	bool SwapInCompacted()
+	{
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+		if (PlatformFile.FileExists(*Path) && !PlatformFile.DeleteFile(*Path))
+			return false;
+
+		return PlatformFile.MoveFile(*Path, *GetCompactedPath());
+	}
+
+	FString GetTempPath() const { return Path + TEXT(".tmp"); }
+	FString GetCompactedPath() const { return Path + TEXT(".compact"); }
+
+	// Rewrites the newest MAX_MESSAGES live records into a fresh log.
+	bool Compact()
+	{
+		if (!Map())
+			return false;
+
+		TArray<uint8> Bytes;
+		EncodeHeader(Bytes);
+
+		const int32 First = FMath::Max(0, ByTime.Num() - MAX_MESSAGES);
+		TMap<uint64, FIndexEntry> NewById;
+		NewById.Reserve(ByTime.Num() - First);
+		for (int32 Index = First; Index < ByTime.Num(); ++Index)
+		{
+			const FIndexEntry& Entry = ById.FindChecked(ByTime[Index].MessageID);
+			NewById.Add(ByTime[Index].MessageID, { Bytes.Num(), Entry.CreatedAt, Entry.Size });
+			Bytes.Append(Data + Entry.Offset, Entry.Size);
+		}
+
+		ReleaseMapping();
+		Writer.Reset();
+
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+		const FString TempPath = GetTempPath();
+		PlatformFile.DeleteFile(*GetCompactedPath());
+		if (!FFileHelper::SaveArrayToFile(Bytes, *TempPath) || !PlatformFile.MoveFile(*GetCompactedPath(), *TempPath))
+		{
+			// The old log is untouched and stays in use.
+			PlatformFile.DeleteFile(*TempPath);
+			ensureMsgf(false, TEXT("[SBChatMessageCache::Compact] Writing %s failed!!"), *TempPath);
+			return false;
+		}
+
+		// From here on the compacted copy is whole, so a failed swap is finished by the next open.
+		if (!SwapInCompacted())
+		{
+			ensureMsgf(false, TEXT("[SBChatMessageCache::Compact] Replacing %s failed!!"), *Path);
+			return false;
+		}
+
+		ByTime.RemoveAt(0, First, false);
+		ById = MoveTemp(NewById);
+		bNeedsCompaction = false;
+		FileSize = Bytes.Num();
+		LiveBytes = 0;
+		for (const TPair<uint64, FIndexEntry>& Pair : ById)
+			LiveBytes += Pair.Value.Size;
+		return true;
+	}
+
+private:
+	FString								Path;
+	FString								ChannelUrl;
+
+	TUniquePtr<IMappedFileHandle>		MappedHandle;
+	TUniquePtr<IMappedFileRegion>		MappedRegion;
+	TArray<uint8>						FallbackBuffer;		// used where the platform can't map files
+	const uint8*						Data = nullptr;
+	int64								DataSize = 0;
+
+	TUniquePtr<IFileHandle>				Writer;
+	int64								FileSize = 0;
+	int64								LiveBytes = 0;
+	bool								bNeedsCompaction = false;
+
+	TMap<uint64, FIndexEntry>			ById;
+	TArray<FTimeKey>					ByTime;
+};
+//- FChannelLog
+
+SBChatMessageCache::SBChatMessageCache()
+	: bOpen(false)
+	, bWriterScheduled(false)
+{
+}
+
+SBChatMessageCache::~SBChatMessageCache()
+{
+	Close();
+}
+
+void SBChatMessageCache::Open(const FString& UserID)
+{
+	FScopeLock ScopeLock(&Lock);
+	// What is still queued belongs to the previous user's logs.
+	ApplyPendingWrites();
+	Logs.Empty();
+	RootDir.Empty();
+	bOpen = false;
+	if (!ensureMsgf(!UserID.IsEmpty(), TEXT("[SBChatMessageCache::Open] Empty UserID!!")))
+		return;
+
+	const FString Dir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("SBChat"), TEXT("MessageCache"), FPaths::MakeValidFileName(UserID));
+	if (FPlatformFileManager::Get().GetPlatformFile().CreateDirectoryTree(*Dir))
+	{
+		RootDir = Dir;
+		bOpen = true;
+	}
+}
+
+void SBChatMessageCache::Close()
+{
+	FScopeLock ScopeLock(&Lock);
+	// Writes already queued still go to disk, so a delete isn't lost with the session.
+	ApplyPendingWrites();
+	Logs.Empty();
+	RootDir.Empty();
+	bOpen = false;
+}
+
+bool SBChatMessageCache::IsOpen() const
+{
+	return bOpen;
+}
+
+void SBChatMessageCache::Put(SBDBaseMessage* Message)
+{
+#if WITH_SENDBIRD
+	if (!ensure(Message) || !bOpen)
+		return;
+
+	FPendingWrite Write;
+	Write.Op = EPendingOp::Put;
+	if (!ToCachedMessage(Message, Write.Message))
+		return;
+
+	Write.ChannelUrl = SBChatStringTable::Convert(Message->channel_url);
+	Write.MessageID = Write.Message.MessageID;
+	QueueWrite(MoveTemp(Write));
+#endif
+}
+
+void SBChatMessageCache::Remove(const FString& ChannelUrl, uint64 MessageID)
+{
+	if (!bOpen)
+		return;
+
+	FPendingWrite Write;
+	Write.Op = EPendingOp::Remove;
+	Write.ChannelUrl = ChannelUrl;
+	Write.MessageID = MessageID;
+	QueueWrite(MoveTemp(Write));
+}
+
+bool SBChatMessageCache::ReadTail(const FString& ChannelUrl, int32 MaxCount, TArray<FCachedMessage>& OutMessages)
+{
+	OutMessages.Reset();
+	FScopeLock ScopeLock(&Lock);
+	FChannelLog* Log = FindOrOpenLog(ChannelUrl);
+	if (Log == nullptr)
+		return false;
+
+	Log->ReadTail(MaxCount, OutMessages);
+	return OutMessages.Num() > 0;
+}
+
+//+ private
+void SBChatMessageCache::QueueWrite(FPendingWrite&& Write)
+{
+	PendingWrites.Enqueue(MoveTemp(Write));
+	if (!bWriterScheduled.Exchange(true))
+		Async(EAsyncExecution::ThreadPool, [this]() { RunWriter(); });
+}
+
+void SBChatMessageCache::RunWriter()
+{
+	for (;;)
+	{
+		{
+			FScopeLock ScopeLock(&Lock);
+			ApplyPendingWrites();
+		}
+		bWriterScheduled = false;
+
+		// A write queued between the last dequeue and clearing the flag found the writer still scheduled.
+		bool bMoreWrites = false;
+		{
+			FScopeLock ScopeLock(&Lock);
+			bMoreWrites = !PendingWrites.IsEmpty();
+		}
+		if (!bMoreWrites || bWriterScheduled.Exchange(true))
+			return;
+	}
+}
+
+void SBChatMessageCache::ApplyPendingWrites()
+{
+	FPendingWrite Write;
+	while (PendingWrites.Dequeue(Write))
+	{
+		FChannelLog* Log = FindOrOpenLog(Write.ChannelUrl);
+		if (Log == nullptr)
+			continue;
+
+		switch (Write.Op)
+		{
+		case EPendingOp::Put:
+			Log->Append(ERecordOp::Put, Write.MessageID, &Write.Message);
+			break;
+
+		case EPendingOp::Remove:
+			Log->Append(ERecordOp::Remove, Write.MessageID, nullptr);
+			break;
+
+		case EPendingOp::Compact:
+			Log->CompactIfNeeded();
+			break;
+		}
+	}
+}
+
+SBChatMessageCache::FChannelLog* SBChatMessageCache::FindOrOpenLog(const FString& ChannelUrl)
+{
+	if (RootDir.IsEmpty() || ChannelUrl.IsEmpty())
+		return nullptr;
+
+	if (TUniquePtr<FChannelLog>* Log = Logs.Find(ChannelUrl))
+		return Log->Get();
+
+	FTCHARToUTF8 Converter(*ChannelUrl);
+	const uint64 UrlHash = CityHash64(Converter.Get(), Converter.Length());
+	const FString Path = FPaths::Combine(RootDir, FString::Printf(TEXT("%016llx.sbcache"), UrlHash));
+
+	TUniquePtr<FChannelLog> Log = MakeUnique<FChannelLog>(Path, ChannelUrl);
+	if (!Log->Load())
+		return nullptr;
+
+	if (Log->NeedsCompaction())
+	{
+		FPendingWrite Write;
+		Write.Op = EPendingOp::Compact;
+		Write.ChannelUrl = ChannelUrl;
+		QueueWrite(MoveTemp(Write));
+	}
+	return Logs.Add(ChannelUrl, MoveTemp(Log)).Get();
+}
+//- private
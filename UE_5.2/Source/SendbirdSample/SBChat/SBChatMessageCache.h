@@ -0,0 +1,79 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "Sendbird/include/Sendbird.h"
+
+// Per-channel message cache on disk, so opening a channel can show its last messages before the network answers.
+// Each channel is an append-only log under Saved/SBChat/MessageCache/<UserID>/. A record is a put (the fields the UI
+// shows) or a delete, with a CRC so a torn write at the end of the log is dropped on load.
+// The log is memory-mapped for reads and indexed by message_id and by (created_at, message_id). A log is compacted
+// whenever more than half of it is dead, and when it is opened holding more than MAX_MESSAGES.
+// Put and Remove only convert the message and queue the record; a background writer appends it and compacts the log,
+// so the caller's thread never waits on the disk. ReadTail sees what the writer has appended so far.
+class SBChatMessageCache
+{
+public:
+	static const int32 MAX_MESSAGES = 2000;
+
+	struct FCachedMessage
+	{
+		uint64							MessageID = 0;
+		int64							CreatedAt = 0;
+		int64							UpdatedAt = 0;
+		uint8							MessageType = 0;
+		FString							SenderID;
+		FString							NickName;
+		FString							ProfileUrl;
+		FString							Message;
+	};
+
+	SBChatMessageCache();
+	~SBChatMessageCache();
+
+	// Caching is off until a user is set; logs are kept per user.
+	void								Open(const FString& UserID);
+	void								Close();
+	bool								IsOpen() const;
+
+	void								Put(SBDBaseMessage* Message);
+	void								Remove(const FString& ChannelUrl, uint64 MessageID);
+
+	// The newest MaxCount messages of the channel, oldest first.
+	bool								ReadTail(const FString& ChannelUrl, int32 MaxCount, TArray<FCachedMessage>& OutMessages);
+
+private:
+	class FChannelLog;
+
+	enum class EPendingOp : uint8
+	{
+		Put,
+		Remove,
+		Compact,
+	};
+
+	struct FPendingWrite
+	{
+		EPendingOp						Op = EPendingOp::Put;
+		FString							ChannelUrl;
+		uint64							MessageID = 0;
+		FCachedMessage					Message;		// Put only
+	};
+
+	void								QueueWrite(FPendingWrite&& Write);
+	void								RunWriter();
+	// Lock must be held.
+	void								ApplyPendingWrites();
+	FChannelLog*						FindOrOpenLog(const FString& ChannelUrl);
+
+private:
+	mutable FCriticalSection			Lock;		// held by the writer while it touches the logs, and by ReadTail
+	FString								RootDir;
+	TMap<FString, TUniquePtr<FChannelLog>>	Logs;
+
+	TQueue<FPendingWrite, EQueueMode::Mpsc>	PendingWrites;
+	TAtomic<bool>						bOpen;
+	TAtomic<bool>						bWriterScheduled;
+};
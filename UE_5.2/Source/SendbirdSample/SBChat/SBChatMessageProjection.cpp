@@ -0,0 +1,93 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#include "SBChatMessageProjection.h"
+#include "SBChatStringTable.h"
+
+namespace SBChatMessageProjection
+{
+	void Project(SBDBaseMessage* Message, FSBMessageInfo& OutMessageInfo)
+	{
+#if WITH_SENDBIRD
+		if (!ensure(Message))
+			return;
+
+		OutMessageInfo.MessageID = Message->message_id;
+		OutMessageInfo.MessageType = (ESBMessageType)Message->message_type;
+		OutMessageInfo.UpdatedTime = ToDateTime(Message->updated_at != 0 ? Message->updated_at : Message->created_at);
+		OutMessageInfo.SendingStatus = ESBMessageSendingStatus::Succeeded;
+
+		switch (Message->message_type)
+		{
+		case SBDMessageType::User:
+		{
+			SBDUserMessage* UserMessage = static_cast<SBDUserMessage*>(Message);
+			ProjectUser(UserMessage->sender, OutMessageInfo.UserInfo);
+			OutMessageInfo.Message = SBChatStringTable::Convert(UserMessage->message);
+			break;
+		}
+
+		case SBDMessageType::Admin:
+		{
+			SBDAdminMessage* AdminMessage = static_cast<SBDAdminMessage*>(Message);
+			OutMessageInfo.UserInfo.UserID = TEXT("Admin");
+			OutMessageInfo.UserInfo.NickName = TEXT("Admin");
+			OutMessageInfo.UserInfo.ProfileUrl.Reset();
+			OutMessageInfo.Message = SBChatStringTable::Convert(AdminMessage->message);
+			break;
+		}
+
+		case SBDMessageType::File:
+		{
+			SBDFileMessage* FileMessage = static_cast<SBDFileMessage*>(Message);
+			ProjectUser(FileMessage->sender, OutMessageInfo.UserInfo);
+			OutMessageInfo.Message = SBChatStringTable::Convert(FileMessage->name);
+			ProjectFile(FileMessage, OutMessageInfo.File);
+			break;
+		}
+
+		default:
+			ensureMsgf(false, TEXT("Unknown MessageType : %d"), (int)Message->message_type);
+			break;
+		}
+#endif
+	}
+
+	FSBMessageInfo& ProjectInto(SBDBaseMessage* Message, TArray<FSBMessageInfo>& OutMessageInfos)
+	{
+		FSBMessageInfo& MessageInfo = OutMessageInfos.AddDefaulted_GetRef();
+		Project(Message, MessageInfo);
+		return MessageInfo;
+	}
+
+	void ProjectUser(const SBDUser& User, FSBUserInfo& OutUserInfo)
+	{
+		OutUserInfo.UserID = SBChatStringTable::Convert(User.user_id);
+		OutUserInfo.NickName = SBChatStringTable::Convert(User.nickname);
+		OutUserInfo.ProfileUrl = SBChatStringTable::Convert(User.profile_url);
+	}
+
+	void ProjectFile(SBDFileMessage* FileMessage, FSBFileInfo& OutFileInfo)
+	{
+#if WITH_SENDBIRD
+		OutFileInfo.Url = SBChatStringTable::Convert(FileMessage->url);
+		OutFileInfo.Size = (int64)FileMessage->size;
+		OutFileInfo.MimeType = SBChatStringTable::Convert(FileMessage->type);
+
+		OutFileInfo.Thumbnails.Reset(FileMessage->thumbnails.size());
+		for (SBDThumbnail& Thumbnail : FileMessage->thumbnails)
+		{
+			FSBThumbnailInfo& ThumbnailInfo = OutFileInfo.Thumbnails.AddDefaulted_GetRef();
+			ThumbnailInfo.MaxWidth = Thumbnail.max_width;
+			ThumbnailInfo.MaxHeight = Thumbnail.max_height;
+			ThumbnailInfo.RealWidth = Thumbnail.real_width;
+			ThumbnailInfo.RealHeight = Thumbnail.real_height;
+			ThumbnailInfo.Url = SBChatStringTable::Convert(Thumbnail.GetUrl());
+		}
+#endif
+	}
+
+	FDateTime ToDateTime(int64 SendbirdTime)
+	{
+		return FDateTime(1970, 1, 1) + FTimespan(SendbirdTime * ETimespan::TicksPerMillisecond);
+	}
+}
@@ -0,0 +1,24 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Sendbird/include/Sendbird.h"
+#include "SBChatCommonStruct.h"
+
+// Turns SDK messages into FSBMessageInfo in one pass: a single switch on the message type, with every string
+// converted straight into the destination's members. There is no intermediate FSBUserInfo and no copy of the result;
+// lists are projected into their own slots, so reserve them first.
+namespace SBChatMessageProjection
+{
+	// OutMessageInfo is expected to be default constructed; fields a message type doesn't have are left alone.
+	void								Project(SBDBaseMessage* Message, FSBMessageInfo& OutMessageInfo);
+	// Appends a slot to OutMessageInfos and projects into it.
+	FSBMessageInfo&						ProjectInto(SBDBaseMessage* Message, TArray<FSBMessageInfo>& OutMessageInfos);
+
+	void								ProjectUser(const SBDUser& User, FSBUserInfo& OutUserInfo);
+	void								ProjectFile(SBDFileMessage* FileMessage, FSBFileInfo& OutFileInfo);
+
+	// Sendbird times are milliseconds since the Unix epoch.
+	FDateTime							ToDateTime(int64 SendbirdTime);
+}
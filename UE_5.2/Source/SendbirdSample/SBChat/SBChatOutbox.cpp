@@ -0,0 +1,524 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#include "SBChatOutbox.h"
+#include "../SendbirdSample.h"
+#include "SBChatManager.h"
+#include "Sendbird/SendbirdTranscode.h"
+
+SBChatOutbox::SBChatOutbox()
+{
+	bConnected = false;
+	bEchoEnabled = false;
+	LastLocalMessageID = -1;
+}
+
+SBChatOutbox::~SBChatOutbox()
+{
+	Reset();
+}
+
+void SBChatOutbox::Start()
+{
+#if WITH_SENDBIRD
+	SBDMain::AddConnectionHandler(L"SBChatOutbox", this);
+#endif
+
+	FScopeLock ScopeLock(&Lock);
+
+	bConnected = true;
+	if (!TickerHandle.IsValid())
+		TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &SBChatOutbox::Tick));
+}
+
+void SBChatOutbox::Reset()
+{
+	FScopeLock ScopeLock(&Lock);
+
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+
+	// Sends still in flight find nothing to complete and are dropped. Local ids keep counting so they are never reused.
+	Queues.Empty();
+	bConnected = false;
+}
+
+FSBMessageInfo SBChatOutbox::Send(SBDBaseChannel* Channel, const FString& Message, FCompletion OnComplete)
+{
+	if (!ensure(Channel))
+		return FSBMessageInfo();
+
+	FEntry Entry;
+	Entry.RequestID = FGuid::NewGuid();
+	Entry.Channel = Channel;
+	Entry.Message = Message;
+	Entry.CreatedTime = FDateTime::UtcNow();
+	Entry.OnComplete = MoveTemp(OnComplete);
+#if WITH_SENDBIRD
+	if (const SBDUser* CurrentUser = SBDMain::GetCurrentUser())
+		Entry.Sender = FSBUserInfo(CurrentUser);
+#endif
+
+	const FString ChannelUrl = SendbirdTranscode::ToFString(Channel->channel_url);
+	SBChatSendLimiter& Limiter = SBChatManager::Get().GetSendLimiter();
+
+	FSBMessageInfo Echo;
+	bool bDropped = false;
+	{
+		FScopeLock ScopeLock(&Lock);
+
+		// Whatever the policy, a channel never holds more than the queue limit.
+		FChannelQueue& Queue = Queues.FindOrAdd(ChannelUrl);
+		int32 NumQueued = 0;
+		for (const FEntry& Each : Queue.Entries)
+			NumQueued += (Each.State == EState::Queued) ? 1 : 0;
+
+		bDropped = (NumQueued >= Limiter.GetMaxQueued());
+		if (!bDropped)
+		{
+			Entry.LocalMessageID = --LastLocalMessageID;
+			Echo = ToMessageInfo(Entry);
+			Queue.Entries.Add(MoveTemp(Entry));
+		}
+	}
+
+	if (bDropped)
+	{
+		UE_LOG(SendbirdSample, Warning, TEXT("[SBChatOutbox::Send] Channel(%s) has %d messages queued already, dropped!!"), *ChannelUrl, Limiter.GetMaxQueued());
+		Limiter.RecordDropped(ChannelUrl);
+		if (Entry.OnComplete)
+			Entry.OnComplete(nullptr, nullptr);
+		return Echo;
+	}
+
+	if (bEchoEnabled)
+		SBChatManager::Get().GetEventQueue().EnqueueMessageReceived(Echo);
+	Pump();
+	return Echo;
+}
+
+bool SBChatOutbox::Resend(int64 LocalMessageID)
+{
+	FSBMessageInfo Echo;
+	bool bCurrentChannel = false;
+	{
+		FScopeLock ScopeLock(&Lock);
+
+		FString ChannelUrl;
+		FEntry* Entry = FindEntry(LocalMessageID, ChannelUrl);
+		if (Entry == nullptr || Entry->State != EState::Failed)
+			return false;
+
+		Entry->State = EState::Queued;
+		Entry->Attempts = 0;
+		Entry->NextAttemptTime = 0.0;
+		Echo = ToMessageInfo(*Entry);
+		bCurrentChannel = (Entry->Channel == SBChatManager::Get().GetCurrentChannel());
+	}
+
+	if (bCurrentChannel && bEchoEnabled)
+		SBChatManager::Get().GetEventQueue().EnqueueMessageUpdated(Echo);
+	Pump();
+	return true;
+}
+
+bool SBChatOutbox::Discard(int64 LocalMessageID)
+{
+	bool bCurrentChannel = false;
+	{
+		FScopeLock ScopeLock(&Lock);
+
+		FString ChannelUrl;
+		FEntry* Entry = FindEntry(LocalMessageID, ChannelUrl);
+		if (Entry == nullptr || Entry->State != EState::Failed)
+			return false;
+
+		bCurrentChannel = (Entry->Channel == SBChatManager::Get().GetCurrentChannel());
+		FChannelQueue& Queue = Queues.FindChecked(ChannelUrl);
+		Queue.Entries.RemoveAll([LocalMessageID](const FEntry& Each) { return Each.LocalMessageID == LocalMessageID; });
+		if (Queue.Entries.Num() == 0)
+			Queues.Remove(ChannelUrl);
+	}
+
+	if (bCurrentChannel && bEchoEnabled)
+		SBChatManager::Get().GetEventQueue().EnqueueMessageDeleted(LocalMessageID);
+	return true;
+}
+
+void SBChatOutbox::RemoveChannel(const FString& ChannelUrl)
+{
+	FScopeLock ScopeLock(&Lock);
+	Queues.Remove(ChannelUrl);
+}
+
+int64 SBChatOutbox::ClaimDelivered(const FString& ChannelUrl, SBDBaseMessage* Message, FString& OutRequestID)
+{
+#if WITH_SENDBIRD
+	if (Message == nullptr || Message->message_type != SBDMessageType::User)
+		return 0;
+
+	const FString SdkRequestID = SendbirdTranscode::ToFString(static_cast<SBDUserMessage*>(Message)->request_id);
+	if (SdkRequestID.IsEmpty())
+		return 0;
+
+	FScopeLock ScopeLock(&Lock);
+	FChannelQueue* Queue = Queues.Find(ChannelUrl);
+	if (Queue == nullptr)
+		return 0;
+
+	// Sends in flight are reconciled by their own ack.
+	const int32 Index = Queue->Entries.IndexOfByPredicate([&SdkRequestID](const FEntry& Entry) {
+		return Entry.State == EState::Failed && Entry.SdkRequestID == SdkRequestID;
+	});
+	if (Index == INDEX_NONE)
+		return 0;
+
+	const int64 LocalMessageID = Queue->Entries[Index].LocalMessageID;
+	OutRequestID = Queue->Entries[Index].RequestID.ToString();
+	Queue->Entries.RemoveAt(Index);
+	if (Queue->Entries.Num() == 0)
+		Queues.Remove(ChannelUrl);
+	return LocalMessageID;
+#else
+	return 0;
+#endif
+}
+
+void SBChatOutbox::GetPending(const FString& ChannelUrl, TArray<FSBMessageInfo>& OutMessageInfos)
+{
+	if (!bEchoEnabled)
+		return;
+
+	FScopeLock ScopeLock(&Lock);
+
+	const FChannelQueue* Queue = Queues.Find(ChannelUrl);
+	if (Queue == nullptr)
+		return;
+
+	OutMessageInfos.Reserve(OutMessageInfos.Num() + Queue->Entries.Num());
+	for (const FEntry& Entry : Queue->Entries)
+		OutMessageInfos.Add(ToMessageInfo(Entry));
+}
+
+int32 SBChatOutbox::Num()
+{
+	FScopeLock ScopeLock(&Lock);
+
+	int32 Count = 0;
+	for (const TPair<FString, FChannelQueue>& Pair : Queues)
+		Count += Pair.Value.Entries.Num();
+	return Count;
+}
+
+//+ SBDConnectionHandler
+void SBChatOutbox::Started()
+{
+	FScopeLock ScopeLock(&Lock);
+	bConnected = false;
+}
+
+void SBChatOutbox::Succeeded()
+{
+	FScopeLock ScopeLock(&Lock);
+
+	// Whatever waited out the reconnection goes out on the next tick, without the retry delay.
+	bConnected = true;
+	for (TPair<FString, FChannelQueue>& Pair : Queues)
+	{
+		for (FEntry& Entry : Pair.Value.Entries)
+		{
+			if (Entry.State == EState::Queued)
+				Entry.NextAttemptTime = 0.0;
+		}
+	}
+}
+
+void SBChatOutbox::Failed()
+{
+	FScopeLock ScopeLock(&Lock);
+	bConnected = false;
+}
+//- SBDConnectionHandler
+
+//+ private
+bool SBChatOutbox::Tick(float DeltaTime)
+{
+	Pump();
+	return true;
+}
+
+void SBChatOutbox::Pump()
+{
+	TArray<FSendRequest> Requests;
+	TArray<FSBMessageInfo> Updated;
+	TArray<int64> Deleted;
+	TArray<FCompletion> Dropped;
+	{
+		FScopeLock ScopeLock(&Lock);
+
+		if (!bConnected)
+			return;
+
+		SBChatSendLimiter& Limiter = SBChatManager::Get().GetSendLimiter();
+		SBDBaseChannel* CurrentChannel = SBChatManager::Get().GetCurrentChannel();
+
+		// Each channel sends in order: a message waiting for its retry delay or a token holds back the ones after it.
+		const double Now = FPlatformTime::Seconds();
+		for (TPair<FString, FChannelQueue>& Pair : Queues)
+		{
+			FChannelQueue& Queue = Pair.Value;
+			const bool bCurrentChannel = Queue.Entries.Num() > 0 && Queue.Entries[0].Channel == CurrentChannel;
+			for (int32 Index = 0; Index < Queue.Entries.Num(); ++Index)
+			{
+				FEntry& Entry = Queue.Entries[Index];
+				if (Queue.InFlight >= MAX_IN_FLIGHT_PER_CHANNEL)
+					break;
+
+				if (Entry.State != EState::Queued)
+					continue;
+
+				if (Entry.NextAttemptTime > Now)
+					break;
+
+				if (!Limiter.TryAcquire(Pair.Key))
+				{
+					const int32 NumUpdated = Updated.Num();
+					const int32 NumDeleted = Deleted.Num();
+					Overflow(Pair.Key, Queue, Index, Now, Updated, Deleted, Dropped);
+
+					// Only the focused channel's echoes are on screen.
+					if (!bCurrentChannel)
+					{
+						Updated.SetNum(NumUpdated);
+						Deleted.SetNum(NumDeleted);
+					}
+					break;
+				}
+
+				if (Entry.BlockedSince > 0.0)
+				{
+					Limiter.RecordDelay(Pair.Key, Now - Entry.BlockedSince);
+					Entry.BlockedSince = 0.0;
+				}
+
+				Entry.State = EState::InFlight;
+				++Entry.Attempts;
+				++Queue.InFlight;
+				Requests.Add(FSendRequest{ Pair.Key, Entry.RequestID, Entry.Channel, Entry.Message });
+			}
+		}
+
+		for (auto It = Queues.CreateIterator(); It; ++It)
+		{
+			if (It.Value().Entries.Num() == 0)
+				It.RemoveCurrent();
+		}
+	}
+
+	if (bEchoEnabled)
+	{
+		for (const FSBMessageInfo& MessageInfo : Updated)
+			SBChatManager::Get().GetEventQueue().EnqueueMessageUpdated(MessageInfo);
+		for (int64 LocalMessageID : Deleted)
+			SBChatManager::Get().GetEventQueue().EnqueueMessageDeleted(LocalMessageID);
+	}
+
+	for (const FCompletion& OnComplete : Dropped)
+	{
+		if (OnComplete)
+			OnComplete(nullptr, nullptr);
+	}
+
+	for (const FSendRequest& Request : Requests)
+		SendNow(Request);
+}
+
+void SBChatOutbox::Overflow(const FString& ChannelUrl, FChannelQueue& Queue, int32 Index, double Now,
+	TArray<FSBMessageInfo>& OutUpdated, TArray<int64>& OutDeleted, TArray<FCompletion>& OutDropped)
+{
+	SBChatSendLimiter& Limiter = SBChatManager::Get().GetSendLimiter();
+	const ESBSendOverflowPolicy Policy = Limiter.GetPolicy();
+
+	// Messages that were sent before may have reached the server, so only never-sent ones are merged or dropped.
+	auto IsUnsent = [](const FEntry& Entry) { return Entry.State == EState::Queued && Entry.Attempts == 0; };
+
+	if (Policy == ESBSendOverflowPolicy::Drop)
+	{
+		for (int32 DropIndex = Queue.Entries.Num() - 1; DropIndex >= Index; --DropIndex)
+		{
+			FEntry& Entry = Queue.Entries[DropIndex];
+			if (!IsUnsent(Entry))
+				continue;
+
+			Limiter.RecordDropped(ChannelUrl);
+			OutDeleted.Add(Entry.LocalMessageID);
+			OutDropped.Add(MoveTemp(Entry.OnComplete));
+			Queue.Entries.RemoveAt(DropIndex);
+		}
+	}
+	else if (Policy == ESBSendOverflowPolicy::Coalesce && IsUnsent(Queue.Entries[Index]))
+	{
+		// Later messages are appended to the first one waiting, one per line, until it is MAX_COALESCED_LENGTH long.
+		FEntry& Head = Queue.Entries[Index];
+		int32 NumCoalesced = 0;
+		for (int32 MergeIndex = Index + 1; MergeIndex < Queue.Entries.Num(); )
+		{
+			FEntry& Entry = Queue.Entries[MergeIndex];
+			if (!IsUnsent(Entry))
+			{
+				++MergeIndex;
+				continue;
+			}
+
+			if (Head.Message.Len() + 1 + Entry.Message.Len() > SBChatSendLimiter::MAX_COALESCED_LENGTH)
+				break;
+
+			Head.Message += TEXT("\n") + Entry.Message;
+			Head.OnComplete = [First = MoveTemp(Head.OnComplete), Second = MoveTemp(Entry.OnComplete)](SBDUserMessage* UserMessage, SBDError* Error) {
+				if (First)
+					First(UserMessage, Error);
+				if (Second)
+					Second(UserMessage, Error);
+			};
+			OutDeleted.Add(Entry.LocalMessageID);
+			Queue.Entries.RemoveAt(MergeIndex);
+			++NumCoalesced;
+		}
+
+		if (NumCoalesced > 0)
+		{
+			Limiter.RecordCoalesced(ChannelUrl, NumCoalesced);
+			OutUpdated.Add(ToMessageInfo(Head));
+		}
+	}
+
+	// What is left waits for a token.
+	for (int32 WaitIndex = Index; WaitIndex < Queue.Entries.Num(); ++WaitIndex)
+	{
+		FEntry& Entry = Queue.Entries[WaitIndex];
+		if (Entry.State == EState::Queued && Entry.BlockedSince == 0.0)
+		{
+			Entry.BlockedSince = Now;
+			Limiter.RecordDelayed(ChannelUrl);
+		}
+	}
+}
+
+void SBChatOutbox::SendNow(const FSendRequest& Request)
+{
+#if WITH_SENDBIRD
+	SBDUserMessageParams Params;
+	Params.SetMessage(SendbirdTranscode::ToWString(Request.Message));
+	SBDUserMessage* PendingMessage = Request.Channel->SendUserMessage(Params, [this, ChannelUrl = Request.ChannelUrl, RequestID = Request.RequestID](SBDUserMessage* UserMessage, SBDError* Error) {
+		OnSendCompleted(ChannelUrl, RequestID, UserMessage, Error);
+	});
+	if (PendingMessage == nullptr)
+		return;
+
+	// The server echoes it back with the same request_id, which is all there is to match a message whose ack was lost.
+	FScopeLock ScopeLock(&Lock);
+	if (FChannelQueue* Queue = Queues.Find(Request.ChannelUrl))
+	{
+		if (FEntry* Entry = Queue->Entries.FindByPredicate([&Request](const FEntry& Each) { return Each.RequestID == Request.RequestID; }))
+			Entry->SdkRequestID = SendbirdTranscode::ToFString(PendingMessage->request_id);
+	}
+#endif
+}
+
+void SBChatOutbox::OnSendCompleted(const FString& ChannelUrl, const FGuid& RequestID, SBDUserMessage* UserMessage, SBDError* Error)
+{
+#if WITH_SENDBIRD
+	SBDBaseChannel* Channel = nullptr;
+	int64 LocalMessageID = 0;
+	FCompletion OnComplete;
+	FSBMessageInfo FailedEcho;
+	{
+		FScopeLock ScopeLock(&Lock);
+
+		FChannelQueue* Queue = Queues.Find(ChannelUrl);
+		const int32 Index = Queue != nullptr ? Queue->Entries.IndexOfByPredicate([&RequestID](const FEntry& Entry) { return Entry.RequestID == RequestID; }) : INDEX_NONE;
+		if (Index == INDEX_NONE)
+			return;
+
+		FEntry& Entry = Queue->Entries[Index];
+		--Queue->InFlight;
+		Channel = Entry.Channel;
+		LocalMessageID = Entry.LocalMessageID;
+
+		if (Error != nullptr)
+		{
+			UE_LOG(SendbirdSample, Warning, TEXT("[SBChatOutbox::OnSendCompleted] ErrorMessage(%s) ErrorCode(%d) Attempts(%d)"),
+				*SendbirdTranscode::ToFString(Error->message), Error->code, Entry.Attempts);
+
+			if (IsRetryable(Error->code) && Entry.Attempts < MAX_ATTEMPTS)
+			{
+				Entry.State = EState::Queued;
+				Entry.NextAttemptTime = FPlatformTime::Seconds() + FMath::Min(RETRY_DELAY_SECONDS * (float)(1 << (Entry.Attempts - 1)), MAX_RETRY_DELAY_SECONDS);
+				return;
+			}
+
+			// A shown echo stays, Failed, until the UI resends or discards it; without one there is nothing to keep.
+			Entry.State = EState::Failed;
+			FailedEcho = ToMessageInfo(Entry);
+		}
+
+		OnComplete = MoveTemp(Entry.OnComplete);
+		if (Error == nullptr || !bEchoEnabled)
+		{
+			Queue->Entries.RemoveAt(Index);
+			if (Queue->Entries.Num() == 0)
+				Queues.Remove(ChannelUrl);
+		}
+	}
+
+	if (Error != nullptr)
+	{
+		if (Channel == SBChatManager::Get().GetCurrentChannel() && bEchoEnabled)
+			SBChatManager::Get().GetEventQueue().EnqueueMessageUpdated(FailedEcho);
+		if (OnComplete)
+			OnComplete(nullptr, Error);
+		return;
+	}
+
+	SBChatManager::Get().ReconcileSentMessage(Channel, LocalMessageID, RequestID.ToString(), UserMessage);
+	if (OnComplete)
+		OnComplete(UserMessage, nullptr);
+#endif
+}
+
+SBChatOutbox::FEntry* SBChatOutbox::FindEntry(int64 LocalMessageID, FString& OutChannelUrl)
+{
+	for (TPair<FString, FChannelQueue>& Pair : Queues)
+	{
+		for (FEntry& Entry : Pair.Value.Entries)
+		{
+			if (Entry.LocalMessageID == LocalMessageID)
+			{
+				OutChannelUrl = Pair.Key;
+				return &Entry;
+			}
+		}
+	}
+	return nullptr;
+}
+
+bool SBChatOutbox::IsRetryable(int64 ErrorCode)
+{
+#if WITH_SENDBIRD
+	// Network errors and closed sockets can come after the server took the message, with no way to tell.
+	return ErrorCode == SBDErrorConnectionRequired;
+#else
+	return false;
+#endif
+}
+
+FSBMessageInfo SBChatOutbox::ToMessageInfo(const FEntry& Entry)
+{
+	FSBMessageInfo MessageInfo(Entry.LocalMessageID, Entry.Sender, ESBMessageType::SBDMessageTypeUser, Entry.Message, Entry.CreatedTime);
+	MessageInfo.SendingStatus = (Entry.State == EState::Failed) ? ESBMessageSendingStatus::Failed : ESBMessageSendingStatus::Pending;
+	MessageInfo.RequestID = Entry.RequestID.ToString();
+	return MessageInfo;
+}
+//- private
@@ -0,0 +1,121 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Sendbird/include/Sendbird.h"
+#include "SBChatCommonStruct.h"
+
+// Outgoing user messages, queued per channel and identified by a client request id.
+// Up to MAX_IN_FLIGHT_PER_CHANNEL sends per channel are on the wire at once; an acked message goes into the history.
+// With echoes on, a message is shown right away with a negative local message id and SendingStatus Pending, and the
+// UI gets OnMessageSent to swap the acked message in for the echo. They are off by default, since a UI that adds
+// the row when SendUserMessage completes would show it twice.
+// A send refused with ConnectionRequired never left the client, so it stays queued and goes out again when
+// SBDConnectionHandler::Succeeded reports the reconnection. Any other failure may have reached the server, and a retry
+// is a fresh SendUserMessage that would post it twice, so it fails the send, as does MAX_ATTEMPTS in a row; with
+// echoes on, the message stays Failed until it is resent or discarded, or until it comes back from the server after all
+// and is matched by the request_id the SDK gave it.
+// Every send goes through the send limiter first; a channel that is over the limit has its waiting messages queued,
+// coalesced into one or dropped, as the limiter's policy says.
+// The queue lives as long as the session; disconnecting on purpose (USBChat::Disconnect) drops it.
+class SBChatOutbox : public SBDConnectionHandler
+{
+public:
+	static const int32 MAX_IN_FLIGHT_PER_CHANNEL	= 4;
+	static const int32 MAX_ATTEMPTS					= 5;
+	static constexpr float RETRY_DELAY_SECONDS		= 1.0f;
+	static constexpr float MAX_RETRY_DELAY_SECONDS	= 16.0f;
+
+	// Called on the SDK's thread once the message is acked or given up on; UserMessage is null on failure.
+	// Both are null when the send limiter dropped the message, in which case it is called on the game thread.
+	using FCompletion = TFunction<void(SBDUserMessage*, SBDError*)>;
+
+	SBChatOutbox();
+	virtual ~SBChatOutbox();
+
+	// Starts following the connection, once connected.
+	void								Start();
+	void								Reset();
+	void								SetEchoEnabled(bool bEnabled) { bEchoEnabled = bEnabled; }
+	bool								IsEchoEnabled() const { return bEchoEnabled; }
+
+	// Queues the message and echoes it to the UI if echoes are on; returns the echo.
+	FSBMessageInfo						Send(SBDBaseChannel* Channel, const FString& Message, FCompletion OnComplete = nullptr);
+	// Queues a Failed message again.
+	bool								Resend(int64 LocalMessageID);
+	// Drops a Failed message; its echo, if shown, is deleted.
+	bool								Discard(int64 LocalMessageID);
+	void								RemoveChannel(const FString& ChannelUrl);
+	// A message of ours the server has while its send is Failed here, e.g. when only the ack was lost: takes the send
+	// whose SDK request_id the message carries off the outbox. Returns its local message id, 0 when there is none.
+	int64								ClaimDelivered(const FString& ChannelUrl, SBDBaseMessage* Message, FString& OutRequestID);
+
+	// Echoes of what the channel still has in the outbox, oldest first; nothing when echoes are off.
+	void								GetPending(const FString& ChannelUrl, TArray<FSBMessageInfo>& OutMessageInfos);
+	int32								Num();
+
+	//+ SBDConnectionHandler
+	virtual void						Started() override;
+	virtual void						Succeeded() override;
+	virtual void						Failed() override;
+	//- SBDConnectionHandler
+
+private:
+	enum class EState : uint8
+	{
+		Queued,
+		InFlight,
+		Failed,
+	};
+
+	struct FEntry
+	{
+		FGuid							RequestID;
+		FString							SdkRequestID;			// request_id the SDK gave the last attempt
+		int64							LocalMessageID = 0;
+		SBDBaseChannel*					Channel = nullptr;
+		FString							Message;
+		FSBUserInfo						Sender;
+		FDateTime						CreatedTime;
+		EState							State = EState::Queued;
+		int32							Attempts = 0;
+		double							NextAttemptTime = 0.0;
+		double							BlockedSince = 0.0;		// when the send limiter first held it back
+		FCompletion						OnComplete;
+	};
+
+	struct FChannelQueue
+	{
+		TArray<FEntry>					Entries;
+		int32							InFlight = 0;
+	};
+
+	struct FSendRequest
+	{
+		FString							ChannelUrl;
+		FGuid							RequestID;
+		SBDBaseChannel*					Channel;
+		FString							Message;
+	};
+
+	bool								Tick(float DeltaTime);
+	void								Pump();
+	void								SendNow(const FSendRequest& Request);
+	// Applies the send limiter's policy to what waits in a channel that is over the limit, from Index on.
+	void								Overflow(const FString& ChannelUrl, FChannelQueue& Queue, int32 Index, double Now,
+											TArray<FSBMessageInfo>& OutUpdated, TArray<int64>& OutDeleted, TArray<FCompletion>& OutDropped);
+	void								OnSendCompleted(const FString& ChannelUrl, const FGuid& RequestID, SBDUserMessage* UserMessage, SBDError* Error);
+	FEntry*								FindEntry(int64 LocalMessageID, FString& OutChannelUrl);
+	static bool							IsRetryable(int64 ErrorCode);
+	static FSBMessageInfo				ToMessageInfo(const FEntry& Entry);
+
+private:
+	FCriticalSection					Lock;
+	TMap<FString, FChannelQueue>		Queues;
+	FTSTicker::FDelegateHandle			TickerHandle;
+	bool								bConnected;
+	TAtomic<bool>						bEchoEnabled;
+	int64								LastLocalMessageID;
+};
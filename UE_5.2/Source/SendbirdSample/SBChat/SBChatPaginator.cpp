@@ -0,0 +1,60 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#include "SBChatPaginator.h"
+
+static constexpr double PAGING_DEFAULT_LATENCY_SECONDS	= 0.3;
+static constexpr double PAGING_MIN_CONSUME_INTERVAL		= 0.05;
+static constexpr double PAGING_SMOOTHING				= 0.3;
+
+SBChatPagingPolicy::SBChatPagingPolicy()
+{
+	LatencySeconds = 0.0;
+	Reset();
+}
+
+void SBChatPagingPolicy::Reset()
+{
+	// Latency is a property of the connection, so it carries over to the next query.
+	if (LatencySeconds <= 0.0)
+		LatencySeconds = PAGING_DEFAULT_LATENCY_SECONDS;
+
+	ConsumerPageSize = MIN_PAGE_LIMIT;
+	ItemsPerSecond = 0.0;
+	LastConsumeTime = 0.0;
+}
+
+void SBChatPagingPolicy::OnConsumed(int32 PageSize, int32 Count)
+{
+	ConsumerPageSize = FMath::Max(PageSize, 1);
+
+	const double Now = FPlatformTime::Seconds();
+	if (LastConsumeTime > 0.0)
+	{
+		const double Rate = Count / FMath::Max(Now - LastConsumeTime, PAGING_MIN_CONSUME_INTERVAL);
+		ItemsPerSecond = ItemsPerSecond > 0.0 ? ItemsPerSecond + (Rate - ItemsPerSecond) * PAGING_SMOOTHING : Rate;
+	}
+	LastConsumeTime = Now;
+}
+
+void SBChatPagingPolicy::OnLoaded(double InLatencySeconds)
+{
+	LatencySeconds += (FMath::Max(InLatencySeconds, 0.0) - LatencySeconds) * PAGING_SMOOTHING;
+}
+
+int32 SBChatPagingPolicy::GetPageLimit() const
+{
+	return FMath::Clamp(ConsumerPageSize + GetLookahead(), MIN_PAGE_LIMIT, MAX_PAGE_LIMIT);
+}
+
+bool SBChatPagingPolicy::ShouldPrefetch(int32 BufferedCount) const
+{
+	return BufferedCount < ConsumerPageSize + GetLookahead();
+}
+
+//+ private
+int32 SBChatPagingPolicy::GetLookahead() const
+{
+	// What the consumer reads while one request is in flight, twice over to absorb jitter.
+	return (int32)FMath::CeilToDouble(ItemsPerSecond * LatencySeconds * 2.0);
+}
+//- private
@@ -0,0 +1,255 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Sendbird/include/Sendbird.h"
+
+// Sizes the pages a paginator asks the server for, from the observed request latency and how fast the consumer reads.
+// The goal is that the buffer never runs dry: it should hold what the consumer reads while one request is in flight,
+// plus the page the consumer asks for.
+class SBChatPagingPolicy
+{
+public:
+	static const int32 MIN_PAGE_LIMIT = 10;
+	static const int32 MAX_PAGE_LIMIT = 100;
+
+	SBChatPagingPolicy();
+
+	void								Reset();
+	void								OnConsumed(int32 PageSize, int32 Count);
+	void								OnLoaded(double LatencySeconds);
+
+	int32								GetPageLimit() const;
+	bool								ShouldPrefetch(int32 BufferedCount) const;
+
+	double								GetLatency() const { return LatencySeconds; }
+	double								GetVelocity() const { return ItemsPerSecond; }
+
+private:
+	int32								GetLookahead() const;
+
+private:
+	int32								ConsumerPageSize;
+	double								LatencySeconds;
+	double								ItemsPerSecond;
+	double								LastConsumeTime;
+};
+
+// Pages a list query (SBDOpenChannelListQuery, SBDGroupChannelListQuery, SBDUserListQuery) ahead of the consumer.
+// Next() is served from the buffer when it can be, and the next page is prefetched in the background once the buffer
+// gets low. Only one LoadNextPage is ever in flight, so the query never fails with SBDErrorQueryInProgress; if the
+// query is loading on behalf of someone else anyway, the load is retried shortly after.
+// Handlers run on the game thread when served from the buffer, and on the SDK thread otherwise.
+template<typename QueryType, typename ItemType>
+class SBChatPaginator
+{
+public:
+	using FPageHandler = TFunction<void(const TArray<ItemType>& Items, SBDError* Error)>;
+
+	static constexpr float RETRY_SECONDS = 0.2f;
+
+	SBChatPaginator()
+	{
+		Query = nullptr;
+		Generation = 0;
+		bLoading = false;
+		RequestTime = 0.0;
+	}
+
+	// Pages of the previous query still in flight are dropped, and its waiting consumers get an empty page.
+	void								SetQuery(QueryType* InQuery)
+	{
+		TArray<FPageHandler> Dropped;
+		{
+			FScopeLock ScopeLock(&Lock);
+			Query = InQuery;
+			++Generation;
+			bLoading = false;
+			Buffer.Empty();
+			Policy.Reset();
+			for (FWaiter& Waiter : Waiters)
+				Dropped.Add(MoveTemp(Waiter.OnPage));
+			Waiters.Empty();
+		}
+
+		for (FPageHandler& OnPage : Dropped)
+			OnPage(TArray<ItemType>(), nullptr);
+	}
+
+	QueryType*							GetQuery() const { return Query; }
+	const SBChatPagingPolicy&			GetPolicy() const { return Policy; }
+
+	bool								HasNext() const
+	{
+		FScopeLock ScopeLock(&Lock);
+		return Query != nullptr && (Buffer.Num() > 0 || Query->has_next);
+	}
+
+	int32								GetBufferedCount() const
+	{
+		FScopeLock ScopeLock(&Lock);
+		return Buffer.Num();
+	}
+
+	// Hands the next Count items to OnPage, or fewer when the query has run out.
+	void								Next(int32 Count, FPageHandler OnPage)
+	{
+		TArray<FDelivery> Ready;
+		uint32 LoadGeneration = 0;
+		{
+			FScopeLock ScopeLock(&Lock);
+			Waiters.Add({ FMath::Max(Count, 1), MoveTemp(OnPage) });
+			TakeReady(Ready);
+			LoadGeneration = BeginLoadIfNeeded();
+		}
+
+		Deliver(Ready);
+		if (LoadGeneration != 0)
+			Load(LoadGeneration);
+	}
+
+private:
+	struct FWaiter
+	{
+		int32							Count;
+		FPageHandler					OnPage;
+	};
+
+	struct FDelivery
+	{
+		TArray<ItemType>				Items;
+		FPageHandler					OnPage;
+	};
+
+	// Lock held.
+	void								TakeReady(TArray<FDelivery>& OutReady)
+	{
+		while (Waiters.Num() > 0)
+		{
+			FWaiter& Waiter = Waiters[0];
+			const bool bExhausted = Query == nullptr || (!Query->has_next && !bLoading);
+			if (Buffer.Num() < Waiter.Count && !bExhausted)
+				break;
+
+			const int32 TakeCount = FMath::Min(Waiter.Count, Buffer.Num());
+			FDelivery& Delivery = OutReady.AddDefaulted_GetRef();
+			Delivery.Items.Append(Buffer.GetData(), TakeCount);
+			Delivery.OnPage = MoveTemp(Waiter.OnPage);
+			Buffer.RemoveAt(0, TakeCount);
+			Policy.OnConsumed(Waiter.Count, TakeCount);
+			Waiters.RemoveAt(0);
+		}
+	}
+
+	// Lock held. Returns the generation to load for, or 0 when no load is needed.
+	uint32								BeginLoadIfNeeded()
+	{
+		if (Query == nullptr || bLoading || !Query->has_next)
+			return 0;
+
+		if (Waiters.Num() == 0 && !Policy.ShouldPrefetch(Buffer.Num()))
+			return 0;
+
+		bLoading = true;
+		RequestTime = FPlatformTime::Seconds();
+		Query->limit = Policy.GetPageLimit();
+		return Generation;
+	}
+
+	void								Load(uint32 LoadGeneration)
+	{
+#if WITH_SENDBIRD
+		QueryType* LoadQuery = nullptr;
+		{
+			FScopeLock ScopeLock(&Lock);
+			if (LoadGeneration != Generation)
+				return;
+
+			// Someone else is paging the same query; calling now would only get SBDErrorQueryInProgress back.
+			if (Query->is_loading)
+			{
+				RetryLater(LoadGeneration);
+				return;
+			}
+			LoadQuery = Query;
+		}
+
+		LoadQuery->LoadNextPage([this, LoadGeneration](const auto& Items, SBDError* Error) {
+			OnLoaded(LoadGeneration, Items, Error);
+		});
+#endif
+	}
+
+	void								OnLoaded(uint32 LoadGeneration, const std::vector<ItemType>& Items, SBDError* Error)
+	{
+#if WITH_SENDBIRD
+		TArray<FDelivery> Ready;
+		TArray<FPageHandler> Failed;
+		uint32 NextGeneration = 0;
+		{
+			FScopeLock ScopeLock(&Lock);
+			if (LoadGeneration != Generation)
+				return;
+
+			if (Error != nullptr && Error->code == SBDErrorQueryInProgress)
+			{
+				RetryLater(LoadGeneration);
+				return;
+			}
+
+			bLoading = false;
+			if (Error != nullptr)
+			{
+				// Only the consumers waiting on this page see the error; buffered items stay for the next call.
+				for (FWaiter& Waiter : Waiters)
+					Failed.Add(MoveTemp(Waiter.OnPage));
+				Waiters.Empty();
+			}
+			else
+			{
+				Policy.OnLoaded(FPlatformTime::Seconds() - RequestTime);
+				Buffer.Reserve(Buffer.Num() + (int32)Items.size());
+				for (const ItemType& Item : Items)
+					Buffer.Add(Item);
+
+				TakeReady(Ready);
+				NextGeneration = BeginLoadIfNeeded();
+			}
+		}
+
+		for (FPageHandler& OnPage : Failed)
+			OnPage(TArray<ItemType>(), Error);
+
+		Deliver(Ready);
+		if (NextGeneration != 0)
+			Load(NextGeneration);
+#endif
+	}
+
+	// Lock held.
+	void								RetryLater(uint32 LoadGeneration)
+	{
+		FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([this, LoadGeneration](float DeltaTime) {
+			Load(LoadGeneration);
+			return false;
+		}), RETRY_SECONDS);
+	}
+
+	static void							Deliver(TArray<FDelivery>& Ready)
+	{
+		for (FDelivery& Delivery : Ready)
+			Delivery.OnPage(Delivery.Items, nullptr);
+	}
+
+private:
+	mutable FCriticalSection			Lock;
+	QueryType*							Query;
+	uint32								Generation;
+	bool								bLoading;
+	double								RequestTime;
+	TArray<ItemType>					Buffer;
+	TArray<FWaiter>						Waiters;
+	SBChatPagingPolicy					Policy;
+};
@@ -0,0 +1,339 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#include "SBChatProfileTextureCache.h"
+#include "SBChatThumbnail.h"
+#include "Engine/Texture2DDynamic.h"
+#include "TextureResource.h"
+#include "RenderingThread.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "HttpModule.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+#include "Async/Async.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Hash/CityHash.h"
+#include "Modules/ModuleManager.h"
+
+SBChatProfileTextureCache::SBChatProfileTextureCache()
+	: SBChatProfileTextureCache(TEXT("ProfileTextures"), MAX_DIMENSION)
+{
+}
+
+SBChatProfileTextureCache::SBChatProfileTextureCache(const TCHAR* DiskFolder, int32 InMaxDimension)
+{
+	MaxDimension = FMath::Max(InMaxDimension, 1);
+	MemoryBudget = DEFAULT_MEMORY_BUDGET;
+	MemoryUsage = 0;
+	ActiveLoads = 0;
+	Generation = 0;
+	bDiskCacheEnabled = true;
+	DiskRoot = FPaths::ProjectSavedDir() / TEXT("SBChat") / DiskFolder;
+	ImageWrapperModule = nullptr;
+}
+
+void SBChatProfileTextureCache::Reset()
+{
+	// Unlinked first, so the list keeps no pointers into the entries being freed.
+	while (UseOrder.PopHead() != nullptr)
+		continue;
+	Entries.Empty();
+	MemoryUsage = 0;
+
+	// Loads still in flight belong to the previous generation and are dropped when they finish.
+	PendingTextures.Empty();
+	PendingImages.Empty();
+	QueuedLoads.Empty();
+	ActiveLoads = 0;
+	++Generation;
+}
+
+void SBChatProfileTextureCache::SetMemoryBudget(int64 InMemoryBudget)
+{
+	MemoryBudget = FMath::Max<int64>(InMemoryBudget, 0);
+	EvictOverBudget(FString());
+}
+
+UTexture2DDynamic* SBChatProfileTextureCache::Find(const FString& ProfileUrl)
+{
+	TUniquePtr<FEntry>* Entry = Entries.Find(ProfileUrl);
+	if (Entry == nullptr)
+		return nullptr;
+
+	Touch(**Entry);
+	return (*Entry)->Texture;
+}
+
+void SBChatProfileTextureCache::Add(const FString& ProfileUrl, UTexture2DDynamic* Texture)
+{
+	if (ProfileUrl.IsEmpty() || Texture == nullptr)
+		return;
+
+	TUniquePtr<FEntry>& Slot = Entries.FindOrAdd(ProfileUrl);
+	if (Slot.IsValid())
+	{
+		Touch(*Slot);
+	}
+	else
+	{
+		Slot = MakeUnique<FEntry>();
+		Slot->ProfileUrl = ProfileUrl;
+		UseOrder.AddTail(Slot.Get());
+	}
+
+	FEntry& Entry = *Slot;
+	MemoryUsage -= Entry.Bytes;
+
+	Entry.Texture = Texture;
+	Entry.Bytes = (int64)Texture->SizeX * Texture->SizeY * GPixelFormats[Texture->Format].BlockBytes;
+	MemoryUsage += Entry.Bytes;
+
+	EvictOverBudget(ProfileUrl);
+}
+
+void SBChatProfileTextureCache::Load(const FString& ProfileUrl, FOnTextureLoaded OnLoaded)
+{
+	if (ProfileUrl.IsEmpty())
+	{
+		OnLoaded(nullptr);
+		return;
+	}
+
+	if (UTexture2DDynamic* Texture = Find(ProfileUrl))
+	{
+		OnLoaded(Texture);
+		return;
+	}
+
+	const bool bInFlight = PendingTextures.Contains(ProfileUrl) || PendingImages.Contains(ProfileUrl);
+	PendingTextures.FindOrAdd(ProfileUrl).Add(MoveTemp(OnLoaded));
+	if (!bInFlight)
+	{
+		QueuedLoads.Add(ProfileUrl);
+		StartLoads();
+	}
+}
+
+void SBChatProfileTextureCache::LoadImage(const FString& ProfileUrl, FOnImageLoaded OnLoaded)
+{
+	if (ProfileUrl.IsEmpty())
+	{
+		OnLoaded(nullptr);
+		return;
+	}
+
+	const bool bInFlight = PendingTextures.Contains(ProfileUrl) || PendingImages.Contains(ProfileUrl);
+	PendingImages.FindOrAdd(ProfileUrl).Add(MoveTemp(OnLoaded));
+	if (!bInFlight)
+	{
+		QueuedLoads.Add(ProfileUrl);
+		StartLoads();
+	}
+}
+
+UTexture2DDynamic* SBChatProfileTextureCache::CreateTexture(const FImage& Image)
+{
+	UTexture2DDynamic* Texture = UTexture2DDynamic::Create(Image.Width, Image.Height);
+	if (Texture == nullptr)
+		return nullptr;
+
+	Texture->SRGB = true;
+	Texture->UpdateResource();
+
+	FTexture2DDynamicResource* TextureResource = static_cast<FTexture2DDynamicResource*>(Texture->GetResource());
+	if (TextureResource != nullptr)
+	{
+		TArray64<uint8> RawData;
+		RawData.Append(reinterpret_cast<const uint8*>(Image.Pixels.GetData()), Image.Pixels.Num() * sizeof(FColor));
+		ENQUEUE_RENDER_COMMAND(FSBChatWriteProfileTexture)(
+			[TextureResource, RawData = MoveTemp(RawData)](FRHICommandListImmediate& RHICmdList) {
+				TextureResource->WriteRawToTexture_RenderThread(RawData);
+			});
+	}
+	return Texture;
+}
+
+bool SBChatProfileTextureCache::Decode(IImageWrapperModule& ImageWrapperModule, const TArray<uint8>& Bytes, int32 MaxDimension, FImage& OutImage)
+{
+	if (Bytes.Num() == 0)
+		return false;
+
+	const EImageFormat Format = ImageWrapperModule.DetectImageFormat(Bytes.GetData(), Bytes.Num());
+	if (Format == EImageFormat::Invalid)
+		return false;
+
+	TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(Format);
+	TArray64<uint8> RawData;
+	if (!ImageWrapper.IsValid() || !ImageWrapper->SetCompressed(Bytes.GetData(), Bytes.Num()) || !ImageWrapper->GetRaw(ERGBFormat::BGRA, 8, RawData))
+		return false;
+
+	const int32 SrcWidth = (int32)ImageWrapper->GetWidth();
+	const int32 SrcHeight = (int32)ImageWrapper->GetHeight();
+	if (SrcWidth <= 0 || SrcHeight <= 0 || RawData.Num() < (int64)SrcWidth * SrcHeight * (int64)sizeof(FColor))
+		return false;
+
+	TArrayView<const FColor> SrcPixels(reinterpret_cast<const FColor*>(RawData.GetData()), SrcWidth * SrcHeight);
+
+	// Avatars and thumbnails are drawn small; keeping them at MaxDimension is what lets hundreds of them fit in the budget.
+	const FIntPoint Size = SBChatThumbnail::FitWithin(SrcWidth, SrcHeight, MaxDimension, MaxDimension);
+	OutImage.Width = Size.X;
+	OutImage.Height = Size.Y;
+	SBChatThumbnail::Resize(SrcPixels, SrcWidth, SrcHeight, OutImage.Width, OutImage.Height, OutImage.Pixels);
+	return true;
+}
+//+ FGCObject
+void SBChatProfileTextureCache::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	for (TPair<FString, TUniquePtr<FEntry>>& Pair : Entries)
+		Collector.AddReferencedObject(Pair.Value->Texture);
+}
+//- FGCObject
+
+//+ private
+void SBChatProfileTextureCache::StartLoads()
+{
+	if (ImageWrapperModule == nullptr)
+		ImageWrapperModule = &FModuleManager::LoadModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
+
+	// A list opens with its visible rows first, so loads start in the order they were asked for.
+	int32 Started = 0;
+	while (ActiveLoads < MAX_CONCURRENT_LOADS && Started < QueuedLoads.Num())
+	{
+		++ActiveLoads;
+		Download(QueuedLoads[Started++], Generation);
+	}
+	QueuedLoads.RemoveAt(0, Started, false);
+}
+
+void SBChatProfileTextureCache::Download(const FString& ProfileUrl, uint32 LoadGeneration)
+{
+	if (!bDiskCacheEnabled)
+	{
+		Fetch(ProfileUrl, LoadGeneration);
+		return;
+	}
+
+	IImageWrapperModule* Wrapper = ImageWrapperModule;
+	Async(EAsyncExecution::ThreadPool, [this, ProfileUrl, LoadGeneration, Wrapper, DiskPath = GetDiskPath(ProfileUrl), MaxDimension = MaxDimension]() {
+		TArray<uint8> Bytes;
+		FImage Image;
+		if (!FFileHelper::LoadFileToArray(Bytes, *DiskPath, FILEREAD_Silent) || !Decode(*Wrapper, Bytes, MaxDimension, Image))
+		{
+			AsyncTask(ENamedThreads::GameThread, [this, ProfileUrl, LoadGeneration]() {
+				if (LoadGeneration == Generation)
+					Fetch(ProfileUrl, LoadGeneration);
+			});
+			return;
+		}
+
+		TSharedPtr<const FImage, ESPMode::ThreadSafe> Loaded = MakeShared<FImage, ESPMode::ThreadSafe>(MoveTemp(Image));
+		AsyncTask(ENamedThreads::GameThread, [this, ProfileUrl, LoadGeneration, Loaded]() {
+			FinishLoad(ProfileUrl, LoadGeneration, Loaded);
+		});
+	});
+}
+
+void SBChatProfileTextureCache::Fetch(const FString& ProfileUrl, uint32 LoadGeneration)
+{
+	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+	Request->SetURL(ProfileUrl);
+	Request->SetVerb(TEXT("GET"));
+	Request->OnProcessRequestComplete().BindLambda([this, ProfileUrl, LoadGeneration](FHttpRequestPtr, FHttpResponsePtr Response, bool bSucceeded) {
+		if (LoadGeneration != Generation)
+			return;
+
+		if (!bSucceeded || !Response.IsValid() || !EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+		{
+			FinishLoad(ProfileUrl, LoadGeneration, nullptr);
+			return;
+		}
+
+		TArray<uint8> Bytes = Response->GetContent();
+		DecodeAsync(ProfileUrl, LoadGeneration, MoveTemp(Bytes), bDiskCacheEnabled);
+	});
+
+	if (!Request->ProcessRequest())
+		FinishLoad(ProfileUrl, LoadGeneration, nullptr);
+}
+
+void SBChatProfileTextureCache::DecodeAsync(const FString& ProfileUrl, uint32 LoadGeneration, TArray<uint8>&& Bytes, bool bSaveToDisk)
+{
+	IImageWrapperModule* Wrapper = ImageWrapperModule;
+	FString DiskPath = bSaveToDisk ? GetDiskPath(ProfileUrl) : FString();
+	Async(EAsyncExecution::ThreadPool, [this, ProfileUrl, LoadGeneration, Wrapper, DiskPath, MaxDimension = MaxDimension, Bytes = MoveTemp(Bytes)]() {
+		FImage Image;
+		TSharedPtr<const FImage, ESPMode::ThreadSafe> Loaded;
+		if (Decode(*Wrapper, Bytes, MaxDimension, Image))
+		{
+			// Only what decodes is kept, so a broken download is fetched again next time.
+			if (!DiskPath.IsEmpty())
+				FFileHelper::SaveArrayToFile(Bytes, *DiskPath);
+
+			Loaded = MakeShared<FImage, ESPMode::ThreadSafe>(MoveTemp(Image));
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [this, ProfileUrl, LoadGeneration, Loaded]() {
+			FinishLoad(ProfileUrl, LoadGeneration, Loaded);
+		});
+	});
+}
+
+void SBChatProfileTextureCache::FinishLoad(const FString& ProfileUrl, uint32 LoadGeneration, TSharedPtr<const FImage, ESPMode::ThreadSafe> Image)
+{
+	if (LoadGeneration != Generation)
+		return;
+
+	--ActiveLoads;
+
+	TArray<FOnImageLoaded> ImageCallbacks;
+	PendingImages.RemoveAndCopyValue(ProfileUrl, ImageCallbacks);
+	for (FOnImageLoaded& OnLoaded : ImageCallbacks)
+		OnLoaded(Image);
+
+	TArray<FOnTextureLoaded> TextureCallbacks;
+	if (PendingTextures.RemoveAndCopyValue(ProfileUrl, TextureCallbacks))
+	{
+		UTexture2DDynamic* Texture = Image.IsValid() ? CreateTexture(*Image) : nullptr;
+		Add(ProfileUrl, Texture);
+		for (FOnTextureLoaded& OnLoaded : TextureCallbacks)
+			OnLoaded(Texture);
+	}
+
+	StartLoads();
+}
+
+void SBChatProfileTextureCache::Touch(FEntry& Entry)
+{
+	// Last in line for eviction.
+	UseOrder.Remove(&Entry);
+	UseOrder.AddTail(&Entry);
+}
+
+void SBChatProfileTextureCache::EvictOverBudget(const FString& KeepUrl)
+{
+	while (MemoryUsage > MemoryBudget)
+	{
+		FEntry* Oldest = UseOrder.GetHead();
+		if (Oldest != nullptr && Oldest->ProfileUrl == KeepUrl)
+			Oldest = Oldest->GetNext();
+
+		if (Oldest == nullptr)
+			break;
+
+		// Widgets still showing the texture keep it alive; the cache only stops holding it.
+		MemoryUsage -= Oldest->Bytes;
+		UseOrder.Remove(Oldest);
+		const FString EvictedUrl = MoveTemp(Oldest->ProfileUrl);
+		Entries.Remove(EvictedUrl);
+	}
+}
+
+FString SBChatProfileTextureCache::GetDiskPath(const FString& ProfileUrl) const
+{
+	FTCHARToUTF8 Converter(*ProfileUrl);
+	const uint64 Hash = CityHash64(Converter.Get(), Converter.Length());
+	return DiskRoot / FString::Printf(TEXT("%016llx.img"), Hash);
+}
+
+//- private
@@ -0,0 +1,100 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/IntrusiveDoubleLinkedList.h"
+#include "UObject/GCObject.h"
+
+class UTexture2DDynamic;
+class IImageWrapperModule;
+
+// Profile images keyed by profile_url, loaded natively so Blueprints only ask for a url.
+// Textures are kept under a byte budget and the least recently used ones are evicted first. A url is fetched once no
+// matter how many rows ask for it, downloads are capped at MAX_CONCURRENT_LOADS, and decoding and downscaling run on a
+// background thread; only the texture creation happens on the game thread. The downloaded files can be kept on disk
+// under Saved/SBChat/ProfileTextures so the next session skips the network.
+// Message thumbnails go through a second cache, with its own folder and a larger MaxDimension.
+// Game thread only.
+class SBChatProfileTextureCache : public FGCObject
+{
+public:
+	static const int64 DEFAULT_MEMORY_BUDGET = 32 * 1024 * 1024;
+	static const int32 MAX_DIMENSION = 128;
+	static const int32 MAX_CONCURRENT_LOADS = 8;
+
+	// A decoded image, downscaled to the cache's MaxDimension.
+	struct FImage
+	{
+		int32							Width = 0;
+		int32							Height = 0;
+		TArray<FColor>					Pixels;
+	};
+
+	using FOnTextureLoaded = TFunction<void(UTexture2DDynamic* Texture)>;
+	using FOnImageLoaded = TFunction<void(TSharedPtr<const FImage, ESPMode::ThreadSafe> Image)>;
+
+	SBChatProfileTextureCache();
+	SBChatProfileTextureCache(const TCHAR* DiskFolder, int32 InMaxDimension);
+
+	void								Reset();
+	void								SetMemoryBudget(int64 InMemoryBudget);
+	int64								GetMemoryBudget() const { return MemoryBudget; }
+	int64								GetMemoryUsage() const { return MemoryUsage; }
+	int32								Num() const { return Entries.Num(); }
+	void								SetDiskCacheEnabled(bool bEnabled) { bDiskCacheEnabled = bEnabled; }
+	bool								IsDiskCacheEnabled() const { return bDiskCacheEnabled; }
+
+	UTexture2DDynamic*					Find(const FString& ProfileUrl);
+	void								Add(const FString& ProfileUrl, UTexture2DDynamic* Texture);
+
+	// OnLoaded gets nullptr when the image can't be fetched or decoded. It can run before Load returns.
+	void								Load(const FString& ProfileUrl, FOnTextureLoaded OnLoaded);
+	// The decoded pixels without a texture, for consumers that upload them somewhere else.
+	void								LoadImage(const FString& ProfileUrl, FOnImageLoaded OnLoaded);
+
+	static UTexture2DDynamic*			CreateTexture(const FImage& Image);
+	// Decodes Bytes and downscales the image to fit in MaxDimension; safe on any thread.
+	static bool							Decode(IImageWrapperModule& ImageWrapperModule, const TArray<uint8>& Bytes, int32 MaxDimension, FImage& OutImage);
+
+	//+ FGCObject
+	virtual void						AddReferencedObjects(FReferenceCollector& Collector) override;
+	virtual FString						GetReferencerName() const override { return TEXT("SBChatProfileTextureCache"); }
+	//- FGCObject
+
+private:
+	// Linked into UseOrder, least recently used first, so touching and evicting an entry don't scan the map.
+	struct FEntry : public TIntrusiveDoubleLinkedListNode<FEntry>
+	{
+		FString							ProfileUrl;
+		UTexture2DDynamic*				Texture = nullptr;
+		int64							Bytes = 0;
+	};
+
+	void								StartLoads();
+	void								Download(const FString& ProfileUrl, uint32 LoadGeneration);
+	void								Fetch(const FString& ProfileUrl, uint32 LoadGeneration);
+	void								DecodeAsync(const FString& ProfileUrl, uint32 LoadGeneration, TArray<uint8>&& Bytes, bool bSaveToDisk);
+	void								FinishLoad(const FString& ProfileUrl, uint32 LoadGeneration, TSharedPtr<const FImage, ESPMode::ThreadSafe> Image);
+	void								Touch(FEntry& Entry);
+	void								EvictOverBudget(const FString& KeepUrl);
+	FString								GetDiskPath(const FString& ProfileUrl) const;
+
+private:
+	// Entries are allocated one by one, so the list's links stay valid while the map grows.
+	TMap<FString, TUniquePtr<FEntry>>	Entries;
+	TIntrusiveDoubleLinkedList<FEntry>	UseOrder;
+	int32								MaxDimension;
+	int64								MemoryBudget;
+	int64								MemoryUsage;
+
+	TMap<FString, TArray<FOnTextureLoaded>>	PendingTextures;
+	TMap<FString, TArray<FOnImageLoaded>>	PendingImages;
+	TArray<FString>						QueuedLoads;
+	int32								ActiveLoads;
+	uint32								Generation;
+
+	bool								bDiskCacheEnabled;
+	FString								DiskRoot;
+	IImageWrapperModule*				ImageWrapperModule;
+};
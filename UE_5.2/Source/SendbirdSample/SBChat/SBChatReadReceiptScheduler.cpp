@@ -0,0 +1,136 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#include "SBChatReadReceiptScheduler.h"
+#include "SBChatStringTable.h"
+
+static constexpr float READ_RECEIPT_TICK_INTERVAL = 0.1f;
+
+SBChatReadReceiptScheduler::SBChatReadReceiptScheduler()
+{
+	DebounceSeconds = DEFAULT_DEBOUNCE_SECONDS;
+
+	RequestedCount = 0;
+	SentCount = 0;
+}
+
+SBChatReadReceiptScheduler::~SBChatReadReceiptScheduler()
+{
+	Reset();
+}
+
+void SBChatReadReceiptScheduler::Reset()
+{
+	FScopeLock ScopeLock(&Lock);
+
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+
+	Channels.Empty();
+}
+
+void SBChatReadReceiptScheduler::RequestMarkAsRead(SBDGroupChannel* Channel)
+{
+#if WITH_SENDBIRD
+	if (!ensure(Channel))
+		return;
+
+	const FSBChatStringRef ChannelUrlRef = SBChatStringTable::Get().Intern(Channel->channel_url);
+	const FString& ChannelUrl = *ChannelUrlRef;
+	FScopeLock ScopeLock(&Lock);
+
+	const double Now = FPlatformTime::Seconds();
+	FChannelState& State = Channels.FindOrAdd(ChannelUrl);
+	State.Channel = Channel;
+	if (!State.bPending)
+	{
+		State.bPending = true;
+		State.MaxDueTime = Now + MAX_WAIT_SECONDS;
+	}
+	// Later requests push the debounce back, but never past the deadline the first one set.
+	State.DueTime = FMath::Min(Now + DebounceSeconds, State.MaxDueTime);
+	++RequestedCount;
+
+	StartTicker();
+#endif
+}
+
+void SBChatReadReceiptScheduler::Flush(SBDGroupChannel* Channel)
+{
+#if WITH_SENDBIRD
+	if (Channel == nullptr)
+		return;
+
+	const FSBChatStringRef ChannelUrlRef = SBChatStringTable::Get().Intern(Channel->channel_url);
+	const FString& ChannelUrl = *ChannelUrlRef;
+	{
+		FScopeLock ScopeLock(&Lock);
+
+		FChannelState* State = Channels.Find(ChannelUrl);
+		if (State == nullptr || !State->bPending)
+			return;
+
+		// Skip the debounce. If the interval doesn't allow it yet, the ticker sends it as soon as it does.
+		const double Now = FPlatformTime::Seconds();
+		State->DueTime = Now;
+		if (!CanSend(*State, Now))
+			return;
+
+		State->bPending = false;
+		State->LastSentTime = Now;
+		++SentCount;
+	}
+
+	Channel->MarkAsRead();
+#endif
+}
+
+void SBChatReadReceiptScheduler::RemoveChannel(const FString& ChannelUrl)
+{
+	FScopeLock ScopeLock(&Lock);
+	Channels.Remove(ChannelUrl);
+}
+
+//+ private
+void SBChatReadReceiptScheduler::StartTicker()
+{
+	if (TickerHandle.IsValid())
+		return;
+
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &SBChatReadReceiptScheduler::Tick), READ_RECEIPT_TICK_INTERVAL);
+}
+
+bool SBChatReadReceiptScheduler::Tick(float DeltaTime)
+{
+#if WITH_SENDBIRD
+	TArray<SBDGroupChannel*, TInlineAllocator<8>> DueChannels;
+	{
+		FScopeLock ScopeLock(&Lock);
+
+		const double Now = FPlatformTime::Seconds();
+		for (TPair<FString, FChannelState>& Pair : Channels)
+		{
+			FChannelState& State = Pair.Value;
+			if (!State.bPending || Now < State.DueTime || !CanSend(State, Now))
+				continue;
+
+			State.bPending = false;
+			State.LastSentTime = Now;
+			DueChannels.Add(State.Channel);
+		}
+		SentCount += DueChannels.Num();
+	}
+
+	for (SBDGroupChannel* Channel : DueChannels)
+		Channel->MarkAsRead();
+#endif
+	return true;
+}
+
+bool SBChatReadReceiptScheduler::CanSend(const FChannelState& State, double Now)
+{
+	return Now - State.LastSentTime >= MIN_INTERVAL_SECONDS;
+}
+//- private
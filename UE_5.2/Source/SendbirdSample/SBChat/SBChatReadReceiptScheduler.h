@@ -0,0 +1,58 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Sendbird/include/Sendbird.h"
+
+// Coalesces GroupChannel::MarkAsRead() calls per channel behind a trailing-edge debounce.
+// A channel that keeps reading is still marked MAX_WAIT_SECONDS after its first pending request, and calls are spaced
+// by at least MIN_INTERVAL_SECONDS per channel. MarkAsRead() reports no result, so the spacing is all that keeps the
+// channel under the server's rate limit.
+// Channels are keyed by channel_url; the manager drops a channel when it is left or deleted.
+class SBChatReadReceiptScheduler
+{
+public:
+	static constexpr float DEFAULT_DEBOUNCE_SECONDS	= 0.5f;
+	static constexpr float MAX_WAIT_SECONDS			= 2.0f;
+	static constexpr float MIN_INTERVAL_SECONDS		= 1.0f;
+
+	SBChatReadReceiptScheduler();
+	~SBChatReadReceiptScheduler();
+
+	void								Reset();
+	void								SetDebounce(float Seconds) { DebounceSeconds = FMath::Max(Seconds, 0.0f); }
+
+	void								RequestMarkAsRead(SBDGroupChannel* Channel);
+	void								Flush(SBDGroupChannel* Channel);
+	// Forgets the channel without sending what is pending.
+	void								RemoveChannel(const FString& ChannelUrl);
+
+	int64								GetRequestedCount() const { return RequestedCount; }
+	int64								GetSentCount() const { return SentCount; }
+	int64								GetSavedCount() const { return RequestedCount - SentCount; }
+
+private:
+	struct FChannelState
+	{
+		SBDGroupChannel*				Channel = nullptr;
+		bool							bPending = false;
+		double							DueTime = 0.0;
+		double							MaxDueTime = 0.0;
+		double							LastSentTime = -MAX_dbl;
+	};
+
+	void								StartTicker();
+	bool								Tick(float DeltaTime);
+	static bool							CanSend(const FChannelState& State, double Now);
+
+private:
+	FCriticalSection					Lock;
+	TMap<FString, FChannelState>		Channels;
+	FTSTicker::FDelegateHandle			TickerHandle;
+	float								DebounceSeconds;
+
+	int64								RequestedCount;
+	int64								SentCount;
+};
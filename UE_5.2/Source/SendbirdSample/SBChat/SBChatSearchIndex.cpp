@@ -0,0 +1,682 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#include "SBChatSearchIndex.h"
+#include "SBChatManager.h"
+#include "SBChatMessageProjection.h"
+#include "Algo/BinarySearch.h"
+#include "Async/Async.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/OutputDeviceRedirector.h"
+
+namespace
+{
+	// Compaction waits for at least this many dead documents, so small indexes never bother.
+	const int32 MIN_DEAD_TO_COMPACT = 4096;
+	// Documents a search copies out per read lock, to check phrases without holding it.
+	const int32 SEARCH_BATCH = 64;
+
+	// Scripts written without spaces between words: kana, CJK ideographs and Hangul syllables.
+	bool IsCJK(TCHAR C)
+	{
+		return (C >= 0x3040 && C <= 0x30FF)		// Hiragana, Katakana
+			|| (C >= 0x3400 && C <= 0x4DBF)		// CJK Unified Ideographs Extension A
+			|| (C >= 0x4E00 && C <= 0x9FFF)		// CJK Unified Ideographs
+			|| (C >= 0xAC00 && C <= 0xD7AF)		// Hangul Syllables
+			|| (C >= 0xF900 && C <= 0xFAFF);	// CJK Compatibility Ideographs
+	}
+
+	bool IsSeparator(TCHAR C)
+	{
+		if (C < 128)
+			return !FChar::IsAlnum(C) && C != TEXT('_');
+
+		return FChar::IsWhitespace(C)
+			|| (C >= 0x2000 && C <= 0x206F)		// General Punctuation
+			|| (C >= 0x3000 && C <= 0x303F)		// CJK Symbols and Punctuation
+			|| (C >= 0xFE30 && C <= 0xFE4F)		// CJK Compatibility Forms
+			|| (C >= 0xFF00 && C <= 0xFF0F) || (C >= 0xFF1A && C <= 0xFF20) || (C >= 0xFF3B && C <= 0xFF40) || (C >= 0xFF5B && C <= 0xFF65);
+	}
+
+	bool IsLess(const FString& A, const FString& B)
+	{
+		return A.Compare(B, ESearchCase::CaseSensitive) < 0;
+	}
+
+	template<typename FuncType>
+	void ForEachPosting(const TArray<uint8>& Bytes, FuncType Func)
+	{
+		int32 DocID = -1;
+		int32 Index = 0;
+		while (Index < Bytes.Num())
+		{
+			uint32 Delta = 0;
+			for (int32 Shift = 0; Index < Bytes.Num(); Shift += 7)
+			{
+				const uint8 Byte = Bytes[Index++];
+				Delta |= (uint32)(Byte & 0x7F) << Shift;
+				if ((Byte & 0x80) == 0)
+					break;
+			}
+			DocID += (int32)Delta;
+			Func(DocID);
+		}
+	}
+}
+
+SBChatSearchIndex::SBChatSearchIndex()
+	: bWriterScheduled(false)
+{
+	LiveCount = 0;
+	OldestLive = 0;
+}
+
+void SBChatSearchIndex::Reset()
+{
+	FPendingOp Op;
+	Op.Op = EPendingOp::Reset;
+	QueueOp(MoveTemp(Op));
+}
+
+void SBChatSearchIndex::Put(SBDBaseMessage* Message)
+{
+#if WITH_SENDBIRD
+	if (!ensure(Message))
+		return;
+
+	FPendingOp Op;
+	Op.Op = EPendingOp::Put;
+	Op.MessageID = Message->message_id;
+	Op.CreatedAt = Message->created_at;
+	Op.UpdatedAt = Message->updated_at;
+	if (Message->message_type == SBDMessageType::User)
+	{
+		SBDUserMessage* UserMessage = static_cast<SBDUserMessage*>(Message);
+		Op.MessageType = ESBMessageType::SBDMessageTypeUser;
+		Op.Sender = FSBUserInfo(UserMessage->sender);
+		Op.Text = SBChatStringTable::Convert(UserMessage->message);
+	}
+	else if (Message->message_type == SBDMessageType::File)
+	{
+		SBDFileMessage* FileMessage = static_cast<SBDFileMessage*>(Message);
+		Op.MessageType = ESBMessageType::SBDMessageTypeFile;
+		Op.Sender = FSBUserInfo(FileMessage->sender);
+		Op.Text = SBChatStringTable::Convert(FileMessage->name);
+	}
+	else
+	{
+		return;
+	}
+
+	Op.ChannelUrl = SBChatStringTable::Convert(Message->channel_url);
+	QueueOp(MoveTemp(Op));
+#endif
+}
+
+void SBChatSearchIndex::Remove(uint64 MessageID)
+{
+	FPendingOp Op;
+	Op.Op = EPendingOp::Remove;
+	Op.MessageID = MessageID;
+	QueueOp(MoveTemp(Op));
+}
+
+void SBChatSearchIndex::RemoveChannel(const FString& ChannelUrl)
+{
+	FPendingOp Op;
+	Op.Op = EPendingOp::RemoveChannel;
+	Op.ChannelUrl = ChannelUrl;
+	QueueOp(MoveTemp(Op));
+}
+
+void SBChatSearchIndex::Put(uint64 MessageID, const FString& ChannelUrl, int64 CreatedAt, int64 UpdatedAt, ESBMessageType MessageType,
+	const FSBUserInfo& Sender, const FString& Text)
+{
+	if (MessageType == ESBMessageType::SBDMessageTypeAdmin)
+		return;
+
+	// Reloading a history puts the same messages again.
+	{
+		FReadScopeLock ReadLock(Lock);
+		const int32* Existing = DocByMessageID.Find(MessageID);
+		if (Existing != nullptr && Documents[*Existing].UpdatedAt == UpdatedAt)
+			return;
+	}
+
+	// Tokenized before taking the lock; each term is posted once per document.
+	TArray<FString> DocTerms;
+	Tokenize(Text, DocTerms);
+	DocTerms.Sort(IsLess);
+
+	FWriteScopeLock WriteLock(Lock);
+
+	if (const int32* Existing = DocByMessageID.Find(MessageID))
+	{
+		if (Documents[*Existing].UpdatedAt == UpdatedAt)
+			return;
+
+		RemoveDocument(*Existing);
+	}
+
+	const int32 DocID = Documents.Num();
+	FDocument& Document = Documents.AddDefaulted_GetRef();
+	Document.MessageID = MessageID;
+	Document.CreatedAt = CreatedAt;
+	Document.UpdatedAt = UpdatedAt;
+	Document.ChannelIndex = FindOrAddChannel(ChannelUrl);
+	Document.SenderIndex = FindOrAddSender(Sender);
+	Document.MessageType = MessageType;
+	Document.Text = Text;
+
+	LiveDocs.Add(true);
+	DocByMessageID.Add(MessageID, DocID);
+	++LiveCount;
+
+	for (int32 Index = 0; Index < DocTerms.Num(); ++Index)
+	{
+		if (Index > 0 && DocTerms[Index].Equals(DocTerms[Index - 1], ESearchCase::CaseSensitive))
+			continue;
+
+		FTerm& Term = Terms[FindOrAddTerm(DocTerms[Index])];
+		AppendVarint(Term.Postings, (uint32)(DocID - Term.LastDocID));
+		Term.LastDocID = DocID;
+	}
+
+	EvictOverLimit();
+	CompactIfNeeded();
+}
+
+void SBChatSearchIndex::Search(const FString& Query, const FString& ChannelUrl, int32 MaxResults, TArray<FSBSearchResult>& OutResults) const
+{
+	OutResults.Reset();
+
+	TArray<FClause> Clauses;
+	ParseQuery(Query, Clauses);
+	if (Clauses.Num() == 0)
+		return;
+
+	if (MaxResults <= 0)
+		MaxResults = DEFAULT_MAX_RESULTS;
+
+	TArray<uint64> Hits;
+	{
+		FReadScopeLock ReadLock(Lock);
+
+		int32 ChannelIndex = INDEX_NONE;
+		if (!ChannelUrl.IsEmpty())
+		{
+			const int32* Found = ChannelIndices.Find(ChannelUrl);
+			if (Found == nullptr)
+				return;
+			ChannelIndex = *Found;
+		}
+
+		TBitArray<> Candidates = LiveDocs;
+		for (const FClause& Clause : Clauses)
+			Match(Clause, Candidates);
+
+		TArray<int32> HitDocs;
+		for (TConstSetBitIterator<> It(Candidates); It; ++It)
+		{
+			if (ChannelIndex == INDEX_NONE || Documents[It.GetIndex()].ChannelIndex == ChannelIndex)
+				HitDocs.Add(It.GetIndex());
+		}
+
+		HitDocs.Sort([this](int32 A, int32 B) {
+			const FDocument& DocumentA = Documents[A];
+			const FDocument& DocumentB = Documents[B];
+			return DocumentA.CreatedAt != DocumentB.CreatedAt ? DocumentA.CreatedAt > DocumentB.CreatedAt : DocumentA.MessageID > DocumentB.MessageID;
+		});
+
+		Hits.Reserve(HitDocs.Num());
+		for (int32 DocID : HitDocs)
+			Hits.Add(Documents[DocID].MessageID);
+	}
+
+	// Posting lists don't know where a term is in the text, so phrases are checked against the text, newest first,
+	// until there are enough results. Documents are copied out a batch at a time and checked without the lock; one
+	// the writer dropped or compacted away meanwhile is found again by its message id, or skipped.
+	TArray<FSBSearchResult> Batch;
+	for (int32 First = 0; First < Hits.Num() && OutResults.Num() < MaxResults; First += SEARCH_BATCH)
+	{
+		Batch.Reset();
+		{
+			FReadScopeLock ReadLock(Lock);
+			const int32 Last = FMath::Min(First + SEARCH_BATCH, Hits.Num());
+			for (int32 Index = First; Index < Last; ++Index)
+			{
+				const int32* DocID = DocByMessageID.Find(Hits[Index]);
+				if (DocID == nullptr)
+					continue;
+
+				const FDocument& Document = Documents[*DocID];
+				FSBSearchResult& Result = Batch.AddDefaulted_GetRef();
+				Result.ChannelUrl = ChannelUrls[Document.ChannelIndex];
+				Result.MessageInfo.MessageID = Document.MessageID;
+				Result.MessageInfo.UserInfo = Senders[Document.SenderIndex];
+				Result.MessageInfo.MessageType = Document.MessageType;
+				Result.MessageInfo.Message = Document.Text;
+				Result.MessageInfo.UpdatedTime = SBChatMessageProjection::ToDateTime(Document.UpdatedAt != 0 ? Document.UpdatedAt : Document.CreatedAt);
+			}
+		}
+
+		for (FSBSearchResult& Result : Batch)
+		{
+			bool bMatched = true;
+			for (const FClause& Clause : Clauses)
+			{
+				if (Clause.Terms.Num() > 1 && !MatchPhrase(Clause, Result.MessageInfo.Message))
+				{
+					bMatched = false;
+					break;
+				}
+			}
+			if (!bMatched)
+				continue;
+
+			OutResults.Add(MoveTemp(Result));
+			if (OutResults.Num() >= MaxResults)
+				break;
+		}
+	}
+}
+
+int32 SBChatSearchIndex::Num() const
+{
+	FReadScopeLock ReadLock(Lock);
+	return LiveCount;
+}
+
+void SBChatSearchIndex::Report(FOutputDevice& Ar) const
+{
+	FReadScopeLock ReadLock(Lock);
+
+	int64 PostingBytes = 0;
+	for (const FTerm& Term : Terms)
+		PostingBytes += Term.Postings.Num();
+
+	int64 TextBytes = 0;
+	for (TConstSetBitIterator<> It(LiveDocs); It; ++It)
+		TextBytes += Documents[It.GetIndex()].Text.Len() * sizeof(TCHAR);
+
+	Ar.Logf(TEXT("documents %d live, %d dead; %d terms, %lld posting bytes, %lld text bytes; %d channels, %d senders"),
+		LiveCount, Documents.Num() - LiveCount, Terms.Num(), PostingBytes, TextBytes, ChannelUrls.Num(), Senders.Num());
+}
+
+void SBChatSearchIndex::Tokenize(const FString& Text, TArray<FString>& OutTerms)
+{
+	const FString Lower = Text.ToLower();
+	const TCHAR* Chars = *Lower;
+	const int32 Len = Lower.Len();
+
+	int32 Index = 0;
+	while (Index < Len)
+	{
+		if (IsSeparator(Chars[Index]))
+		{
+			++Index;
+			continue;
+		}
+
+		int32 End = Index + 1;
+		if (IsCJK(Chars[Index]))
+		{
+			while (End < Len && IsCJK(Chars[End]))
+				++End;
+
+			// A lone character is its own term; longer runs are posted as overlapping pairs.
+			if (End - Index == 1)
+				OutTerms.Add(FString(1, Chars + Index));
+			for (int32 Pair = Index; Pair + 1 < End; ++Pair)
+				OutTerms.Add(FString(2, Chars + Pair));
+		}
+		else
+		{
+			while (End < Len && !IsSeparator(Chars[End]) && !IsCJK(Chars[End]))
+				++End;
+
+			OutTerms.Add(FString(FMath::Min(End - Index, MAX_TERM_LENGTH), Chars + Index));
+		}
+		Index = End;
+	}
+}
+
+//+ private
+void SBChatSearchIndex::QueueOp(FPendingOp&& Op)
+{
+	PendingOps.Enqueue(MoveTemp(Op));
+	if (!bWriterScheduled.Exchange(true))
+		Async(EAsyncExecution::ThreadPool, [this]() { RunWriter(); });
+}
+
+void SBChatSearchIndex::RunWriter()
+{
+	for (;;)
+	{
+		FPendingOp Op;
+		while (PendingOps.Dequeue(Op))
+			Apply(Op);
+		bWriterScheduled = false;
+
+		// An op queued between the last dequeue and clearing the flag found the writer still scheduled.
+		if (PendingOps.IsEmpty() || bWriterScheduled.Exchange(true))
+			return;
+	}
+}
+
+void SBChatSearchIndex::Apply(FPendingOp& Op)
+{
+	switch (Op.Op)
+	{
+	case EPendingOp::Put:
+		Put(Op.MessageID, Op.ChannelUrl, Op.CreatedAt, Op.UpdatedAt, Op.MessageType, Op.Sender, Op.Text);
+		break;
+
+	case EPendingOp::Remove:
+		ApplyRemove(Op.MessageID);
+		break;
+
+	case EPendingOp::RemoveChannel:
+		ApplyRemoveChannel(Op.ChannelUrl);
+		break;
+
+	case EPendingOp::Reset:
+		ApplyReset();
+		break;
+	}
+}
+
+void SBChatSearchIndex::ApplyReset()
+{
+	FWriteScopeLock WriteLock(Lock);
+
+	Documents.Empty();
+	LiveDocs.Empty();
+	DocByMessageID.Empty();
+	LiveCount = 0;
+	OldestLive = 0;
+
+	Terms.Empty();
+	TermIDs.Empty();
+	SortedTerms.Empty();
+
+	ChannelUrls.Empty();
+	ChannelIndices.Empty();
+	Senders.Empty();
+	SenderIndices.Empty();
+}
+
+void SBChatSearchIndex::ApplyRemove(uint64 MessageID)
+{
+	FWriteScopeLock WriteLock(Lock);
+
+	const int32* DocID = DocByMessageID.Find(MessageID);
+	if (DocID == nullptr)
+		return;
+
+	RemoveDocument(*DocID);
+	CompactIfNeeded();
+}
+
+void SBChatSearchIndex::ApplyRemoveChannel(const FString& ChannelUrl)
+{
+	FWriteScopeLock WriteLock(Lock);
+
+	const int32* ChannelIndex = ChannelIndices.Find(ChannelUrl);
+	if (ChannelIndex == nullptr)
+		return;
+
+	for (int32 DocID = OldestLive; DocID < Documents.Num(); ++DocID)
+	{
+		if (LiveDocs[DocID] && Documents[DocID].ChannelIndex == *ChannelIndex)
+			RemoveDocument(DocID);
+	}
+	CompactIfNeeded();
+}
+
+void SBChatSearchIndex::ParseQuery(const FString& Query, TArray<FClause>& OutClauses)
+{
+	TArray<FString> Parts;
+	Query.ParseIntoArray(Parts, TEXT("\""), false);
+
+	// Parts alternate between outside and inside quotes; an unclosed quote runs to the end.
+	for (int32 PartIndex = 0; PartIndex < Parts.Num(); ++PartIndex)
+	{
+		if (PartIndex % 2 == 1)
+		{
+			FClause Clause;
+			Tokenize(Parts[PartIndex], Clause.Terms);
+			if (Clause.Terms.Num() > 0)
+				OutClauses.Add(MoveTemp(Clause));
+			continue;
+		}
+
+		// A word that splits into several terms, like "don't" or a run of CJK text, is matched as a phrase.
+		TArray<FString> Words;
+		Parts[PartIndex].ParseIntoArrayWS(Words);
+		for (const FString& Word : Words)
+		{
+			FClause Clause;
+			Clause.bPrefix = true;
+			Tokenize(Word, Clause.Terms);
+			if (Clause.Terms.Num() > 0)
+				OutClauses.Add(MoveTemp(Clause));
+		}
+	}
+}
+
+void SBChatSearchIndex::Match(const FClause& Clause, TBitArray<>& InOutCandidates) const
+{
+	TBitArray<> TermDocs;
+	for (int32 Index = 0; Index < Clause.Terms.Num(); ++Index)
+	{
+		const FString& Text = Clause.Terms[Index];
+		TermDocs.Init(false, Documents.Num());
+
+		if (Clause.bPrefix && Index == Clause.Terms.Num() - 1)
+		{
+			const int32 First = Algo::LowerBoundBy(SortedTerms, Text, [this](int32 TermID) -> const FString& { return Terms[TermID].Text; }, IsLess);
+			for (int32 Sorted = First; Sorted < SortedTerms.Num(); ++Sorted)
+			{
+				const FTerm& Term = Terms[SortedTerms[Sorted]];
+				if (!Term.Text.StartsWith(Text, ESearchCase::CaseSensitive))
+					break;
+				CollectPostings(Term, TermDocs);
+			}
+		}
+		else if (const int32* TermID = TermIDs.Find(Text))
+		{
+			CollectPostings(Terms[*TermID], TermDocs);
+		}
+
+		InOutCandidates.CombineWithBitwiseAND(TermDocs, EBitwiseOperatorFlags::MaintainSize);
+	}
+}
+
+bool SBChatSearchIndex::MatchPhrase(const FClause& Clause, const FString& Text)
+{
+	TArray<FString> DocTerms;
+	Tokenize(Text, DocTerms);
+
+	const int32 Last = Clause.Terms.Num() - 1;
+	for (int32 Start = 0; Start + Last < DocTerms.Num(); ++Start)
+	{
+		int32 Index = 0;
+		while (Index < Last && DocTerms[Start + Index].Equals(Clause.Terms[Index], ESearchCase::CaseSensitive))
+			++Index;
+		if (Index < Last)
+			continue;
+
+		const FString& DocTerm = DocTerms[Start + Last];
+		if (Clause.bPrefix ? DocTerm.StartsWith(Clause.Terms[Last], ESearchCase::CaseSensitive) : DocTerm.Equals(Clause.Terms[Last], ESearchCase::CaseSensitive))
+			return true;
+	}
+	return false;
+}
+
+void SBChatSearchIndex::CollectPostings(const FTerm& Term, TBitArray<>& OutDocs) const
+{
+	ForEachPosting(Term.Postings, [&OutDocs](int32 DocID) {
+		OutDocs[DocID] = true;
+	});
+}
+
+int32 SBChatSearchIndex::FindOrAddTerm(const FString& Text)
+{
+	if (const int32* TermID = TermIDs.Find(Text))
+		return *TermID;
+
+	const int32 TermID = Terms.Num();
+	Terms.AddDefaulted_GetRef().Text = Text;
+	TermIDs.Add(Text, TermID);
+	SortedTerms.Insert(TermID, Algo::LowerBoundBy(SortedTerms, Text, [this](int32 SortedID) -> const FString& { return Terms[SortedID].Text; }, IsLess));
+	return TermID;
+}
+
+int32 SBChatSearchIndex::FindOrAddChannel(const FString& ChannelUrl)
+{
+	if (const int32* ChannelIndex = ChannelIndices.Find(ChannelUrl))
+		return *ChannelIndex;
+
+	return ChannelIndices.Add(ChannelUrl, ChannelUrls.Add(ChannelUrl));
+}
+
+int32 SBChatSearchIndex::FindOrAddSender(const FSBUserInfo& Sender)
+{
+	// Results show the sender's latest nickname and profile.
+	if (const int32* SenderIndex = SenderIndices.Find(Sender.UserID))
+	{
+		Senders[*SenderIndex] = Sender;
+		return *SenderIndex;
+	}
+
+	return SenderIndices.Add(Sender.UserID, Senders.Add(Sender));
+}
+
+void SBChatSearchIndex::RemoveDocument(int32 DocID)
+{
+	FDocument& Document = Documents[DocID];
+	DocByMessageID.Remove(Document.MessageID);
+	Document.Text.Empty();
+	LiveDocs[DocID] = false;
+	--LiveCount;
+}
+
+void SBChatSearchIndex::EvictOverLimit()
+{
+	while (LiveCount > MAX_DOCUMENTS)
+	{
+		while (!LiveDocs[OldestLive])
+			++OldestLive;
+		RemoveDocument(OldestLive);
+	}
+}
+
+void SBChatSearchIndex::CompactIfNeeded()
+{
+	const int32 DeadCount = Documents.Num() - LiveCount;
+	if (DeadCount < MIN_DEAD_TO_COMPACT || DeadCount <= LiveCount)
+		return;
+
+	// Live documents keep their order, so ids stay increasing in every posting list.
+	TArray<int32> NewDocIDs;
+	NewDocIDs.SetNumUninitialized(Documents.Num());
+	TArray<FDocument> KeptDocuments;
+	KeptDocuments.Reserve(LiveCount);
+	for (int32 DocID = 0; DocID < Documents.Num(); ++DocID)
+	{
+		if (!LiveDocs[DocID])
+		{
+			NewDocIDs[DocID] = INDEX_NONE;
+			continue;
+		}
+
+		NewDocIDs[DocID] = KeptDocuments.Num();
+		DocByMessageID[Documents[DocID].MessageID] = KeptDocuments.Num();
+		KeptDocuments.Add(MoveTemp(Documents[DocID]));
+	}
+	Documents = MoveTemp(KeptDocuments);
+	LiveDocs.Init(true, Documents.Num());
+	OldestLive = 0;
+
+	// Terms left with no live document go away.
+	TArray<int32> NewTermIDs;
+	NewTermIDs.SetNumUninitialized(Terms.Num());
+	TArray<FTerm> KeptTerms;
+	TermIDs.Reset();
+	for (int32 TermID = 0; TermID < Terms.Num(); ++TermID)
+	{
+		FTerm NewTerm;
+		ForEachPosting(Terms[TermID].Postings, [&NewDocIDs, &NewTerm](int32 DocID) {
+			const int32 NewDocID = NewDocIDs[DocID];
+			if (NewDocID == INDEX_NONE)
+				return;
+
+			AppendVarint(NewTerm.Postings, (uint32)(NewDocID - NewTerm.LastDocID));
+			NewTerm.LastDocID = NewDocID;
+		});
+
+		if (NewTerm.LastDocID == INDEX_NONE)
+		{
+			NewTermIDs[TermID] = INDEX_NONE;
+			continue;
+		}
+
+		NewTerm.Text = MoveTemp(Terms[TermID].Text);
+		NewTerm.Postings.Shrink();
+		NewTermIDs[TermID] = KeptTerms.Num();
+		TermIDs.Add(NewTerm.Text, KeptTerms.Num());
+		KeptTerms.Add(MoveTemp(NewTerm));
+	}
+	Terms = MoveTemp(KeptTerms);
+
+	TArray<int32> KeptSortedTerms;
+	KeptSortedTerms.Reserve(Terms.Num());
+	for (int32 TermID : SortedTerms)
+	{
+		if (NewTermIDs[TermID] != INDEX_NONE)
+			KeptSortedTerms.Add(NewTermIDs[TermID]);
+	}
+	SortedTerms = MoveTemp(KeptSortedTerms);
+}
+
+void SBChatSearchIndex::AppendVarint(TArray<uint8>& Bytes, uint32 Value)
+{
+	while (Value >= 0x80)
+	{
+		Bytes.Add((uint8)(Value | 0x80));
+		Value >>= 7;
+	}
+	Bytes.Add((uint8)Value);
+}
+//- private
+
+#if !UE_BUILD_SHIPPING
+
+namespace SBChatSearchIndexCommands
+{
+	static void Search(const TArray<FString>& Args)
+	{
+		SBChatSearchIndex& SearchIndex = SBChatManager::Get().GetSearchIndex();
+		if (Args.Num() == 0)
+		{
+			SearchIndex.Report(*GLog);
+			return;
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+		TArray<FSBSearchResult> Results;
+		SearchIndex.Search(FString::Join(Args, TEXT(" ")), FString(), SBChatSearchIndex::DEFAULT_MAX_RESULTS, Results);
+		const double Elapsed = FPlatformTime::Seconds() - StartTime;
+
+		for (const FSBSearchResult& Result : Results)
+			GLog->Logf(TEXT("%-48s %-16s %s"), *Result.ChannelUrl, *Result.MessageInfo.UserInfo.NickName, *Result.MessageInfo.Message);
+		GLog->Logf(TEXT("%d results in %.3f ms over %d messages"), Results.Num(), Elapsed * 1000.0, SearchIndex.Num());
+	}
+
+	static FAutoConsoleCommand SearchCommand(
+		TEXT("sbchat.Search"),
+		TEXT("Searches every indexed message, or prints the index's size without a query. Usage: sbchat.Search [Query]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&Search));
+}
+
+#endif
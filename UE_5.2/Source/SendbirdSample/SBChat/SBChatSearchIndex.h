@@ -0,0 +1,140 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "Sendbird/include/Sendbird.h"
+#include "SBChatCommonStruct.h"
+
+// Inverted index over the text of every message the session has seen (user message text, file names), across
+// channels. It outlives the history stores, so a channel's messages stay searchable after its history is reloaded
+// or evicted; it is dropped with the session.
+// Text is lowercased and split into words; runs of CJK characters, which have no spaces, are split into overlapping
+// character pairs. A term's posting list holds the ids of the documents containing it, delta and varint encoded.
+// Updates and deletes only mark the old document dead; the postings are compacted once more than half of the
+// documents are dead. Past MAX_DOCUMENTS the documents indexed first are dropped.
+// Changes made from the game thread are queued and applied by a writer on the thread pool, so the game thread never
+// takes the lock. Searches run on the thread pool too; a read-write lock keeps them apart from the writer, and a
+// search copies documents out a batch at a time so it never holds the lock for the whole query.
+class SBChatSearchIndex
+{
+public:
+	static const int32 MAX_DOCUMENTS		= 200000;
+	// Longer words are cut; nobody types 32 characters to search.
+	static const int32 MAX_TERM_LENGTH		= 32;
+	static const int32 DEFAULT_MAX_RESULTS	= 50;
+
+	SBChatSearchIndex();
+
+	// Queued for the writer, in order; the caller's thread only copies the message's fields.
+	void								Reset();
+	void								Put(SBDBaseMessage* Message);
+	void								Remove(uint64 MessageID);
+	void								RemoveChannel(const FString& ChannelUrl);
+
+	// Indexes the message, or reindexes it if it changed since; admin messages are not indexed.
+	// Applied right away under the write lock, on the caller's thread.
+	void								Put(uint64 MessageID, const FString& ChannelUrl, int64 CreatedAt, int64 UpdatedAt, ESBMessageType MessageType,
+											const FSBUserInfo& Sender, const FString& Text);
+
+	// Words in the query match as prefixes ("gui ra" finds "guild raid"); text in double quotes must appear as is,
+	// word for word. Every part has to match. Results are newest first; an empty ChannelUrl searches every channel.
+	// Call it off the game thread.
+	void								Search(const FString& Query, const FString& ChannelUrl, int32 MaxResults, TArray<FSBSearchResult>& OutResults) const;
+
+	int32								Num() const;
+	void								Report(FOutputDevice& Ar) const;
+
+	// Lowercased terms of Text in order, as they are indexed.
+	static void							Tokenize(const FString& Text, TArray<FString>& OutTerms);
+
+private:
+	struct FDocument
+	{
+		uint64							MessageID;
+		int64							CreatedAt;
+		int64							UpdatedAt;
+		int32							ChannelIndex;
+		int32							SenderIndex;
+		ESBMessageType					MessageType;
+		FString							Text;
+	};
+
+	struct FTerm
+	{
+		FString							Text;
+		TArray<uint8>					Postings;		// deltas between increasing document ids, varint encoded
+		int32							LastDocID = -1;
+	};
+
+	// One part of a query: its terms in order, the last one possibly matched as a prefix.
+	struct FClause
+	{
+		TArray<FString>					Terms;
+		bool							bPrefix = false;
+	};
+
+	enum class EPendingOp : uint8
+	{
+		Put,
+		Remove,
+		RemoveChannel,
+		Reset,
+	};
+
+	struct FPendingOp
+	{
+		EPendingOp						Op = EPendingOp::Put;
+		uint64							MessageID = 0;
+		FString							ChannelUrl;
+		int64							CreatedAt = 0;
+		int64							UpdatedAt = 0;
+		ESBMessageType					MessageType = ESBMessageType::SBDMessageTypeUser;
+		FSBUserInfo						Sender;
+		FString							Text;
+	};
+
+	void								QueueOp(FPendingOp&& Op);
+	void								RunWriter();
+	void								Apply(FPendingOp& Op);
+	void								ApplyReset();
+	void								ApplyRemove(uint64 MessageID);
+	void								ApplyRemoveChannel(const FString& ChannelUrl);
+
+	static void							ParseQuery(const FString& Query, TArray<FClause>& OutClauses);
+	void								Match(const FClause& Clause, TBitArray<>& InOutCandidates) const;
+	static bool							MatchPhrase(const FClause& Clause, const FString& Text);
+	void								CollectPostings(const FTerm& Term, TBitArray<>& OutDocs) const;
+	int32								FindOrAddTerm(const FString& Text);
+	int32								FindOrAddChannel(const FString& ChannelUrl);
+	int32								FindOrAddSender(const FSBUserInfo& Sender);
+	void								RemoveDocument(int32 DocID);
+	void								EvictOverLimit();
+	void								CompactIfNeeded();
+
+	static void							AppendVarint(TArray<uint8>& Bytes, uint32 Value);
+
+private:
+	mutable FRWLock						Lock;
+
+	TArray<FDocument>					Documents;
+	TBitArray<>							LiveDocs;
+	TMap<uint64, int32>					DocByMessageID;
+	int32								LiveCount;
+	// Documents before it are all dead; where eviction looks first.
+	int32								OldestLive;
+
+	TArray<FTerm>						Terms;
+	TMap<FString, int32>				TermIDs;
+	// Term ids ordered by text, for prefix lookups.
+	TArray<int32>						SortedTerms;
+
+	TArray<FString>						ChannelUrls;
+	TMap<FString, int32>				ChannelIndices;
+	TArray<FSBUserInfo>					Senders;
+	TMap<FString, int32>				SenderIndices;
+
+	TQueue<FPendingOp, EQueueMode::Mpsc>	PendingOps;
+	TAtomic<bool>						bWriterScheduled;
+};
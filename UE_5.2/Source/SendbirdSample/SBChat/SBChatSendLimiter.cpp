@@ -0,0 +1,163 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#include "SBChatSendLimiter.h"
+#include "SBChatManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/OutputDeviceRedirector.h"
+
+SBChatSendLimiter::SBChatSendLimiter()
+{
+	Policy = ESBSendOverflowPolicy::Queue;
+	MaxQueued = DEFAULT_MAX_QUEUED;
+	ChannelRate = DEFAULT_CHANNEL_RATE;
+	ChannelBurst = DEFAULT_CHANNEL_BURST;
+	GlobalRate = DEFAULT_GLOBAL_RATE;
+	GlobalBurst = DEFAULT_GLOBAL_BURST;
+
+	Reset();
+}
+
+void SBChatSendLimiter::Reset()
+{
+	GlobalBucket.Tokens = GlobalBurst;
+	GlobalBucket.LastRefillTime = FPlatformTime::Seconds();
+	ChannelBuckets.Empty();
+
+	Totals = FStats();
+	ChannelStats.Empty();
+}
+
+void SBChatSendLimiter::SetChannelLimit(float Rate, float Burst)
+{
+	ChannelRate = FMath::Max(Rate, 0.01f);
+	ChannelBurst = FMath::Max(Burst, 1.0f);
+	for (TPair<FString, FBucket>& Pair : ChannelBuckets)
+		Pair.Value.Tokens = FMath::Min(Pair.Value.Tokens, (double)ChannelBurst);
+}
+
+void SBChatSendLimiter::SetGlobalLimit(float Rate, float Burst)
+{
+	GlobalRate = FMath::Max(Rate, 0.01f);
+	GlobalBurst = FMath::Max(Burst, 1.0f);
+	GlobalBucket.Tokens = FMath::Min(GlobalBucket.Tokens, (double)GlobalBurst);
+}
+
+void SBChatSendLimiter::SetPolicy(ESBSendOverflowPolicy InPolicy, int32 InMaxQueued)
+{
+	Policy = InPolicy;
+	MaxQueued = FMath::Max(InMaxQueued, 1);
+}
+
+void SBChatSendLimiter::RemoveChannel(const FString& ChannelUrl)
+{
+	ChannelBuckets.Remove(ChannelUrl);
+}
+
+bool SBChatSendLimiter::TryAcquire(const FString& ChannelUrl)
+{
+	const double Now = FPlatformTime::Seconds();
+
+	// A channel seen for the first time starts with a full burst.
+	FBucket* Bucket = ChannelBuckets.Find(ChannelUrl);
+	if (Bucket == nullptr)
+		Bucket = &ChannelBuckets.Add(ChannelUrl, FBucket{ ChannelBurst, Now });
+
+	Refill(*Bucket, ChannelRate, ChannelBurst, Now);
+	Refill(GlobalBucket, GlobalRate, GlobalBurst, Now);
+	if (Bucket->Tokens < 1.0 || GlobalBucket.Tokens < 1.0)
+		return false;
+
+	Bucket->Tokens -= 1.0;
+	GlobalBucket.Tokens -= 1.0;
+	++Totals.Sent;
+	++GetChannelStats(ChannelUrl).Sent;
+	return true;
+}
+
+//+ Report
+void SBChatSendLimiter::RecordDelayed(const FString& ChannelUrl)
+{
+	++Totals.Delayed;
+	++GetChannelStats(ChannelUrl).Delayed;
+}
+
+void SBChatSendLimiter::RecordDelay(const FString& ChannelUrl, double Seconds)
+{
+	FStats& Stats = GetChannelStats(ChannelUrl);
+	++Stats.DelaySamples;
+	Stats.TotalDelaySeconds += Seconds;
+	Stats.MaxDelaySeconds = FMath::Max(Stats.MaxDelaySeconds, Seconds);
+	++Totals.DelaySamples;
+	Totals.TotalDelaySeconds += Seconds;
+	Totals.MaxDelaySeconds = FMath::Max(Totals.MaxDelaySeconds, Seconds);
+}
+
+void SBChatSendLimiter::RecordCoalesced(const FString& ChannelUrl, int32 Count)
+{
+	Totals.Coalesced += Count;
+	GetChannelStats(ChannelUrl).Coalesced += Count;
+}
+
+void SBChatSendLimiter::RecordDropped(const FString& ChannelUrl)
+{
+	++Totals.Dropped;
+	++GetChannelStats(ChannelUrl).Dropped;
+}
+
+void SBChatSendLimiter::Report(FOutputDevice& Ar) const
+{
+	static const TCHAR* PolicyNames[] = { TEXT("queue"), TEXT("coalesce"), TEXT("drop") };
+	Ar.Logf(TEXT("policy %s, max queued %d, channel %.2f/s burst %.0f, global %.2f/s burst %.0f"), PolicyNames[(int32)Policy], MaxQueued,
+		ChannelRate, ChannelBurst, GlobalRate, GlobalBurst);
+
+	Ar.Logf(TEXT("%-48s %8s %8s %10s %8s %14s %12s"), TEXT("channel"), TEXT("sent"), TEXT("delayed"), TEXT("coalesced"), TEXT("dropped"),
+		TEXT("mean delay ms"), TEXT("max delay ms"));
+
+	auto LogStats = [&Ar](const FString& Name, const FStats& Stats) {
+		const double MeanDelay = Stats.DelaySamples > 0 ? Stats.TotalDelaySeconds / Stats.DelaySamples : 0.0;
+		Ar.Logf(TEXT("%-48s %8lld %8lld %10lld %8lld %14.1f %12.1f"), *Name, Stats.Sent, Stats.Delayed, Stats.Coalesced, Stats.Dropped,
+			MeanDelay * 1000.0, Stats.MaxDelaySeconds * 1000.0);
+	};
+
+	for (const TPair<FString, FStats>& Pair : ChannelStats)
+		LogStats(Pair.Key, Pair.Value);
+	LogStats(TEXT("total"), Totals);
+}
+//- Report
+
+//+ private
+void SBChatSendLimiter::Refill(FBucket& Bucket, float Rate, float Burst, double Now)
+{
+	Bucket.Tokens = FMath::Min((double)Burst, Bucket.Tokens + (Now - Bucket.LastRefillTime) * Rate);
+	Bucket.LastRefillTime = Now;
+}
+
+SBChatSendLimiter::FStats& SBChatSendLimiter::GetChannelStats(const FString& ChannelUrl)
+{
+	return ChannelStats.FindOrAdd(ChannelUrl);
+}
+//- private
+
+#if !UE_BUILD_SHIPPING
+
+namespace SBChatSendLimiterCommands
+{
+	static void ShowSendLimiter(const TArray<FString>& Args)
+	{
+		SBChatSendLimiter& Limiter = SBChatManager::Get().GetSendLimiter();
+		if (Args.Num() > 0 && Args[0] == TEXT("reset"))
+		{
+			Limiter.Reset();
+			return;
+		}
+
+		Limiter.Report(*GLog);
+	}
+
+	static FAutoConsoleCommand SendLimiterCommand(
+		TEXT("sbchat.SendLimiter"),
+		TEXT("Prints what the send limiter delayed, coalesced and dropped, per channel. Usage: sbchat.SendLimiter [reset]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&ShowSendLimiter));
+}
+
+#endif
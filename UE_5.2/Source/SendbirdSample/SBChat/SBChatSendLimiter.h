@@ -0,0 +1,85 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SBChatCommonEnum.h"
+
+// Token buckets in front of the SDK's send calls, so a player mashing Enter or a bot can't get the channel throttled
+// by the server. Every channel has its own bucket and all of them share a global one; a send needs a token from both.
+// A bucket refills at Rate tokens per second up to Burst. What happens to a send that finds no token is up to the
+// overflow policy, applied by the caller (the outbox); the limiter only keeps count of what was delayed, coalesced
+// or dropped.
+// Game thread only.
+class SBChatSendLimiter
+{
+public:
+	static constexpr float DEFAULT_CHANNEL_RATE		= 2.0f;
+	static constexpr float DEFAULT_CHANNEL_BURST	= 5.0f;
+	static constexpr float DEFAULT_GLOBAL_RATE		= 5.0f;
+	static constexpr float DEFAULT_GLOBAL_BURST		= 10.0f;
+	static const int32 DEFAULT_MAX_QUEUED			= 32;
+	// Coalesced messages stop growing past this many characters.
+	static const int32 MAX_COALESCED_LENGTH			= 1024;
+
+	struct FStats
+	{
+		int64							Sent = 0;
+		int64							Delayed = 0;
+		int64							Coalesced = 0;
+		int64							Dropped = 0;
+		int64							DelaySamples = 0;		// delayed sends that went out
+		double							TotalDelaySeconds = 0.0;
+		double							MaxDelaySeconds = 0.0;
+	};
+
+	SBChatSendLimiter();
+
+	void								Reset();
+	void								SetChannelLimit(float Rate, float Burst);
+	void								SetGlobalLimit(float Rate, float Burst);
+	void								SetPolicy(ESBSendOverflowPolicy InPolicy, int32 InMaxQueued);
+	ESBSendOverflowPolicy				GetPolicy() const { return Policy; }
+	// Per channel; sends past it are dropped under the Queue policy.
+	int32								GetMaxQueued() const { return MaxQueued; }
+	void								RemoveChannel(const FString& ChannelUrl);
+
+	// Takes a token from the channel's bucket and the global one if both have one.
+	bool								TryAcquire(const FString& ChannelUrl);
+
+	//+ Report
+	// A send found no token; counted once per send, however long it waits.
+	void								RecordDelayed(const FString& ChannelUrl);
+	// A delayed send went out after waiting Seconds.
+	void								RecordDelay(const FString& ChannelUrl, double Seconds);
+	void								RecordCoalesced(const FString& ChannelUrl, int32 Count);
+	void								RecordDropped(const FString& ChannelUrl);
+
+	FStats								GetStats() const { return Totals; }
+	void								Report(FOutputDevice& Ar) const;
+	//- Report
+
+private:
+	struct FBucket
+	{
+		double							Tokens = 0.0;
+		double							LastRefillTime = 0.0;
+	};
+
+	static void							Refill(FBucket& Bucket, float Rate, float Burst, double Now);
+	FStats&								GetChannelStats(const FString& ChannelUrl);
+
+private:
+	ESBSendOverflowPolicy				Policy;
+	int32								MaxQueued;
+	float								ChannelRate;
+	float								ChannelBurst;
+	float								GlobalRate;
+	float								GlobalBurst;
+
+	FBucket								GlobalBucket;
+	TMap<FString, FBucket>				ChannelBuckets;
+
+	FStats								Totals;
+	TMap<FString, FStats>				ChannelStats;
+};
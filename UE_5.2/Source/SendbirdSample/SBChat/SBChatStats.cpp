@@ -0,0 +1,102 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#include "SBChatStats.h"
+#include "HAL/MemoryBase.h"
+#include "ProfilingDebugging/CountersTrace.h"
+
+UE_TRACE_CHANNEL_DEFINE(SBChatChannel);
+
+DEFINE_STAT(STAT_SBChat_HandlerMessageReceived);
+DEFINE_STAT(STAT_SBChat_HandlerMessageUpdated);
+DEFINE_STAT(STAT_SBChat_HandlerMessageDeleted);
+DEFINE_STAT(STAT_SBChat_HandlerReadReceiptUpdated);
+DEFINE_STAT(STAT_SBChat_HandlerUserJoined);
+DEFINE_STAT(STAT_SBChat_HandlerUserLeft);
+DEFINE_STAT(STAT_SBChat_HandlerUserEntered);
+DEFINE_STAT(STAT_SBChat_HandlerUserExited);
+DEFINE_STAT(STAT_SBChat_HandlerInvitationReceived);
+DEFINE_STAT(STAT_SBChat_HandlerChannelDeleted);
+
+DEFINE_STAT(STAT_SBChat_ApplyMessageReceived);
+DEFINE_STAT(STAT_SBChat_ApplyMessageUpdated);
+DEFINE_STAT(STAT_SBChat_ApplyMessageDeleted);
+DEFINE_STAT(STAT_SBChat_ApplyReadReceiptUpdated);
+DEFINE_STAT(STAT_SBChat_ApplyUserJoined);
+DEFINE_STAT(STAT_SBChat_ApplyUserLeft);
+DEFINE_STAT(STAT_SBChat_ApplyUserEntered);
+DEFINE_STAT(STAT_SBChat_ApplyUserExited);
+DEFINE_STAT(STAT_SBChat_ApplyChannelDeleted);
+DEFINE_STAT(STAT_SBChat_DispatchMessageReceived);
+DEFINE_STAT(STAT_SBChat_DispatchMessageUpdated);
+DEFINE_STAT(STAT_SBChat_DispatchMessageDeleted);
+DEFINE_STAT(STAT_SBChat_DispatchMessageSent);
+DEFINE_STAT(STAT_SBChat_DispatchUser);
+DEFINE_STAT(STAT_SBChat_DispatchInvitationReceived);
+DEFINE_STAT(STAT_SBChat_DispatchCompletion);
+
+DEFINE_STAT(STAT_SBChat_QueueDepth);
+DEFINE_STAT(STAT_SBChat_EventsDispatched);
+DEFINE_STAT(STAT_SBChat_Conversions);
+DEFINE_STAT(STAT_SBChat_ConversionBytes);
+DEFINE_STAT(STAT_SBChat_HistoryMessages);
+DEFINE_STAT(STAT_SBChat_HistoryMemory);
+DEFINE_STAT(STAT_SBChat_RequestsCompleted);
+DEFINE_STAT(STAT_SBChat_RequestLatency);
+
+TRACE_DECLARE_INT_COUNTER(SBChat_QueueDepth, TEXT("SBChat/QueueDepth"));
+TRACE_DECLARE_INT_COUNTER(SBChat_HistoryMessages, TEXT("SBChat/HistoryMessages"));
+TRACE_DECLARE_MEMORY_COUNTER(SBChat_HistoryMemory, TEXT("SBChat/HistoryMemory"));
+TRACE_DECLARE_INT_COUNTER(SBChat_Conversions, TEXT("SBChat/Conversions"));
+TRACE_DECLARE_FLOAT_COUNTER(SBChat_RequestLatency, TEXT("SBChat/RequestLatencyMs"));
+
+namespace SBChatStats
+{
+	void SampleFrame(int32 QueueDepth, int32 HistoryMessages, int64 HistoryMemory)
+	{
+		SET_DWORD_STAT(STAT_SBChat_QueueDepth, QueueDepth);
+		SET_DWORD_STAT(STAT_SBChat_HistoryMessages, HistoryMessages);
+		SET_MEMORY_STAT(STAT_SBChat_HistoryMemory, HistoryMemory);
+
+		TRACE_COUNTER_SET(SBChat_QueueDepth, QueueDepth);
+		TRACE_COUNTER_SET(SBChat_HistoryMessages, HistoryMessages);
+		TRACE_COUNTER_SET(SBChat_HistoryMemory, HistoryMemory);
+	}
+
+	void RecordConversion(int32 Length)
+	{
+		// Called from the handler threads as well; both stats and trace counters take that.
+		INC_DWORD_STAT(STAT_SBChat_Conversions);
+		INC_DWORD_STAT_BY(STAT_SBChat_ConversionBytes, (Length + 1) * sizeof(TCHAR));
+		TRACE_COUNTER_INCREMENT(SBChat_Conversions);
+	}
+
+	void RecordRequestLatency(double Seconds)
+	{
+		const float Milliseconds = (float)(Seconds * 1000.0);
+		INC_DWORD_STAT(STAT_SBChat_RequestsCompleted);
+		SET_FLOAT_STAT(STAT_SBChat_RequestLatency, Milliseconds);
+		TRACE_COUNTER_SET(SBChat_RequestLatency, Milliseconds);
+	}
+
+	bool GetAllocationCount(uint64& OutCount)
+	{
+		OutCount = 0;
+#if STATS
+		if (GMalloc == nullptr)
+			return false;
+
+		// The counters themselves are protected; the allocator reports them by name.
+		FGenericMemoryStats MemoryStats;
+		GMalloc->GetAllocatorStats(MemoryStats);
+		const SIZE_T* MallocCalls = MemoryStats.Data.Find(TEXT("Malloc calls"));
+		const SIZE_T* ReallocCalls = MemoryStats.Data.Find(TEXT("Realloc calls"));
+		if (MallocCalls == nullptr)
+			return false;
+
+		OutCount = (uint64)*MallocCalls + (ReallocCalls != nullptr ? (uint64)*ReallocCalls : 0);
+		return true;
+#else
+		return false;
+#endif
+	}
+}
@@ -0,0 +1,77 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+// "stat sbchat" shows where chat spends its time; the same scopes go to Unreal Insights on the SBChat channel
+// (-trace=cpu,counters,sbchat).
+// Handler scopes run on the SDK's threads and only cover handing the event over; Apply scopes are the handler's work
+// once it runs on the game thread, and dispatch scopes the calls into the UI.
+
+DECLARE_STATS_GROUP(TEXT("SBChat"), STATGROUP_SBChat, STATCAT_Advanced);
+
+UE_TRACE_CHANNEL_EXTERN(SBChatChannel);
+
+//+ SDK threads
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Handler MessageReceived"), STAT_SBChat_HandlerMessageReceived, STATGROUP_SBChat, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Handler MessageUpdated"), STAT_SBChat_HandlerMessageUpdated, STATGROUP_SBChat, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Handler MessageDeleted"), STAT_SBChat_HandlerMessageDeleted, STATGROUP_SBChat, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Handler ReadReceiptUpdated"), STAT_SBChat_HandlerReadReceiptUpdated, STATGROUP_SBChat, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Handler UserJoined"), STAT_SBChat_HandlerUserJoined, STATGROUP_SBChat, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Handler UserLeft"), STAT_SBChat_HandlerUserLeft, STATGROUP_SBChat, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Handler UserEntered"), STAT_SBChat_HandlerUserEntered, STATGROUP_SBChat, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Handler UserExited"), STAT_SBChat_HandlerUserExited, STATGROUP_SBChat, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Handler InvitationReceived"), STAT_SBChat_HandlerInvitationReceived, STATGROUP_SBChat, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Handler ChannelDeleted"), STAT_SBChat_HandlerChannelDeleted, STATGROUP_SBChat, );
+//- SDK threads
+
+//+ Game thread
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply MessageReceived"), STAT_SBChat_ApplyMessageReceived, STATGROUP_SBChat, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply MessageUpdated"), STAT_SBChat_ApplyMessageUpdated, STATGROUP_SBChat, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply MessageDeleted"), STAT_SBChat_ApplyMessageDeleted, STATGROUP_SBChat, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply ReadReceiptUpdated"), STAT_SBChat_ApplyReadReceiptUpdated, STATGROUP_SBChat, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply UserJoined"), STAT_SBChat_ApplyUserJoined, STATGROUP_SBChat, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply UserLeft"), STAT_SBChat_ApplyUserLeft, STATGROUP_SBChat, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply UserEntered"), STAT_SBChat_ApplyUserEntered, STATGROUP_SBChat, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply UserExited"), STAT_SBChat_ApplyUserExited, STATGROUP_SBChat, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply ChannelDeleted"), STAT_SBChat_ApplyChannelDeleted, STATGROUP_SBChat, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Dispatch OnMessageReceived"), STAT_SBChat_DispatchMessageReceived, STATGROUP_SBChat, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Dispatch OnMessageUpdated"), STAT_SBChat_DispatchMessageUpdated, STATGROUP_SBChat, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Dispatch OnMessageDeleted"), STAT_SBChat_DispatchMessageDeleted, STATGROUP_SBChat, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Dispatch OnMessageSent"), STAT_SBChat_DispatchMessageSent, STATGROUP_SBChat, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Dispatch OnUser"), STAT_SBChat_DispatchUser, STATGROUP_SBChat, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Dispatch OnInvitationReceived"), STAT_SBChat_DispatchInvitationReceived, STATGROUP_SBChat, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Dispatch Completion"), STAT_SBChat_DispatchCompletion, STATGROUP_SBChat, );
+//- Game thread
+
+//+ Counters
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Event queue depth"), STAT_SBChat_QueueDepth, STATGROUP_SBChat, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Events dispatched"), STAT_SBChat_EventsDispatched, STATGROUP_SBChat, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("String conversions"), STAT_SBChat_Conversions, STATGROUP_SBChat, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("String conversion bytes"), STAT_SBChat_ConversionBytes, STATGROUP_SBChat, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("History messages"), STAT_SBChat_HistoryMessages, STATGROUP_SBChat, );
+DECLARE_MEMORY_STAT_EXTERN(TEXT("History memory"), STAT_SBChat_HistoryMemory, STATGROUP_SBChat, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Requests completed"), STAT_SBChat_RequestsCompleted, STATGROUP_SBChat, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Request latency (ms)"), STAT_SBChat_RequestLatency, STATGROUP_SBChat, );
+//- Counters
+
+// A stat scope that also shows up in Insights under the SBChat channel.
+#define SBCHAT_SCOPE_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Stat, SBChatChannel)
+
+namespace SBChatStats
+{
+	// Once per frame on the game thread, from the event queue's tick after it drained the queue.
+	void								SampleFrame(int32 QueueDepth, int32 HistoryMessages, int64 HistoryMemory);
+	void								RecordConversion(int32 Length);
+	// Seconds from the USBChat action being created until the SDK called back.
+	void								RecordRequestLatency(double Seconds);
+	// Malloc and Realloc calls on every thread so far, from GMalloc's allocator stats. False where the allocator
+	// doesn't count them, which includes every build without STATS.
+	bool								GetAllocationCount(uint64& OutCount);
+}
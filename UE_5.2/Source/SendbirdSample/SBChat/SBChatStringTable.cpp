@@ -0,0 +1,92 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#include "SBChatStringTable.h"
+#include "Misc/Crc.h"
+#include "Sendbird/SendbirdTranscode.h"
+#include "SBChatStats.h"
+
+SBChatStringTable& SBChatStringTable::Get()
+{
+	static SBChatStringTable StringTable;
+	return StringTable;
+}
+
+SBChatStringTable::SBChatStringTable()
+{
+	HitCount = 0;
+	MissCount = 0;
+}
+
+FString SBChatStringTable::Convert(const std::wstring& Source)
+{
+	SBChatStats::RecordConversion((int32)Source.size());
+	return SendbirdTranscode::ToFString(Source);
+}
+
+FSBChatStringRef SBChatStringTable::Intern(const std::wstring& Source)
+{
+	static const FSBChatStringRef EmptyString = MakeShared<FString, ESPMode::ThreadSafe>();
+	if (Source.empty())
+		return EmptyString;
+
+	const uint32 SourceHash = Hash(Source);
+	{
+		FReadScopeLock ReadLock(Lock);
+		if (const FEntry* Entry = FindEntry(SourceHash, Source))
+		{
+			++HitCount;
+			return Entry->Value;
+		}
+	}
+
+	FSBChatStringRef Value = MakeShared<FString, ESPMode::ThreadSafe>(Convert(Source));
+	++MissCount;
+
+	FWriteScopeLock WriteLock(Lock);
+	if (const FEntry* Entry = FindEntry(SourceHash, Source))
+		return Entry->Value;
+
+	// Handed-out references keep their strings alive, so the table can simply start over when it gets too large.
+	if (Entries.Num() >= MAX_ENTRIES)
+	{
+		Entries.Reset();
+		IndexByHash.Reset();
+	}
+
+	IndexByHash.Add(SourceHash, Entries.Num());
+	Entries.Add({ Source, Value });
+	return Value;
+}
+
+void SBChatStringTable::Reset()
+{
+	FWriteScopeLock WriteLock(Lock);
+	Entries.Empty();
+	IndexByHash.Empty();
+	HitCount = 0;
+	MissCount = 0;
+}
+
+int32 SBChatStringTable::Num() const
+{
+	FReadScopeLock ReadLock(Lock);
+	return Entries.Num();
+}
+
+//+ private
+uint32 SBChatStringTable::Hash(const std::wstring& Source)
+{
+	return FCrc::MemCrc32(Source.data(), (int32)(Source.size() * sizeof(wchar_t)));
+}
+
+const SBChatStringTable::FEntry* SBChatStringTable::FindEntry(uint32 SourceHash, const std::wstring& Source) const
+{
+	for (auto It = IndexByHash.CreateConstKeyIterator(SourceHash); It; ++It)
+	{
+		const FEntry& Entry = Entries[It.Value()];
+		if (Entry.Source == Source)
+			return &Entry;
+	}
+	return nullptr;
+}
+//- private
@@ -0,0 +1,49 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <string>
+
+// A string the table shares; it stays valid after the table drops it.
+using FSBChatStringRef = TSharedRef<const FString, ESPMode::ThreadSafe>;
+
+// Converts the SDK's std::wstring values into FString.
+// Values that repeat a lot (user ids, nicknames, profile urls, channel urls) go through Intern(), which converts each
+// distinct value once and hands out a shared reference to it. Lookups and comparisons then work on the shared string
+// without allocating. Interning is for internal keys only: a Blueprint-facing struct's UPROPERTY FString owns its
+// buffer and can't share the table's, so the structs use Convert() and skip the lookup.
+class SBChatStringTable
+{
+public:
+	static const int32 MAX_ENTRIES = 16384;
+
+	static SBChatStringTable& Get();
+	static FString				Convert(const std::wstring& Source);
+
+	FSBChatStringRef			Intern(const std::wstring& Source);
+	void						Reset();
+
+	int32						Num() const;
+	int64						GetHitCount() const { return HitCount; }
+	int64						GetMissCount() const { return MissCount; }
+
+private:
+	SBChatStringTable();
+
+	struct FEntry
+	{
+		std::wstring			Source;
+		FSBChatStringRef		Value;
+	};
+
+	static uint32				Hash(const std::wstring& Source);
+	const FEntry*				FindEntry(uint32 SourceHash, const std::wstring& Source) const;
+
+private:
+	mutable FRWLock				Lock;
+	TMultiMap<uint32, int32>	IndexByHash;
+	TArray<FEntry>				Entries;
+	TAtomic<int64>				HitCount;
+	TAtomic<int64>				MissCount;
+};
@@ -0,0 +1,110 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#include "SBChatSubscriptions.h"
+#include "SBChatStringTable.h"
+
+SBChatSubscriptions::SBChatSubscriptions()
+{
+	MaxChannels = DEFAULT_MAX_CHANNELS;
+	HistoryMemoryBudget = SBChatHistoryStore::DEFAULT_MEMORY_BUDGET;
+}
+
+void SBChatSubscriptions::Reset()
+{
+	FScopeLock ScopeLock(&Lock);
+	States.Empty();
+	Order.Empty();
+}
+
+int32 SBChatSubscriptions::Num() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return States.Num();
+}
+
+void SBChatSubscriptions::SetHistoryMemoryBudget(int64 InMemoryBudget)
+{
+	FScopeLock ScopeLock(&Lock);
+	HistoryMemoryBudget = InMemoryBudget;
+	for (TPair<FString, TUniquePtr<FState>>& Pair : States)
+		Pair.Value->History.SetMemoryBudget(HistoryMemoryBudget);
+}
+
+SBChatSubscriptions::FState* SBChatSubscriptions::Subscribe(SBDBaseChannel* Channel)
+{
+#if WITH_SENDBIRD
+	if (!ensure(Channel))
+		return nullptr;
+
+	const FSBChatStringRef ChannelUrlRef = SBChatStringTable::Get().Intern(Channel->channel_url);
+	const FString& ChannelUrl = *ChannelUrlRef;
+	FScopeLock ScopeLock(&Lock);
+	if (TUniquePtr<FState>* Existing = States.Find(ChannelUrl))
+	{
+		(*Existing)->Channel = Channel;
+		return Existing->Get();
+	}
+
+	if (States.Num() >= MaxChannels)
+		return nullptr;
+
+	TUniquePtr<FState>& State = States.Add(ChannelUrl, MakeUnique<FState>());
+	State->Channel = Channel;
+	State->History.SetMemoryBudget(HistoryMemoryBudget);
+	if (Channel->is_group_channel)
+	{
+		SBDGroupChannel* GroupChannel = static_cast<SBDGroupChannel*>(Channel);
+		State->UnreadCount = (int32)GroupChannel->unread_message_count;
+		for (const SBDMember& Member : GroupChannel->members)
+			State->Members.Add(Member);
+	}
+
+	Order.Add(ChannelUrl);
+	return State.Get();
+#else
+	return nullptr;
+#endif
+}
+
+bool SBChatSubscriptions::Unsubscribe(const FString& ChannelUrl)
+{
+	FScopeLock ScopeLock(&Lock);
+	if (States.Remove(ChannelUrl) == 0)
+		return false;
+
+	Order.Remove(ChannelUrl);
+	return true;
+}
+
+SBChatSubscriptions::FState* SBChatSubscriptions::Find(SBDBaseChannel* Channel) const
+{
+	FScopeLock ScopeLock(&Lock);
+	return FindLocked(Channel);
+}
+
+SBChatSubscriptions::FState* SBChatSubscriptions::Find(const FString& ChannelUrl) const
+{
+	FScopeLock ScopeLock(&Lock);
+	const TUniquePtr<FState>* State = States.Find(ChannelUrl);
+	return State != nullptr ? State->Get() : nullptr;
+}
+
+//+ private
+SBChatSubscriptions::FState* SBChatSubscriptions::FindLocked(SBDBaseChannel* Channel) const
+{
+#if WITH_SENDBIRD
+	if (Channel == nullptr || States.Num() == 0)
+		return nullptr;
+
+	const TUniquePtr<FState>* State = States.Find(*SBChatStringTable::Get().Intern(Channel->channel_url));
+	if (State == nullptr)
+		return nullptr;
+
+	// The SDK can hand out a new object for the same channel.
+	(*State)->Channel = Channel;
+	return State->Get();
+#else
+	return nullptr;
+#endif
+}
+//- private
@@ -0,0 +1,74 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Sendbird/include/Sendbird.h"
+#include "SBChatHistoryStore.h"
+#include "SBChatUserDirectory.h"
+
+// Channels the sample keeps live state for while they are not focused: history, members and unread count.
+// The channel handler updates every subscribed channel, so focusing one of them is served from memory instead of
+// re-entering the channel and reloading its history.
+// States are keyed by channel_url and live until unsubscribed, so a state pointer stays valid while it is subscribed.
+// States are game-thread state: subscribing, unsubscribing and the pointers Find() returns are only used there.
+class SBChatSubscriptions
+{
+public:
+	static const int32 DEFAULT_MAX_CHANNELS = 8;
+
+	struct FState
+	{
+		SBDBaseChannel*					Channel = nullptr;
+		SBChatHistoryStore				History;
+		SBChatUserDirectory				Members;
+		int32							UnreadCount = 0;
+		bool							bHistoryLoaded = false;
+	};
+
+	SBChatSubscriptions();
+
+	void								Reset();
+	void								SetMaxChannels(int32 InMaxChannels) { MaxChannels = FMath::Max(InMaxChannels, 1); }
+	int32								GetMaxChannels() const { return MaxChannels; }
+	int32								Num() const;
+	// Applied to every subscribed history and to the ones subscribed later.
+	void								SetHistoryMemoryBudget(int64 InMemoryBudget);
+
+	// Returns nullptr when the limit is reached. Subscribing twice returns the existing state.
+	FState*								Subscribe(SBDBaseChannel* Channel);
+	bool								Unsubscribe(const FString& ChannelUrl);
+	FState*								Find(SBDBaseChannel* Channel) const;
+	FState*								Find(const FString& ChannelUrl) const;
+
+	// Runs Func under the subscription lock when the channel is subscribed.
+	template<typename FuncType>
+	bool								Update(SBDBaseChannel* Channel, FuncType Func)
+	{
+		FScopeLock ScopeLock(&Lock);
+		FState* State = FindLocked(Channel);
+		if (State == nullptr)
+			return false;
+
+		Func(*State);
+		return true;
+	}
+
+	template<typename FuncType>
+	void								ForEach(FuncType Func) const
+	{
+		FScopeLock ScopeLock(&Lock);
+		for (const FString& ChannelUrl : Order)
+			Func(*States.FindChecked(ChannelUrl));
+	}
+
+private:
+	FState*								FindLocked(SBDBaseChannel* Channel) const;
+
+private:
+	mutable FCriticalSection			Lock;
+	TMap<FString, TUniquePtr<FState>>	States;
+	TArray<FString>						Order;
+	int32								MaxChannels;
+	int64								HistoryMemoryBudget;
+};
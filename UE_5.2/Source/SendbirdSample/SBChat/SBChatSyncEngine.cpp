@@ -0,0 +1,133 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#include "SBChatSyncEngine.h"
+#include "SBChatStringTable.h"
+#include "../SendbirdSample.h"
+
+SBChatSyncEngine::SBChatSyncEngine()
+{
+	FetchedPageCount = 0;
+	FetchedMessageCount = 0;
+}
+
+void SBChatSyncEngine::Reset()
+{
+	// Pages in flight find their channel gone and stop.
+	FScopeLock ScopeLock(&Lock);
+	Channels.Empty();
+}
+
+void SBChatSyncEngine::Forget(const FString& ChannelUrl)
+{
+	FScopeLock ScopeLock(&Lock);
+	Channels.Remove(ChannelUrl);
+}
+
+void SBChatSyncEngine::Observe(SBDBaseMessage* Message)
+{
+#if WITH_SENDBIRD
+	if (Message == nullptr)
+		return;
+
+	const FSBChatStringRef ChannelUrlRef = SBChatStringTable::Get().Intern(Message->channel_url);
+	const FString& ChannelUrl = *ChannelUrlRef;
+	FScopeLock ScopeLock(&Lock);
+	FWatermark& Watermark = Channels.FindOrAdd(ChannelUrl).Watermark;
+	Watermark.NewestCreatedAt = FMath::Max(Watermark.NewestCreatedAt, Message->created_at);
+#endif
+}
+
+bool SBChatSyncEngine::GetWatermark(const FString& ChannelUrl, FWatermark& OutWatermark) const
+{
+	FScopeLock ScopeLock(&Lock);
+	const FChannelSync* ChannelSync = Channels.Find(ChannelUrl);
+	if (ChannelSync == nullptr || ChannelSync->Watermark.NewestCreatedAt == 0)
+		return false;
+
+	OutWatermark = ChannelSync->Watermark;
+	return true;
+}
+
+void SBChatSyncEngine::Sync(SBDBaseChannel* Channel, int64 FromTime, FHeldMessages Held, FPageHandler OnPage)
+{
+#if WITH_SENDBIRD
+	if (!ensure(Channel) || !ensure(OnPage))
+		return;
+
+	const FSBChatStringRef ChannelUrlRef = SBChatStringTable::Get().Intern(Channel->channel_url);
+	const FString& ChannelUrl = *ChannelUrlRef;
+	uint32 Generation = 0;
+	{
+		FScopeLock ScopeLock(&Lock);
+		FChannelSync& ChannelSync = Channels.FindOrAdd(ChannelUrl);
+		Generation = ++ChannelSync.Generation;
+		ChannelSync.bRunning = true;
+	}
+
+	RequestPage(Channel, ChannelUrl, Generation, FromTime, MakeShared<const FHeldMessages, ESPMode::ThreadSafe>(MoveTemp(Held)), MoveTemp(OnPage));
+#endif
+}
+
+bool SBChatSyncEngine::IsSyncing(const FString& ChannelUrl) const
+{
+	FScopeLock ScopeLock(&Lock);
+	const FChannelSync* ChannelSync = Channels.Find(ChannelUrl);
+	return ChannelSync != nullptr && ChannelSync->bRunning;
+}
+
+//+ private
+void SBChatSyncEngine::RequestPage(SBDBaseChannel* Channel, const FString& ChannelUrl, uint32 Generation, int64 FromTime,
+	TSharedRef<const FHeldMessages, ESPMode::ThreadSafe> Held, FPageHandler OnPage)
+{
+#if WITH_SENDBIRD
+	Channel->GetNextMessagesByTimestamp(FromTime, PAGE_LIMIT, false, SBDMessageTypeFilter::All, SBD_NULL_WSTRING,
+		[this, Channel, ChannelUrl, Generation, FromTime, Held, OnPage](const std::vector<SBDBaseMessage*>& Messages, SBDError* Error) {
+		if (!IsCurrent(ChannelUrl, Generation))
+			return;
+
+		// The watermark only moves with applied pages, so the next sync resumes from here.
+		if (Error != nullptr)
+		{
+			UE_LOG(SendbirdSample, Warning, TEXT("[SBChatSyncEngine::RequestPage] Channel(%s) ErrorCode(%d)"), *ChannelUrl, (int32)Error->code);
+			Finish(ChannelUrl, Generation);
+			return;
+		}
+
+		int64 PageEnd = FromTime;
+		for (SBDBaseMessage* Message : Messages)
+			PageEnd = FMath::Max(PageEnd, Message->created_at);
+
+		++FetchedPageCount;
+		FetchedMessageCount += (int64)Messages.size();
+
+		// A full page may cut a run of messages sharing the last timestamp, so that timestamp is read again with the next page.
+		const bool bCaughtUp = (int32)Messages.size() < PAGE_LIMIT;
+		const int64 NextFromTime = PageEnd - 1 > FromTime ? PageEnd - 1 : PageEnd;
+		OnPage(Channel, *Held, Messages, FromTime + 1, bCaughtUp ? MAX_int64 : NextFromTime);
+
+		if (bCaughtUp || NextFromTime <= FromTime)
+		{
+			Finish(ChannelUrl, Generation);
+			return;
+		}
+
+		RequestPage(Channel, ChannelUrl, Generation, NextFromTime, Held, OnPage);
+	});
+#endif
+}
+
+bool SBChatSyncEngine::IsCurrent(const FString& ChannelUrl, uint32 Generation) const
+{
+	FScopeLock ScopeLock(&Lock);
+	const FChannelSync* ChannelSync = Channels.Find(ChannelUrl);
+	return ChannelSync != nullptr && ChannelSync->Generation == Generation;
+}
+
+void SBChatSyncEngine::Finish(const FString& ChannelUrl, uint32 Generation)
+{
+	FScopeLock ScopeLock(&Lock);
+	FChannelSync* ChannelSync = Channels.Find(ChannelUrl);
+	if (ChannelSync != nullptr && ChannelSync->Generation == Generation)
+		ChannelSync->bRunning = false;
+}
+//- private
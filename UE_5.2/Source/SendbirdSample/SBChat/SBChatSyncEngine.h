@@ -0,0 +1,69 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Sendbird/include/Sendbird.h"
+
+// Brings channel history up to date without reloading it: remembers the newest created_at seen per channel and pages
+// GetNextMessagesByTimestamp from a point in time until a short page says the channel is caught up.
+// The SDK has no change log, so updates and deletes are found by re-reading the window the caller already holds along
+// with the gap. Each page goes to the caller with the time span it covers; a held message in that span that the page
+// does not return was deleted. Edits and deletes of messages older than that window are not synced; they show up the
+// next time the history is loaded.
+class SBChatSyncEngine
+{
+public:
+	static const int32 PAGE_LIMIT = 100;
+
+	struct FHeldMessage
+	{
+		int64							CreatedAt = 0;
+		int64							UpdatedAt = 0;
+	};
+	using FHeldMessages = TMap<uint64, FHeldMessage>;
+
+	struct FWatermark
+	{
+		int64							NewestCreatedAt = 0;
+	};
+
+	// Called on the SDK thread for every page, oldest page first.
+	using FPageHandler = TFunction<void(SBDBaseChannel* Channel, const FHeldMessages& Held, const std::vector<SBDBaseMessage*>& Messages,
+		int64 WindowStart, int64 WindowEnd)>;
+
+	SBChatSyncEngine();
+
+	void								Reset();
+	void								Forget(const FString& ChannelUrl);
+
+	// Advances the watermark of the message's channel.
+	void								Observe(SBDBaseMessage* Message);
+	bool								GetWatermark(const FString& ChannelUrl, FWatermark& OutWatermark) const;
+
+	// Fetches every message created after FromTime. Syncing a channel again supersedes the sync in flight.
+	void								Sync(SBDBaseChannel* Channel, int64 FromTime, FHeldMessages Held, FPageHandler OnPage);
+	bool								IsSyncing(const FString& ChannelUrl) const;
+
+	int64								GetFetchedPageCount() const { return FetchedPageCount; }
+	int64								GetFetchedMessageCount() const { return FetchedMessageCount; }
+
+private:
+	struct FChannelSync
+	{
+		FWatermark						Watermark;
+		uint32							Generation = 0;
+		bool							bRunning = false;
+	};
+
+	void								RequestPage(SBDBaseChannel* Channel, const FString& ChannelUrl, uint32 Generation, int64 FromTime,
+											TSharedRef<const FHeldMessages, ESPMode::ThreadSafe> Held, FPageHandler OnPage);
+	bool								IsCurrent(const FString& ChannelUrl, uint32 Generation) const;
+	void								Finish(const FString& ChannelUrl, uint32 Generation);
+
+private:
+	mutable FCriticalSection			Lock;
+	TMap<FString, FChannelSync>			Channels;
+	TAtomic<int64>						FetchedPageCount;
+	TAtomic<int64>						FetchedMessageCount;
+};
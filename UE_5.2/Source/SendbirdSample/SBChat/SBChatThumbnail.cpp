@@ -0,0 +1,92 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#include "SBChatThumbnail.h"
+#include "ImageUtils.h"
+
+namespace
+{
+	// Odd last rows and columns are dropped; at thumbnail sizes nobody sees the missing half pixel.
+	void HalveImage(TArray<FColor>& InOutPixels, int32& InOutWidth, int32& InOutHeight)
+	{
+		const int32 Width = InOutWidth;
+		const int32 HalfWidth = InOutWidth / 2;
+		const int32 HalfHeight = InOutHeight / 2;
+
+		TArray<FColor> Half;
+		Half.SetNumUninitialized(HalfWidth * HalfHeight);
+
+		// VectorStoreByte4 truncates, so half a step is added to round to the nearest.
+		const VectorRegister4Float Quarter = VectorSetFloat1(0.25f);
+		const VectorRegister4Float Rounding = VectorSetFloat1(0.5f);
+		for (int32 Y = 0; Y < HalfHeight; ++Y)
+		{
+			const FColor* Row0 = InOutPixels.GetData() + (Y * 2) * Width;
+			const FColor* Row1 = Row0 + Width;
+			FColor* Dst = Half.GetData() + Y * HalfWidth;
+			for (int32 X = 0; X < HalfWidth; ++X)
+			{
+				const VectorRegister4Float Top = VectorAdd(VectorLoadByte4(Row0 + X * 2), VectorLoadByte4(Row0 + X * 2 + 1));
+				const VectorRegister4Float Bottom = VectorAdd(VectorLoadByte4(Row1 + X * 2), VectorLoadByte4(Row1 + X * 2 + 1));
+				VectorStoreByte4(VectorMultiplyAdd(VectorAdd(Top, Bottom), Quarter, Rounding), Dst + X);
+			}
+		}
+
+		InOutPixels = MoveTemp(Half);
+		InOutWidth = HalfWidth;
+		InOutHeight = HalfHeight;
+	}
+}
+
+FIntPoint SBChatThumbnail::FitWithin(int32 Width, int32 Height, int32 MaxWidth, int32 MaxHeight)
+{
+	if (Width <= 0 || Height <= 0)
+		return FIntPoint::ZeroValue;
+
+	const float Scale = FMath::Min3(1.0f, (float)MaxWidth / (float)Width, (float)MaxHeight / (float)Height);
+	return FIntPoint(FMath::Max(1, FMath::RoundToInt(Width * Scale)), FMath::Max(1, FMath::RoundToInt(Height * Scale)));
+}
+
+void SBChatThumbnail::Resize(TArrayView<const FColor> SrcPixels, int32 SrcWidth, int32 SrcHeight, int32 DstWidth, int32 DstHeight, TArray<FColor>& OutPixels)
+{
+	if (SrcWidth == DstWidth && SrcHeight == DstHeight)
+	{
+		OutPixels = TArray<FColor>(SrcPixels);
+		return;
+	}
+
+	TArray<FColor> Pixels(SrcPixels);
+	int32 Width = SrcWidth;
+	int32 Height = SrcHeight;
+	while (Width >= DstWidth * 2 && Height >= DstHeight * 2)
+		HalveImage(Pixels, Width, Height);
+
+	if (Width == DstWidth && Height == DstHeight)
+		OutPixels = MoveTemp(Pixels);
+	else
+		FImageUtils::ImageResize(Width, Height, Pixels, DstWidth, DstHeight, OutPixels, false);
+}
+
+const FSBThumbnailInfo* SBChatThumbnail::PickBest(const FSBFileInfo& FileInfo, int32 Width, int32 Height)
+{
+	const FSBThumbnailInfo* Best = nullptr;
+	bool bBestCovers = false;
+	for (const FSBThumbnailInfo& Thumbnail : FileInfo.Thumbnails)
+	{
+		if (Thumbnail.Url.IsEmpty())
+			continue;
+
+		// Drawn to fit the widget, a thumbnail only has to reach one of its sides to never be scaled up.
+		const bool bCovers = Thumbnail.RealWidth >= Width || Thumbnail.RealHeight >= Height;
+		const int64 Area = Thumbnail.RealWidth * Thumbnail.RealHeight;
+		const int64 BestArea = Best != nullptr ? Best->RealWidth * Best->RealHeight : 0;
+		if (Best == nullptr
+			|| (bCovers && !bBestCovers)
+			|| (bCovers && bBestCovers && Area < BestArea)
+			|| (!bCovers && !bBestCovers && Area > BestArea))
+		{
+			Best = &Thumbnail;
+			bBestCovers = bCovers;
+		}
+	}
+	return Best;
+}
@@ -0,0 +1,25 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SBChatCommonStruct.h"
+
+// Image file messages are shown through their thumbnails: the sender asks the server for a few sizes, and a list picks
+// the smallest one that still covers the widget, so scrolling never downloads or decodes a full-size image.
+namespace SBChatThumbnail
+{
+	// Thumbnails are decoded no larger than this; a widget asking for more gets a scaled-up texture.
+	static const int32 MAX_DIMENSION	= 512;
+
+	// Size of a Width x Height image scaled to fit in MaxWidth x MaxHeight, aspect kept; images are never scaled up.
+	FIntPoint							FitWithin(int32 Width, int32 Height, int32 MaxWidth, int32 MaxHeight);
+
+	// Halves the image with a 2x2 box filter, four channels at a time in a vector register, while it is at least twice
+	// the destination size; ImageResize only does the last, less than 2x, step. Call it off the game thread.
+	void								Resize(TArrayView<const FColor> SrcPixels, int32 SrcWidth, int32 SrcHeight, int32 DstWidth, int32 DstHeight, TArray<FColor>& OutPixels);
+
+	// The smallest thumbnail whose real size covers Width or Height, the largest one when none does, nullptr when the
+	// file has none.
+	const FSBThumbnailInfo*				PickBest(const FSBFileInfo& FileInfo, int32 Width, int32 Height);
+}
@@ -0,0 +1,258 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#include "SBChatUnreadCounter.h"
+#include "SBChatManager.h"
+#include "SBChatChannelEvent.h"
+#include "SBChatStringTable.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/OutputDeviceRedirector.h"
+
+SBChatUnreadCounter::SBChatUnreadCounter()
+{
+	TotalCount = 0;
+	bServerTotals = false;
+	bDirty = false;
+	ChangeCount = 0;
+	PushCount = 0;
+}
+
+SBChatUnreadCounter::~SBChatUnreadCounter()
+{
+	Reset();
+}
+
+void SBChatUnreadCounter::Start()
+{
+#if WITH_SENDBIRD
+	SBDMain::AddUserEventHandler(L"SBChatUnreadCounter", this);
+#endif
+
+	FScopeLock ScopeLock(&Lock);
+	if (!TickerHandle.IsValid())
+		TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &SBChatUnreadCounter::Tick));
+}
+
+void SBChatUnreadCounter::Reset()
+{
+	FScopeLock ScopeLock(&Lock);
+
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+
+	ChannelCounts.Empty();
+	TotalCount = 0;
+	CountByCustomType.Empty();
+	bServerTotals = false;
+	ChangedChannels.Empty();
+	bDirty = false;
+	ChangeCount = 0;
+	PushCount = 0;
+}
+
+void SBChatUnreadCounter::Observe(SBDGroupChannel* Channel)
+{
+#if WITH_SENDBIRD
+	if (!ensure(Channel))
+		return;
+
+	FScopeLock ScopeLock(&Lock);
+
+	const int32 Count = (int32)Channel->unread_message_count;
+	SetCount(*SBChatStringTable::Get().Intern(Channel->channel_url), *SBChatStringTable::Get().Intern(Channel->custom_type), Count,
+		bServerTotals ? Count : 0);
+#endif
+}
+
+void SBChatUnreadCounter::OnMessageReceived(SBDGroupChannel* Channel, bool bSentByCurrentUser)
+{
+#if WITH_SENDBIRD
+	FScopeLock ScopeLock(&Lock);
+
+	const FSBChatStringRef ChannelUrlRef = SBChatStringTable::Get().Intern(Channel->channel_url);
+	const FString& ChannelUrl = *ChannelUrlRef;
+	const FSBChatStringRef CustomTypeRef = SBChatStringTable::Get().Intern(Channel->custom_type);
+	const FString& CustomType = *CustomTypeRef;
+	const int32 SDKCount = (int32)Channel->unread_message_count;
+
+	// Sending from another device means the user has read the channel there.
+	if (bSentByCurrentUser)
+	{
+		SetCount(ChannelUrl, CustomType, 0, bServerTotals ? SDKCount : 0);
+		return;
+	}
+
+	// The SDK may or may not have counted the message already; the larger of the two is right either way.
+	const FChannelCount* Known = ChannelCounts.Find(ChannelUrl);
+	const int32 NewCount = FMath::Max(Known != nullptr ? Known->Count + 1 : 1, SDKCount);
+	SetCount(ChannelUrl, CustomType, NewCount, bServerTotals ? NewCount - 1 : 0);
+#endif
+}
+
+void SBChatUnreadCounter::OnReadReceiptUpdated(SBDGroupChannel* Channel)
+{
+#if WITH_SENDBIRD
+	FScopeLock ScopeLock(&Lock);
+
+	// Receipts come for every member's reads; only the SDK's count tells whether the user's own went down.
+	const FSBChatStringRef ChannelUrlRef = SBChatStringTable::Get().Intern(Channel->channel_url);
+	const FString& ChannelUrl = *ChannelUrlRef;
+	const int32 SDKCount = (int32)Channel->unread_message_count;
+	const FChannelCount* Known = ChannelCounts.Find(ChannelUrl);
+	if (Known == nullptr || SDKCount < Known->Count)
+		SetCount(ChannelUrl, *SBChatStringTable::Get().Intern(Channel->custom_type), SDKCount, bServerTotals ? SDKCount : 0);
+#endif
+}
+
+void SBChatUnreadCounter::MarkRead(SBDGroupChannel* Channel)
+{
+#if WITH_SENDBIRD
+	FScopeLock ScopeLock(&Lock);
+
+	SetCount(*SBChatStringTable::Get().Intern(Channel->channel_url), *SBChatStringTable::Get().Intern(Channel->custom_type), 0,
+		bServerTotals ? (int32)Channel->unread_message_count : 0);
+#endif
+}
+
+void SBChatUnreadCounter::RemoveChannel(const FString& ChannelUrl)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	const FChannelCount* Known = ChannelCounts.Find(ChannelUrl);
+	if (Known == nullptr)
+		return;
+
+	// A channel that is gone takes its unread messages out of the totals.
+	SetCount(ChannelUrl, FString(Known->CustomType), 0, 0);
+	ChannelCounts.Remove(ChannelUrl);
+}
+
+int32 SBChatUnreadCounter::GetChannelCount(const FString& ChannelUrl) const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	const FChannelCount* Known = ChannelCounts.Find(ChannelUrl);
+	return Known != nullptr ? Known->Count : 0;
+}
+
+void SBChatUnreadCounter::GetCounts(FSBUnreadCounts& OutCounts) const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	OutCounts.TotalCount = TotalCount;
+	OutCounts.CountByCustomType = CountByCustomType;
+	OutCounts.ChannelCounts.Empty(ChannelCounts.Num());
+	for (const TPair<FString, FChannelCount>& Pair : ChannelCounts)
+		OutCounts.ChannelCounts.Add(Pair.Key, Pair.Value.Count);
+}
+
+void SBChatUnreadCounter::Report(FOutputDevice& Ar) const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	Ar.Logf(TEXT("total %d (%s), %d channels, %lld changes pushed as %lld updates"), TotalCount,
+		bServerTotals ? TEXT("server") : TEXT("local"), ChannelCounts.Num(), ChangeCount, PushCount);
+
+	for (const TPair<FString, int32>& Pair : CountByCustomType)
+		Ar.Logf(TEXT("  custom type %-32s %8d"), Pair.Key.IsEmpty() ? TEXT("(none)") : *Pair.Key, Pair.Value);
+
+	for (const TPair<FString, FChannelCount>& Pair : ChannelCounts)
+	{
+		if (Pair.Value.Count > 0)
+			Ar.Logf(TEXT("  channel %-48s %8d"), *Pair.Key, Pair.Value.Count);
+	}
+}
+
+//+ SBDUserEventHandler
+void SBChatUnreadCounter::TotalUnreadMessageCountChanged(int total_count, std::map<std::wstring, int> total_count_by_custom_type)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	TotalCount = FMath::Max(total_count, 0);
+	CountByCustomType.Reset();
+	for (const std::pair<const std::wstring, int>& Pair : total_count_by_custom_type)
+		CountByCustomType.Add(*SBChatStringTable::Get().Intern(Pair.first), FMath::Max(Pair.second, 0));
+
+	bServerTotals = true;
+	bDirty = true;
+	++ChangeCount;
+}
+//- SBDUserEventHandler
+
+//+ private
+bool SBChatUnreadCounter::Tick(float DeltaTime)
+{
+	FSBUnreadCounts Counts;
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (!bDirty)
+			return true;
+
+		bDirty = false;
+		++PushCount;
+
+		Counts.TotalCount = TotalCount;
+		Counts.CountByCustomType = CountByCustomType;
+		for (const FString& ChannelUrl : ChangedChannels)
+		{
+			const FChannelCount* Known = ChannelCounts.Find(ChannelUrl);
+			Counts.ChannelCounts.Add(ChannelUrl, Known != nullptr ? Known->Count : 0);
+		}
+		ChangedChannels.Reset();
+	}
+
+	TWeakObjectPtr<UObject> ChannelEvent = SBChatManager::Get().GetChannelEvent();
+	if (ChannelEvent.IsValid() && ensure(ChannelEvent->GetClass()->ImplementsInterface(USBChatChannelEvent::StaticClass())))
+		ISBChatChannelEvent::Execute_OnUnreadCountsChanged(ChannelEvent.Get(), Counts);
+	return true;
+}
+
+void SBChatUnreadCounter::SetCount(const FString& ChannelUrl, const FString& CustomType, int32 NewCount, int32 UntrackedCount)
+{
+	NewCount = FMath::Max(NewCount, 0);
+
+	FChannelCount* Known = ChannelCounts.Find(ChannelUrl);
+	const int32 Previous = Known != nullptr ? Known->Count : FMath::Max(UntrackedCount, 0);
+	if (Known == nullptr)
+		Known = &ChannelCounts.Add(ChannelUrl);
+	else if (Previous == NewCount)
+		return;
+
+	Known->Count = NewCount;
+	Known->CustomType = CustomType;
+
+	const int32 Delta = NewCount - Previous;
+	if (Delta != 0)
+	{
+		TotalCount = FMath::Max(TotalCount + Delta, 0);
+		if (!CustomType.IsEmpty())
+		{
+			int32& CustomTypeCount = CountByCustomType.FindOrAdd(CustomType);
+			CustomTypeCount = FMath::Max(CustomTypeCount + Delta, 0);
+		}
+	}
+
+	ChangedChannels.Add(ChannelUrl);
+	bDirty = true;
+	++ChangeCount;
+}
+//- private
+
+#if !UE_BUILD_SHIPPING
+
+namespace SBChatUnreadCounterCommands
+{
+	static void ShowUnreadCounts(const TArray<FString>& Args)
+	{
+		SBChatManager::Get().GetUnreadCounter().Report(*GLog);
+	}
+
+	static FAutoConsoleCommand UnreadCountsCommand(
+		TEXT("sbchat.Unread"),
+		TEXT("Prints the unread totals, per custom type and per channel, and how many changes went out as how many updates. Usage: sbchat.Unread"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&ShowUnreadCounts));
+}
+
+#endif
@@ -0,0 +1,73 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Sendbird/include/Sendbird.h"
+#include "SBChatCommonStruct.h"
+
+// Unread counts of group channels, kept up to date from events, so badges never wait for a channel list reload and
+// GetTotalUnreadMessageCount is never asked.
+// A channel's count starts from its unread_message_count when it is listed. After that, a message received while the
+// channel is not focused adds one. A message the user sent from another device, or focusing the channel, clears it. A
+// read receipt lowers it to the SDK's count. Each change moves the total and its custom type's total by the same
+// delta. Whenever the server reports totals (SBDUserEventHandler::TotalUnreadMessageCountChanged), they replace the
+// local ones; they also cover channels that were never listed.
+// Changes are coalesced: the game thread's ticker pushes at most one OnUnreadCountsChanged a frame, with the channels
+// that changed since the last one.
+// Channel events and focus changes reach it on the game thread, where the channel handler hands them over. The lock
+// covers what the SDK still calls on its threads: TotalUnreadMessageCountChanged, and Observe from channel list pages.
+class SBChatUnreadCounter : public SBDUserEventHandler
+{
+public:
+	SBChatUnreadCounter();
+	virtual ~SBChatUnreadCounter();
+
+	// Starts following the user's unread counts; called once connected.
+	void								Start();
+	void								Reset();
+
+	// Takes the channel's count from the server, e.g. from a channel list.
+	void								Observe(SBDGroupChannel* Channel);
+	// A message arrived in a channel that is not focused.
+	void								OnMessageReceived(SBDGroupChannel* Channel, bool bSentByCurrentUser);
+	void								OnReadReceiptUpdated(SBDGroupChannel* Channel);
+	// The channel is focused, so what it has is being read.
+	void								MarkRead(SBDGroupChannel* Channel);
+	void								RemoveChannel(const FString& ChannelUrl);
+
+	int32								GetChannelCount(const FString& ChannelUrl) const;
+	// Every known channel goes in ChannelCounts.
+	void								GetCounts(FSBUnreadCounts& OutCounts) const;
+	void								Report(FOutputDevice& Ar) const;
+
+	//+ SBDUserEventHandler
+	virtual void						TotalUnreadMessageCountChanged(int total_count, std::map<std::wstring, int> total_count_by_custom_type) override;
+	//- SBDUserEventHandler
+
+private:
+	struct FChannelCount
+	{
+		int32							Count = 0;
+		FString							CustomType;
+	};
+
+	bool								Tick(float DeltaTime);
+	// Moves the channel to NewCount and the totals by the difference. A channel not tracked yet is taken to have had
+	// UntrackedCount, the part of it the totals already hold: some of it once the server reported totals, none before.
+	void								SetCount(const FString& ChannelUrl, const FString& CustomType, int32 NewCount, int32 UntrackedCount);
+
+private:
+	mutable FCriticalSection			Lock;
+	TMap<FString, FChannelCount>		ChannelCounts;
+	int32								TotalCount;
+	TMap<FString, int32>				CountByCustomType;
+	bool								bServerTotals;		// the server reported totals since Start
+
+	TSet<FString>						ChangedChannels;
+	bool								bDirty;
+	int64								ChangeCount;		// changes applied
+	int64								PushCount;			// updates pushed to the UI
+	FTSTicker::FDelegateHandle			TickerHandle;
+};
@@ -0,0 +1,170 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#include "SBChatUserDirectory.h"
+#include "Hash/CityHash.h"
+
+static const int32 MIN_REMOVED_TO_COMPACT = 32;
+
+SBChatUserDirectory::SBChatUserDirectory()
+{
+	Channel = nullptr;
+	RemovedCount = 0;
+	Version = 0;
+}
+
+void SBChatUserDirectory::Reset(SBDBaseChannel* InChannel)
+{
+	FScopeLock ScopeLock(&Lock);
+	Channel = InChannel;
+	Front.Reset();
+	Back.Reset();
+	SlotByUserID.Reset();
+	RemovedCount = 0;
+	++Version;
+}
+
+SBDBaseChannel* SBChatUserDirectory::GetChannel() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Channel;
+}
+
+int32 SBChatUserDirectory::Num() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return SlotByUserID.Num();
+}
+
+bool SBChatUserDirectory::Add(const SBDUser& User)
+{
+	FScopeLock ScopeLock(&Lock);
+	return AddSlot(User, false);
+}
+
+bool SBChatUserDirectory::AddFront(const SBDUser& User)
+{
+	FScopeLock ScopeLock(&Lock);
+	return AddSlot(User, true);
+}
+
+bool SBChatUserDirectory::Remove(const std::wstring& UserID)
+{
+	FScopeLock ScopeLock(&Lock);
+	return RemoveSlot(UserID);
+}
+
+bool SBChatUserDirectory::Contains(const std::wstring& UserID) const
+{
+	FScopeLock ScopeLock(&Lock);
+	return SlotByUserID.Contains(UserID);
+}
+
+bool SBChatUserDirectory::Find(const std::wstring& UserID, SBDUser& OutUser) const
+{
+	FScopeLock ScopeLock(&Lock);
+	const int32* SlotID = SlotByUserID.Find(UserID);
+	if (SlotID == nullptr)
+		return false;
+
+	OutUser = GetSlot(*SlotID).User;
+	return true;
+}
+
+void SBChatUserDirectory::ApplyMembership(SBDBaseChannel* InChannel, const SBDUser& User, bool bJoined)
+{
+	FScopeLock ScopeLock(&Lock);
+	if (InChannel == nullptr || InChannel != Channel)
+		return;
+
+	if (bJoined)
+		AddSlot(User, false);
+	else
+		RemoveSlot(User.user_id);
+}
+
+void SBChatUserDirectory::GetUsers(TArray<SBDUser>& OutUsers) const
+{
+	FScopeLock ScopeLock(&Lock);
+	OutUsers.Reset(SlotByUserID.Num());
+	for (int32 Index = Front.Num() - 1; Index >= 0; --Index)
+	{
+		if (!Front[Index].bRemoved)
+			OutUsers.Add(Front[Index].User);
+	}
+
+	for (const FSlot& Slot : Back)
+	{
+		if (!Slot.bRemoved)
+			OutUsers.Add(Slot.User);
+	}
+}
+
+uint32 SBChatUserDirectory::GetVersion() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Version;
+}
+
+//+ private
+uint32 SBChatUserDirectory::FUserIDKeyFuncs::GetKeyHash(const std::wstring& Key)
+{
+	return CityHash32(reinterpret_cast<const char*>(Key.data()), (uint32)(Key.size() * sizeof(wchar_t)));
+}
+
+bool SBChatUserDirectory::AddSlot(const SBDUser& User, bool bFront)
+{
+	if (const int32* SlotID = SlotByUserID.Find(User.user_id))
+	{
+		GetSlot(*SlotID).User = User;
+		++Version;
+		return false;
+	}
+
+	TArray<FSlot>& Slots = bFront ? Front : Back;
+	const int32 Index = Slots.Add({ User, false });
+	SlotByUserID.Add(User.user_id, ToSlotID(bFront, Index));
+	++Version;
+	return true;
+}
+
+bool SBChatUserDirectory::RemoveSlot(const std::wstring& UserID)
+{
+	int32 SlotID = 0;
+	if (!SlotByUserID.RemoveAndCopyValue(UserID, SlotID))
+		return false;
+
+	GetSlot(SlotID).bRemoved = true;
+	++RemovedCount;
+	++Version;
+	CompactIfNeeded();
+	return true;
+}
+
+void SBChatUserDirectory::CompactIfNeeded()
+{
+	if (RemovedCount < MIN_REMOVED_TO_COMPACT || RemovedCount * 2 < Front.Num() + Back.Num())
+		return;
+
+	for (int32 Pass = 0; Pass < 2; ++Pass)
+	{
+		const bool bFront = Pass == 0;
+		TArray<FSlot>& Slots = bFront ? Front : Back;
+
+		int32 Kept = 0;
+		for (int32 Index = 0; Index < Slots.Num(); ++Index)
+		{
+			if (Slots[Index].bRemoved)
+				continue;
+
+			if (Kept != Index)
+				Slots[Kept] = MoveTemp(Slots[Index]);
+
+			SlotByUserID.FindChecked(Slots[Kept].User.user_id) = ToSlotID(bFront, Kept);
+			++Kept;
+		}
+		Slots.SetNum(Kept, false);
+	}
+
+	RemovedCount = 0;
+}
+//- private
@@ -0,0 +1,67 @@
+// Copyright (c) 2021 Sendbird, Inc. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Sendbird/include/Sendbird.h"
+
+// The user list shown by the sample (all users, open channel participants or group channel members), in display order,
+// with an index on user_id so lookups, adds and removes don't scan the list.
+// Users can be added at either end, so the order is kept as two arrays: Front (prepended, newest last) and Back (appended).
+// Removed slots are tombstoned and compacted once they make up half of the list.
+// When the list belongs to a channel, the channel handler keeps it current through ApplyMembership().
+class SBChatUserDirectory
+{
+public:
+	SBChatUserDirectory();
+
+	// Clears the list. Channel is the channel whose members or participants it will hold, if any.
+	void								Reset(SBDBaseChannel* InChannel = nullptr);
+	SBDBaseChannel*						GetChannel() const;
+	int32								Num() const;
+
+	// Return false when the user is already in the list; the stored user is refreshed in that case.
+	bool								Add(const SBDUser& User);
+	bool								AddFront(const SBDUser& User);
+	bool								Remove(const std::wstring& UserID);
+	bool								Contains(const std::wstring& UserID) const;
+	bool								Find(const std::wstring& UserID, SBDUser& OutUser) const;
+
+	// Membership change reported by the channel handler; ignored unless the list belongs to that channel.
+	void								ApplyMembership(SBDBaseChannel* InChannel, const SBDUser& User, bool bJoined);
+
+	void								GetUsers(TArray<SBDUser>& OutUsers) const;
+	// Bumped whenever a user is added, removed or refreshed, so game-thread consumers only re-read the list when it changed.
+	uint32								GetVersion() const;
+
+private:
+	struct FSlot
+	{
+		SBDUser							User;
+		bool							bRemoved;
+	};
+
+	struct FUserIDKeyFuncs : BaseKeyFuncs<TPair<std::wstring, int32>, std::wstring, false>
+	{
+		static const std::wstring&		GetSetKey(const TPair<std::wstring, int32>& Element) { return Element.Key; }
+		static bool						Matches(const std::wstring& A, const std::wstring& B) { return A == B; }
+		static uint32					GetKeyHash(const std::wstring& Key);
+	};
+
+	// Slot ids: Back[i] is i, Front[i] is -1 - i.
+	static int32						ToSlotID(bool bFront, int32 Index) { return bFront ? -1 - Index : Index; }
+	FSlot&								GetSlot(int32 SlotID) { return SlotID < 0 ? Front[-1 - SlotID] : Back[SlotID]; }
+	const FSlot&						GetSlot(int32 SlotID) const { return SlotID < 0 ? Front[-1 - SlotID] : Back[SlotID]; }
+	bool								AddSlot(const SBDUser& User, bool bFront);
+	bool								RemoveSlot(const std::wstring& UserID);
+	void								CompactIfNeeded();
+
+private:
+	mutable FCriticalSection			Lock;
+	SBDBaseChannel*						Channel;
+	TArray<FSlot>						Front;
+	TArray<FSlot>						Back;
+	TMap<std::wstring, int32, FDefaultSetAllocator, FUserIDKeyFuncs>	SlotByUserID;
+	int32								RemovedCount;
+	uint32								Version;
+};
@@ -10,6 +10,6 @@ public class SendbirdSample : ModuleRules
 		
 		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore" });
 
-		PrivateDependencyModuleNames.AddRange(new string[] { "OpenSSL", "Sendbird" });
+		PrivateDependencyModuleNames.AddRange(new string[] { "OpenSSL", "Sendbird", "HTTP", "ImageWrapper", "RenderCore", "RHI" });
 	}
 }